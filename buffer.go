@@ -0,0 +1,178 @@
+package extractous
+
+/*
+#include <extractous.h>
+*/
+import "C"
+import (
+	"runtime"
+	"sync"
+	"unsafe"
+)
+
+// Buffer is a reusable native output buffer for ExtractBytesInto and
+// ExtractFileInto.
+//
+// Each extraction overwrites the buffer's contents in place and only grows its
+// allocation when a document no longer fits, so a worker that keeps a Buffer
+// (or takes one from GetBuffer for each document) does not allocate for
+// content once the buffer has grown to its largest document. The content is
+// read with Bytes, without copying it into a Go string.
+//
+// A Buffer must not be used by several goroutines at once.
+type Buffer struct {
+	ptr *C.struct_CBuffer
+}
+
+var bufferPool = sync.Pool{
+	New: func() any { return NewBuffer(0) },
+}
+
+// NewBuffer creates an empty buffer with room for at least capacity bytes.
+// Returns nil if the memory cannot be allocated.
+func NewBuffer(capacity int) *Buffer {
+	if capacity < 0 {
+		capacity = 0
+	}
+	ptr := C.extractous_buffer_new(C.size_t(capacity))
+	if ptr == nil {
+		return nil
+	}
+	b := &Buffer{ptr: ptr}
+	runtime.SetFinalizer(b, (*Buffer).Close)
+	return b
+}
+
+// GetBuffer takes a buffer from a package-wide sync.Pool, creating one if the
+// pool is empty. Give it back with PutBuffer once its content has been used:
+//
+//	buf := extractous.GetBuffer()
+//	defer extractous.PutBuffer(buf)
+//	if _, err := extractor.ExtractBytesInto(data, buf); err != nil {
+//	    return err
+//	}
+//	index(buf.Bytes())
+func GetBuffer() *Buffer {
+	return bufferPool.Get().(*Buffer)
+}
+
+// PutBuffer empties buf and returns it to the pool used by GetBuffer. Slices
+// returned by its Bytes method must not be used afterwards.
+func PutBuffer(buf *Buffer) {
+	if buf == nil || buf.ptr == nil {
+		return
+	}
+	buf.Reset()
+	bufferPool.Put(buf)
+}
+
+// Bytes returns the buffer's contents. The slice points into native memory: it
+// is only valid until the next extraction into the buffer, Reserve, Close, or
+// PutBuffer, and must be copied to be kept.
+func (b *Buffer) Bytes() []byte {
+	if b == nil || b.ptr == nil || b.ptr.len == 0 {
+		return nil
+	}
+	return unsafe.Slice((*byte)(unsafe.Pointer(b.ptr.data)), int(b.ptr.len))
+}
+
+// String returns a copy of the buffer's contents.
+func (b *Buffer) String() string {
+	return string(b.Bytes())
+}
+
+// Len returns the length of the buffer's contents in bytes.
+func (b *Buffer) Len() int {
+	if b == nil || b.ptr == nil {
+		return 0
+	}
+	return int(b.ptr.len)
+}
+
+// Cap returns the size of the buffer's allocation in bytes.
+func (b *Buffer) Cap() int {
+	if b == nil || b.ptr == nil {
+		return 0
+	}
+	return int(b.ptr.capacity)
+}
+
+// Reserve grows the buffer so it holds at least capacity bytes in total
+// without reallocating. Its contents are kept.
+func (b *Buffer) Reserve(capacity int) error {
+	if b == nil || b.ptr == nil {
+		return ErrNullPointer
+	}
+	if capacity < 0 {
+		capacity = 0
+	}
+	if code := C.extractous_buffer_reserve(b.ptr, C.size_t(capacity)); code != errOK {
+		return newError(code)
+	}
+	return nil
+}
+
+// Reset empties the buffer, keeping its allocation.
+func (b *Buffer) Reset() {
+	if b != nil && b.ptr != nil {
+		C.extractous_buffer_clear(b.ptr)
+	}
+}
+
+// Close frees the buffer's native memory. It is safe to call more than once.
+//
+// Always returns nil (implements io.Closer for compatibility).
+func (b *Buffer) Close() error {
+	if b != nil && b.ptr != nil {
+		C.extractous_buffer_destroy(b.ptr)
+		b.ptr = nil
+		runtime.SetFinalizer(b, nil)
+	}
+	return nil
+}
+
+// ExtractBytesInto extracts a byte slice like ExtractBytesToString, writing
+// the content into buf instead of returning a new string. The result cache and
+// the content budget apply as for ExtractBytesToString. On error buf is left
+// unchanged.
+func (e *Extractor) ExtractBytesInto(data []byte, buf *Buffer) (Metadata, error) {
+	if e == nil || e.ptr == nil || buf == nil || buf.ptr == nil {
+		return nil, ErrNullPointer
+	}
+
+	if len(data) == 0 {
+		buf.Reset()
+		return make(Metadata), nil
+	}
+
+	var cMeta *C.struct_CMetadataPacked
+	code := C.extractous_extractor_extract_bytes_into(
+		e.ptr,
+		(*C.uint8_t)(&data[0]),
+		C.size_t(len(data)),
+		buf.ptr,
+		&cMeta,
+	)
+	if code != errOK {
+		return nil, newError(code)
+	}
+	return newPackedMetadata(cMeta), nil
+}
+
+// ExtractFileInto is like ExtractBytesInto, for a local file, and otherwise
+// behaves like ExtractFileToString.
+func (e *Extractor) ExtractFileInto(path string, buf *Buffer) (Metadata, error) {
+	if e == nil || e.ptr == nil || buf == nil || buf.ptr == nil {
+		return nil, ErrNullPointer
+	}
+
+	cPath := cString(path)
+	defer freeString(cPath)
+
+	var cMeta *C.struct_CMetadataPacked
+	code := C.extractous_extractor_extract_file_into(e.ptr, cPath, buf.ptr, &cMeta)
+	if code != errOK {
+		return nil, newError(code)
+	}
+	return newPackedMetadata(cMeta), nil
+}
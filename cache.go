@@ -0,0 +1,85 @@
+package extractous
+
+/*
+#include <extractous.h>
+#include <stdlib.h>
+*/
+import "C"
+import (
+	"runtime"
+	"unsafe"
+)
+
+// Cache is a content-addressed store of extraction results, shared by the
+// extractors it is attached to with Extractor.SetCache.
+//
+// Entries are keyed by a hash of the input bytes and of the extractor's whole
+// configuration, so a duplicate document parsed with the same settings is
+// answered from the cache without running the parser (or OCR) again. The
+// memory tier is bounded in bytes and evicts least recently used entries; an
+// optional disk tier (SetDiskTier) keeps entries across restarts.
+//
+// Only ExtractBytesToString and ExtractFileMmapToString use the cache.
+// Streaming, path and URL extractions always parse.
+//
+//	cache := extractous.NewCache(256 << 20)
+//	defer cache.Close()
+//	extractor := extractous.New().SetCache(cache)
+//
+// Hits and misses are counted in Stats as CacheHits and CacheMisses.
+type Cache struct {
+	ptr *C.struct_CResultCache
+}
+
+// NewCache creates an empty cache holding at most maxBytes of content and
+// metadata in memory. A bound of 0 keeps nothing in memory, which is useful
+// together with a disk tier.
+func NewCache(maxBytes int64) *Cache {
+	if maxBytes < 0 {
+		maxBytes = 0
+	}
+	c := &Cache{ptr: C.extractous_cache_new(C.uint64_t(maxBytes))}
+	runtime.SetFinalizer(c, (*Cache).Close)
+	return c
+}
+
+// SetDiskTier backs the cache with dir, holding at most maxBytes of entries.
+// The directory is created if needed, and entries already in it are reused,
+// including by later library releases.
+// An empty dir detaches the disk tier and keeps its files.
+func (c *Cache) SetDiskTier(dir string, maxBytes int64) error {
+	if c == nil || c.ptr == nil {
+		return newError(errNullPointer)
+	}
+	if maxBytes < 0 {
+		maxBytes = 0
+	}
+	var cDir *C.char
+	if dir != "" {
+		cDir = C.CString(dir)
+		defer C.free(unsafe.Pointer(cDir))
+	}
+	if code := C.extractous_cache_set_disk_tier(c.ptr, cDir, C.uint64_t(maxBytes)); code != errOK {
+		return newError(code)
+	}
+	return nil
+}
+
+// Clear removes every entry, including the files of the disk tier.
+func (c *Cache) Clear() {
+	if c != nil && c.ptr != nil {
+		C.extractous_cache_clear(c.ptr)
+	}
+}
+
+// Close releases the caller's reference to the cache. Extractors it is
+// attached to keep using it until they are closed or detached.
+//
+// Always returns nil (implements io.Closer for compatibility).
+func (c *Cache) Close() error {
+	if c != nil && c.ptr != nil {
+		C.extractous_cache_free(c.ptr)
+		c.ptr = nil
+	}
+	return nil
+}
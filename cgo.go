@@ -28,7 +28,9 @@ package extractous
 */
 import "C"
 import (
+	"io"
 	"runtime"
+	"runtime/cgo"
 	"unsafe"
 )
 
@@ -50,3 +52,98 @@ func goString(cs *C.char) string {
 func freeString(cs *C.char) {
 	C.free(unsafe.Pointer(cs))
 }
+
+// goStringFromBuffer copies a length-prefixed C buffer into a Go string.
+//
+// Unlike goString this performs a single copy without scanning for a NUL
+// terminator, so interior NUL bytes are preserved and lengths beyond the
+// C.GoStringN int limit are supported.
+func goStringFromBuffer(buf *C.uint8_t, n C.size_t) string {
+	if buf == nil || n == 0 {
+		return ""
+	}
+	return string(unsafe.Slice((*byte)(unsafe.Pointer(buf)), int(n)))
+}
+
+// goReleasePinnedBytes is the native release callback for buffers borrowed by
+// extractous_extractor_extract_bytes_borrowed. userData carries the cgo.Handle
+// of the runtime.Pinner that keeps the buffer in place.
+//
+//export goReleasePinnedBytes
+func goReleasePinnedBytes(userData unsafe.Pointer) {
+	h := cgo.Handle(uintptr(userData))
+	h.Value().(*runtime.Pinner).Unpin()
+	h.Delete()
+}
+
+// maxConsecutiveEmptyReads bounds how many times goReadCallback retries a
+// reader that returns no data and no error, as in bufio.
+const maxConsecutiveEmptyReads = 100
+
+// readerState is the Go side of a native read callback used by ExtractReader.
+type readerState struct {
+	r   io.Reader
+	err error // first non-EOF error returned by r
+}
+
+// goReadCallback is the native read callback for
+// extractous_extractor_extract_reader. userData carries the cgo.Handle of a
+// *readerState. It returns the number of bytes written to buf, 0 at EOF, or -1
+// after recording the reader's error, or io.ErrNoProgress if the reader keeps
+// returning no data and no error.
+//
+//export goReadCallback
+func goReadCallback(userData unsafe.Pointer, buf *C.uint8_t, n C.size_t) C.intptr_t {
+	state := cgo.Handle(uintptr(userData)).Value().(*readerState)
+	if state.err != nil {
+		return -1
+	}
+	if n == 0 {
+		return 0
+	}
+	p := unsafe.Slice((*byte)(unsafe.Pointer(buf)), int(n))
+	for tries := 0; tries < maxConsecutiveEmptyReads; tries++ {
+		read, err := state.r.Read(p)
+		if read > 0 {
+			// A trailing error fails the next call, which the native
+			// side makes because this one did not return 0.
+			if err != nil && err != io.EOF {
+				state.err = err
+			}
+			return C.intptr_t(read)
+		}
+		if err == io.EOF {
+			return 0
+		}
+		if err != nil {
+			state.err = err
+			return -1
+		}
+	}
+	state.err = io.ErrNoProgress
+	return -1
+}
+
+// goAsyncComplete is the native completion callback for
+// extractous_extractor_extract_file_async. It runs on a native worker thread;
+// userData carries the cgo.Handle of the buffered result channel, which receives
+// the outcome and is closed. The job's accounting is read here, on the thread
+// that ran it.
+//
+//export goAsyncComplete
+func goAsyncComplete(userData unsafe.Pointer, code C.int, content *C.uint8_t, n C.size_t, meta *C.struct_CMetadataPacked) {
+	h := cgo.Handle(uintptr(userData))
+	ch := h.Value().(chan AsyncResult)
+	h.Delete()
+
+	r := AsyncResult{Stats: lastCallStats()}
+	if code != errOK {
+		r.Err = newError(code)
+	} else {
+		r.Content = goStringFromBuffer(content, n)
+		C.extractous_buffer_free(content, n)
+		r.Metadata = newPackedMetadata(meta)
+	}
+	ch <- r
+	close(ch)
+}
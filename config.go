@@ -451,6 +451,11 @@ func (c *OfficeConfig) free() {
 //   - Using lower DPI for faster processing (at the cost of accuracy)
 //   - Enabling image preprocessing for better results on low-quality scans
 //
+// The core OCRs the pages of one document one after another, in page order.
+// Density, depth and the timeout apply to each page. The only way to keep more
+// cores busy is to run several documents at once, with ExtractFilesBatch, a
+// Pool or goroutines sharing one Extractor.
+//
 // # Usage Pattern
 //
 // Configuration objects use the builder pattern:
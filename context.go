@@ -0,0 +1,88 @@
+package extractous
+
+/*
+#include <extractous.h>
+*/
+import "C"
+import (
+	"context"
+	"fmt"
+)
+
+// cancelToken ties a native cancel token to a context.Context: the token is
+// cancelled as soon as the context is done.
+//
+// A nil *cancelToken stands for a context that can never be cancelled, such as
+// context.Background(), and costs nothing.
+//
+// Internal use only.
+type cancelToken struct {
+	ptr  *C.struct_CCancelToken
+	ctx  context.Context
+	stop func() bool   // Deregisters the AfterFunc
+	done chan struct{} // Closed once the AfterFunc has cancelled the token
+}
+
+// newCancelToken returns a token that follows ctx, or nil if ctx can never be
+// cancelled. Callers must release the token.
+//
+// Internal use only.
+func newCancelToken(ctx context.Context) *cancelToken {
+	if ctx.Done() == nil {
+		return nil
+	}
+	t := &cancelToken{
+		ptr:  C.extractous_cancel_token_new(),
+		ctx:  ctx,
+		done: make(chan struct{}),
+	}
+	t.stop = context.AfterFunc(ctx, func() {
+		C.extractous_cancel_token_cancel(t.ptr)
+		close(t.done)
+	})
+	return t
+}
+
+// c returns the native token, or nil for a nil token.
+func (t *cancelToken) c() *C.struct_CCancelToken {
+	if t == nil {
+		return nil
+	}
+	return t.ptr
+}
+
+// cancelled reports whether the context behind the token is done.
+func (t *cancelToken) cancelled() bool {
+	return t != nil && t.ctx.Err() != nil
+}
+
+// err converts a native error code into a Go error. ERR_CANCELLED also wraps
+// the context's cause, so errors.Is matches context.Canceled and
+// context.DeadlineExceeded.
+func (t *cancelToken) err(code C.int) error {
+	if code == errCancelled && t != nil {
+		return cancelledError(t.ctx)
+	}
+	return newError(code)
+}
+
+// release deregisters the token from its context and frees it. Once release
+// returns, the context no longer refers to the token.
+func (t *cancelToken) release() {
+	if t == nil {
+		return
+	}
+	if !t.stop() {
+		// The AfterFunc has started; wait for it to finish with the token.
+		<-t.done
+	}
+	C.extractous_cancel_token_free(t.ptr)
+	t.ptr = nil
+}
+
+// cancelledError returns ErrCancelled wrapping the cause of ctx.
+//
+// Internal use only.
+func cancelledError(ctx context.Context) error {
+	return fmt.Errorf("%w: %w", newError(errCancelled), context.Cause(ctx))
+}
@@ -0,0 +1,49 @@
+package extractous
+
+/*
+#include <extractous.h>
+*/
+import "C"
+
+import "unsafe"
+
+// Detect returns the MIME type of a document from its magic bytes and
+// container headers alone, without parsing it, such as "application/pdf" or
+// "application/vnd.openxmlformats-officedocument.wordprocessingml.document".
+//
+// Only the first 64 KiB of data are looked at, and the native runtime is not
+// started, so detection takes microseconds where an extraction takes a full
+// parse. Use it to route documents or skip unsupported formats first:
+//
+//	if extractous.Detect(data) == "application/octet-stream" {
+//	    return errUnsupported
+//	}
+//
+// Text that is not HTML, XML or an e-mail is "text/plain", and anything
+// unrecognised is "application/octet-stream". The Content-Type reported by an
+// extraction can be more precise.
+func Detect(data []byte) string {
+	var cMime *C.char
+	var code C.int
+	if len(data) == 0 {
+		code = C.extractous_detect_bytes(nil, 0, &cMime)
+	} else {
+		code = C.extractous_detect_bytes((*C.uint8_t)(unsafe.Pointer(&data[0])), C.size_t(len(data)), &cMime)
+	}
+	if code != errOK {
+		return "application/octet-stream"
+	}
+	return goString(cMime)
+}
+
+// DetectFile is like Detect, for a local file. Only the first 64 KiB are read.
+func DetectFile(path string) (string, error) {
+	cPath := cString(path)
+	defer freeString(cPath)
+
+	var cMime *C.char
+	if code := C.extractous_detect_file(cPath, &cMime); code != errOK {
+		return "", newError(code)
+	}
+	return goString(cMime), nil
+}
@@ -160,6 +160,29 @@ var (
 	//	config := extractous.NewPdfConfig().SetOcrStrategy(strategy)
 	//	// May return ErrInvalidEnum
 	ErrInvalidEnum = errors.New("invalid enum value")
+
+	// ErrOutOfMemory indicates an extraction went over the memory limit set
+	// with SetMemoryLimit, or memory for its result could not be allocated.
+	// Only that extraction fails; the extractor stays usable.
+	ErrOutOfMemory = errors.New("out of memory")
+
+	// ErrCancelled indicates an extraction was stopped before it finished.
+	//
+	// It is returned by the Context variants of the extraction methods, and by
+	// StreamReader reads, once the context is cancelled or its deadline passes.
+	// The error also wraps the context's error, so errors.Is works with both:
+	//
+	//	ctx, cancel := context.WithTimeout(ctx, 30*time.Second)
+	//	defer cancel()
+	//	_, _, err := extractor.ExtractFileToStringContext(ctx, "document.pdf")
+	//	if errors.Is(err, context.DeadlineExceeded) {
+	//	    // Document took too long; skip it
+	//	}
+	ErrCancelled = errors.New("extraction cancelled")
+
+	// ErrPoolInUse is returned by Pool.Close while extractors acquired from
+	// the pool have not been returned yet.
+	ErrPoolInUse = errors.New("extractor pool has extractors in use")
 )
 
 // ExtractError wraps detailed extraction error information.
@@ -240,6 +263,10 @@ func newError(code C.int) error {
         sentinelErr = ErrInvalidConfig
     case errInvalidEnum:
         sentinelErr = ErrInvalidEnum
+    case errOutOfMemory:
+        sentinelErr = ErrOutOfMemory
+    case errCancelled:
+        sentinelErr = ErrCancelled
     default:
         sentinelErr = fmt.Errorf("unknown error code: %d", code)
     }
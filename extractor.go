@@ -3,9 +3,58 @@ package extractous
 /*
 #include <extractous.h>
 #include <stdlib.h>
+
+extern void goReleasePinnedBytes(void *user_data);
+
+// extract_bytes_pinned borrows a pinned Go buffer; the cgo.Handle travels as user_data
+// and is handed back to goReleasePinnedBytes once the stream no longer needs the bytes.
+static inline int extract_bytes_pinned(struct CExtractor *handle,
+                                       const uint8_t *data,
+                                       size_t data_len,
+                                       uintptr_t pin,
+                                       struct CStreamReader **out_reader,
+                                       struct CMetadataPacked **out_metadata) {
+    return extractous_extractor_extract_bytes_borrowed(handle, data, data_len,
+                                                       goReleasePinnedBytes, (void *)pin,
+                                                       out_reader, out_metadata);
+}
+
+extern intptr_t goReadCallback(void *user_data, uint8_t *buf, size_t len);
+
+// extract_from_reader pulls input through goReadCallback; the cgo.Handle of the Go
+// reader state travels as user_data.
+static inline int extract_from_reader(struct CExtractor *handle,
+                                      uintptr_t state,
+                                      size_t size_hint,
+                                      struct CStreamReader **out_reader,
+                                      struct CMetadataPacked **out_metadata) {
+    return extractous_extractor_extract_reader(handle, goReadCallback, (void *)state,
+                                               size_hint, out_reader, out_metadata);
+}
+
+extern void goAsyncComplete(void *user_data, int error_code, uint8_t *content,
+                            size_t content_len, struct CMetadataPacked *metadata);
+
+// extract_file_async submits a file to the native worker pool; the cgo.Handle of the
+// result channel travels as user_data and goAsyncComplete delivers the outcome to it.
+static inline int extract_file_async(struct CExtractor *handle,
+                                     const char *path,
+                                     uintptr_t result) {
+    return extractous_extractor_extract_file_async(handle, path, goAsyncComplete,
+                                                   (void *)result, NULL);
+}
 */
 import "C"
-import "runtime"
+import (
+	"context"
+	"fmt"
+	"io"
+	"runtime"
+	"runtime/cgo"
+	"sync"
+	"sync/atomic"
+	"unsafe"
+)
 
 // Extractor is the main entry point for document extraction.
 //
@@ -17,50 +66,43 @@ import "runtime"
 //
 // # Thread Safety
 //
-// Extractor instances are NOT safe for concurrent use by multiple goroutines.
-// Each goroutine should create its own Extractor instance. The underlying
-// implementation requires thread affinity, and sharing extractors across
-// goroutines can lead to undefined behavior and crashes.
+// An Extractor is safe for concurrent use by multiple goroutines, so one instance
+// can serve a whole worker pool:
 //
-//	// WRONG - unsafe concurrent use
-//	extractor := extractous.New()
-//	for _, file := range files {
-//	    go func(f string) {
-//	        extractor.ExtractFileToString(f) // UNSAFE!
-//	    }(file)
-//	}
-//
-//	// CORRECT - separate extractor per goroutine
+//	extractor := extractous.New().SetXmlOutput(true)
+//	defer extractor.Close()
 //	for _, file := range files {
 //	    go func(f string) {
-//	        extractor := extractous.New()
-//	        defer extractor.Close()
 //	        extractor.ExtractFileToString(f) // Safe
 //	    }(file)
 //	}
 //
+// Each extraction runs against an immutable snapshot of the configuration taken
+// when it starts. Set* methods atomically publish a new snapshot, so they may be
+// called while other goroutines are extracting; extractions already running keep
+// their old configuration. Close must not be called while the extractor is
+// still in use, and StreamReaders are not safe for concurrent use.
+//
 // # Memory Management
 //
 // Extractors use finalizers for automatic cleanup, but calling Close() explicitly
 // is strongly recommended for deterministic resource cleanup, especially in
 // long-running applications or when processing many documents.
 //
-// Builder methods (Set*) follow the builder pattern and return a new Extractor
-// instance. The old instance is consumed and should not be used:
-//
-//	// WRONG - old extractor is invalid
-//	extractor := extractous.New()
-//	extractor.SetXmlOutput(true) // extractor is now invalid!
+// Set* methods update the extractor in place and return the same Extractor, so
+// calls can be chained; the return value never needs to replace the receiver:
 //
-//	// CORRECT - use returned value
 //	extractor := extractous.New()
-//	extractor = extractor.SetXmlOutput(true) // extractor is valid
+//	extractor.SetXmlOutput(true) // extractor now produces XML
 //
-//	// BEST - chain method calls
+//	// Or, chained
 //	extractor := extractous.New().
 //	    SetExtractStringMaxLength(10000).
 //	    SetXmlOutput(true)
 //
+// Every goroutine sharing the extractor sees the change from its next
+// extraction on, as described under Thread Safety.
+//
 // # Basic Usage
 //
 // Extract a document to a string:
@@ -111,7 +153,9 @@ import "runtime"
 //	    fmt.Print(string(buf[:n]))
 //	}
 type Extractor struct {
-	ptr *C.struct_CExtractor
+	ptr  *C.struct_CExtractor
+	pool *Pool                       // Set for extractors acquired from a Pool
+	http atomic.Pointer[httpFetcher] // Set by SetHTTPConfig
 }
 
 // New creates a new Extractor with default configuration.
@@ -155,8 +199,9 @@ func New() *Extractor {
 //	extractor := extractous.New().
 //	    SetExtractStringMaxLength(10 * 1024 * 1024)
 //
-// This method consumes the receiver and returns a new Extractor. Always use the
-// returned value.
+// The extractor is updated in place and returned for chaining. It may be
+// called while other goroutines extract with it; extractions already running
+// keep the previous setting.
 //
 // Returns nil if the configuration failed.
 func (e *Extractor) SetExtractStringMaxLength(maxLen int) *Extractor {
@@ -180,7 +225,9 @@ func (e *Extractor) SetExtractStringMaxLength(maxLen int) *Extractor {
 //	extractor := extractous.New().
 //	    SetEncoding(extractous.CharSetUTF8)
 //
-// This method consumes the receiver and returns a new Extractor.
+// The extractor is updated in place and returned for chaining. It may be
+// called while other goroutines extract with it; extractions already running
+// keep the previous setting.
 //
 // Returns nil if the encoding is invalid.
 func (e *Extractor) SetEncoding(charset CharSet) *Extractor {
@@ -206,7 +253,9 @@ func (e *Extractor) SetEncoding(charset CharSet) *Extractor {
 // The config is consumed by this method and becomes owned by the Extractor.
 // Do not use the config after passing it to this method.
 //
-// This method consumes the receiver and returns a new Extractor.
+// The extractor is updated in place and returned for chaining. It may be
+// called while other goroutines extract with it; extractions already running
+// keep the previous setting.
 //
 // Returns nil if the config is nil or invalid.
 func (e *Extractor) SetPdfConfig(config *PdfConfig) *Extractor {
@@ -234,7 +283,9 @@ func (e *Extractor) SetPdfConfig(config *PdfConfig) *Extractor {
 //
 // The config is consumed by this method and becomes owned by the Extractor.
 //
-// This method consumes the receiver and returns a new Extractor.
+// The extractor is updated in place and returned for chaining. It may be
+// called while other goroutines extract with it; extractions already running
+// keep the previous setting.
 //
 // Returns nil if the config is nil or invalid.
 func (e *Extractor) SetOfficeConfig(config *OfficeConfig) *Extractor {
@@ -270,7 +321,9 @@ func (e *Extractor) SetOfficeConfig(config *OfficeConfig) *Extractor {
 //
 // The config is consumed by this method and becomes owned by the Extractor.
 //
-// This method consumes the receiver and returns a new Extractor.
+// The extractor is updated in place and returned for chaining. It may be
+// called while other goroutines extract with it; extractions already running
+// keep the previous setting.
 //
 // Returns nil if the config is nil or invalid.
 func (e *Extractor) SetOcrConfig(config *OcrConfig) *Extractor {
@@ -293,7 +346,9 @@ func (e *Extractor) SetOcrConfig(config *OcrConfig) *Extractor {
 //	extractor := extractous.New().
 //	    SetXmlOutput(true)
 //
-// This method consumes the receiver and returns a new Extractor.
+// The extractor is updated in place and returned for chaining. It may be
+// called while other goroutines extract with it; extractions already running
+// keep the previous setting.
 //
 // Returns nil if the configuration failed.
 func (e *Extractor) SetXmlOutput(xmlOutput bool) *Extractor {
@@ -304,6 +359,130 @@ func (e *Extractor) SetXmlOutput(xmlOutput bool) *Extractor {
 	return e
 }
 
+// SetContentBudget stops extractions once maxBytes of content have been
+// produced, without parsing the rest of the document. A value of 0 or less
+// removes the budget.
+//
+// Unlike SetExtractStringMaxLength, which truncates text after the whole
+// document has been parsed, the budget ends the parse itself, which makes
+// previews of large documents cheap, and it has no 2 GB limit. Streams end
+// with io.EOF once the budget is spent. For the string and buffer methods the
+// budget counts UTF-8 bytes and never splits a character; the string max
+// length, counted in bytes, still applies if it is smaller. Metadata is not
+// affected.
+//
+// Example:
+//
+//	// Preview: the first 64 KB of text
+//	extractor := extractous.New().
+//	    SetContentBudget(64 << 10)
+//
+// Returns nil if the extractor is closed.
+func (e *Extractor) SetContentBudget(maxBytes int64) *Extractor {
+	if e == nil || e.ptr == nil {
+		return nil
+	}
+	if maxBytes < 0 {
+		maxBytes = 0
+	}
+	C.extractous_extractor_set_content_budget_mut(e.ptr, C.uint64_t(maxBytes))
+	return e
+}
+
+// SetMemoryLimit makes extractions that need more than maxBytes of memory fail
+// with ErrOutOfMemory, stopping their parse, while other extractions carry
+// on. 0 or a negative value removes the limit.
+//
+// The limit covers the extracted content held by the native library and, on
+// Linux, the growth of the process's resident memory while the extraction
+// runs, which includes the parser's heap. That growth is process-wide: with
+// concurrent extractions, it is charged to whichever one observes it. Memory
+// held by the Go side, such as the string returned to the caller, is not
+// counted. On other platforms only the native content is limited.
+//
+// Example:
+//
+//	// Skip documents that need more than 512 MB
+//	extractor := extractous.New().
+//	    SetMemoryLimit(512 << 20)
+//
+// Returns nil if the extractor is closed.
+func (e *Extractor) SetMemoryLimit(maxBytes int64) *Extractor {
+	if e == nil || e.ptr == nil {
+		return nil
+	}
+	if maxBytes < 0 {
+		maxBytes = 0
+	}
+	C.extractous_extractor_set_memory_limit_mut(e.ptr, C.uint64_t(maxBytes))
+	return e
+}
+
+// Normalization selects text normalization stages for SetNormalization.
+// Values can be combined with |.
+type Normalization uint32
+
+const (
+	NormalizeStripControl       Normalization = C.NORMALIZE_STRIP_CONTROL       // Drop control characters other than tab and line breaks
+	NormalizeCollapseWhitespace Normalization = C.NORMALIZE_COLLAPSE_WHITESPACE // Collapse whitespace runs and trim the content
+	NormalizeDehyphenate        Normalization = C.NORMALIZE_DEHYPHENATE         // Join words hyphenated across line breaks
+	NormalizeAll                Normalization = C.NORMALIZE_ALL                 // Every stage above
+)
+
+// SetNormalization makes the native library normalize extracted content as
+// it is read, so text needs no second pass in Go. 0 turns normalization off.
+//
+// The stages apply to StreamReader reads and events and to every string and
+// buffer method, which are then cut at the string max length in bytes
+// rather than characters.
+// NormalizeStripControl drops control characters other than tab, \n and \r,
+// including DEL and U+0080 to U+009F. NormalizeDehyphenate removes a hyphen
+// after a letter when a line break and a lowercase letter follow, as in
+// justified PDF text. NormalizeCollapseWhitespace turns each whitespace run
+// into one space, one line break, or a blank line if it held two or more
+// line breaks, and trims the start and end. The content budget counts
+// normalized bytes. Metadata is not affected. The stages work on UTF-8, so
+// while any are set content is produced in UTF-8 whatever SetEncoding chose.
+//
+// Example:
+//
+//	extractor := extractous.New().
+//	    SetNormalization(extractous.NormalizeAll)
+//
+// Returns nil if the extractor is closed.
+func (e *Extractor) SetNormalization(stages Normalization) *Extractor {
+	if e == nil || e.ptr == nil {
+		return nil
+	}
+	C.extractous_extractor_set_normalization_mut(e.ptr, C.uint32_t(stages))
+	return e
+}
+
+// SetCache attaches a result cache, or detaches the current one when cache is
+// nil. See Cache for which methods use it.
+//
+// Example:
+//
+//	cache := extractous.NewCache(256 << 20)
+//	extractor := extractous.New().SetCache(cache)
+//
+// Returns nil if the extractor or the cache is closed.
+func (e *Extractor) SetCache(cache *Cache) *Extractor {
+	if e == nil || e.ptr == nil {
+		return nil
+	}
+	var cCache *C.struct_CResultCache
+	if cache != nil {
+		if cache.ptr == nil {
+			return nil
+		}
+		cCache = cache.ptr
+	}
+	C.extractous_extractor_set_cache_mut(e.ptr, cCache)
+	runtime.KeepAlive(cache)
+	return e
+}
+
 // ExtractFileToString extracts a file's content to a string.
 //
 // This method loads the entire document content into memory, which is suitable
@@ -335,6 +514,9 @@ func (e *Extractor) SetXmlOutput(xmlOutput bool) *Extractor {
 //	fmt.Println("Author:", metadata.Get("author"))
 //
 // Supported file formats: PDF, DOCX, XLSX, PPTX, ODT, HTML, TXT, and many more.
+//
+// The content is received from the native library as a length-prefixed buffer
+// and copied into Go memory exactly once; interior NUL bytes are preserved.
 func (e *Extractor) ExtractFileToString(path string) (content string, metadata Metadata, err error) {
 	if e == nil || e.ptr == nil {
 		return "", nil, ErrNullPointer
@@ -343,18 +525,19 @@ func (e *Extractor) ExtractFileToString(path string) (content string, metadata M
 	cPath := cString(path)
 	defer freeString(cPath)
 
-	var cContent *C.char
-	var cMeta *C.struct_CMetadata
+	var cContent *C.uint8_t
+	var cLen C.size_t
+	var cMeta *C.struct_CMetadataPacked
 
-	code := C.extractous_extractor_extract_file_to_string(e.ptr, cPath, &cContent, &cMeta)
+	code := C.extractous_extractor_extract_file_to_buffer_packed(e.ptr, cPath, &cContent, &cLen, &cMeta)
 	if code != errOK {
 		return "", nil, newError(code)
 	}
 
-	content = goString(cContent)
-	C.extractous_string_free(cContent)
+	content = goStringFromBuffer(cContent, cLen)
+	C.extractous_buffer_free(cContent, cLen)
 
-	metadata = newMetadata(cMeta)
+	metadata = newPackedMetadata(cMeta)
 	return content, metadata, nil
 }
 
@@ -406,18 +589,89 @@ func (e *Extractor) ExtractFile(path string) (reader *StreamReader, metadata Met
 	defer freeString(cPath)
 
 	var cReader *C.struct_CStreamReader
-	var cMeta *C.struct_CMetadata
+	var cMeta *C.struct_CMetadataPacked
+
+	code := C.extractous_extractor_extract_file_packed(e.ptr, cPath, &cReader, &cMeta)
+	if code != errOK {
+		return nil, nil, newError(code)
+	}
+
+	reader = newStreamReader(cReader)
+	metadata = newPackedMetadata(cMeta)
+	return reader, metadata, nil
+}
+
+// ExtractFileMmap extracts a file's content as a streaming reader, using a
+// read-only memory mapping of the file as parser input.
+//
+// Unlike ExtractBytes, the file is never loaded into a Go []byte, and unlike
+// ExtractFile the native side hands the mapped pages straight to the parser
+// without a heap copy. Peak memory stays close to the parser's working set,
+// which makes this the preferred path for very large local files.
+//
+// The mapping is held until the reader is closed. The file must not be
+// truncated while the reader is open. On platforms without mmap (Windows) the
+// file is read into native memory instead.
+//
+// Example:
+//
+//	reader, metadata, err := extractor.ExtractFileMmap("huge.pdf")
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	defer reader.Close()
+//
+//	io.Copy(os.Stdout, reader)
+func (e *Extractor) ExtractFileMmap(path string) (reader *StreamReader, metadata Metadata, err error) {
+	if e == nil || e.ptr == nil {
+		return nil, nil, ErrNullPointer
+	}
+
+	cPath := cString(path)
+	defer freeString(cPath)
+
+	var cReader *C.struct_CStreamReader
+	var cMeta *C.struct_CMetadataPacked
 
-	code := C.extractous_extractor_extract_file(e.ptr, cPath, &cReader, &cMeta)
+	code := C.extractous_extractor_extract_mmap_packed(e.ptr, cPath, &cReader, &cMeta)
 	if code != errOK {
 		return nil, nil, newError(code)
 	}
 
 	reader = newStreamReader(cReader)
-	metadata = newMetadata(cMeta)
+	metadata = newPackedMetadata(cMeta)
 	return reader, metadata, nil
 }
 
+// ExtractFileMmapToString extracts a file's content to a string, using a
+// read-only memory mapping of the file as parser input.
+//
+// See ExtractFileMmap for the memory behaviour. The mapping is released
+// before this method returns.
+func (e *Extractor) ExtractFileMmapToString(path string) (content string, metadata Metadata, err error) {
+	if e == nil || e.ptr == nil {
+		return "", nil, ErrNullPointer
+	}
+
+	cPath := cString(path)
+	defer freeString(cPath)
+
+	var cContent *C.uint8_t
+	var cLen C.size_t
+	var cMeta *C.struct_CMetadataPacked
+
+	code := C.extractous_extractor_extract_mmap_to_buffer_packed(e.ptr, cPath, &cContent, &cLen, &cMeta)
+	if code != errOK {
+		return "", nil, newError(code)
+	}
+
+	content = goStringFromBuffer(cContent, cLen)
+	C.extractous_buffer_free(cContent, cLen)
+
+	metadata = newPackedMetadata(cMeta)
+	return content, metadata, nil
+}
+
 // ExtractBytesToString extracts content from a byte slice to a string.
 //
 // Use this when you have document data already loaded in memory (e.g., from a
@@ -458,25 +712,26 @@ func (e *Extractor) ExtractBytesToString(data []byte) (content string, metadata
 		return "", make(Metadata), nil
 	}
 
-	var cContent *C.char
-	var cMeta *C.struct_CMetadata
+	var cContent *C.uint8_t
+	var cLen C.size_t
+	var cMeta *C.struct_CMetadataPacked
 
-	code := C.extractous_extractor_extract_bytes_to_string(
+	code := C.extractous_extractor_extract_bytes_to_buffer_packed(
 		e.ptr,
 		(*C.uint8_t)(&data[0]),
 		C.size_t(len(data)),
 		&cContent,
+		&cLen,
 		&cMeta,
 	)
-
 	if code != errOK {
 		return "", nil, newError(code)
 	}
 
-	content = goString(cContent)
-	C.extractous_string_free(cContent)
+	content = goStringFromBuffer(cContent, cLen)
+	C.extractous_buffer_free(cContent, cLen)
 
-	metadata = newMetadata(cMeta)
+	metadata = newPackedMetadata(cMeta)
 	return content, metadata, nil
 }
 
@@ -520,12 +775,67 @@ func (e *Extractor) ExtractBytes(data []byte) (reader *StreamReader, metadata Me
 	}
 
 	var cReader *C.struct_CStreamReader
-	var cMeta *C.struct_CMetadata
+	var cMeta *C.struct_CMetadataPacked
+
+	code := C.extractous_extractor_extract_bytes_packed(
+		e.ptr,
+		(*C.uint8_t)(&data[0]),
+		C.size_t(len(data)),
+		&cReader,
+		&cMeta,
+	)
+
+	if code != errOK {
+		return nil, nil, newError(code)
+	}
+
+	reader = newStreamReader(cReader)
+	metadata = newPackedMetadata(cMeta)
+	return reader, metadata, nil
+}
+
+// ExtractBytesNoCopy extracts content from a byte slice to a streaming reader
+// without copying the slice.
+//
+// ExtractBytes only lends data to the native library for the duration of the
+// call, so the parser has to work from its own copy. ExtractBytesNoCopy pins
+// data with a runtime.Pinner instead and lets the parser read it in place for
+// as long as the reader is open. This halves peak memory for
+// documents that are already held in memory.
+//
+// data must not be modified until the returned reader is closed. The pin is
+// released when the reader is closed, or immediately if extraction fails.
+//
+// Example:
+//
+//	obj, _ := io.ReadAll(s3Object.Body)
+//	reader, metadata, err := extractor.ExtractBytesNoCopy(obj)
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	defer reader.Close() // obj may be reused after this
+func (e *Extractor) ExtractBytesNoCopy(data []byte) (reader *StreamReader, metadata Metadata, err error) {
+	if e == nil || e.ptr == nil {
+		return nil, nil, ErrNullPointer
+	}
+
+	if len(data) == 0 {
+		return nil, make(Metadata), nil
+	}
+
+	// Unpinned by goReleasePinnedBytes, which the native side calls exactly once.
+	pinner := new(runtime.Pinner)
+	pinner.Pin(&data[0])
+	pin := cgo.NewHandle(pinner)
+
+	var cReader *C.struct_CStreamReader
+	var cMeta *C.struct_CMetadataPacked
 
-	code := C.extractous_extractor_extract_bytes(
+	code := C.extract_bytes_pinned(
 		e.ptr,
 		(*C.uint8_t)(&data[0]),
 		C.size_t(len(data)),
+		C.uintptr_t(pin),
 		&cReader,
 		&cMeta,
 	)
@@ -535,7 +845,65 @@ func (e *Extractor) ExtractBytes(data []byte) (reader *StreamReader, metadata Me
 	}
 
 	reader = newStreamReader(cReader)
-	metadata = newMetadata(cMeta)
+	metadata = newPackedMetadata(cMeta)
+	return reader, metadata, nil
+}
+
+// ExtractReader extracts content from an io.Reader to a streaming reader.
+//
+// Input is pulled from r on demand by the native library, so documents coming
+// from network streams (S3 objects, Kafka messages, HTTP bodies) can be
+// extracted without first being collected into a Go []byte or spilled to a
+// temporary file.
+//
+// The parser needs its complete input before it starts, so r is read to EOF
+// into a single native buffer before ExtractReader returns. If r implements
+// Len() int (as *bytes.Reader and *bytes.Buffer do), that length is used to
+// size the buffer up front. r is not used after ExtractReader returns.
+//
+// An error returned by r aborts the extraction; the returned error wraps both
+// ErrIO and the reader's error.
+//
+// Example:
+//
+//	obj, err := s3Client.GetObject(ctx, input)
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	defer obj.Body.Close()
+//
+//	reader, metadata, err := extractor.ExtractReader(obj.Body)
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	defer reader.Close()
+func (e *Extractor) ExtractReader(r io.Reader) (reader *StreamReader, metadata Metadata, err error) {
+	if e == nil || e.ptr == nil || r == nil {
+		return nil, nil, ErrNullPointer
+	}
+
+	var sizeHint int
+	if l, ok := r.(interface{ Len() int }); ok {
+		sizeHint = l.Len()
+	}
+
+	state := &readerState{r: r}
+	h := cgo.NewHandle(state)
+	defer h.Delete()
+
+	var cReader *C.struct_CStreamReader
+	var cMeta *C.struct_CMetadataPacked
+
+	code := C.extract_from_reader(e.ptr, C.uintptr_t(h), C.size_t(sizeHint), &cReader, &cMeta)
+	if code != errOK {
+		if state.err != nil {
+			return nil, nil, fmt.Errorf("%w: %w", newError(code), state.err)
+		}
+		return nil, nil, newError(code)
+	}
+
+	reader = newStreamReader(cReader)
+	metadata = newPackedMetadata(cMeta)
 	return reader, metadata, nil
 }
 
@@ -568,27 +936,36 @@ func (e *Extractor) ExtractBytes(data []byte) (reader *StreamReader, metadata Me
 //
 // Note: This method downloads the entire document before extraction. For large
 // remote documents, consider downloading to a file first and using ExtractFile,
-// or use ExtractURL for streaming.
+// or use ExtractURL for streaming. Use SetHTTPConfig for connection reuse,
+// timeouts and size and per-host limits.
 func (e *Extractor) ExtractURLToString(url string) (content string, metadata Metadata, err error) {
 	if e == nil || e.ptr == nil {
 		return "", nil, ErrNullPointer
 	}
+	if f := e.http.Load(); f != nil {
+		data, err := f.fetch(url)
+		if err != nil {
+			return "", nil, err
+		}
+		return e.ExtractBytesToString(data)
+	}
 
 	cUrl := cString(url)
 	defer freeString(cUrl)
 
-	var cContent *C.char
-	var cMeta *C.struct_CMetadata
+	var cContent *C.uint8_t
+	var cLen C.size_t
+	var cMeta *C.struct_CMetadataPacked
 
-	code := C.extractous_extractor_extract_url_to_string(e.ptr, cUrl, &cContent, &cMeta)
+	code := C.extractous_extractor_extract_url_to_buffer_packed(e.ptr, cUrl, &cContent, &cLen, &cMeta)
 	if code != errOK {
 		return "", nil, newError(code)
 	}
 
-	content = goString(cContent)
-	C.extractous_string_free(cContent)
+	content = goStringFromBuffer(cContent, cLen)
+	C.extractous_buffer_free(cContent, cLen)
 
-	metadata = newMetadata(cMeta)
+	metadata = newPackedMetadata(cMeta)
 
 	return content, metadata, nil
 }
@@ -622,24 +999,441 @@ func (e *Extractor) ExtractURL(url string) (reader *StreamReader, metadata Metad
 	if e == nil || e.ptr == nil {
 		return nil, nil, ErrNullPointer
 	}
+	if f := e.http.Load(); f != nil {
+		data, err := f.fetch(url)
+		if err != nil {
+			return nil, nil, err
+		}
+		return e.ExtractBytes(data)
+	}
 
 	cUrl := cString(url)
 	defer freeString(cUrl)
 
 	var cReader *C.struct_CStreamReader
-	var cMeta *C.struct_CMetadata
+	var cMeta *C.struct_CMetadataPacked
 
-	code := C.extractous_extractor_extract_url(e.ptr, cUrl, &cReader, &cMeta)
+	code := C.extractous_extractor_extract_url_packed(e.ptr, cUrl, &cReader, &cMeta)
 	if code != errOK {
 		return nil, nil, newError(code)
 	}
 
 	reader = newStreamReader(cReader)
-	metadata = newMetadata(cMeta)
+	metadata = newPackedMetadata(cMeta)
 
 	return reader, metadata, nil
 }
 
+// BatchResult holds the outcome of extracting one file in a batch.
+//
+// Exactly one of Err or (Content, Metadata) is meaningful: when Err is non-nil the
+// document failed and Content is empty.
+type BatchResult struct {
+	Path     string   // Input path, as passed to ExtractFilesBatch
+	Content  string   // Extracted text content
+	Metadata Metadata // Document metadata
+	Err      error    // Per-document error, nil on success
+}
+
+// ExtractMetadata extracts only the metadata of a local file, such as
+// Content-Type, author, dates and page count.
+//
+// It is much cheaper than a full extraction for classification workloads:
+// body text is not returned, the parse stops as soon as the body starts, and
+// PDFs are parsed without OCR. The extractor's other settings still apply.
+// Metadata the parser only produces while reading the body may be missing.
+//
+// Example:
+//
+//	metadata, err := extractor.ExtractMetadata("report.pdf")
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	fmt.Println(metadata.Get("Content-Type"))
+func (e *Extractor) ExtractMetadata(path string) (Metadata, error) {
+	if e == nil || e.ptr == nil {
+		return nil, ErrNullPointer
+	}
+
+	cPath := cString(path)
+	defer freeString(cPath)
+
+	var cMeta *C.struct_CMetadataPacked
+	code := C.extractous_extractor_extract_metadata_only_packed(e.ptr, cPath, &cMeta)
+	if code != errOK {
+		return nil, newError(code)
+	}
+	return newPackedMetadata(cMeta), nil
+}
+
+// ExtractBytesMetadata is like ExtractMetadata, for a document already in
+// memory.
+func (e *Extractor) ExtractBytesMetadata(data []byte) (Metadata, error) {
+	if e == nil || e.ptr == nil {
+		return nil, ErrNullPointer
+	}
+	if len(data) == 0 {
+		return make(Metadata), nil
+	}
+
+	var cMeta *C.struct_CMetadataPacked
+	code := C.extractous_extractor_extract_bytes_metadata_only_packed(
+		e.ptr,
+		(*C.uint8_t)(&data[0]),
+		C.size_t(len(data)),
+		&cMeta,
+	)
+	if code != errOK {
+		return nil, newError(code)
+	}
+	return newPackedMetadata(cMeta), nil
+}
+
+// ExtractFilesBatch extracts many files to strings in a single call.
+//
+// The whole batch crosses into the native library once and is fanned out over a
+// worker pool owned by the library, sharing this extractor's configuration. This
+// avoids a cgo transition and a pinned OS thread per document, which matters when
+// processing large numbers of small files.
+//
+// Parameters:
+//   - paths: File system paths to the documents
+//   - parallelism: Number of worker threads; 0 or less uses one per CPU
+//
+// Returns:
+//   - results: One BatchResult per path, in the same order as paths
+//   - err: Error if the batch could not be run at all (per-document failures are
+//     reported in BatchResult.Err instead)
+//
+// Example:
+//
+//	results, err := extractor.ExtractFilesBatch(paths, 8)
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	for _, r := range results {
+//	    if r.Err != nil {
+//	        log.Printf("%s: %v", r.Path, r.Err)
+//	        continue
+//	    }
+//	    index(r.Path, r.Content, r.Metadata)
+//	}
+func (e *Extractor) ExtractFilesBatch(paths []string, parallelism int) (results []BatchResult, err error) {
+	if e == nil || e.ptr == nil {
+		return nil, ErrNullPointer
+	}
+
+	if len(paths) == 0 {
+		return []BatchResult{}, nil
+	}
+
+	// Build a C array of C strings; freed once the call returns.
+	cPaths := (**C.char)(C.malloc(C.size_t(len(paths)) * C.size_t(unsafe.Sizeof(uintptr(0)))))
+	defer C.free(unsafe.Pointer(cPaths))
+
+	cPathSlice := unsafe.Slice(cPaths, len(paths))
+	for i, p := range paths {
+		cPathSlice[i] = cString(p)
+	}
+	defer func() {
+		for _, cp := range cPathSlice {
+			freeString(cp)
+		}
+	}()
+
+	var cResults *C.struct_CBatchResult
+	code := C.extractous_extractor_extract_files_batch(
+		e.ptr,
+		cPaths,
+		C.size_t(len(paths)),
+		C.int(parallelism),
+		&cResults,
+	)
+	if code != errOK {
+		return nil, newError(code)
+	}
+	defer C.extractous_batch_results_free(cResults, C.size_t(len(paths)))
+
+	items := unsafe.Slice(cResults, len(paths))
+	results = make([]BatchResult, len(paths))
+	for i, item := range items {
+		results[i].Path = paths[i]
+		if item.error_code != errOK {
+			results[i].Err = newError(item.error_code)
+			continue
+		}
+		results[i].Content = goStringFromBuffer(item.content, item.content_len)
+		results[i].Metadata = packedMetadataFromC(item.metadata)
+	}
+
+	return results, nil
+}
+
+// EmbeddedDocument is one document returned by ExtractFileRecursive: the
+// container itself, or a document embedded in it.
+type EmbeddedDocument struct {
+	Path      string   // Path inside the container, entry names joined with "/"; "" for the container
+	Depth     int      // Nesting depth: 0 for the container, 1 for its direct children
+	Parent    int      // Index of the parent document in the results; 0 for the container
+	Content   string   // The document's own text, without that of its returned children
+	Metadata  Metadata // Container metadata for the first result; empty for embedded documents
+	Truncated bool     // A limit stopped extraction inside this document
+}
+
+// ExtractFileRecursive extracts a container, such as an archive, an e-mail or
+// an Office document with attachments, returning each embedded document as
+// its own result.
+//
+// The first result is the container; embedded documents follow in document
+// order. Documents nested deeper than maxDepth are not split out: their text
+// stays with their nearest returned ancestor. If the container holds more than
+// maxCount embedded documents at any depth, extraction stops and the documents
+// read so far are returned with Truncated set; 0 or less means no limit. The
+// content budget set with SetContentBudget applies to the whole container.
+// Both limits guard against archive bombs.
+//
+// The native library parses embedded documents one after another while it
+// reads the container, in a single call. The core only reports metadata for
+// the container.
+//
+// Example:
+//
+//	docs, err := extractor.ExtractFileRecursive("mail.eml", 4, 1000)
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	for _, d := range docs[1:] {
+//	    index(d.Path, d.Content)
+//	}
+func (e *Extractor) ExtractFileRecursive(path string, maxDepth, maxCount int) ([]EmbeddedDocument, error) {
+	if e == nil || e.ptr == nil {
+		return nil, ErrNullPointer
+	}
+	if maxDepth < 0 {
+		maxDepth = 0
+	}
+	if maxCount < 0 {
+		maxCount = 0
+	}
+
+	cPath := cString(path)
+	defer freeString(cPath)
+
+	var cResults *C.struct_CEmbeddedResult
+	var n C.size_t
+	code := C.extractous_extractor_extract_file_recursive(
+		e.ptr,
+		cPath,
+		C.uint32_t(maxDepth),
+		C.size_t(maxCount),
+		&cResults,
+		&n,
+	)
+	if code != errOK {
+		return nil, newError(code)
+	}
+	defer C.extractous_embedded_results_free(cResults, n)
+
+	items := unsafe.Slice(cResults, int(n))
+	docs := make([]EmbeddedDocument, len(items))
+	for i, item := range items {
+		docs[i] = EmbeddedDocument{
+			Path:      goString(item.path),
+			Depth:     int(item.depth),
+			Parent:    int(item.parent),
+			Content:   goStringFromBuffer(item.content, item.content_len),
+			Metadata:  packedMetadataFromC(item.metadata),
+			Truncated: bool(item.truncated),
+		}
+	}
+	return docs, nil
+}
+
+// AsyncResult is the outcome of an ExtractFileAsync call.
+//
+// Exactly one of Err or (Content, Metadata) is meaningful.
+type AsyncResult struct {
+	Content  string          // Extracted text content
+	Metadata Metadata        // Document metadata
+	Err      error           // Extraction error, nil on success
+	Stats    ExtractionStats // Resource accounting of the job, while EnableStats is on
+}
+
+// ExtractFileAsync starts extracting a file to a string and returns immediately.
+//
+// The document is parsed on a worker pool owned by the native library, not on the
+// calling goroutine's thread, so in-flight extractions do not each pin an OS thread
+// for the length of the parse. This matters for slow documents such as OCR'd PDFs.
+//
+// The returned channel receives exactly one AsyncResult and is then closed. The
+// extractor's configuration is captured when the call is made; reconfiguring or
+// closing the extractor afterwards does not affect the running extraction.
+//
+// Example:
+//
+//	results := make([]<-chan extractous.AsyncResult, len(paths))
+//	for i, p := range paths {
+//	    results[i] = extractor.ExtractFileAsync(p)
+//	}
+//	for i, ch := range results {
+//	    r := <-ch
+//	    if r.Err != nil {
+//	        log.Printf("%s: %v", paths[i], r.Err)
+//	        continue
+//	    }
+//	    index(paths[i], r.Content, r.Metadata)
+//	}
+func (e *Extractor) ExtractFileAsync(path string) <-chan AsyncResult {
+	ch := make(chan AsyncResult, 1)
+	if e == nil || e.ptr == nil {
+		ch <- AsyncResult{Err: ErrNullPointer}
+		close(ch)
+		return ch
+	}
+
+	cPath := cString(path)
+	defer freeString(cPath)
+
+	h := cgo.NewHandle(ch)
+	code := C.extract_file_async(e.ptr, cPath, C.uintptr_t(h))
+	if code != errOK {
+		// The job was not started, so the callback will never run.
+		h.Delete()
+		ch <- AsyncResult{Err: newError(code)}
+		close(ch)
+	}
+	return ch
+}
+
+// ExtractFileContext is like ExtractFile, but the returned stream follows ctx.
+//
+// Once ctx is cancelled or its deadline passes, reads from the stream fail with
+// ErrCancelled (wrapping ctx's error) and the native parse behind it is stopped
+// and its memory released, without waiting for Close. Cancellation is observed
+// between reads of the parser's output.
+//
+// Example:
+//
+//	ctx, cancel := context.WithTimeout(context.Background(), time.Minute)
+//	defer cancel()
+//	reader, _, err := extractor.ExtractFileContext(ctx, "document.pdf")
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	defer reader.Close()
+//	_, err = io.Copy(out, reader) // Fails with ErrCancelled after a minute
+func (e *Extractor) ExtractFileContext(ctx context.Context, path string) (reader *StreamReader, metadata Metadata, err error) {
+	if ctx.Err() != nil {
+		return nil, nil, cancelledError(ctx)
+	}
+
+	reader, metadata, err = e.ExtractFile(path)
+	if err != nil {
+		return nil, nil, err
+	}
+
+	if t := newCancelToken(ctx); t != nil {
+		C.extractous_stream_set_cancel_token(reader.ptr, t.ptr)
+		reader.cancel = t
+	}
+	return reader, metadata, nil
+}
+
+// ExtractFileToStringContext is like ExtractFileToString, but stops early with
+// ErrCancelled (wrapping ctx's error) once ctx is cancelled or its deadline
+// passes.
+//
+// Use it to bound the time spent on pathological documents, such as zip bombs
+// or giant spreadsheets. The native parse is stopped and its memory released as
+// soon as cancellation is observed, which happens between reads of the
+// parser's output.
+//
+// The content is read from the parser's output stream rather than produced by
+// a single native to-string call, which could not be interrupted. It is still
+// UTF-8 and cut like ExtractFileToString's: at the smaller of the content
+// budget and SetExtractStringMaxLength, counted in bytes, on a character
+// boundary.
+//
+// Example:
+//
+//	ctx, cancel := context.WithTimeout(ctx, 30*time.Second)
+//	defer cancel()
+//	content, _, err := extractor.ExtractFileToStringContext(ctx, "document.pdf")
+//	if errors.Is(err, context.DeadlineExceeded) {
+//	    log.Printf("skipping slow document")
+//	}
+func (e *Extractor) ExtractFileToStringContext(ctx context.Context, path string) (content string, metadata Metadata, err error) {
+	if e == nil || e.ptr == nil {
+		return "", nil, ErrNullPointer
+	}
+	if ctx.Err() != nil {
+		return "", nil, cancelledError(ctx)
+	}
+
+	cPath := cString(path)
+	defer freeString(cPath)
+
+	t := newCancelToken(ctx)
+	defer t.release()
+
+	var cContent *C.uint8_t
+	var cLen C.size_t
+	var cMeta *C.struct_CMetadataPacked
+
+	code := C.extractous_extractor_extract_file_to_buffer_cancellable(e.ptr, cPath, t.c(), &cContent, &cLen, &cMeta)
+	if code != errOK {
+		return "", nil, t.err(code)
+	}
+
+	content = goStringFromBuffer(cContent, cLen)
+	C.extractous_buffer_free(cContent, cLen)
+
+	metadata = newPackedMetadata(cMeta)
+	return content, metadata, nil
+}
+
+// ExtractBytesToStringContext is like ExtractBytesToString, but stops early
+// with ErrCancelled (wrapping ctx's error) once ctx is cancelled or its deadline
+// passes. See ExtractFileToStringContext for how cancellation works.
+func (e *Extractor) ExtractBytesToStringContext(ctx context.Context, data []byte) (content string, metadata Metadata, err error) {
+	if e == nil || e.ptr == nil {
+		return "", nil, ErrNullPointer
+	}
+	if ctx.Err() != nil {
+		return "", nil, cancelledError(ctx)
+	}
+
+	if len(data) == 0 {
+		return "", make(Metadata), nil
+	}
+
+	t := newCancelToken(ctx)
+	defer t.release()
+
+	var cContent *C.uint8_t
+	var cLen C.size_t
+	var cMeta *C.struct_CMetadataPacked
+
+	code := C.extractous_extractor_extract_bytes_to_buffer_cancellable(
+		e.ptr,
+		(*C.uint8_t)(&data[0]),
+		C.size_t(len(data)),
+		t.c(),
+		&cContent,
+		&cLen,
+		&cMeta,
+	)
+	if code != errOK {
+		return "", nil, t.err(code)
+	}
+
+	content = goStringFromBuffer(cContent, cLen)
+	C.extractous_buffer_free(cContent, cLen)
+
+	metadata = newPackedMetadata(cMeta)
+	return content, metadata, nil
+}
+
 // Close releases the extractor's resources.
 //
 // While extractors use finalizers for automatic cleanup, calling Close explicitly
@@ -647,7 +1441,8 @@ func (e *Extractor) ExtractURL(url string) (reader *StreamReader, metadata Metad
 // many documents or in long-running applications.
 //
 // After Close is called, the Extractor should not be used. Calling Close multiple
-// times is safe (subsequent calls are no-ops).
+// times is safe (subsequent calls are no-ops). Closing an extractor acquired
+// from a Pool returns it to the pool instead of freeing it.
 //
 // Example:
 //
@@ -660,8 +1455,170 @@ func (e *Extractor) ExtractURL(url string) (reader *StreamReader, metadata Metad
 // Always returns nil (implements io.Closer for compatibility).
 func (e *Extractor) Close() error {
 	if e.ptr != nil {
-		C.extractous_extractor_free(e.ptr)
+		if e.pool != nil {
+			e.pool.release(e.ptr)
+		} else {
+			C.extractous_extractor_free(e.ptr)
+		}
 		e.ptr = nil
 	}
 	return nil
 }
+
+// Pool is a fixed set of pre-warmed extractors sharing one configuration.
+//
+// Each extractor runs a tiny built-in document when the pool is created, so
+// start-up costs in the native core are paid by NewPool rather than by the
+// first requests. The pool also bounds how many extractions run at once:
+// Acquire waits while every extractor is in use.
+//
+//	pool, err := extractous.NewPool(extractous.New().SetXmlOutput(true), 8)
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	defer pool.Close()
+//
+//	ext, err := pool.Acquire(ctx)
+//	if err != nil {
+//	    return err
+//	}
+//	defer ext.Close() // Returns the extractor to the pool
+//
+// Acquired extractors may be reconfigured; the pool restores its configuration
+// when they are returned. Acquire, Release and Close are safe for concurrent
+// use; once Close succeeds, pending and later Acquire calls fail with
+// ErrNullPointer.
+type Pool struct {
+	mu   sync.RWMutex // Guards ptr; Close holds it exclusively
+	ptr  *C.struct_CExtractorPool
+	idle chan struct{} // One token per idle extractor
+	done chan struct{} // Closed once Close has freed the pool
+	http *httpFetcher  // The HTTP configuration of the config extractor, if any
+}
+
+// NewPool creates a pool of size extractors configured like config.
+//
+// The pool copies config's current configuration; config may be closed or
+// reconfigured afterwards. A nil config selects the default configuration,
+// and a size of 0 selects one extractor per available CPU.
+func NewPool(config *Extractor, size int) (*Pool, error) {
+	if size < 0 {
+		return nil, newError(errInvalidConfig)
+	}
+	var cfg *C.struct_CExtractor
+	if config != nil {
+		if config.ptr == nil {
+			return nil, newError(errNullPointer)
+		}
+		cfg = config.ptr
+	}
+
+	ptr := C.extractous_pool_new(cfg, C.size_t(size))
+	runtime.KeepAlive(config)
+	if ptr == nil {
+		return nil, newError(errExtractionFailed)
+	}
+
+	n := int(C.extractous_pool_size(ptr))
+	p := &Pool{ptr: ptr, idle: make(chan struct{}, n), done: make(chan struct{})}
+	if config != nil {
+		p.http = config.http.Load()
+	}
+	for i := 0; i < n; i++ {
+		p.idle <- struct{}{}
+	}
+	runtime.SetFinalizer(p, (*Pool).Close)
+	return p, nil
+}
+
+// Size returns the number of extractors the pool owns, idle or not.
+func (p *Pool) Size() int {
+	if p == nil {
+		return 0
+	}
+	return cap(p.idle)
+}
+
+// Acquire takes an extractor from the pool, waiting until one is idle or ctx
+// is done. Waiting happens in Go and holds no OS thread.
+//
+// The extractor must be given back with Close or Release. If ctx is done
+// first, the error wraps ErrCancelled and the context's cause. If the pool is
+// or becomes closed, the error is ErrNullPointer.
+func (p *Pool) Acquire(ctx context.Context) (*Extractor, error) {
+	if p == nil {
+		return nil, newError(errNullPointer)
+	}
+	select {
+	case <-p.idle:
+	case <-p.done:
+		return nil, newError(errNullPointer)
+	case <-ctx.Done():
+		return nil, cancelledError(ctx)
+	}
+
+	// Holding a token guarantees an idle native extractor, and keeps Close
+	// from freeing the pool.
+	var ptr *C.struct_CExtractor
+	p.mu.RLock()
+	if p.ptr != nil {
+		ptr = C.extractous_pool_try_acquire(p.ptr)
+	}
+	p.mu.RUnlock()
+	if ptr == nil {
+		p.idle <- struct{}{}
+		return nil, newError(errNullPointer)
+	}
+	ext := &Extractor{ptr: ptr, pool: p}
+	ext.http.Store(p.http)
+	runtime.SetFinalizer(ext, (*Extractor).Close)
+	return ext, nil
+}
+
+// Release returns an extractor acquired from p; it is equivalent to e.Close().
+// Returns ErrInvalidConfig if e was not acquired from p.
+func (p *Pool) Release(e *Extractor) error {
+	if e == nil || e.pool != p {
+		return newError(errInvalidConfig)
+	}
+	return e.Close()
+}
+
+// release hands a native extractor back to the pool.
+//
+// Internal use only.
+func (p *Pool) release(ptr *C.struct_CExtractor) {
+	p.mu.RLock()
+	C.extractous_pool_release(p.ptr, ptr)
+	p.mu.RUnlock()
+	p.idle <- struct{}{}
+}
+
+// Close frees the pool and its extractors.
+//
+// Returns ErrPoolInUse, leaving the pool open, if any extractor is still
+// acquired. Calling Close multiple times is safe.
+func (p *Pool) Close() error {
+	if p == nil {
+		return nil
+	}
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	if p.ptr == nil {
+		return nil
+	}
+	for taken := 0; taken < cap(p.idle); taken++ {
+		select {
+		case <-p.idle:
+		default:
+			for ; taken > 0; taken-- {
+				p.idle <- struct{}{}
+			}
+			return ErrPoolInUse
+		}
+	}
+	C.extractous_pool_free(p.ptr)
+	p.ptr = nil
+	close(p.done)
+	return nil
+}
@@ -53,6 +53,8 @@
 
 #define ERR_OCR_FAILED -10
 
+#define ERR_CANCELLED -11
+
 #define CHARSET_UTF_8 0
 
 #define CHARSET_US_ASCII 1
@@ -67,17 +69,103 @@
 
 #define PDF_OCR_STRATEGY_AUTO 3
 
-typedef struct CPdfParserConfig {
-  uint8_t _private[0];
-} CPdfParserConfig;
+/*
+ Default size of a stream's read-ahead buffer, in bytes.
+ */
+#define STREAM_DEFAULT_BUFFER_SIZE (64 * 1024)
 
-typedef struct COfficeParserConfig {
-  uint8_t _private[0];
-} COfficeParserConfig;
+/*
+ `CStreamEvent` kind: the end of the stream. Every later call returns it again.
+ */
+#define STREAM_EVENT_END 0
 
-typedef struct CTesseractOcrConfig {
-  uint8_t _private[0];
-} CTesseractOcrConfig;
+/*
+ `CStreamEvent` kind: a run of text, in `data`.
+ */
+#define STREAM_EVENT_TEXT 1
+
+/*
+ `CStreamEvent` kind: a page, slide or sheet begins; `index` is its number, from 1.
+ */
+#define STREAM_EVENT_PAGE_START 2
+
+/*
+ `CStreamEvent` kind: the page, slide or sheet numbered `index` ends.
+ */
+#define STREAM_EVENT_PAGE_END 3
+
+/*
+ `CStreamEvent` kind: the name of the sheet numbered `index`, in `data`.
+ */
+#define STREAM_EVENT_SHEET_NAME 4
+
+/*
+ `CStreamEvent` kind: an embedded document begins; `index` is its nesting depth, from 1.
+ */
+#define STREAM_EVENT_EMBEDDED_START 5
+
+/*
+ `CStreamEvent` kind: the embedded document at nesting depth `index` ends.
+ */
+#define STREAM_EVENT_EMBEDDED_END 6
+
+/*
+ `CStreamEvent` kind: the name of the embedded document at nesting depth `index`, in
+ `data`, such as its path inside an archive or its attachment file name.
+ */
+#define STREAM_EVENT_EMBEDDED_NAME 7
+
+/*
+ Number of entries in `CStats::errors_by_code`, indexed by the negated error code.
+ */
+#define STATS_ERROR_CODE_SLOTS 16
+
+/*
+ Number of buckets in the `CStats` latency histogram.
+ */
+#define STATS_LATENCY_BUCKETS 12
+
+/*
+ `extractous_warmup` format bit: the PDF parser.
+ */
+#define WARMUP_FORMAT_PDF (1 << 0)
+
+/*
+ `extractous_warmup` format bit: the Office Open XML (DOCX) parser.
+ */
+#define WARMUP_FORMAT_OFFICE (1 << 1)
+
+/*
+ `extractous_warmup` format bit: the HTML parser.
+ */
+#define WARMUP_FORMAT_HTML (1 << 2)
+
+/*
+ Every `extractous_warmup` format bit.
+ */
+#define WARMUP_FORMAT_ALL ((WARMUP_FORMAT_PDF | WARMUP_FORMAT_OFFICE) | WARMUP_FORMAT_HTML)
+
+/*
+ `extractous_extractor_set_normalization_mut` stage: drop control characters other
+ than tab and line breaks.
+ */
+#define NORMALIZE_STRIP_CONTROL (1 << 0)
+
+/*
+ `extractous_extractor_set_normalization_mut` stage: collapse runs of whitespace.
+ */
+#define NORMALIZE_COLLAPSE_WHITESPACE (1 << 1)
+
+/*
+ `extractous_extractor_set_normalization_mut` stage: join words hyphenated across
+ line breaks.
+ */
+#define NORMALIZE_DEHYPHENATE (1 << 2)
+
+/*
+ Every `extractous_extractor_set_normalization_mut` stage.
+ */
+#define NORMALIZE_ALL ((NORMALIZE_STRIP_CONTROL | NORMALIZE_COLLAPSE_WHITESPACE) | NORMALIZE_DEHYPHENATE)
 
 typedef struct CExtractor {
   uint8_t _private[0];
@@ -98,21 +186,540 @@ typedef struct CMetadata {
   size_t len;
 } CMetadata;
 
-typedef struct CStreamReader {
-  uint8_t _private[0];
-} CStreamReader;
+/*
+ Metadata packed into a single allocation: this header, three offset tables and one
+ contiguous arena of key/value bytes. Freed with one call to `extractous_metadata_packed_free`.
+
+ Multi-valued entries are preserved: key `i` spans `key_offsets[i]..key_offsets[i+1]` in
+ `data` and owns values `value_starts[i]..value_starts[i+1]` of the value table, where
+ value `j` spans `value_offsets[j]..value_offsets[j+1]` in `data`.
+ */
+typedef struct CMetadataPacked {
+  /*
+   The number of keys
+   */
+  size_t len;
+  /*
+   The total number of values across all keys
+   */
+  size_t value_count;
+  /*
+   The total number of bytes in `data`
+   */
+  size_t data_len;
+  /*
+   `len + 1` byte offsets of the keys in `data`
+   */
+  const size_t *key_offsets;
+  /*
+   `len + 1` indices into the value table; key `i` has `value_starts[i+1] - value_starts[i]` values
+   */
+  const size_t *value_starts;
+  /*
+   `value_count + 1` byte offsets of the values in `data`
+   */
+  const size_t *value_offsets;
+  /*
+   UTF-8 key and value bytes back to back, without separators or null terminators
+   */
+  const uint8_t *data;
+} CMetadataPacked;
+
+/*
+ Callback invoked exactly once when the library no longer needs a caller-owned buffer.
+ */
+typedef void (*ExtractousReleaseFn)(void *user_data);
+
+/*
+ Callback that fills `buf` with up to `len` bytes of input.
+
+ Returns the number of bytes written, 0 at end of input, or a negative value on error.
+ */
+typedef intptr_t (*ExtractousReadFn)(void *user_data, uint8_t *buf, size_t len);
+
+/*
+ Callback invoked exactly once, on a library worker thread, when an async extraction ends.
+
+ On success `error_code` is `ERR_OK` and the callback takes ownership of `content`
+ (free with `extractous_buffer_free(content, content_len)`; NULL when empty) and
+ `metadata` (free with `extractous_metadata_packed_free`). On failure both are NULL.
+ */
+typedef void (*ExtractousCompletionFn)(void *user_data,
+                                       int error_code,
+                                       uint8_t *content,
+                                       size_t content_len,
+                                       struct CMetadataPacked *metadata);
+
+/*
+ A caller buffer for `extractous_stream_read_into_iov`, laid out like POSIX `struct iovec`.
+ */
+typedef struct CIoVec {
+  /*
+   Start of the buffer
+   */
+  uint8_t *base;
+  /*
+   Length of the buffer in bytes
+   */
+  size_t len;
+} CIoVec;
+
+/*
+ Content and metadata of one extraction, laid out in a single allocation.
+
+ Returned by `extractous_extractor_extract_file_to_result` and
+ `extractous_extractor_extract_bytes_to_result`; freed with one call to
+ `extractous_result_free`.
+ */
+typedef struct CExtractionResult {
+  /*
+   Extracted content, null-terminated; may contain interior NUL bytes
+   */
+  const char *content;
+  /*
+   Length of `content` in bytes, excluding the terminator
+   */
+  size_t content_len;
+  /*
+   Extracted metadata, read through `&result->metadata`; not freed on its own
+   */
+  struct CMetadataPacked metadata;
+} CExtractionResult;
+
+/*
+ A reusable, growable output buffer created by `extractous_buffer_new`.
+
+ Callers read `data[0..len]`; the fields are managed by the library.
+ */
+typedef struct CBuffer {
+  /*
+   Start of the contents, or NULL while nothing has been allocated
+   */
+  uint8_t *data;
+  /*
+   Length of the contents in bytes
+   */
+  size_t len;
+  /*
+   Size of the allocation in bytes
+   */
+  size_t capacity;
+} CBuffer;
+
+/*
+ One event returned by `extractous_stream_next_event`.
+ */
+typedef struct CStreamEvent {
+  /*
+   One of the `STREAM_EVENT_*` kinds
+   */
+  int kind;
+  /*
+   Page number for page, sheet-name and text events (0 outside pages), or nesting
+   depth for embedded-document events
+   */
+  uint32_t index;
+  /*
+   UTF-8 payload, not null-terminated; owned by the stream and valid until its next
+   call or until it is freed. NULL when the event has no payload.
+   */
+  const uint8_t *data;
+  /*
+   Length of `data` in bytes
+   */
+  size_t len;
+} CStreamEvent;
+
+/*
+ One chunk returned by `extractous_stream_next_chunk`.
+ */
+typedef struct CStreamChunk {
+  /*
+   Content bytes, not null-terminated; owned by the stream and valid until its next
+   call or until it is freed. NULL at the end of the stream.
+   */
+  const uint8_t *data;
+  /*
+   Length of `data` in bytes; 0 at the end of the stream
+   */
+  size_t len;
+  /*
+   Offset of `data` in the stream's content, in bytes
+   */
+  uint64_t offset;
+} CStreamChunk;
+
+/*
+ A snapshot of the library's process-wide extraction statistics.
+
+ A call is one extraction entry point (or one batch item), from the start of the core
+ parse to the end of the FFI conversion of its results. Streamed content is parsed
+ lazily, so for streams most of the parse time shows up in `stream_read_ns`.
+ */
+typedef struct CStats {
+  /*
+   Whether collection is currently enabled
+   */
+  bool enabled;
+  /*
+   Completed extraction calls, successful or not
+   */
+  uint64_t calls;
+  /*
+   Failed extraction calls, including input errors such as a failed mapping
+   */
+  uint64_t errors;
+  /*
+   Failures per error code: `errors_by_code[-code]`
+   */
+  uint64_t errors_by_code[STATS_ERROR_CODE_SLOTS];
+  /*
+   Bytes of in-memory, mapped or callback-supplied input; path and URL inputs are not counted
+   */
+  uint64_t bytes_in;
+  /*
+   Bytes of extracted content returned as strings or buffers, or read from streams
+   */
+  uint64_t bytes_out;
+  /*
+   Metadata keys returned
+   */
+  uint64_t metadata_entries;
+  /*
+   Pages the PDF parser sent to OCR, from the `pdf:ocrPageCount` metadata value
+   */
+  uint64_t ocr_pages;
+  /*
+   Time spent in the core library parsing, including parser setup
+   */
+  uint64_t parse_ns;
+  /*
+   Time spent converting results into C structures
+   */
+  uint64_t convert_ns;
+  /*
+   Reads made against core stream readers (read-ahead hits are not counted)
+   */
+  uint64_t stream_reads;
+  /*
+   Time spent in those reads
+   */
+  uint64_t stream_read_ns;
+  /*
+   Inclusive upper bound of each latency bucket; the last one is `UINT64_MAX`
+   */
+  uint64_t latency_bounds_ns[STATS_LATENCY_BUCKETS];
+  /*
+   Calls per latency bucket
+   */
+  uint64_t latency_buckets[STATS_LATENCY_BUCKETS];
+  /*
+   Result cache lookups answered from a cache, from memory or disk
+   */
+  uint64_t cache_hits;
+  /*
+   Those of `cache_hits` answered from a disk tier
+   */
+  uint64_t cache_disk_hits;
+  /*
+   Result cache lookups that fell through to a full extraction
+   */
+  uint64_t cache_misses;
+} CStats;
+
+/*
+ The resource accounting of one extraction call, or of the reads made on one stream.
+
+ Filled while statistics collection is enabled; see `extractous_stats_last_call` and
+ `extractous_stream_get_stats`. CPU time is that of the thread running the call; the
+ core parses on it, but any helper threads the core uses are not included. RSS is
+ sampled before and after the call, or for a stream at its first read, at the end of
+ its content or a failed read, and when its stats are copied out, so memory
+ allocated and released again in between is not seen; it is process-wide, so with
+ several extractions running at once, each is charged the growth made by all of them
+ meanwhile.
+ */
+typedef struct CExtractionStats {
+  /*
+   `ERR_OK`, or the error code the call (or the last failed read) returned
+   */
+  int code;
+  /*
+   Wall-clock time of the call, or of the stream's reads
+   */
+  uint64_t total_ns;
+  /*
+   Time spent in the core library parsing, including parser setup
+   */
+  uint64_t parse_ns;
+  /*
+   Time spent converting results into C structures
+   */
+  uint64_t convert_ns;
+  /*
+   CPU time of the calling thread
+   */
+  uint64_t cpu_ns;
+  /*
+   Bytes of extracted content returned, or read from the stream
+   */
+  uint64_t bytes_out;
+  /*
+   Metadata keys returned
+   */
+  uint64_t metadata_entries;
+  /*
+   Pages the PDF parser sent to OCR, from the `pdf:ocrPageCount` metadata value
+   */
+  uint64_t ocr_pages;
+  /*
+   The process's resident set size when the call ended, in bytes
+   */
+  uint64_t rss_bytes;
+  /*
+   How much the process's resident set grew during the call, in bytes
+   */
+  uint64_t rss_growth_bytes;
+} CExtractionStats;
+
+/*
+ Options for `extractous_init`.
+ */
+typedef struct CInitOptions {
+  /*
+   `WARMUP_FORMAT_*` bits to warm up, as with `extractous_warmup`; 0 skips the warm-up
+   */
+  uint32_t warmup_formats;
+  /*
+   Start the async worker threads now rather than on the first `_async` call
+   */
+  bool start_workers;
+} CInitOptions;
+
+/*
+ Outcome of extracting a single item of a batch.
+ */
+typedef struct CBatchResult {
+  /*
+   Extracted content, as a UTF-8 buffer of `content_len` bytes, or NULL if the item
+   failed or the content is empty
+   */
+  uint8_t *content;
+  size_t content_len;
+  /*
+   Extracted metadata, or NULL if the item failed
+   */
+  struct CMetadataPacked *metadata;
+  /*
+   `ERR_OK` on success, otherwise the error code for this item
+   */
+  int error_code;
+} CBatchResult;
+
+/*
+ One document returned by `extractous_extractor_extract_file_recursive`
+ */
+typedef struct CEmbeddedResult {
+  /*
+   Path inside the container, entry names joined with `/`; empty for the container
+   */
+  char *path;
+  /*
+   Nesting depth: 0 for the container, 1 for its direct children
+   */
+  uint32_t depth;
+  /*
+   Index of the parent result; 0 for the container itself
+   */
+  size_t parent;
+  /*
+   The document's own text, as a UTF-8 buffer of `content_len` bytes, or NULL if empty
+   */
+  uint8_t *content;
+  size_t content_len;
+  /*
+   Metadata of the container, for the first result only; NULL for embedded documents
+   */
+  struct CMetadataPacked *metadata;
+  /*
+   True if a count limit or the content budget stopped extraction inside this document
+   */
+  bool truncated;
+} CEmbeddedResult;
+
+typedef struct CPdfParserConfig {
+  uint8_t _private[0];
+} CPdfParserConfig;
+
+typedef struct COfficeParserConfig {
+  uint8_t _private[0];
+} COfficeParserConfig;
+
+typedef struct CTesseractOcrConfig {
+  uint8_t _private[0];
+} CTesseractOcrConfig;
+
+typedef struct CStreamReader {
+  uint8_t _private[0];
+} CStreamReader;
+
+typedef struct CAsyncJob {
+  uint8_t _private[0];
+} CAsyncJob;
+
+typedef struct CCancelToken {
+  uint8_t _private[0];
+} CCancelToken;
+
+typedef struct CExtractorPool {
+  uint8_t _private[0];
+} CExtractorPool;
+
+typedef struct CResultCache {
+  uint8_t _private[0];
+} CResultCache;
+
+/*
+ Returns the FFI wrapper version as a null-terminated UTF-8 string.
+ The returned pointer is to a static string and must not be freed.
+ */
+const char *extractous_ffi_version(void);
+
+/*
+ Returns the underlying Extractous core library version.
+ The returned pointer is to a static string and must not be freed.
+ */
+const char *extractous_core_version(void);
+
+/*
+ Extracts a list of local files to strings in parallel on a library-owned worker pool.
+
+ All workers share the extractor's configuration. `parallelism <= 0` uses one worker
+ per available CPU. On success `*out_results` points to an array of `n` results in the
+ same order as `paths`; each item carries its own error code, so a failing document does
+ not fail the batch. The array must be freed with `extractous_batch_results_free`.
+ */
+int extractous_extractor_extract_files_batch(struct CExtractor *handle,
+                                             const char *const *paths,
+                                             size_t n,
+                                             int parallelism,
+                                             struct CBatchResult **out_results);
+
+/*
+ Frees a result array returned by `extractous_extractor_extract_files_batch`,
+ including every content buffer and packed metadata block it holds.
+ */
+void extractous_batch_results_free(struct CBatchResult *results, size_t n);
+
+/*
+ Creates an empty, reusable output buffer with room for at least `capacity` bytes.
+
+ Pass it to `extractous_extractor_extract_bytes_into` or
+ `extractous_extractor_extract_file_into`, which overwrite its contents on every call
+ and only reallocate when the content outgrows its capacity. A worker that keeps one
+ buffer for its lifetime stops allocating for content once the buffer has grown to its
+ largest document. Returns NULL if the memory cannot be allocated.
+
+ The returned buffer must be freed with `extractous_buffer_destroy`, not
+ `extractous_buffer_free`.
+ */
+struct CBuffer *extractous_buffer_new(size_t capacity);
+
+/*
+ Grows `buffer` so it can hold at least `capacity` bytes in total without reallocating.
+ Its contents are kept. Does nothing if it is already large enough.
+
+ Returns `ERR_OUT_OF_MEMORY` if the memory cannot be allocated; the buffer is then
+ unchanged.
+ */
+int extractous_buffer_reserve(struct CBuffer *buffer, size_t capacity);
+
+/*
+ Empties `buffer`, keeping its allocation.
+ */
+void extractous_buffer_clear(struct CBuffer *buffer);
+
+/*
+ Frees a buffer created by `extractous_buffer_new`, with its allocation.
+ */
+void extractous_buffer_destroy(struct CBuffer *buffer);
+
+/*
+ Creates an empty result cache holding at most `max_bytes` of content and metadata in
+ memory, evicting the least recently used entries beyond that. A bound of 0 keeps
+ nothing in memory, which is useful with a disk tier.
+
+ Attach it to one or more extractors with `extractous_extractor_set_cache_mut`.
+ The returned handle must be freed with `extractous_cache_free`.
+ */
+struct CResultCache *extractous_cache_new(uint64_t max_bytes);
+
+/*
+ Backs the cache with a directory holding at most `max_bytes` of entries, one file per
+ entry. The directory is created if needed, and entries already in it are reused, so
+ the tier survives restarts and can be shared by processes. Keys are built from a
+ stable hash, so they stay valid across library releases and platforms; entries in
+ an older format are ignored. Memory misses fall back to the disk tier, and new
+ entries are written to both.
+
+ Pass a NULL `dir` to detach the disk tier; its files are kept. Returns `ERR_IO_ERROR`
+ if the directory cannot be created or listed.
+ */
+int extractous_cache_set_disk_tier(const struct CResultCache *cache,
+                                   const char *dir,
+                                   uint64_t max_bytes);
+
+/*
+ Removes every entry from the cache, including the files of its disk tier.
+ */
+void extractous_cache_clear(const struct CResultCache *cache);
+
+/*
+ Frees the caller's reference to a cache. Extractors it is attached to keep using it
+ until they are freed or detached.
+ */
+void extractous_cache_free(struct CResultCache *cache);
 
 /*
- Returns the FFI wrapper version as a null-terminated UTF-8 string.
- The returned pointer is to a static string and must not be freed.
+ Attaches a result cache to the extractor, or detaches it when `cache` is NULL.
+
+ With a cache attached, the byte-slice and memory-mapped extractions to a string or
+ buffer look up the input first, keyed by a hash of the bytes and of the extractor's
+ whole configuration. A hit returns a copy of the cached content and metadata without
+ parsing, unless its content is over the extractor's memory limit, which fails with
+ `ERR_OUT_OF_MEMORY` as the extraction would. Streaming, path and URL extractions are
+ not cached.
  */
-const char *extractous_ffi_version(void);
+void extractous_extractor_set_cache_mut(struct CExtractor *handle, const struct CResultCache *cache);
 
 /*
- Returns the underlying Extractous core library version.
- The returned pointer is to a static string and must not be freed.
+ Creates a new cancellation token with no deadline.
+ The returned handle must be freed with `extractous_cancel_token_free`.
  */
-const char *extractous_core_version(void);
+struct CCancelToken *extractous_cancel_token_new(void);
+
+/*
+ Cancels the token. Every extraction and stream observing it stops at its next check
+ and reports `ERR_CANCELLED`. Safe to call from any thread, any number of times.
+ */
+void extractous_cancel_token_cancel(const struct CCancelToken *handle);
+
+/*
+ Sets the token to cancel itself `timeout_ms` milliseconds from now, replacing any
+ earlier deadline. A timeout of 0 clears the deadline. Safe to call from any thread.
+ */
+int extractous_cancel_token_set_timeout_ms(const struct CCancelToken *handle, uint64_t timeout_ms);
+
+/*
+ Returns true if the token has been cancelled or its deadline has passed.
+ */
+bool extractous_cancel_token_is_cancelled(const struct CCancelToken *handle);
+
+/*
+ Frees the caller's reference to a token. Streams the token is attached to keep
+ observing it until they are freed.
+ */
+void extractous_cancel_token_free(struct CCancelToken *handle);
 
 /*
  Creates a new PDF parser configuration with default settings.
@@ -188,6 +795,12 @@ void extractous_office_config_set_include_shape_based_content(struct COfficePars
 
 /*
  Creates a new Tesseract OCR configuration with default settings.
+
+ The core OCRs the pages of a document one at a time, in page order, and the density,
+ depth and timeout settings apply to each page. It has no page-level parallelism: to
+ use more cores for OCR-heavy work, run several documents at once with
+ `extractous_extractor_extract_files_batch`, an extractor pool, or one extractor shared
+ by several threads.
  */
 struct CTesseractOcrConfig *extractous_ocr_config_new(void);
 
@@ -222,6 +835,66 @@ void extractous_ocr_config_set_enable_image_preprocessing(struct CTesseractOcrCo
  */
 void extractous_ocr_config_set_timeout_seconds(struct CTesseractOcrConfig *handle, int32_t seconds);
 
+/*
+ Detects the MIME type of an in-memory document from its magic bytes and container
+ headers alone, without parsing it.
+
+ Only the first 64 KiB are looked at. ZIP containers are told apart as Office Open
+ XML, OpenDocument or EPUB from their first entries, and legacy Office files from
+ their OLE2 directory; other files from their leading signature. Text that is not
+ HTML, XML or an e-mail is `text/plain`, and anything unrecognised is
+ `application/octet-stream`.
+
+ On success `*out_mime` points to a static string that must not be freed. This is much
+ cheaper than an extraction and never starts the core's runtime, so it can be used to
+ skip unsupported formats before extracting. It may name a type the core does not
+ parse, and the core's own detection, reported in `Content-Type`, can be more precise.
+ */
+int extractous_detect_bytes(const uint8_t *data, size_t len, const char **out_mime);
+
+/*
+ Like `extractous_detect_bytes`, for a local file. Only the first 64 KiB are read.
+
+ Returns `ERR_IO_ERROR` if the file cannot be read.
+ */
+int extractous_detect_file(const char *path, const char **out_mime);
+
+/*
+ Extracts a container, such as an archive, an e-mail or an Office document with
+ attachments, returning each embedded document as its own result.
+
+ The first result is the container itself, with its metadata; the others follow in
+ document order, each with its path inside the container (entry names joined with
+ `/`), its nesting depth and the index of its parent result. The content of each result
+ excludes that of the children returned separately. The core only reports metadata for
+ the container, so embedded results have NULL metadata.
+
+ Documents nested deeper than `max_depth` are not split out: their content stays with
+ their nearest returned ancestor, so `max_depth` 0 returns the container alone. If the
+ container holds more than `max_count` embedded documents at any depth, the parse is
+ stopped as the next one starts and the documents read so far are returned, marked as
+ truncated; 0 means no limit. The extractor's content budget also applies, to the whole
+ container. Both limits guard against archive bombs.
+
+ Embedded documents are parsed by the core inline, one after another, while it reads
+ the container; this call only splits its output, in one pass.
+
+ On success the array of `*out_n` results must be freed with
+ `extractous_embedded_results_free`.
+ */
+int extractous_extractor_extract_file_recursive(struct CExtractor *handle,
+                                                const char *path,
+                                                uint32_t max_depth,
+                                                size_t max_count,
+                                                struct CEmbeddedResult **out_results,
+                                                size_t *out_n);
+
+/*
+ Frees a result array returned by `extractous_extractor_extract_file_recursive`,
+ including every path, content buffer and packed metadata block it holds.
+ */
+void extractous_embedded_results_free(struct CEmbeddedResult *results, size_t n);
+
 char *extractous_error_message(int code);
 
 /*
@@ -245,6 +918,9 @@ struct CExtractor *extractous_extractor_new(void);
 
 /*
  Frees the memory associated with an `Extractor` handle.
+
+ Extractions still running on other threads keep their configuration snapshot alive,
+ but the handle itself must not be used once this is called.
  */
 void extractous_extractor_free(struct CExtractor *handle);
 
@@ -282,6 +958,64 @@ void extractous_extractor_set_ocr_config_mut(struct CExtractor *handle,
  */
 void extractous_extractor_set_xml_output_mut(struct CExtractor *handle, bool xml_output);
 
+/*
+ Sets a content budget: extractions stop once `max_bytes` of content have been
+ produced, and the rest of the document is not parsed. Pass 0 to remove the budget.
+
+ Unlike `extractous_extractor_set_extract_string_max_length_mut`, which truncates text the
+ parser has already produced, the budget ends the parse itself, and it is not limited
+ to 2 GB. It applies to streams, which report the end of the stream once the budget is
+ spent, and to every to-string and to-buffer call. For those, the budget counts UTF-8
+ bytes of the result, and the result is also cut at `extract_string_max_length`
+ bytes if that is smaller; a result cut off inside a multi-byte character is shortened
+ to the last whole character.
+ Metadata is not affected.
+ */
+void extractous_extractor_set_content_budget_mut(struct CExtractor *handle, uint64_t max_bytes);
+
+/*
+ Sets a memory limit: an extraction that needs more than `max_bytes` of memory fails
+ with `ERR_OUT_OF_MEMORY`, and its parse is stopped, without affecting other
+ extractions. Pass 0 to remove the limit.
+
+ The limit covers the extracted content the library holds, and on Linux the growth of
+ the process's resident memory while the extraction runs, which includes the parser's
+ heap. That growth is sampled after each read from the parser and is process-wide, so
+ with concurrent extractions it is charged to whichever extraction observes it. On
+ other platforms only the content held by the library is limited. To-string calls
+ read from the content stream under a limit, so that they can be stopped mid-parse,
+ and are then cut at `extract_string_max_length` bytes rather than characters.
+ Whether or not a limit is set, `extractous_stream_read_all` and the to-buffer calls
+ report a failed allocation of their result as `ERR_OUT_OF_MEMORY` instead of aborting.
+ */
+void extractous_extractor_set_memory_limit_mut(struct CExtractor *handle, uint64_t max_bytes);
+
+/*
+ Sets the normalization stages applied to extracted content, as `NORMALIZE_*` bits.
+ Pass 0 to turn normalization off; unknown bits are ignored.
+
+ The stages run inside the library on each block of content as it is read from the
+ parser, so normalized text needs no second pass or copy. They apply to every read of
+ a stream, including through `extractous_stream_next_event`, and to every to-string
+ and to-buffer call, which then read from the content stream and are cut at
+ `extract_string_max_length` normalized bytes rather than characters. The content
+ budget counts normalized bytes. With XML
+ output the stages also see the markup. Metadata is not affected. The stages work on
+ UTF-8, so while any are set content is produced in UTF-8 whatever encoding was set
+ with `extractous_extractor_set_encoding_mut`.
+
+ - `NORMALIZE_STRIP_CONTROL` drops ASCII control characters other than tab, `\n` and
+   `\r`, DEL, and the C1 control characters U+0080 to U+009F.
+ - `NORMALIZE_DEHYPHENATE` joins words broken across lines with a hyphen, as in
+   justified PDF text: a hyphen after a letter, followed by a line break and a
+   lowercase ASCII letter, is removed together with the break.
+ - `NORMALIZE_COLLAPSE_WHITESPACE` turns each run of whitespace into one space, one
+   line break, or a blank line if it held two or more line breaks, and trims the
+   start and end of the content. `\r\n`, `\r`, vertical tab and form feed count as
+   line breaks.
+ */
+void extractous_extractor_set_normalization_mut(struct CExtractor *handle, uint32_t stages);
+
 /*
  Extracts content and metadata from a local file path into a string.
 
@@ -301,6 +1035,49 @@ int extractous_extractor_extract_file(struct CExtractor *handle,
                                       struct CStreamReader **out_reader,
                                       struct CMetadata **out_metadata);
 
+/*
+ Extracts content from a local file path into a stream, with packed metadata.
+
+ Identical to `extractous_extractor_extract_file`, except that metadata is returned as a
+ single-allocation `CMetadataPacked` that must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_file_packed(struct CExtractor *handle,
+                                             const char *path,
+                                             struct CStreamReader **out_reader,
+                                             struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content and metadata from a local file path into a length-prefixed buffer.
+
+ The content is returned as a UTF-8 byte buffer of `*out_len` bytes that is NOT
+ null-terminated and may contain interior NUL bytes. This avoids the NUL scan and copy
+ of `extractous_extractor_extract_file_to_string`. An empty result is returned as
+ NULL with a length of 0.
+
+ Output buffers must be freed with `extractous_buffer_free(buffer, len)`.
+ Output metadata must be freed with `extractous_metadata_free`.
+ */
+int extractous_extractor_extract_file_to_buffer(struct CExtractor *handle,
+                                                const char *path,
+                                                uint8_t **out_buffer,
+                                                size_t *out_len,
+                                                struct CMetadata **out_metadata);
+
+/*
+ Extracts content from a local file path into a length-prefixed buffer, with packed metadata.
+
+ Identical to `extractous_extractor_extract_file_to_buffer`, except that metadata is
+ returned as a single-allocation `CMetadataPacked`.
+
+ Output buffers must be freed with `extractous_buffer_free(buffer, len)`.
+ Output metadata must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_file_to_buffer_packed(struct CExtractor *handle,
+                                                       const char *path,
+                                                       uint8_t **out_buffer,
+                                                       size_t *out_len,
+                                                       struct CMetadataPacked **out_metadata);
+
 /*
  Extracts content and metadata from a byte slice into a string.
  */
@@ -319,6 +1096,84 @@ int extractous_extractor_extract_bytes(struct CExtractor *handle,
                                        struct CStreamReader **out_reader,
                                        struct CMetadata **out_metadata);
 
+/*
+ Extracts content from a byte slice into a stream, with packed metadata.
+ */
+int extractous_extractor_extract_bytes_packed(struct CExtractor *handle,
+                                              const uint8_t *data,
+                                              size_t data_len,
+                                              struct CStreamReader **out_reader,
+                                              struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content from a caller-owned byte slice into a stream without copying it,
+ with packed metadata.
+
+ The bytes are borrowed rather than duplicated: the caller must keep `data` valid and
+ unmodified until `release(user_data)` is called. `release` is invoked exactly once, on
+ any thread: when the returned stream is freed with `extractous_stream_free`, or before
+ this function returns if it fails. `release` may be NULL if no notification is needed.
+
+ Output metadata must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_bytes_borrowed(struct CExtractor *handle,
+                                                const uint8_t *data,
+                                                size_t data_len,
+                                                ExtractousReleaseFn release,
+                                                void *user_data,
+                                                struct CStreamReader **out_reader,
+                                                struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content and metadata from a byte slice into a length-prefixed buffer.
+
+ See `extractous_extractor_extract_file_to_buffer` for the buffer ownership rules.
+ */
+int extractous_extractor_extract_bytes_to_buffer(struct CExtractor *handle,
+                                                 const uint8_t *data,
+                                                 size_t data_len,
+                                                 uint8_t **out_buffer,
+                                                 size_t *out_len,
+                                                 struct CMetadata **out_metadata);
+
+/*
+ Extracts content from a byte slice into a length-prefixed buffer, with packed metadata.
+
+ See `extractous_extractor_extract_file_to_buffer_packed` for the ownership rules.
+ */
+int extractous_extractor_extract_bytes_to_buffer_packed(struct CExtractor *handle,
+                                                        const uint8_t *data,
+                                                        size_t data_len,
+                                                        uint8_t **out_buffer,
+                                                        size_t *out_len,
+                                                        struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content from a byte slice into a reusable buffer, with packed metadata.
+
+ The content replaces the contents of `buffer`, a handle from `extractous_buffer_new`,
+ as UTF-8 bytes that are NOT null-terminated. Its allocation is reused and only grows
+ when the content no longer fits, so a caller that keeps one buffer per worker does
+ not allocate a content buffer, nor copy through a C string, per document. The result
+ cache and the content budget apply as for `extractous_extractor_extract_bytes_to_buffer`.
+ On error the buffer is left unchanged.
+
+ Output metadata must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_bytes_into(struct CExtractor *handle,
+                                            const uint8_t *data,
+                                            size_t data_len,
+                                            struct CBuffer *buffer,
+                                            struct CMetadataPacked **out_metadata);
+
+/*
+ Like `extractous_extractor_extract_bytes_into`, for a local file path.
+ */
+int extractous_extractor_extract_file_into(struct CExtractor *handle,
+                                           const char *path,
+                                           struct CBuffer *buffer,
+                                           struct CMetadataPacked **out_metadata);
+
 /*
  Extracts content and metadata from a URL into a string.
  */
@@ -335,16 +1190,347 @@ int extractous_extractor_extract_url(struct CExtractor *handle,
                                      struct CStreamReader **out_reader,
                                      struct CMetadata **out_metadata);
 
+/*
+ Extracts content from a URL into a stream, with packed metadata.
+ */
+int extractous_extractor_extract_url_packed(struct CExtractor *handle,
+                                            const char *url,
+                                            struct CStreamReader **out_reader,
+                                            struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content and metadata from a URL into a length-prefixed buffer.
+
+ See `extractous_extractor_extract_file_to_buffer` for the buffer ownership rules.
+ */
+int extractous_extractor_extract_url_to_buffer(struct CExtractor *handle,
+                                               const char *url,
+                                               uint8_t **out_buffer,
+                                               size_t *out_len,
+                                               struct CMetadata **out_metadata);
+
+/*
+ Extracts content from a URL into a length-prefixed buffer, with packed metadata.
+
+ See `extractous_extractor_extract_file_to_buffer_packed` for the ownership rules.
+ */
+int extractous_extractor_extract_url_to_buffer_packed(struct CExtractor *handle,
+                                                      const char *url,
+                                                      uint8_t **out_buffer,
+                                                      size_t *out_len,
+                                                      struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts only the metadata of a local file.
+
+ Body text is not returned, and the parse stops as soon as the body starts: the
+ extractor runs with a one-character write limit, and its PDF configuration is
+ replaced by one without OCR or inline image extraction. The handle's other settings
+ still apply. Metadata the parser only fills in after reading the body, such as some
+ per-page statistics, may be missing.
+
+ Output metadata must be freed with `extractous_metadata_free`.
+ */
+int extractous_extractor_extract_metadata_only(struct CExtractor *handle,
+                                               const char *path,
+                                               struct CMetadata **out_metadata);
+
+/*
+ Like `extractous_extractor_extract_metadata_only`, with packed metadata.
+
+ Output metadata must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_metadata_only_packed(struct CExtractor *handle,
+                                                      const char *path,
+                                                      struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts only the metadata of a byte slice, with packed metadata.
+
+ See `extractous_extractor_extract_metadata_only` for what is skipped.
+ Output metadata must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_bytes_metadata_only_packed(struct CExtractor *handle,
+                                                            const uint8_t *data,
+                                                            size_t data_len,
+                                                            struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content and metadata from a memory-mapped local file into a stream.
+
+ The file is mapped read-only and the mapping itself is handed to the parser as its
+ input, so the source is never copied onto the heap. The mapping stays alive until the
+ stream is freed with `extractous_stream_free`. The file must not be truncated while the
+ stream is open. On platforms without `mmap` the file is read into memory instead.
+
+ Output metadata must be freed with `extractous_metadata_free`.
+ */
+int extractous_extractor_extract_mmap(struct CExtractor *handle,
+                                      const char *path,
+                                      struct CStreamReader **out_reader,
+                                      struct CMetadata **out_metadata);
+
+/*
+ Extracts content from a memory-mapped local file into a stream, with packed metadata.
+
+ Identical to `extractous_extractor_extract_mmap`, except that metadata is returned as a
+ single-allocation `CMetadataPacked` that must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_mmap_packed(struct CExtractor *handle,
+                                             const char *path,
+                                             struct CStreamReader **out_reader,
+                                             struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content from a memory-mapped local file into a length-prefixed buffer, with
+ packed metadata.
+
+ The mapping is released before this function returns. See
+ `extractous_extractor_extract_file_to_buffer_packed` for the ownership rules.
+ */
+int extractous_extractor_extract_mmap_to_buffer_packed(struct CExtractor *handle,
+                                                       const char *path,
+                                                       uint8_t **out_buffer,
+                                                       size_t *out_len,
+                                                       struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content from input pulled through a caller-supplied read callback into a
+ stream, with packed metadata.
+
+ `read(user_data, buf, len)` is called on the calling thread until it returns 0 (end of
+ input) or a negative value (error, reported as `ERR_IO_ERROR`). No callbacks are made
+ after this function returns. Pass the input length as `size_hint` if known, or 0.
+
+ The core parser needs its whole input up front, so the input is collected into a single
+ library-owned buffer before parsing starts; that buffer is owned by the returned stream
+ and released by `extractous_stream_free`. This avoids a temporary file or a second
+ caller-side copy, but parsing does not overlap with reading.
+
+ Output metadata must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_reader(struct CExtractor *handle,
+                                        ExtractousReadFn read,
+                                        void *user_data,
+                                        size_t size_hint,
+                                        struct CStreamReader **out_reader,
+                                        struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content from a local file into a length-prefixed buffer, with packed metadata,
+ stopping early with `ERR_CANCELLED` if `token` is cancelled or its deadline passes.
+
+ `token` may be NULL, in which case the call cannot be cancelled. The parse is stopped
+ and its memory released as soon as cancellation is observed, which happens between
+ reads of the parser's output; a parser that produces no output for a long time is
+ stopped when it next does.
+
+ The content is read from the parser's output stream, but otherwise comes back as from
+ `extractous_extractor_extract_file_to_buffer`: in UTF-8, cut at the smaller of the
+ content budget and `extract_string_max_length` (counted in bytes) on a character
+ boundary.
+
+ Output buffers must be freed with `extractous_buffer_free(buffer, len)`.
+ Output metadata must be freed with `extractous_metadata_packed_free`.
+ */
+int extractous_extractor_extract_file_to_buffer_cancellable(struct CExtractor *handle,
+                                                            const char *path,
+                                                            const struct CCancelToken *token,
+                                                            uint8_t **out_buffer,
+                                                            size_t *out_len,
+                                                            struct CMetadataPacked **out_metadata);
+
+/*
+ Extracts content from a byte slice into a length-prefixed buffer, with packed metadata,
+ stopping early with `ERR_CANCELLED` if `token` is cancelled or its deadline passes.
+
+ See `extractous_extractor_extract_file_to_buffer_cancellable` for the cancellation
+ and ownership rules.
+ */
+int extractous_extractor_extract_bytes_to_buffer_cancellable(struct CExtractor *handle,
+                                                             const uint8_t *data,
+                                                             size_t data_len,
+                                                             const struct CCancelToken *token,
+                                                             uint8_t **out_buffer,
+                                                             size_t *out_len,
+                                                             struct CMetadataPacked **out_metadata);
+
 /*
  Frees a C-style string that was allocated by this library.
  */
 void extractous_string_free(char *s);
 
+/*
+ Starts extracting a local file on the library's worker pool and returns immediately.
+
+ The extractor's configuration is captured when the job is submitted, so the handle may
+ be reconfigured or freed while the job runs. When the extraction ends, `callback` is
+ invoked exactly once on a worker thread with `user_data` and the outcome (see
+ `ExtractousCompletionFn` for ownership). It should return quickly: it runs on one of
+ a small, fixed set of threads. Errors are reported only through `error_code`;
+ `extractous_error_get_last_debug` does not cover async jobs.
+
+ If `out_job` is not NULL it receives a job handle that can be waited on and must be
+ freed with `extractous_job_free`; pass NULL to rely on the callback alone.
+ If this function returns an error, the job was not started and `callback` is never
+ invoked.
+ */
+int extractous_extractor_extract_file_async(struct CExtractor *handle,
+                                            const char *path,
+                                            ExtractousCompletionFn callback,
+                                            void *user_data,
+                                            struct CAsyncJob **out_job);
+
+/*
+ Blocks until the job's callback has returned, then returns the job's error code.
+ */
+int extractous_job_wait(struct CAsyncJob *job);
+
+/*
+ Returns true once the job's callback has returned. Never blocks.
+ */
+bool extractous_job_is_done(const struct CAsyncJob *job);
+
+/*
+ Frees a job handle. A job that is still running is not affected: it runs to
+ completion and its callback is still invoked.
+ */
+void extractous_job_free(struct CAsyncJob *job);
+
 /*
  Frees a metadata structure and all associated memory.
  */
 void extractous_metadata_free(struct CMetadata *metadata);
 
+/*
+ Frees a packed metadata block. The whole block is released with a single deallocation.
+ */
+void extractous_metadata_packed_free(struct CMetadataPacked *metadata);
+
+/*
+ Creates a pool of `size` extractors configured like `config`.
+
+ `config` is only read: the pool takes its current configuration snapshot, result
+ cache, content budget, memory limit and normalization stages, and the handle may be
+ reconfigured or freed afterwards without affecting the pool. Pass NULL for the
+ default configuration. A `size` of 0 selects one extractor per available CPU.
+
+ Before returning, each extractor runs a tiny built-in document on its own thread, in
+ parallel, so start-up costs in the core are paid here and not by the first requests.
+ Returns NULL if `size` extractors could not be created.
+ The returned handle must be freed with `extractous_pool_free`.
+ */
+struct CExtractorPool *extractous_pool_new(const struct CExtractor *config, size_t size);
+
+/*
+ Takes an extractor from the pool, blocking until one is idle.
+
+ The returned handle is used with the regular `extractous_extractor_*` functions and
+ must be given back with `extractous_pool_release`, never freed directly. Setters may
+ be called on it; the pool restores its configuration on release.
+ Returns NULL if `pool` is NULL.
+ */
+struct CExtractor *extractous_pool_acquire(struct CExtractorPool *pool);
+
+/*
+ Like `extractous_pool_acquire`, but returns NULL instead of blocking when every
+ extractor is in use.
+ */
+struct CExtractor *extractous_pool_try_acquire(struct CExtractorPool *pool);
+
+/*
+ Returns an acquired extractor to the pool and wakes one waiting caller.
+
+ Returns `ERR_INVALID_CONFIG` if `extractor` was not acquired from this pool, or is
+ already idle.
+ */
+int extractous_pool_release(struct CExtractorPool *pool, struct CExtractor *extractor);
+
+/*
+ Returns the number of extractors the pool owns, idle or not.
+ */
+size_t extractous_pool_size(const struct CExtractorPool *pool);
+
+/*
+ Frees a pool and all of its extractors.
+
+ Every acquired extractor must have been released first: handles still out are freed
+ with the pool. Extractions still running keep their configuration snapshot alive.
+ */
+void extractous_pool_free(struct CExtractorPool *pool);
+
+/*
+ Extracts content and metadata from a local file into a single result block.
+
+ The content, the packed metadata and all of their tables live in one allocation, so
+ the whole result is released with one call to `extractous_result_free`, however many
+ metadata entries it has. The content is null-terminated for convenience, but may
+ contain interior NUL bytes: `content_len` is authoritative. The metadata is read like
+ a `CMetadataPacked`, through `&result->metadata`, and must not be freed on its own.
+
+ The content budget applies as for `extractous_extractor_extract_file_to_buffer`.
+ */
+int extractous_extractor_extract_file_to_result(struct CExtractor *handle,
+                                                const char *path,
+                                                struct CExtractionResult **out_result);
+
+/*
+ Like `extractous_extractor_extract_file_to_result`, for a byte slice. The result cache
+ applies as for `extractous_extractor_extract_bytes_to_buffer`.
+ */
+int extractous_extractor_extract_bytes_to_result(struct CExtractor *handle,
+                                                 const uint8_t *data,
+                                                 size_t data_len,
+                                                 struct CExtractionResult **out_result);
+
+/*
+ Frees a result block, with its content and metadata, in a single deallocation.
+ */
+void extractous_result_free(struct CExtractionResult *result);
+
+/*
+ Turns statistics collection on or off.
+
+ Collection is off by default. While off, instrumented calls only pay for one relaxed
+ atomic load. Counters keep their values while collection is off.
+ */
+void extractous_stats_enable(bool enabled);
+
+/*
+ Resets all counters to zero.
+ */
+void extractous_stats_reset(void);
+
+/*
+ Copies the accounting of the last extraction call completed on the calling thread
+ into `out`, successful or not.
+
+ This covers the synchronous extraction entry points and async jobs: a job's
+ completion callback runs on the worker thread right after the job, so it can read
+ the job's record with this function. Batch items run on the batch's own threads and
+ are only counted in `extractous_stats_snapshot`.
+ Calls are only measured while statistics collection is enabled: for a call made while
+ it is off, before the first call and after `extractous_stats_last_call_reset`, every
+ field is 0. For streams, the record covers the call that created the stream; see
+ `extractous_stream_get_stats` for the reads made on it.
+ */
+int extractous_stats_last_call(struct CExtractionStats *out);
+
+/*
+ Clears the calling thread's record of its last extraction call, so that a call which
+ returns before it is measured, such as one given a NULL pointer, reads as all zeros
+ from `extractous_stats_last_call` instead of as the call before it.
+ */
+void extractous_stats_last_call_reset(void);
+
+/*
+ Copies the current counters into `out`.
+
+ Each counter is read atomically, but the snapshot as a whole is not: calls that finish
+ while it is taken may be only partly included.
+ */
+int extractous_stats_snapshot(struct CStats *out);
+
 /*
  Reads data from a stream into a user-provided buffer.
 
@@ -367,6 +1553,96 @@ int extractous_stream_read_exact(struct CStreamReader *handle,
                                  size_t buffer_size,
                                  size_t *bytes_read);
 
+/*
+ Reads into several caller buffers with one call, in order, like POSIX `readv`.
+
+ The call reads from the core at most once: it blocks until some content is available,
+ then fills the buffers with that content and whatever is already buffered, returning
+ early rather than waiting for more. The total number of bytes read is returned via
+ `bytes_read`, also when an I/O error interrupts the call. A total of 0 with `ERR_OK`
+ means the end of the stream was reached; a short total does not. Buffers with a length
+ of 0 may be NULL.
+ */
+int extractous_stream_read_into_iov(struct CStreamReader *handle,
+                                    const struct CIoVec *iov,
+                                    size_t iovcnt,
+                                    size_t *bytes_read);
+
+/*
+ Returns the next structural event of the stream: the start and end of pages, slides
+ and sheets, sheet names, the boundaries of embedded documents, and runs of text.
+
+ Events come from the XHTML the core produces with
+ `extractous_extractor_set_xml_output_mut(handle, true)`, which is tokenized as it is
+ read, in one pass: the markup is not returned, and character references in text are
+ decoded. A stream of plain text yields text events only. Text runs hold whole UTF-8
+ characters and never span a page boundary. Whitespace between XHTML tags is dropped.
+
+ The end of the stream is reported as a `STREAM_EVENT_END` event with `ERR_OK`. The
+ event's `data` is owned by the stream and valid until the next call on it or until it
+ is freed. Do not mix this with the `extractous_stream_read*` functions on one stream:
+ events are parsed from input read ahead of them.
+ */
+int extractous_stream_next_event(struct CStreamReader *handle, struct CStreamEvent *out_event);
+
+/*
+ Returns the next chunk of the stream's content, for splitting documents into
+ overlapping segments, such as for embedding, as they are extracted.
+
+ Each chunk holds at most `max_bytes` bytes and starts with up to `overlap` bytes from
+ the end of the one before it. Chunks end after the last paragraph break, sentence end,
+ line break or space in their second half, in that order of preference, or else on a
+ UTF-8 character boundary; overlaps start at a word where they can. The stream is read
+ only as far as the current chunk, so chunks arrive while the document is still being
+ parsed, and memory stays bounded by `max_bytes`. Normalization and the content budget
+ apply to the content as for other reads.
+
+ The end of the stream is reported as a chunk with NULL `data` and `len` 0, with
+ `ERR_OK`. The chunk's `data` is owned by the stream and valid until the next call on it
+ or until it is freed. `max_bytes` and `overlap` may change between calls. Returns
+ `ERR_INVALID_CONFIG` if `max_bytes` is below 4, the longest UTF-8 character, or if
+ `overlap` is not below `max_bytes`. Do not mix this with the other
+ `extractous_stream_read*` and event functions on one stream: content past the
+ current chunk is read ahead.
+ */
+int extractous_stream_next_chunk(struct CStreamReader *handle,
+                                 size_t max_bytes,
+                                 size_t overlap,
+                                 struct CStreamChunk *out_chunk);
+
+/*
+ Sets the size of the stream's read-ahead buffer.
+
+ Reads smaller than this are served from the buffer, which is refilled with one large
+ read from the parser; larger reads bypass it. A size of 0 disables read-ahead.
+ Already buffered bytes are never discarded. Defaults to `STREAM_DEFAULT_BUFFER_SIZE`.
+ */
+int extractous_stream_set_buffer_size(struct CStreamReader *handle, size_t size);
+
+/*
+ Attaches a cancel token to the stream, replacing any earlier one; NULL detaches it.
+
+ Once the token is cancelled or its deadline passes, the next read of any kind
+ returns `ERR_CANCELLED`, as does every read after it. The parse behind the stream is
+ stopped and its memory released at that point, without waiting for
+ `extractous_stream_free`. Cancellation is observed between reads: a single read that
+ is blocked inside the parser returns when the parser next produces output.
+ The stream keeps its own reference, so the token handle may be freed afterwards.
+ */
+int extractous_stream_set_cancel_token(struct CStreamReader *handle,
+                                       const struct CCancelToken *token);
+
+/*
+ Copies the accounting of the reads made on the stream so far into `out`.
+
+ Streamed content is parsed while it is read, so this is where the cost of a streamed
+ extraction shows up; the call that created the stream is covered by
+ `extractous_stats_last_call`. Reads served from the read-ahead buffer cost nothing
+ here. `convert_ns` and `metadata_entries` are always 0, and `code` is that of the
+ last failed read. Reads are only accounted while statistics collection is enabled.
+ */
+int extractous_stream_get_stats(const struct CStreamReader *handle, struct CExtractionStats *out);
+
 /*
  Reads the remaining stream into a newly allocated buffer.
  */
@@ -375,7 +1651,21 @@ int extractous_stream_read_all(struct CStreamReader *handle,
                                size_t *out_size);
 
 /*
- Frees a buffer allocated by `extractous_stream_read_all`.
+ Copies the rest of the stream to a file descriptor without returning to the caller.
+
+ The read/write loop runs entirely inside the library with a large buffer, so the
+ extracted text never passes through caller memory. Writes are retried until complete.
+ The number of bytes written is returned via `bytes_written`, also on failure. The
+ descriptor is not closed. Write failures are reported as `ERR_IO_ERROR` and recorded
+ for `extractous_error_get_last_debug`.
+
+ Only POSIX file descriptors are supported; on Windows this returns `ERR_IO_ERROR`.
+ */
+int extractous_stream_copy_to_fd(struct CStreamReader *handle, int fd, size_t *bytes_written);
+
+/*
+ Frees a buffer allocated by `extractous_stream_read_all` or one of the
+ `extractous_extractor_extract_*_to_buffer` functions.
  */
 void extractous_buffer_free(uint8_t *buffer, size_t size);
 
@@ -384,4 +1674,30 @@ void extractous_buffer_free(uint8_t *buffer, size_t size);
  */
 void extractous_stream_free(struct CStreamReader *handle);
 
+/*
+ Performs the library's one-time initialization up front, so it does not land on the
+ first real request.
+
+ This brings up the core's embedded runtime by extracting a tiny plain-text document,
+ optionally starts the async worker threads, and then warms up the parsers selected by
+ `opts->warmup_formats` like `extractous_warmup`. Pass NULL to start the workers and
+ warm up every format.
+
+ Everything done here would otherwise happen lazily, so calling it is optional, and it
+ is safe to call more than once or from several threads. Returns `ERR_INVALID_ENUM` for
+ unknown format bits, without doing anything. Otherwise returns the first error met;
+ initialization still runs to the end, and a failed step is retried lazily on use.
+ */
+int extractous_init(const struct CInitOptions *opts);
+
+/*
+ Pre-loads the parsers selected by `formats_mask` (`WARMUP_FORMAT_*` bits) by running a
+ tiny built-in sample document through each of them.
+
+ Samples run with the default configuration and are not counted in the statistics.
+ Returns `ERR_INVALID_ENUM` for unknown bits, without running anything, or else the
+ first error a sample produced.
+ */
+int extractous_warmup(uint32_t formats_mask);
+
 #endif  /* EXTRACTOUS_H */
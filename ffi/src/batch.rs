@@ -0,0 +1,177 @@
+use crate::errors::*;
+use crate::extractor::{extract_to_string_within, string_into_buffer};
+use crate::metadata::metadata_to_packed;
+use crate::shared::{self, Snapshot};
+use crate::stats::CallTimer;
+use crate::types::*;
+use std::collections::HashMap;
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_int};
+use std::ptr;
+use std::sync::OnceLock;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::thread;
+
+type ItemResult = Result<(String, HashMap<String, Vec<String>>), c_int>;
+
+/// Resolves the number of worker threads for a batch of `n` items.
+/// A non-positive `parallelism` means one worker per available CPU.
+fn worker_count(parallelism: c_int, n: usize) -> usize {
+    let requested = if parallelism > 0 {
+        parallelism as usize
+    } else {
+        thread::available_parallelism().map_or(1, |p| p.get())
+    };
+    requested.clamp(1, n.max(1))
+}
+
+/// Runs `extract_file_to_string` for every path on a scoped worker pool.
+///
+/// Workers pull the next index from a shared counter, so slow documents do not
+/// hold up a statically assigned slice of the batch. Each result is written to the slot
+/// of its path, so they come back in input order. There is always one result per path:
+/// items a worker did not finish, because it panicked, fail with `ERR_EXTRACTION_FAILED`.
+fn run_batch(
+    snapshot: &Snapshot,
+    paths: &[Result<&str, c_int>],
+    workers: usize,
+) -> Vec<ItemResult> {
+    let next = AtomicUsize::new(0);
+    let slots: Vec<OnceLock<ItemResult>> = paths.iter().map(|_| OnceLock::new()).collect();
+
+    thread::scope(|scope| {
+        let handles: Vec<_> = (0..workers)
+            .map(|_| {
+                scope.spawn(|| {
+                    loop {
+                        let i = next.fetch_add(1, Ordering::Relaxed);
+                        if i >= paths.len() {
+                            break;
+                        }
+                        let result = match paths[i] {
+                            Ok(path) => {
+                                let mut timer = CallTimer::start();
+                                match extract_to_string_within(
+                                    snapshot,
+                                    |e| e.extract_file(path),
+                                    |e| e.extract_file_to_string(path),
+                                ) {
+                                    Ok((content, metadata)) => {
+                                        timer.parsed(&content, &metadata);
+                                        timer.finish_ok();
+                                        Ok((content, metadata))
+                                    }
+                                    Err(e) => {
+                                        let code = e.error_code();
+                                        timer.finish_err(code);
+                                        Err(code)
+                                    }
+                                }
+                            }
+                            Err(code) => Err(code),
+                        };
+                        let _ = slots[i].set(result);
+                    }
+                })
+            })
+            .collect();
+
+        // Joining here keeps a worker's panic from propagating out of the scope.
+        for handle in handles {
+            let _ = handle.join();
+        }
+    });
+
+    slots
+        .into_iter()
+        .map(|slot| slot.into_inner().unwrap_or(Err(ERR_EXTRACTION_FAILED)))
+        .collect()
+}
+
+/// Extracts a list of local files to strings in parallel on a library-owned worker pool.
+///
+/// All workers share the extractor's configuration. `parallelism <= 0` uses one worker
+/// per available CPU. On success `*out_results` points to an array of `n` results in the
+/// same order as `paths`; each item carries its own error code, so a failing document does
+/// not fail the batch. The array must be freed with `extractous_batch_results_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_files_batch(
+    handle: *mut CExtractor,
+    paths: *const *const c_char,
+    n: libc::size_t,
+    parallelism: c_int,
+    out_results: *mut *mut CBatchResult,
+) -> c_int {
+    if handle.is_null() || out_results.is_null() || (paths.is_null() && n > 0) {
+        return ERR_NULL_POINTER;
+    }
+    unsafe { *out_results = ptr::null_mut() };
+    if n == 0 {
+        return ERR_OK;
+    }
+
+    let snapshot = unsafe { shared::snapshot(handle) };
+    let raw_paths = unsafe { std::slice::from_raw_parts(paths, n) };
+    let parsed: Vec<Result<&str, c_int>> = raw_paths
+        .iter()
+        .map(|&p| {
+            if p.is_null() {
+                return Err(ERR_NULL_POINTER);
+            }
+            unsafe { CStr::from_ptr(p) }
+                .to_str()
+                .map_err(|_| ERR_INVALID_UTF8)
+        })
+        .collect();
+
+    let results = run_batch(&snapshot, &parsed, worker_count(parallelism, n));
+
+    let mut c_results: Vec<CBatchResult> = results
+        .into_iter()
+        .map(|r| match r {
+            Ok((content, metadata)) => {
+                let mut buffer = ptr::null_mut();
+                let mut len = 0;
+                unsafe { string_into_buffer(content, &mut buffer, &mut len) };
+                CBatchResult {
+                    content: buffer,
+                    content_len: len,
+                    metadata: metadata_to_packed(metadata),
+                    error_code: ERR_OK,
+                }
+            }
+            Err(code) => CBatchResult {
+                content: ptr::null_mut(),
+                content_len: 0,
+                metadata: ptr::null_mut(),
+                error_code: code,
+            },
+        })
+        .collect();
+
+    c_results.shrink_to_fit();
+    let results_ptr = c_results.as_mut_ptr();
+    std::mem::forget(c_results);
+
+    unsafe { *out_results = results_ptr };
+    ERR_OK
+}
+
+/// Frees a result array returned by `extractous_extractor_extract_files_batch`,
+/// including every content buffer and packed metadata block it holds.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_batch_results_free(
+    results: *mut CBatchResult,
+    n: libc::size_t,
+) {
+    if results.is_null() || n == 0 {
+        return;
+    }
+    let items = unsafe { Vec::from_raw_parts(results, n, n) };
+    for item in items {
+        unsafe {
+            crate::stream::extractous_buffer_free(item.content, item.content_len);
+            crate::metadata::extractous_metadata_packed_free(item.metadata);
+        }
+    }
+}
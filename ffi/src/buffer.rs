@@ -0,0 +1,104 @@
+use crate::errors::*;
+use crate::types::*;
+use std::mem::ManuallyDrop;
+use std::os::raw::c_int;
+use std::ptr;
+
+/// Runs `f` on the vector a `CBuffer` describes, then writes its new parts back, so the
+/// allocation survives from one call to the next.
+pub(crate) unsafe fn with_vec<R>(buffer: *mut CBuffer, f: impl FnOnce(&mut Vec<u8>) -> R) -> R {
+    let buffer = unsafe { &mut *buffer };
+    let mut vec = if buffer.data.is_null() {
+        Vec::new()
+    } else {
+        unsafe { Vec::from_raw_parts(buffer.data, buffer.len, buffer.capacity) }
+    };
+    let result = f(&mut vec);
+    let mut vec = ManuallyDrop::new(vec);
+    buffer.capacity = vec.capacity();
+    buffer.len = vec.len();
+    buffer.data = if buffer.capacity == 0 {
+        ptr::null_mut()
+    } else {
+        vec.as_mut_ptr()
+    };
+    result
+}
+
+/// Replaces the contents of `buffer` with `content`, reusing its allocation when it is
+/// large enough.
+pub(crate) unsafe fn fill(buffer: *mut CBuffer, content: &[u8]) {
+    unsafe {
+        with_vec(buffer, |vec| {
+            vec.clear();
+            vec.extend_from_slice(content);
+        })
+    }
+}
+
+/// Creates an empty, reusable output buffer with room for at least `capacity` bytes.
+///
+/// Pass it to `extractous_extractor_extract_bytes_into` or
+/// `extractous_extractor_extract_file_into`, which overwrite its contents on every call
+/// and only reallocate when the content outgrows its capacity. A worker that keeps one
+/// buffer for its lifetime stops allocating for content once the buffer has grown to its
+/// largest document. Returns NULL if the memory cannot be allocated.
+///
+/// The returned buffer must be freed with `extractous_buffer_destroy`, not
+/// `extractous_buffer_free`.
+#[unsafe(no_mangle)]
+pub extern "C" fn extractous_buffer_new(capacity: libc::size_t) -> *mut CBuffer {
+    let buffer = Box::into_raw(Box::new(CBuffer {
+        data: ptr::null_mut(),
+        len: 0,
+        capacity: 0,
+    }));
+    if capacity > 0 && unsafe { extractous_buffer_reserve(buffer, capacity) } != ERR_OK {
+        unsafe { extractous_buffer_destroy(buffer) };
+        return ptr::null_mut();
+    }
+    buffer
+}
+
+/// Grows `buffer` so it can hold at least `capacity` bytes in total without reallocating.
+/// Its contents are kept. Does nothing if it is already large enough.
+///
+/// Returns `ERR_OUT_OF_MEMORY` if the memory cannot be allocated; the buffer is then
+/// unchanged.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_buffer_reserve(
+    buffer: *mut CBuffer,
+    capacity: libc::size_t,
+) -> c_int {
+    if buffer.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    unsafe {
+        with_vec(buffer, |vec| {
+            match vec.try_reserve_exact(capacity.saturating_sub(vec.len())) {
+                Ok(()) => ERR_OK,
+                Err(_) => ERR_OUT_OF_MEMORY,
+            }
+        })
+    }
+}
+
+/// Empties `buffer`, keeping its allocation.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_buffer_clear(buffer: *mut CBuffer) {
+    if !buffer.is_null() {
+        unsafe { (*buffer).len = 0 };
+    }
+}
+
+/// Frees a buffer created by `extractous_buffer_new`, with its allocation.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_buffer_destroy(buffer: *mut CBuffer) {
+    if buffer.is_null() {
+        return;
+    }
+    let buffer = unsafe { Box::from_raw(buffer) };
+    if !buffer.data.is_null() {
+        drop(unsafe { Vec::from_raw_parts(buffer.data, buffer.len, buffer.capacity) });
+    }
+}
@@ -0,0 +1,710 @@
+use crate::errors::*;
+use crate::extractor::extract_to_string_within;
+use crate::memory::OutOfMemory;
+use crate::shared::{SharedExtractor, Snapshot};
+use crate::stats;
+use crate::types::*;
+use std::collections::{BTreeMap, HashMap};
+use std::ffi::CStr;
+use std::fs;
+use std::os::raw::{c_char, c_int};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
+
+type Metadata = HashMap<String, Vec<String>>;
+
+/// Identifies one extraction result: the input bytes and the configuration that parsed
+/// them, so extractors with different settings never share entries.
+///
+/// Keys are persisted by disk tiers, so everything in them is stable across releases and
+/// platforms: the input is hashed with XXH64 under two fixed seeds in one pass, giving 128
+/// bits plus the length, and the configuration is hashed from an explicit encoding of its
+/// settings. A change to either layout must change `DISK_MAGIC`.
+#[derive(Clone, Copy, PartialEq, Eq, Hash)]
+struct CacheKey {
+    len: u64,
+    content: [u64; 2],
+    config: u64,
+}
+
+const KEY_BYTES: usize = 32;
+
+impl CacheKey {
+    fn new(snapshot: &Snapshot, bytes: &[u8]) -> Self {
+        Self {
+            len: bytes.len() as u64,
+            content: xxh64_pair(bytes, CONTENT_SEEDS),
+            config: xxh64_pair(&config_fingerprint(snapshot), [CONFIG_SEED, 0])[0],
+        }
+    }
+
+    fn to_bytes(self) -> [u8; KEY_BYTES] {
+        let mut out = [0; KEY_BYTES];
+        let words = [self.len, self.content[0], self.content[1], self.config];
+        for (chunk, word) in out.chunks_exact_mut(8).zip(words) {
+            chunk.copy_from_slice(&word.to_le_bytes());
+        }
+        out
+    }
+
+    fn from_bytes(bytes: &[u8]) -> Option<Self> {
+        let word = |i: usize| {
+            Some(u64::from_le_bytes(
+                bytes.get(i * 8..i * 8 + 8)?.try_into().ok()?,
+            ))
+        };
+        Some(Self {
+            len: word(0)?,
+            content: [word(1)?, word(2)?],
+            config: word(3)?,
+        })
+    }
+
+    /// Name of the key's file in a disk tier.
+    fn file_name(self) -> String {
+        let hex: String = self.to_bytes().iter().map(|b| format!("{b:02x}")).collect();
+        format!("{hex}.{DISK_EXTENSION}")
+    }
+
+    fn from_file_name(name: &str) -> Option<Self> {
+        let hex = name.strip_suffix(DISK_EXTENSION)?.strip_suffix('.')?;
+        if hex.len() != KEY_BYTES * 2 {
+            return None;
+        }
+        let bytes: Option<Vec<u8>> = (0..KEY_BYTES)
+            .map(|i| u8::from_str_radix(hex.get(i * 2..i * 2 + 2)?, 16).ok())
+            .collect();
+        Self::from_bytes(&bytes?)
+    }
+}
+
+const CONTENT_SEEDS: [u64; 2] = [0, 1];
+const CONFIG_SEED: u64 = 2;
+
+/// Encodes every setting that changes an extraction's result, in a fixed order: the
+/// core settings as they were set, `extract_string_max_length`, the content budget and
+/// the normalization stages. The memory limit only decides whether a result is
+/// returned, so it is checked on hits instead.
+fn config_fingerprint(snapshot: &Snapshot) -> Vec<u8> {
+    let settings = &snapshot.settings;
+    let options = snapshot.options;
+    let mut out = Fingerprint(Vec::with_capacity(128));
+    out.int(settings.encoding.map(i64::from));
+    out.flag(settings.xml_output);
+    out.int(Some(options.string_max_length.into()));
+    out.int(Some(options.content_budget as i64));
+    out.int(Some(options.normalize.into()));
+
+    out.section(settings.pdf.as_ref(), |out, pdf| {
+        out.int(pdf.ocr_strategy.map(i64::from));
+        out.flag(pdf.extract_inline_images);
+        out.flag(pdf.extract_unique_inline_images_only);
+        out.flag(pdf.extract_marked_content);
+        out.flag(pdf.extract_annotation_text);
+    });
+    out.section(settings.office.as_ref(), |out, office| {
+        out.flag(office.extract_macros);
+        out.flag(office.include_deleted_content);
+        out.flag(office.include_move_from_content);
+        out.flag(office.include_shape_based_content);
+    });
+    out.section(settings.ocr.as_ref(), |out, ocr| {
+        out.text(ocr.language.as_deref());
+        out.int(ocr.density.map(i64::from));
+        out.int(ocr.depth.map(i64::from));
+        out.flag(ocr.enable_image_preprocessing);
+        out.int(ocr.timeout_seconds.map(i64::from));
+    });
+    out.0
+}
+
+/// Writer for `config_fingerprint`. Every value is tagged, with 0 for a setting left at
+/// the core's default, so no two configurations share an encoding.
+struct Fingerprint(Vec<u8>);
+
+impl Fingerprint {
+    fn flag(&mut self, value: Option<bool>) {
+        self.0.push(match value {
+            None => 0,
+            Some(false) => 1,
+            Some(true) => 2,
+        });
+    }
+
+    fn int(&mut self, value: Option<i64>) {
+        match value {
+            None => self.0.push(0),
+            Some(v) => {
+                self.0.push(1);
+                self.0.extend_from_slice(&v.to_le_bytes());
+            }
+        }
+    }
+
+    fn text(&mut self, value: Option<&str>) {
+        match value {
+            None => self.0.push(0),
+            Some(v) => {
+                self.0.push(1);
+                self.0.extend_from_slice(&(v.len() as u64).to_le_bytes());
+                self.0.extend_from_slice(v.as_bytes());
+            }
+        }
+    }
+
+    fn section<T>(&mut self, value: Option<&T>, encode: impl FnOnce(&mut Self, &T)) {
+        match value {
+            None => self.0.push(0),
+            Some(v) => {
+                self.0.push(1);
+                encode(self, v);
+            }
+        }
+    }
+}
+
+const PRIME64_1: u64 = 0x9E37_79B1_85EB_CA87;
+const PRIME64_2: u64 = 0xC2B2_AE3D_27D4_EB4F;
+const PRIME64_3: u64 = 0x1656_67B1_9E37_79F9;
+const PRIME64_4: u64 = 0x85EB_CA77_C2B2_AE63;
+const PRIME64_5: u64 = 0x27D4_EB2F_1656_67C5;
+
+fn read_u64(bytes: &[u8]) -> u64 {
+    u64::from_le_bytes(bytes[..8].try_into().unwrap())
+}
+
+fn xxh64_round(acc: u64, input: u64) -> u64 {
+    acc.wrapping_add(input.wrapping_mul(PRIME64_2))
+        .rotate_left(31)
+        .wrapping_mul(PRIME64_1)
+}
+
+fn xxh64_merge(acc: u64, lane: u64) -> u64 {
+    (acc ^ xxh64_round(0, lane))
+        .wrapping_mul(PRIME64_1)
+        .wrapping_add(PRIME64_4)
+}
+
+/// XXH64 of `bytes` under each of `seeds`, as in the xxHash specification, reading the
+/// input once for both.
+fn xxh64_pair(bytes: &[u8], seeds: [u64; 2]) -> [u64; 2] {
+    let stripes = bytes.chunks_exact(32);
+    let tail = stripes.remainder();
+    let mut hashes = seeds.map(|seed| seed.wrapping_add(PRIME64_5));
+    if bytes.len() >= 32 {
+        let mut lanes = seeds.map(|seed| {
+            [
+                seed.wrapping_add(PRIME64_1).wrapping_add(PRIME64_2),
+                seed.wrapping_add(PRIME64_2),
+                seed,
+                seed.wrapping_sub(PRIME64_1),
+            ]
+        });
+        for stripe in stripes {
+            for lanes in &mut lanes {
+                for (i, lane) in lanes.iter_mut().enumerate() {
+                    *lane = xxh64_round(*lane, read_u64(&stripe[i * 8..]));
+                }
+            }
+        }
+        hashes = lanes.map(|[v1, v2, v3, v4]| {
+            let h = v1
+                .rotate_left(1)
+                .wrapping_add(v2.rotate_left(7))
+                .wrapping_add(v3.rotate_left(12))
+                .wrapping_add(v4.rotate_left(18));
+            [v1, v2, v3, v4].into_iter().fold(h, xxh64_merge)
+        });
+    }
+    hashes.map(|h| xxh64_finish(h.wrapping_add(bytes.len() as u64), tail))
+}
+
+fn xxh64_finish(mut h: u64, tail: &[u8]) -> u64 {
+    let mut words = tail.chunks_exact(8);
+    for word in &mut words {
+        h = (h ^ xxh64_round(0, read_u64(word)))
+            .rotate_left(27)
+            .wrapping_mul(PRIME64_1)
+            .wrapping_add(PRIME64_4);
+    }
+    let mut rest = words.remainder();
+    if rest.len() >= 4 {
+        let word = u32::from_le_bytes(rest[..4].try_into().unwrap());
+        h = (h ^ u64::from(word).wrapping_mul(PRIME64_1))
+            .rotate_left(23)
+            .wrapping_mul(PRIME64_2)
+            .wrapping_add(PRIME64_3);
+        rest = &rest[4..];
+    }
+    for &byte in rest {
+        h = (h ^ u64::from(byte).wrapping_mul(PRIME64_5))
+            .rotate_left(11)
+            .wrapping_mul(PRIME64_1);
+    }
+    h ^= h >> 33;
+    h = h.wrapping_mul(PRIME64_2);
+    h ^= h >> 29;
+    h = h.wrapping_mul(PRIME64_3);
+    h ^ (h >> 32)
+}
+
+/// A cached extraction result.
+struct CachedResult {
+    content: String,
+    metadata: Metadata,
+}
+
+/// Fixed per-entry cost added to the payload when accounting memory.
+const ENTRY_OVERHEAD: u64 = 128;
+
+impl CachedResult {
+    fn size(&self) -> u64 {
+        let metadata: usize = self
+            .metadata
+            .iter()
+            .map(|(k, vs)| k.len() + vs.iter().map(String::len).sum::<usize>())
+            .sum();
+        (self.content.len() + metadata) as u64 + ENTRY_OVERHEAD
+    }
+}
+
+/// A byte-bounded map that evicts its least recently used entries.
+struct Lru<V> {
+    /// Value, last-use tick and accounted size per key.
+    entries: HashMap<CacheKey, (V, u64, u64)>,
+    /// Keys by last-use tick, oldest first.
+    order: BTreeMap<u64, CacheKey>,
+    next_tick: u64,
+    bytes: u64,
+    max_bytes: u64,
+}
+
+impl<V> Lru<V> {
+    fn new(max_bytes: u64) -> Self {
+        Self {
+            entries: HashMap::new(),
+            order: BTreeMap::new(),
+            next_tick: 0,
+            bytes: 0,
+            max_bytes,
+        }
+    }
+
+    fn tick(&mut self) -> u64 {
+        self.next_tick += 1;
+        self.next_tick
+    }
+
+    /// Returns the value for `key` and marks it most recently used.
+    fn get(&mut self, key: &CacheKey) -> Option<&V> {
+        let tick = self.tick();
+        let (_, last_use, _) = self.entries.get_mut(key)?;
+        self.order.remove(last_use);
+        self.order.insert(tick, *key);
+        *last_use = tick;
+        self.entries.get(key).map(|(v, _, _)| v)
+    }
+
+    /// Inserts or replaces `key`, then evicts until the map fits its bound. Returns the
+    /// evicted entries; an entry larger than the bound is evicted right away.
+    fn insert(&mut self, key: CacheKey, value: V, size: u64) -> Vec<(CacheKey, V)> {
+        self.remove(&key);
+        let mut evicted = Vec::new();
+        let tick = self.tick();
+        self.entries.insert(key, (value, tick, size));
+        self.order.insert(tick, key);
+        self.bytes += size;
+        while self.bytes > self.max_bytes {
+            let Some((_, oldest)) = self.order.pop_first() else {
+                break;
+            };
+            if let Some((v, _, size)) = self.entries.remove(&oldest) {
+                self.bytes -= size;
+                evicted.push((oldest, v));
+            }
+        }
+        evicted
+    }
+
+    fn remove(&mut self, key: &CacheKey) -> Option<V> {
+        let (value, tick, size) = self.entries.remove(key)?;
+        self.order.remove(&tick);
+        self.bytes -= size;
+        Some(value)
+    }
+
+    fn clear(&mut self) -> Vec<CacheKey> {
+        self.order.clear();
+        self.bytes = 0;
+        self.entries.drain().map(|(k, _)| k).collect()
+    }
+}
+
+/// File extension of disk tier entries; other files in the directory are left alone.
+const DISK_EXTENSION: &str = "exc";
+/// Versions the entry layout and the key: bumped whenever either changes, so entries
+/// written by an incompatible build are orphaned rather than misread.
+const DISK_MAGIC: &[u8; 4] = b"EXC2";
+
+/// An on-disk second tier: one file per entry, indexed in memory.
+struct DiskTier {
+    dir: PathBuf,
+    index: Lru<()>,
+}
+
+impl DiskTier {
+    /// Opens `dir`, creating it if needed, and indexes the entries already in it, oldest
+    /// modification first.
+    fn open(dir: &Path, max_bytes: u64) -> std::io::Result<Self> {
+        fs::create_dir_all(dir)?;
+        let mut found = Vec::new();
+        for entry in fs::read_dir(dir)? {
+            let entry = entry?;
+            let Some(key) = entry
+                .file_name()
+                .to_str()
+                .and_then(CacheKey::from_file_name)
+            else {
+                continue;
+            };
+            let meta = entry.metadata()?;
+            found.push((meta.modified().ok(), key, meta.len()));
+        }
+        found.sort_by_key(|(modified, _, _)| *modified);
+
+        let mut tier = Self {
+            dir: dir.to_path_buf(),
+            index: Lru::new(max_bytes),
+        };
+        for (_, key, size) in found {
+            for (old, ()) in tier.index.insert(key, (), size) {
+                let _ = fs::remove_file(tier.path(old));
+            }
+        }
+        Ok(tier)
+    }
+
+    fn path(&self, key: CacheKey) -> PathBuf {
+        self.dir.join(key.file_name())
+    }
+}
+
+fn encode(key: CacheKey, result: &CachedResult) -> Vec<u8> {
+    fn put(out: &mut Vec<u8>, bytes: &[u8]) {
+        out.extend_from_slice(&(bytes.len() as u64).to_le_bytes());
+        out.extend_from_slice(bytes);
+    }
+    let mut out = Vec::with_capacity(result.size() as usize);
+    out.extend_from_slice(DISK_MAGIC);
+    out.extend_from_slice(&key.to_bytes());
+    put(&mut out, result.content.as_bytes());
+    out.extend_from_slice(&(result.metadata.len() as u64).to_le_bytes());
+    for (k, values) in &result.metadata {
+        put(&mut out, k.as_bytes());
+        out.extend_from_slice(&(values.len() as u64).to_le_bytes());
+        for v in values {
+            put(&mut out, v.as_bytes());
+        }
+    }
+    out
+}
+
+/// Decodes a disk tier file, returning `None` if it is truncated, corrupt or for
+/// another key.
+fn decode(key: CacheKey, data: &[u8]) -> Option<CachedResult> {
+    let rest = data.strip_prefix(DISK_MAGIC)?;
+    let (stored, rest) = rest.split_at_checked(KEY_BYTES)?;
+    if CacheKey::from_bytes(stored)? != key {
+        return None;
+    }
+
+    let mut reader = Reader { data: rest };
+    let content = reader.string()?;
+    let mut metadata = Metadata::new();
+    for _ in 0..reader.count()? {
+        let k = reader.string()?;
+        let values = (0..reader.count()?)
+            .map(|_| reader.string())
+            .collect::<Option<Vec<_>>>()?;
+        metadata.insert(k, values);
+    }
+    Some(CachedResult { content, metadata })
+}
+
+/// Cursor over an encoded entry.
+struct Reader<'a> {
+    data: &'a [u8],
+}
+
+impl Reader<'_> {
+    fn count(&mut self) -> Option<usize> {
+        let (head, tail) = self.data.split_at_checked(8)?;
+        self.data = tail;
+        usize::try_from(u64::from_le_bytes(head.try_into().ok()?)).ok()
+    }
+
+    fn string(&mut self) -> Option<String> {
+        let len = self.count()?;
+        let (head, tail) = self.data.split_at_checked(len)?;
+        self.data = tail;
+        String::from_utf8(head.to_vec()).ok()
+    }
+}
+
+/// The state behind a `CResultCache` handle: a byte-bounded, in-memory LRU of extraction
+/// results, optionally backed by a disk tier. Shared by reference count between the
+/// caller's handle and every extractor it is attached to.
+pub(crate) struct ResultCache {
+    memory: Mutex<Lru<Arc<CachedResult>>>,
+    disk: Mutex<Option<DiskTier>>,
+}
+
+/// Distinguishes temporary files of concurrent writers.
+static TEMP_COUNTER: AtomicU64 = AtomicU64::new(0);
+
+impl ResultCache {
+    fn get(&self, key: &CacheKey) -> Option<Arc<CachedResult>> {
+        let mut memory = self.memory.lock().unwrap_or_else(|e| e.into_inner());
+        if let Some(hit) = memory.get(key) {
+            let hit = Arc::clone(hit);
+            drop(memory);
+            stats::record_cache_hit(false);
+            return Some(hit);
+        }
+        drop(memory);
+
+        let hit = self.get_from_disk(*key)?;
+        stats::record_cache_hit(true);
+        let size = hit.size();
+        self.memory
+            .lock()
+            .unwrap_or_else(|e| e.into_inner())
+            .insert(*key, Arc::clone(&hit), size);
+        Some(hit)
+    }
+
+    fn get_from_disk(&self, key: CacheKey) -> Option<Arc<CachedResult>> {
+        let path = {
+            let mut disk = self.disk.lock().unwrap_or_else(|e| e.into_inner());
+            let tier = disk.as_mut()?;
+            tier.index.get(&key)?;
+            tier.path(key)
+        };
+        // Read outside the lock; a file evicted meanwhile is simply a miss.
+        match fs::read(&path).ok().and_then(|data| decode(key, &data)) {
+            Some(result) => Some(Arc::new(result)),
+            None => {
+                let mut disk = self.disk.lock().unwrap_or_else(|e| e.into_inner());
+                if let Some(tier) = disk.as_mut() {
+                    tier.index.remove(&key);
+                }
+                let _ = fs::remove_file(&path);
+                None
+            }
+        }
+    }
+
+    fn insert(&self, key: CacheKey, result: CachedResult) {
+        let result = Arc::new(result);
+        let size = result.size();
+        self.memory
+            .lock()
+            .unwrap_or_else(|e| e.into_inner())
+            .insert(key, Arc::clone(&result), size);
+        self.insert_on_disk(key, &result);
+    }
+
+    /// Writes an entry to the disk tier, if any. Failures only cost the entry.
+    fn insert_on_disk(&self, key: CacheKey, result: &CachedResult) {
+        let Some(dir) = self
+            .disk
+            .lock()
+            .unwrap_or_else(|e| e.into_inner())
+            .as_ref()
+            .map(|t| t.dir.clone())
+        else {
+            return;
+        };
+        let data = encode(key, result);
+        let path = dir.join(key.file_name());
+        let temp = dir.join(format!(
+            "{}.tmp-{}-{}",
+            key.file_name(),
+            std::process::id(),
+            TEMP_COUNTER.fetch_add(1, Ordering::Relaxed)
+        ));
+        // Write then rename, so readers never see a partial file.
+        if fs::write(&temp, &data)
+            .and_then(|()| fs::rename(&temp, &path))
+            .is_err()
+        {
+            let _ = fs::remove_file(&temp);
+            return;
+        }
+
+        let mut disk = self.disk.lock().unwrap_or_else(|e| e.into_inner());
+        match disk.as_mut() {
+            Some(tier) if tier.dir == dir => {
+                for (old, ()) in tier.index.insert(key, (), data.len() as u64) {
+                    let _ = fs::remove_file(tier.path(old));
+                }
+            }
+            // The tier was detached or moved while writing.
+            _ => {
+                let _ = fs::remove_file(&path);
+            }
+        }
+    }
+}
+
+/// Returns a new reference to the cache behind `handle`, or `None` for NULL.
+unsafe fn cache_from_c(handle: *const CResultCache) -> Option<Arc<ResultCache>> {
+    if handle.is_null() {
+        return None;
+    }
+    let cache = handle as *const ResultCache;
+    unsafe {
+        Arc::increment_strong_count(cache);
+        Some(Arc::from_raw(cache))
+    }
+}
+
+/// Extracts a byte slice to a string, through the cache attached to `handle` if there is
+/// one. Only successful extractions are cached.
+pub(crate) unsafe fn extract_bytes_to_string(
+    handle: *const CExtractor,
+    snapshot: &Snapshot,
+    bytes: &[u8],
+) -> Result<(String, Metadata), ExtractError> {
+    let shared = unsafe { &*(handle as *const SharedExtractor) };
+    let options = snapshot.options;
+    let extract = || {
+        extract_to_string_within(
+            snapshot,
+            |e| e.extract_bytes(bytes),
+            |e| e.extract_bytes_to_string(bytes),
+        )
+    };
+    let Some(cache) = shared.cache() else {
+        return extract();
+    };
+    let key = CacheKey::new(snapshot, bytes);
+    if let Some(hit) = cache.get(&key) {
+        // The memory limit is not part of the key, so an entry cached without one may be
+        // larger than this extraction is allowed to hold.
+        if options.memory_limit > 0 && hit.content.len() as u64 > options.memory_limit {
+            return Err(ExtractError::Stream(OutOfMemory::io_error()));
+        }
+        return Ok((hit.content.clone(), hit.metadata.clone()));
+    }
+    stats::record_cache_miss();
+    let (content, metadata) = extract()?;
+    cache.insert(
+        key,
+        CachedResult {
+            content: content.clone(),
+            metadata: metadata.clone(),
+        },
+    );
+    Ok((content, metadata))
+}
+
+/// Creates an empty result cache holding at most `max_bytes` of content and metadata in
+/// memory, evicting the least recently used entries beyond that. A bound of 0 keeps
+/// nothing in memory, which is useful with a disk tier.
+///
+/// Attach it to one or more extractors with `extractous_extractor_set_cache_mut`.
+/// The returned handle must be freed with `extractous_cache_free`.
+#[unsafe(no_mangle)]
+pub extern "C" fn extractous_cache_new(max_bytes: u64) -> *mut CResultCache {
+    let cache = Arc::new(ResultCache {
+        memory: Mutex::new(Lru::new(max_bytes)),
+        disk: Mutex::new(None),
+    });
+    Arc::into_raw(cache) as *mut CResultCache
+}
+
+/// Backs the cache with a directory holding at most `max_bytes` of entries, one file per
+/// entry. The directory is created if needed, and entries already in it are reused, so
+/// the tier survives restarts and can be shared by processes. Keys are built from a
+/// stable hash, so they stay valid across library releases and platforms; entries in
+/// an older format are ignored. Memory misses fall back to the disk tier, and new
+/// entries are written to both.
+///
+/// Pass a NULL `dir` to detach the disk tier; its files are kept. Returns `ERR_IO_ERROR`
+/// if the directory cannot be created or listed.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_cache_set_disk_tier(
+    cache: *const CResultCache,
+    dir: *const c_char,
+    max_bytes: u64,
+) -> c_int {
+    if cache.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let cache = unsafe { &*(cache as *const ResultCache) };
+    let tier = if dir.is_null() {
+        None
+    } else {
+        let dir = match unsafe { CStr::from_ptr(dir).to_str() } {
+            Ok(s) => s,
+            Err(_) => return ERR_INVALID_UTF8,
+        };
+        match DiskTier::open(Path::new(dir), max_bytes) {
+            Ok(tier) => Some(tier),
+            Err(_) => return ERR_IO_ERROR,
+        }
+    };
+    *cache.disk.lock().unwrap_or_else(|e| e.into_inner()) = tier;
+    ERR_OK
+}
+
+/// Removes every entry from the cache, including the files of its disk tier.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_cache_clear(cache: *const CResultCache) {
+    if cache.is_null() {
+        return;
+    }
+    let cache = unsafe { &*(cache as *const ResultCache) };
+    cache
+        .memory
+        .lock()
+        .unwrap_or_else(|e| e.into_inner())
+        .clear();
+    let mut disk = cache.disk.lock().unwrap_or_else(|e| e.into_inner());
+    if let Some(tier) = disk.as_mut() {
+        for key in tier.index.clear() {
+            let _ = fs::remove_file(tier.path(key));
+        }
+    }
+}
+
+/// Frees the caller's reference to a cache. Extractors it is attached to keep using it
+/// until they are freed or detached.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_cache_free(cache: *mut CResultCache) {
+    if !cache.is_null() {
+        unsafe { drop(Arc::from_raw(cache as *const ResultCache)) };
+    }
+}
+
+/// Attaches a result cache to the extractor, or detaches it when `cache` is NULL.
+///
+/// With a cache attached, the byte-slice and memory-mapped extractions to a string or
+/// buffer look up the input first, keyed by a hash of the bytes and of the extractor's
+/// whole configuration. A hit returns a copy of the cached content and metadata without
+/// parsing, unless its content is over the extractor's memory limit, which fails with
+/// `ERR_OUT_OF_MEMORY` as the extraction would. Streaming, path and URL extractions are
+/// not cached.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_set_cache_mut(
+    handle: *mut CExtractor,
+    cache: *const CResultCache,
+) {
+    if handle.is_null() {
+        return;
+    }
+    let cache = unsafe { cache_from_c(cache) };
+    unsafe { &*(handle as *const SharedExtractor) }.set_cache(cache);
+}
@@ -0,0 +1,138 @@
+use crate::errors::*;
+use crate::types::*;
+use std::os::raw::c_int;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Arc, OnceLock};
+use std::time::Instant;
+
+/// Origin for deadlines, so they fit in an atomic.
+static EPOCH: OnceLock<Instant> = OnceLock::new();
+
+fn now_ns() -> u64 {
+    let epoch = *EPOCH.get_or_init(Instant::now);
+    u64::try_from(epoch.elapsed().as_nanos()).unwrap_or(u64::MAX)
+}
+
+/// The state behind a `CCancelToken` handle.
+///
+/// A token is cancelled explicitly, or implicitly once its deadline passes. It is shared
+/// by reference count between the caller's handle and every stream it is attached to, so
+/// the handle may be freed while extractions still observe it.
+pub(crate) struct CancelToken {
+    cancelled: AtomicBool,
+    /// Deadline in nanoseconds since `EPOCH`; 0 means none.
+    deadline_ns: AtomicU64,
+}
+
+impl CancelToken {
+    pub(crate) fn is_cancelled(&self) -> bool {
+        if self.cancelled.load(Ordering::Relaxed) {
+            return true;
+        }
+        let deadline = self.deadline_ns.load(Ordering::Relaxed);
+        deadline != 0 && now_ns() >= deadline
+    }
+}
+
+/// Marks a read or extraction that stopped because its token was cancelled.
+#[derive(Debug)]
+pub(crate) struct Cancelled;
+
+impl std::fmt::Display for Cancelled {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.write_str("extraction cancelled")
+    }
+}
+
+impl std::error::Error for Cancelled {}
+
+impl Cancelled {
+    pub(crate) fn io_error() -> std::io::Error {
+        std::io::Error::other(Cancelled)
+    }
+}
+
+/// Maps an I/O error from a stream read to an error code, telling cancellation and
+/// running out of memory apart.
+pub(crate) fn io_error_to_code(e: &std::io::Error) -> c_int {
+    if e.get_ref().is_some_and(|inner| inner.is::<Cancelled>()) {
+        ERR_CANCELLED
+    } else if e.kind() == std::io::ErrorKind::OutOfMemory {
+        ERR_OUT_OF_MEMORY
+    } else {
+        ERR_IO_ERROR
+    }
+}
+
+/// Returns a new reference to the token behind `handle`, or `None` for NULL.
+pub(crate) unsafe fn token_from_c(handle: *const CCancelToken) -> Option<Arc<CancelToken>> {
+    if handle.is_null() {
+        return None;
+    }
+    let token = handle as *const CancelToken;
+    unsafe {
+        Arc::increment_strong_count(token);
+        Some(Arc::from_raw(token))
+    }
+}
+
+/// Creates a new cancellation token with no deadline.
+/// The returned handle must be freed with `extractous_cancel_token_free`.
+#[unsafe(no_mangle)]
+pub extern "C" fn extractous_cancel_token_new() -> *mut CCancelToken {
+    let token = Arc::new(CancelToken {
+        cancelled: AtomicBool::new(false),
+        deadline_ns: AtomicU64::new(0),
+    });
+    Arc::into_raw(token) as *mut CCancelToken
+}
+
+/// Cancels the token. Every extraction and stream observing it stops at its next check
+/// and reports `ERR_CANCELLED`. Safe to call from any thread, any number of times.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_cancel_token_cancel(handle: *const CCancelToken) {
+    if !handle.is_null() {
+        let token = unsafe { &*(handle as *const CancelToken) };
+        token.cancelled.store(true, Ordering::Relaxed);
+    }
+}
+
+/// Sets the token to cancel itself `timeout_ms` milliseconds from now, replacing any
+/// earlier deadline. A timeout of 0 clears the deadline. Safe to call from any thread.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_cancel_token_set_timeout_ms(
+    handle: *const CCancelToken,
+    timeout_ms: u64,
+) -> c_int {
+    if handle.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let token = unsafe { &*(handle as *const CancelToken) };
+    let deadline = if timeout_ms == 0 {
+        0
+    } else {
+        now_ns()
+            .saturating_add(timeout_ms.saturating_mul(1_000_000))
+            .max(1)
+    };
+    token.deadline_ns.store(deadline, Ordering::Relaxed);
+    ERR_OK
+}
+
+/// Returns true if the token has been cancelled or its deadline has passed.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_cancel_token_is_cancelled(handle: *const CCancelToken) -> bool {
+    if handle.is_null() {
+        return false;
+    }
+    unsafe { &*(handle as *const CancelToken) }.is_cancelled()
+}
+
+/// Frees the caller's reference to a token. Streams the token is attached to keep
+/// observing it until they are freed.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_cancel_token_free(handle: *mut CCancelToken) {
+    if !handle.is_null() {
+        unsafe { drop(Arc::from_raw(handle as *const CancelToken)) };
+    }
+}
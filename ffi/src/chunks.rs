@@ -0,0 +1,117 @@
+use std::io::Read;
+
+/// Whether `b` is whitespace a chunk may end after.
+fn is_space(b: u8) -> bool {
+    matches!(b, b' ' | b'\t' | b'\n' | b'\r')
+}
+
+/// Whether a UTF-8 character starts at `text[i]`, or `i` is the end of `text`.
+fn is_char_boundary(text: &[u8], i: usize) -> bool {
+    text.get(i).is_none_or(|&b| b & 0xC0 != 0x80)
+}
+
+/// Picks where a chunk of `text`, which holds more than `max` bytes, ends: the last
+/// paragraph break, sentence end, line break or space in `text[floor..=max]`, in that
+/// order of preference, or else the last UTF-8 character boundary up to `max`. Requires
+/// `max >= 4`, so a whole character always fits.
+fn cut_point(text: &[u8], floor: usize, max: usize) -> usize {
+    let (mut sentence, mut line, mut space) = (None, None, None);
+    for end in (floor.max(2)..=max).rev() {
+        let (before, last) = (text[end - 2], text[end - 1]);
+        if !is_space(last) || is_space(text[end]) {
+            continue;
+        }
+        if last == b'\n' && before == b'\n' {
+            return end;
+        }
+        if sentence.is_none() && matches!(before, b'.' | b'!' | b'?') {
+            sentence = Some(end);
+        } else if line.is_none() && last == b'\n' {
+            line = Some(end);
+        } else if space.is_none() {
+            space = Some(end);
+        }
+    }
+    sentence.or(line).or(space).unwrap_or_else(|| {
+        (1..=max)
+            .rev()
+            .find(|&end| is_char_boundary(text, end))
+            .unwrap_or(max)
+    })
+}
+
+/// Where the chunk after `text[..cut]` starts so that it repeats at most `overlap` bytes:
+/// the first word start in the last `overlap` bytes, or else the first UTF-8 character
+/// boundary there. Never 0, so every chunk moves forward.
+fn overlap_start(text: &[u8], cut: usize, overlap: usize) -> usize {
+    let from = cut.saturating_sub(overlap).max(1);
+    (from..cut)
+        .find(|&i| is_space(text[i - 1]) && !is_space(text[i]))
+        .or_else(|| (from..cut).find(|&i| is_char_boundary(text, i)))
+        .unwrap_or(cut)
+}
+
+/// Splits the content of a stream into bounded, overlapping chunks as it is read, for
+/// `extractous_stream_next_chunk`.
+///
+/// Only the current chunk and one more byte are read ahead, so memory stays bounded by
+/// the chunk size however long the document is.
+#[derive(Default)]
+pub(crate) struct Chunker {
+    /// Content read but not handed out past; ends with the bytes read ahead.
+    window: Vec<u8>,
+    /// Offset in the content of `window[0]`.
+    start: u64,
+    /// Bytes at the front of `window` left behind by the last chunk, dropped on the next
+    /// call so the chunk stays valid until then.
+    consumed: usize,
+    eof: bool,
+}
+
+impl Chunker {
+    /// Returns the offset and bytes of the next chunk of at most `max_bytes`, repeating
+    /// up to `overlap` bytes of the one before it, or `None` at the end of the content.
+    /// Requires `max_bytes >= 4` and `overlap < max_bytes`.
+    pub(crate) fn next(
+        &mut self,
+        reader: &mut impl Read,
+        max_bytes: usize,
+        overlap: usize,
+    ) -> std::io::Result<Option<(u64, &[u8])>> {
+        self.window.drain(..self.consumed);
+        self.start += self.consumed as u64;
+        self.consumed = 0;
+
+        // One byte past the chunk tells whether it is the last, and whether it ends on a
+        // character or word boundary.
+        while !self.eof && self.window.len() <= max_bytes {
+            let len = self.window.len();
+            self.window.resize(max_bytes + 1, 0);
+            let result = reader.read(&mut self.window[len..]);
+            self.window.truncate(len + *result.as_ref().unwrap_or(&0));
+            match result {
+                Ok(0) => self.eof = true,
+                Ok(_) => {}
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {}
+                Err(e) => return Err(e),
+            }
+        }
+
+        if self.window.is_empty() {
+            return Ok(None);
+        }
+        if self.window.len() <= max_bytes {
+            self.consumed = self.window.len();
+            return Ok(Some((self.start, &self.window)));
+        }
+        // Chunks end no earlier than halfway, and after the overlap so they move forward.
+        let floor = (max_bytes / 2).max(overlap + 1).min(max_bytes);
+        let cut = cut_point(&self.window, floor, max_bytes);
+        self.consumed = if overlap == 0 {
+            cut
+        } else {
+            overlap_start(&self.window, cut, overlap)
+        };
+        Ok(Some((self.start, &self.window[..cut])))
+    }
+}
@@ -7,20 +7,73 @@ use std::ffi::CStr;
 use std::os::raw::c_char;
 use std::ptr;
 
-/// Macro to safely update a config instance behind a raw pointer.
+/// The state behind a parser config handle: the core config, and the settings applied
+/// to it. The core does not expose its settings, and the result cache keys on them.
+pub(crate) struct ConfigState<C, S> {
+    pub(crate) core: C,
+    pub(crate) settings: S,
+}
+
+impl<C, S: Default> ConfigState<C, S> {
+    /// Boxes `core` into a new handle, with no settings recorded yet.
+    fn new_handle<H>(core: C) -> *mut H {
+        let state = Box::new(Self {
+            core,
+            settings: S::default(),
+        });
+        Box::into_raw(state) as *mut H
+    }
+}
+
+pub(crate) type PdfConfigState = ConfigState<CorePdfConfig, PdfSettings>;
+pub(crate) type OfficeConfigState = ConfigState<CoreOfficeConfig, OfficeSettings>;
+pub(crate) type OcrConfigState = ConfigState<CoreOcrConfig, OcrSettings>;
+
+/// PDF parser settings as set; `None` leaves the core's default.
+#[derive(Clone, Default)]
+pub(crate) struct PdfSettings {
+    /// A `PDF_OCR_STRATEGY_*` value.
+    pub(crate) ocr_strategy: Option<libc::c_int>,
+    pub(crate) extract_inline_images: Option<bool>,
+    pub(crate) extract_unique_inline_images_only: Option<bool>,
+    pub(crate) extract_marked_content: Option<bool>,
+    pub(crate) extract_annotation_text: Option<bool>,
+}
+
+/// Office parser settings as set; `None` leaves the core's default.
+#[derive(Clone, Default)]
+pub(crate) struct OfficeSettings {
+    pub(crate) extract_macros: Option<bool>,
+    pub(crate) include_deleted_content: Option<bool>,
+    pub(crate) include_move_from_content: Option<bool>,
+    pub(crate) include_shape_based_content: Option<bool>,
+}
+
+/// Tesseract OCR settings as set; `None` leaves the core's default.
+#[derive(Clone, Default)]
+pub(crate) struct OcrSettings {
+    pub(crate) language: Option<String>,
+    pub(crate) density: Option<i32>,
+    pub(crate) depth: Option<i32>,
+    pub(crate) enable_image_preprocessing: Option<bool>,
+    pub(crate) timeout_seconds: Option<i32>,
+}
+
+/// Macro to safely update a config instance behind a raw pointer, recording the setting.
 macro_rules! update_config {
-    ($handle:expr, $T:ty, |$config_val:ident| $body:block) => {
+    ($handle:expr, $T:ty, |$config_val:ident, $settings:ident| $body:block) => {
         if $handle.is_null() {
             return;
         }
         unsafe {
-            let config_ptr = $handle as *mut $T;
-            let old_config = ptr::read(config_ptr);
+            let state = &mut *($handle as *mut $T);
+            let $settings = &mut state.settings;
+            let old_config = ptr::read(&state.core);
             let new_config = {
                 let $config_val = old_config;
                 $body
             };
-            ptr::write(config_ptr, new_config);
+            ptr::write(&mut state.core, new_config);
         }
     };
 }
@@ -31,8 +84,7 @@ macro_rules! update_config {
 // #[must_use]
 #[unsafe(no_mangle)]
 pub extern "C" fn extractous_pdf_config_new() -> *mut CPdfParserConfig {
-    let config = Box::new(CorePdfConfig::new());
-    Box::into_raw(config) as *mut CPdfParserConfig
+    PdfConfigState::new_handle(CorePdfConfig::new())
 }
 
 /// Frees the memory associated with a PDF parser configuration.
@@ -40,7 +92,7 @@ pub extern "C" fn extractous_pdf_config_new() -> *mut CPdfParserConfig {
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn extractous_pdf_config_free(handle: *mut CPdfParserConfig) {
     if !handle.is_null() {
-        drop(unsafe { Box::from_raw(handle as *mut CorePdfConfig) });
+        drop(unsafe { Box::from_raw(handle as *mut PdfConfigState) });
     }
 }
 
@@ -57,7 +109,8 @@ pub unsafe extern "C" fn extractous_pdf_config_set_ocr_strategy(
         PDF_OCR_STRATEGY_AUTO => PdfOcrStrategy::AUTO,
         _ => return, // Invalid strategy, do nothing.
     };
-    update_config!(handle, CorePdfConfig, |config| {
+    update_config!(handle, PdfConfigState, |config, settings| {
+        settings.ocr_strategy = Some(strategy);
         config.set_ocr_strategy(ocr_strategy)
     });
 }
@@ -68,7 +121,8 @@ pub unsafe extern "C" fn extractous_pdf_config_set_extract_inline_images(
     handle: *mut CPdfParserConfig,
     value: bool,
 ) {
-    update_config!(handle, CorePdfConfig, |config| {
+    update_config!(handle, PdfConfigState, |config, settings| {
+        settings.extract_inline_images = Some(value);
         config.set_extract_inline_images(value)
     });
 }
@@ -79,7 +133,8 @@ pub unsafe extern "C" fn extractous_pdf_config_set_extract_unique_inline_images_
     handle: *mut CPdfParserConfig,
     value: bool,
 ) {
-    update_config!(handle, CorePdfConfig, |config| {
+    update_config!(handle, PdfConfigState, |config, settings| {
+        settings.extract_unique_inline_images_only = Some(value);
         config.set_extract_unique_inline_images_only(value)
     });
 }
@@ -90,7 +145,8 @@ pub unsafe extern "C" fn extractous_pdf_config_set_extract_marked_content(
     handle: *mut CPdfParserConfig,
     value: bool,
 ) {
-    update_config!(handle, CorePdfConfig, |config| {
+    update_config!(handle, PdfConfigState, |config, settings| {
+        settings.extract_marked_content = Some(value);
         config.set_extract_marked_content(value)
     });
 }
@@ -101,7 +157,8 @@ pub unsafe extern "C" fn extractous_pdf_config_set_extract_annotation_text(
     handle: *mut CPdfParserConfig,
     value: bool,
 ) {
-    update_config!(handle, CorePdfConfig, |config| {
+    update_config!(handle, PdfConfigState, |config, settings| {
+        settings.extract_annotation_text = Some(value);
         config.set_extract_annotation_text(value)
     });
 }
@@ -110,15 +167,14 @@ pub unsafe extern "C" fn extractous_pdf_config_set_extract_annotation_text(
 // #[must_use]
 #[unsafe(no_mangle)]
 pub extern "C" fn extractous_office_config_new() -> *mut COfficeParserConfig {
-    let config = Box::new(CoreOfficeConfig::new());
-    Box::into_raw(config) as *mut COfficeParserConfig
+    OfficeConfigState::new_handle(CoreOfficeConfig::new())
 }
 
 /// Frees the memory associated with an Office parser configuration.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn extractous_office_config_free(handle: *mut COfficeParserConfig) {
     if !handle.is_null() {
-        drop(unsafe { Box::from_raw(handle as *mut CoreOfficeConfig) });
+        drop(unsafe { Box::from_raw(handle as *mut OfficeConfigState) });
     }
 }
 
@@ -128,7 +184,8 @@ pub unsafe extern "C" fn extractous_office_config_set_extract_macros(
     handle: *mut COfficeParserConfig,
     value: bool,
 ) {
-    update_config!(handle, CoreOfficeConfig, |config| {
+    update_config!(handle, OfficeConfigState, |config, settings| {
+        settings.extract_macros = Some(value);
         config.set_extract_macros(value)
     });
 }
@@ -139,7 +196,8 @@ pub unsafe extern "C" fn extractous_office_config_set_include_deleted_content(
     handle: *mut COfficeParserConfig,
     value: bool,
 ) {
-    update_config!(handle, CoreOfficeConfig, |config| {
+    update_config!(handle, OfficeConfigState, |config, settings| {
+        settings.include_deleted_content = Some(value);
         config.set_include_deleted_content(value)
     });
 }
@@ -150,7 +208,8 @@ pub unsafe extern "C" fn extractous_office_config_set_include_move_from_content(
     handle: *mut COfficeParserConfig,
     value: bool,
 ) {
-    update_config!(handle, CoreOfficeConfig, |config| {
+    update_config!(handle, OfficeConfigState, |config, settings| {
+        settings.include_move_from_content = Some(value);
         config.set_include_move_from_content(value)
     });
 }
@@ -161,24 +220,30 @@ pub unsafe extern "C" fn extractous_office_config_set_include_shape_based_conten
     handle: *mut COfficeParserConfig,
     value: bool,
 ) {
-    update_config!(handle, CoreOfficeConfig, |config| {
+    update_config!(handle, OfficeConfigState, |config, settings| {
+        settings.include_shape_based_content = Some(value);
         config.set_include_shape_based_content(value)
     });
 }
 
 /// Creates a new Tesseract OCR configuration with default settings.
+///
+/// The core OCRs the pages of a document one at a time, in page order, and the density,
+/// depth and timeout settings apply to each page. It has no page-level parallelism: to
+/// use more cores for OCR-heavy work, run several documents at once with
+/// `extractous_extractor_extract_files_batch`, an extractor pool, or one extractor shared
+/// by several threads.
 // #[must_use]
 #[unsafe(no_mangle)]
 pub extern "C" fn extractous_ocr_config_new() -> *mut CTesseractOcrConfig {
-    let config = Box::new(CoreOcrConfig::new());
-    Box::into_raw(config) as *mut CTesseractOcrConfig
+    OcrConfigState::new_handle(CoreOcrConfig::new())
 }
 
 /// Frees the memory associated with a Tesseract OCR configuration.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn extractous_ocr_config_free(handle: *mut CTesseractOcrConfig) {
     if !handle.is_null() {
-        drop(unsafe { Box::from_raw(handle as *mut CoreOcrConfig) });
+        drop(unsafe { Box::from_raw(handle as *mut OcrConfigState) });
     }
 }
 
@@ -195,7 +260,8 @@ pub unsafe extern "C" fn extractous_ocr_config_set_language(
         Ok(s) => s,
         Err(_) => return, // Invalid UTF-8, do nothing.
     };
-    update_config!(handle, CoreOcrConfig, |config| {
+    update_config!(handle, OcrConfigState, |config, settings| {
+        settings.language = Some(lang_str.to_owned());
         config.set_language(lang_str)
     });
 }
@@ -206,7 +272,8 @@ pub unsafe extern "C" fn extractous_ocr_config_set_density(
     handle: *mut CTesseractOcrConfig,
     density: i32,
 ) {
-    update_config!(handle, CoreOcrConfig, |config| {
+    update_config!(handle, OcrConfigState, |config, settings| {
+        settings.density = Some(density);
         config.set_density(density)
     });
 }
@@ -217,7 +284,10 @@ pub unsafe extern "C" fn extractous_ocr_config_set_depth(
     handle: *mut CTesseractOcrConfig,
     depth: i32,
 ) {
-    update_config!(handle, CoreOcrConfig, |config| { config.set_depth(depth) });
+    update_config!(handle, OcrConfigState, |config, settings| {
+        settings.depth = Some(depth);
+        config.set_depth(depth)
+    });
 }
 
 /// Enables or disables image preprocessing for OCR.
@@ -226,7 +296,8 @@ pub unsafe extern "C" fn extractous_ocr_config_set_enable_image_preprocessing(
     handle: *mut CTesseractOcrConfig,
     value: bool,
 ) {
-    update_config!(handle, CoreOcrConfig, |config| {
+    update_config!(handle, OcrConfigState, |config, settings| {
+        settings.enable_image_preprocessing = Some(value);
         config.set_enable_image_preprocessing(value)
     });
 }
@@ -237,7 +308,8 @@ pub unsafe extern "C" fn extractous_ocr_config_set_timeout_seconds(
     handle: *mut CTesseractOcrConfig,
     seconds: i32,
 ) {
-    update_config!(handle, CoreOcrConfig, |config| {
+    update_config!(handle, OcrConfigState, |config, settings| {
+        settings.timeout_seconds = Some(seconds);
         config.set_timeout_seconds(seconds)
     });
 }
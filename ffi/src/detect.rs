@@ -0,0 +1,255 @@
+use crate::errors::*;
+use std::ffi::CStr;
+use std::fs::File;
+use std::io::Read;
+use std::os::raw::{c_char, c_int};
+use std::slice;
+
+/// How much of a document detection looks at: enough for every signature below,
+/// including the first entries of a ZIP container and the directory of a small OLE2 file.
+const DETECT_PREFIX: usize = 64 * 1024;
+
+/// Leading signatures, checked in order.
+const MAGIC: [(&[u8], &CStr); 12] = [
+    (b"%PDF-", c"application/pdf"),
+    (b"{\\rtf", c"application/rtf"),
+    (b"\x89PNG\r\n\x1a\n", c"image/png"),
+    (b"\xff\xd8\xff", c"image/jpeg"),
+    (b"GIF87a", c"image/gif"),
+    (b"GIF89a", c"image/gif"),
+    (b"II*\0", c"image/tiff"),
+    (b"MM\0*", c"image/tiff"),
+    (b"\x1f\x8b", c"application/gzip"),
+    (b"7z\xbc\xaf\x27\x1c", c"application/x-7z-compressed"),
+    (b"Rar!\x1a\x07", c"application/x-rar-compressed"),
+    (b"BZh", c"application/x-bzip2"),
+];
+
+/// ZIP-based formats recognised by their uncompressed first entry, `mimetype`.
+const ZIP_MIMETYPES: [&CStr; 6] = [
+    c"application/epub+zip",
+    c"application/vnd.oasis.opendocument.text",
+    c"application/vnd.oasis.opendocument.spreadsheet",
+    c"application/vnd.oasis.opendocument.presentation",
+    c"application/vnd.oasis.opendocument.graphics",
+    c"application/vnd.oasis.opendocument.formula",
+];
+
+/// Office Open XML formats, recognised by the folder their main part lives in.
+const OOXML_FOLDERS: [(&[u8], &CStr); 3] = [
+    (
+        b"word/",
+        c"application/vnd.openxmlformats-officedocument.wordprocessingml.document",
+    ),
+    (
+        b"xl/",
+        c"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
+    ),
+    (
+        b"ppt/",
+        c"application/vnd.openxmlformats-officedocument.presentationml.presentation",
+    ),
+];
+
+/// Legacy Office formats, recognised by a stream name in the OLE2 directory.
+const OLE2_STREAMS: [(&str, &CStr); 4] = [
+    ("WordDocument", c"application/msword"),
+    ("Workbook", c"application/vnd.ms-excel"),
+    ("Book", c"application/vnd.ms-excel"),
+    ("PowerPoint Document", c"application/vnd.ms-powerpoint"),
+];
+
+/// Header names that open an e-mail message.
+const MAIL_HEADERS: [&[u8]; 5] = [
+    b"from:",
+    b"received:",
+    b"return-path:",
+    b"delivered-to:",
+    b"message-id:",
+];
+
+/// Returns the MIME type of a document from its first bytes, without parsing it.
+fn detect(data: &[u8]) -> &'static CStr {
+    let data = &data[..data.len().min(DETECT_PREFIX)];
+    if data.starts_with(b"PK\x03\x04") {
+        return detect_zip(data);
+    }
+    if data.starts_with(b"\xd0\xcf\x11\xe0\xa1\xb1\x1a\xe1") {
+        return detect_ole2(data);
+    }
+    if data.len() >= 12 && data.starts_with(b"RIFF") && &data[8..12] == b"WEBP" {
+        return c"image/webp";
+    }
+    // "BM" alone is too common in text; the reserved header fields must be zero.
+    if data.len() >= 14 && data.starts_with(b"BM") && data[6..10] == [0; 4] {
+        return c"image/bmp";
+    }
+    if data.get(257..262) == Some(b"ustar") {
+        return c"application/x-tar";
+    }
+    if let Some((_, mime)) = MAGIC.iter().find(|(magic, _)| data.starts_with(magic)) {
+        return mime;
+    }
+    detect_text(data)
+}
+
+fn detect_zip(data: &[u8]) -> &'static CStr {
+    let u16_at = |at: usize| {
+        data.get(at..at + 2)
+            .map(|b| u16::from_le_bytes([b[0], b[1]]))
+    };
+    let u32_at = |at: usize| {
+        data.get(at..at + 4)
+            .map(|b| u32::from_le_bytes([b[0], b[1], b[2], b[3]]))
+    };
+
+    // Walk the local file headers in the prefix.
+    let mut pos = 0;
+    let mut first = true;
+    while data.get(pos..pos + 4) == Some(b"PK\x03\x04") {
+        let (Some(flags), Some(size), Some(name_len), Some(extra_len)) = (
+            u16_at(pos + 6),
+            u32_at(pos + 18),
+            u16_at(pos + 26),
+            u16_at(pos + 28),
+        ) else {
+            break;
+        };
+        let name_start = pos + 30;
+        let Some(name) = data.get(name_start..name_start + name_len as usize) else {
+            break;
+        };
+        let body = name_start + name_len as usize + extra_len as usize;
+
+        if first && name == b"mimetype" {
+            let mimetype = data.get(body..body + size as usize).unwrap_or_default();
+            if let Some(mime) = ZIP_MIMETYPES.iter().find(|m| m.to_bytes() == mimetype) {
+                return mime;
+            }
+        }
+        if let Some((_, mime)) = OOXML_FOLDERS.iter().find(|(f, _)| name.starts_with(f)) {
+            return mime;
+        }
+
+        first = false;
+        // When bit 3 is set the sizes follow the data, as written by streaming zip
+        // writers, so the next header is found by its signature instead.
+        pos = if flags & 0x08 != 0 {
+            match data[body.min(data.len())..]
+                .windows(4)
+                .position(|w| w == b"PK\x03\x04")
+            {
+                Some(offset) => body + offset,
+                None => break,
+            }
+        } else {
+            body + size as usize
+        };
+    }
+    c"application/zip"
+}
+
+fn detect_ole2(data: &[u8]) -> &'static CStr {
+    // Directory entry names are UTF-16LE; look for the main stream of each format.
+    for (stream, mime) in OLE2_STREAMS {
+        let mut name: Vec<u8> = stream.encode_utf16().flat_map(u16::to_le_bytes).collect();
+        // The name is NUL-terminated, so "Book" does not match inside "Workbook".
+        name.extend_from_slice(&[0, 0]);
+        if data.windows(name.len()).any(|w| w == name) {
+            return mime;
+        }
+    }
+    c"application/x-tika-msoffice"
+}
+
+fn detect_text(data: &[u8]) -> &'static CStr {
+    let text = data.strip_prefix(b"\xef\xbb\xbf").unwrap_or(data);
+    let start = text.trim_ascii_start();
+    let head = &start[..start.len().min(64)].to_ascii_lowercase();
+    if head.starts_with(b"<!doctype html") || head.starts_with(b"<html") {
+        return c"text/html";
+    }
+    if head.starts_with(b"<?xml") {
+        let decl = &start[..start.len().min(1024)].to_ascii_lowercase();
+        if decl.windows(5).any(|w| w == b"<html") {
+            return c"application/xhtml+xml";
+        }
+        return c"application/xml";
+    }
+    if MAIL_HEADERS.iter().any(|h| head.starts_with(h)) {
+        return c"message/rfc822";
+    }
+
+    // Text must be valid UTF-8, allowing a character cut off by the prefix, with no
+    // control characters other than whitespace.
+    let valid = match std::str::from_utf8(text) {
+        Ok(_) => true,
+        Err(e) => e.error_len().is_none(),
+    };
+    let binary = text
+        .iter()
+        .any(|&b| b < 0x20 && !matches!(b, b'\t' | b'\n' | b'\r' | 0x0c));
+    if valid && !binary {
+        c"text/plain"
+    } else {
+        c"application/octet-stream"
+    }
+}
+
+/// Detects the MIME type of an in-memory document from its magic bytes and container
+/// headers alone, without parsing it.
+///
+/// Only the first 64 KiB are looked at. ZIP containers are told apart as Office Open
+/// XML, OpenDocument or EPUB from their first entries, and legacy Office files from
+/// their OLE2 directory; other files from their leading signature. Text that is not
+/// HTML, XML or an e-mail is `text/plain`, and anything unrecognised is
+/// `application/octet-stream`.
+///
+/// On success `*out_mime` points to a static string that must not be freed. This is much
+/// cheaper than an extraction and never starts the core's runtime, so it can be used to
+/// skip unsupported formats before extracting. It may name a type the core does not
+/// parse, and the core's own detection, reported in `Content-Type`, can be more precise.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_detect_bytes(
+    data: *const u8,
+    len: libc::size_t,
+    out_mime: *mut *const c_char,
+) -> c_int {
+    if out_mime.is_null() || (data.is_null() && len > 0) {
+        return ERR_NULL_POINTER;
+    }
+    let data = if len == 0 {
+        &[][..]
+    } else {
+        unsafe { slice::from_raw_parts(data, len) }
+    };
+    unsafe { *out_mime = detect(data).as_ptr() };
+    ERR_OK
+}
+
+/// Like `extractous_detect_bytes`, for a local file. Only the first 64 KiB are read.
+///
+/// Returns `ERR_IO_ERROR` if the file cannot be read.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_detect_file(
+    path: *const c_char,
+    out_mime: *mut *const c_char,
+) -> c_int {
+    if path.is_null() || out_mime.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    let mut prefix = Vec::with_capacity(DETECT_PREFIX);
+    let read = File::open(path_str)
+        .and_then(|file| file.take(DETECT_PREFIX as u64).read_to_end(&mut prefix));
+    if let Err(e) = read {
+        set_last_error(e);
+        return ERR_IO_ERROR;
+    }
+    unsafe { *out_mime = detect(&prefix).as_ptr() };
+    ERR_OK
+}
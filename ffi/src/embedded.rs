@@ -0,0 +1,229 @@
+use crate::ecore::Extractor as CoreExtractor;
+use crate::errors::*;
+use crate::events::EventParser;
+use crate::extractor::bytes_into_buffer;
+use crate::metadata::metadata_to_packed;
+use crate::shared;
+use crate::stats::CallTimer;
+use crate::stream::StreamState;
+use crate::types::*;
+use std::ffi::{CStr, CString};
+use std::os::raw::{c_char, c_int};
+use std::ptr;
+
+/// One document found by a recursive extraction, before conversion to C.
+struct Document {
+    path: String,
+    depth: u32,
+    parent: usize,
+    content: Vec<u8>,
+    truncated: bool,
+}
+
+/// Splits the event stream of a container into one `Document` per embedded document,
+/// container first and children in the order they start.
+fn split_documents(
+    stream: &mut StreamState,
+    max_depth: u32,
+    max_count: usize,
+) -> std::io::Result<Vec<Document>> {
+    let mut documents = vec![Document {
+        path: String::new(),
+        depth: 0,
+        parent: 0,
+        content: Vec::new(),
+        truncated: false,
+    }];
+    // One entry per open embedded document: its index in `documents`, or `None` if it is
+    // below `max_depth` and its content goes to the nearest split-out ancestor.
+    let mut open: Vec<Option<usize>> = Vec::new();
+    let mut seen = 0;
+    let mut parser = EventParser::default();
+
+    let target = |open: &[Option<usize>]| open.iter().rev().find_map(|d| *d).unwrap_or(0);
+    let stopped = loop {
+        let event = parser.next(stream)?;
+        match event.kind {
+            STREAM_EVENT_END => break stream.budget_spent(),
+            STREAM_EVENT_TEXT => documents[target(&open)]
+                .content
+                .extend_from_slice(&event.data),
+            STREAM_EVENT_SHEET_NAME => {
+                let content = &mut documents[target(&open)].content;
+                content.extend_from_slice(&event.data);
+                content.push(b'\n');
+            }
+            STREAM_EVENT_EMBEDDED_START => {
+                seen += 1;
+                if max_count > 0 && seen > max_count {
+                    break true;
+                }
+                if event.index > max_depth {
+                    open.push(None);
+                    continue;
+                }
+                let parent = target(&open);
+                documents.push(Document {
+                    path: format!("{}/embedded-{seen}", documents[parent].path),
+                    depth: event.index,
+                    parent,
+                    content: Vec::new(),
+                    truncated: false,
+                });
+                open.push(Some(documents.len() - 1));
+            }
+            STREAM_EVENT_EMBEDDED_NAME => match open.last() {
+                Some(Some(index)) => {
+                    let name = String::from_utf8_lossy(&event.data);
+                    let parent = &documents[documents[*index].parent].path;
+                    documents[*index].path = format!("{parent}/{name}");
+                }
+                // A folded child keeps its name in its ancestor's text, as in plain output.
+                _ => {
+                    let content = &mut documents[target(&open)].content;
+                    content.extend_from_slice(&event.data);
+                    content.push(b'\n');
+                }
+            },
+            STREAM_EVENT_EMBEDDED_END => {
+                open.pop();
+            }
+            _ => {}
+        }
+    };
+
+    if stopped {
+        documents[0].truncated = true;
+        for index in open.into_iter().flatten() {
+            documents[index].truncated = true;
+        }
+    }
+    for document in &mut documents {
+        if document.path.starts_with('/') {
+            document.path.remove(0);
+        }
+    }
+    Ok(documents)
+}
+
+/// Extracts a container, such as an archive, an e-mail or an Office document with
+/// attachments, returning each embedded document as its own result.
+///
+/// The first result is the container itself, with its metadata; the others follow in
+/// document order, each with its path inside the container (entry names joined with
+/// `/`), its nesting depth and the index of its parent result. The content of each result
+/// excludes that of the children returned separately. The core only reports metadata for
+/// the container, so embedded results have NULL metadata.
+///
+/// Documents nested deeper than `max_depth` are not split out: their content stays with
+/// their nearest returned ancestor, so `max_depth` 0 returns the container alone. If the
+/// container holds more than `max_count` embedded documents at any depth, the parse is
+/// stopped as the next one starts and the documents read so far are returned, marked as
+/// truncated; 0 means no limit. The extractor's content budget also applies, to the whole
+/// container. Both limits guard against archive bombs.
+///
+/// Embedded documents are parsed by the core inline, one after another, while it reads
+/// the container; this call only splits its output, in one pass.
+///
+/// On success the array of `*out_n` results must be freed with
+/// `extractous_embedded_results_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_file_recursive(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    max_depth: u32,
+    max_count: libc::size_t,
+    out_results: *mut *mut CEmbeddedResult,
+    out_n: *mut libc::size_t,
+) -> c_int {
+    if handle.is_null() || path.is_null() || out_results.is_null() || out_n.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    unsafe {
+        *out_results = ptr::null_mut();
+        *out_n = 0;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    // Document boundaries are only visible in XML output.
+    let snapshot = unsafe { shared::snapshot(handle) };
+    let extractor = CoreExtractor::clone(&snapshot).set_xml_output(true);
+    let mut timer = CallTimer::start();
+    let (reader, metadata) = match extractor.extract_file(path_str) {
+        Ok(r) => r,
+        Err(e) => {
+            let code = extractous_error_to_code(&e);
+            timer.finish_err(code);
+            set_last_error(e);
+            return code;
+        }
+    };
+    timer.parsed(&reader, &metadata);
+
+    let mut stream = StreamState::new(reader, None);
+    stream.set_content_options(snapshot.options);
+    let documents = match split_documents(&mut stream, max_depth, max_count) {
+        Ok(documents) => documents,
+        Err(e) => {
+            let code = crate::cancel::io_error_to_code(&e);
+            timer.finish_err(code);
+            set_last_error(e);
+            return code;
+        }
+    };
+    // Stop the parse before converting, so its resources are not held any longer.
+    drop(stream);
+
+    let mut metadata = Some(metadata);
+    let mut results: Vec<CEmbeddedResult> = documents
+        .into_iter()
+        .map(|document| {
+            let mut content = ptr::null_mut();
+            let mut content_len = 0;
+            unsafe { bytes_into_buffer(document.content, &mut content, &mut content_len) };
+            CEmbeddedResult {
+                path: CString::new(document.path).map_or(ptr::null_mut(), |s| s.into_raw()),
+                depth: document.depth,
+                parent: document.parent,
+                content,
+                content_len,
+                metadata: metadata.take().map_or(ptr::null_mut(), metadata_to_packed),
+                truncated: document.truncated,
+            }
+        })
+        .collect();
+
+    results.shrink_to_fit();
+    unsafe {
+        *out_n = results.len();
+        *out_results = results.as_mut_ptr();
+    }
+    std::mem::forget(results);
+    timer.finish_ok();
+    ERR_OK
+}
+
+/// Frees a result array returned by `extractous_extractor_extract_file_recursive`,
+/// including every path, content buffer and packed metadata block it holds.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_embedded_results_free(
+    results: *mut CEmbeddedResult,
+    n: libc::size_t,
+) {
+    if results.is_null() || n == 0 {
+        return;
+    }
+    let items = unsafe { Vec::from_raw_parts(results, n, n) };
+    for item in items {
+        if !item.path.is_null() {
+            drop(unsafe { CString::from_raw(item.path) });
+        }
+        unsafe {
+            crate::stream::extractous_buffer_free(item.content, item.content_len);
+            crate::metadata::extractous_metadata_packed_free(item.metadata);
+        }
+    }
+}
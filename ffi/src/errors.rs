@@ -16,6 +16,7 @@ pub const ERR_INVALID_ENUM: c_int = -7;
 pub const ERR_UNSUPPORTED_FORMAT: c_int = -8;
 pub const ERR_OUT_OF_MEMORY: c_int = -9;
 pub const ERR_OCR_FAILED: c_int = -10;
+pub const ERR_CANCELLED: c_int = -11;
 
 pub(crate) fn extractous_error_to_code(err: &Error) -> c_int {
     match err {
@@ -57,6 +58,58 @@ pub(crate) fn extractous_error_to_code(err: &Error) -> c_int {
     }
 }
 
+/// An extraction failure: an error from the core, or from reading the content stream of
+/// a to-string call, which keeps its own code, such as a memory limit being exceeded.
+#[derive(Debug)]
+pub(crate) enum ExtractError {
+    Core(Error),
+    Stream(std::io::Error),
+}
+
+impl From<Error> for ExtractError {
+    fn from(e: Error) -> Self {
+        Self::Core(e)
+    }
+}
+
+impl std::fmt::Display for ExtractError {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        match self {
+            Self::Core(e) => e.fmt(f),
+            Self::Stream(e) => e.fmt(f),
+        }
+    }
+}
+
+impl StdError for ExtractError {
+    fn source(&self) -> Option<&(dyn StdError + 'static)> {
+        match self {
+            Self::Core(e) => e.source(),
+            Self::Stream(e) => e.source(),
+        }
+    }
+}
+
+/// The error code an extraction failure is reported with.
+pub(crate) trait ErrorCode {
+    fn error_code(&self) -> c_int;
+}
+
+impl ErrorCode for Error {
+    fn error_code(&self) -> c_int {
+        extractous_error_to_code(self)
+    }
+}
+
+impl ErrorCode for ExtractError {
+    fn error_code(&self) -> c_int {
+        match self {
+            Self::Core(e) => extractous_error_to_code(e),
+            Self::Stream(e) => crate::cancel::io_error_to_code(e),
+        }
+    }
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn extractous_error_message(code: c_int) -> *mut c_char {
     let msg = match code {
@@ -71,6 +124,7 @@ pub extern "C" fn extractous_error_message(code: c_int) -> *mut c_char {
         ERR_UNSUPPORTED_FORMAT => "Unsupported file format",
         ERR_OUT_OF_MEMORY => "Memory allocation failed",
         ERR_OCR_FAILED => "OCR operation failed",
+        ERR_CANCELLED => "Extraction cancelled or deadline exceeded",
         _ => "Unknown error code",
     };
     match CString::new(msg) {
@@ -0,0 +1,511 @@
+use crate::types::*;
+use std::collections::VecDeque;
+use std::io::Read;
+use std::os::raw::c_int;
+
+/// Bytes requested from the stream per refill.
+const READ_CHUNK: usize = 16 * 1024;
+/// Text runs longer than this are returned as several events.
+const MAX_TEXT_RUN: usize = 64 * 1024;
+/// Longest entity reference decoded, as in `&#x10FFFF;`. A longer `&...` is kept as text.
+const MAX_ENTITY: usize = 12;
+
+/// One structural event, owning its payload.
+pub(crate) struct Event {
+    pub(crate) kind: c_int,
+    pub(crate) index: u32,
+    pub(crate) data: Vec<u8>,
+}
+
+impl Event {
+    fn new(kind: c_int, index: u32, data: Vec<u8>) -> Self {
+        Self { kind, index, data }
+    }
+}
+
+enum Mode {
+    /// Not enough input seen yet to tell XHTML from plain text.
+    Undecided,
+    Xhtml,
+    Text,
+}
+
+/// An open `<div>`, so that its closing tag can be matched to the event it ends.
+enum Div {
+    Page(u32),
+    Embedded(u32),
+    Other,
+}
+
+/// Whether an `<h1>` naming the enclosing part may follow: spreadsheet parsers open each
+/// sheet with one, and embedded documents start with one holding their name. Carries the
+/// kind and index of the event the heading turns into.
+#[derive(Clone, Copy, PartialEq)]
+enum Heading {
+    None,
+    Expected(c_int, u32),
+    Capturing(c_int, u32),
+}
+
+/// Turns the XHTML content stream of an extraction into structural events in one pass.
+///
+/// This is not a general XML parser: it follows the markup the core emits. Pages, slides
+/// and sheets are `<div class="page">` or `<div class="slide-content">`, and a sheet name
+/// is the `<h1>` that opens such a page. Each embedded document the core parses is
+/// wrapped in `<div class="package-entry">`, opened by an `<h1>` with its name. All other
+/// markup is dropped, and character references are decoded. Text outside `<body>` is
+/// skipped.
+///
+/// A stream that does not start with an XML declaration or `<html` is plain text: it is
+/// returned as text events only.
+pub(crate) struct EventParser {
+    mode: Mode,
+    /// Unparsed input is `input[pos..]`.
+    input: Vec<u8>,
+    pos: usize,
+    eof: bool,
+    /// Whether the end event has been queued.
+    finished: bool,
+    in_body: bool,
+    divs: Vec<Div>,
+    pages: u32,
+    embedded: u32,
+    heading: Heading,
+    /// Text gathered since the last event.
+    text: Vec<u8>,
+    pending: VecDeque<Event>,
+    /// The event most recently handed out, kept alive until the next call.
+    current: Event,
+}
+
+impl Default for EventParser {
+    fn default() -> Self {
+        Self {
+            mode: Mode::Undecided,
+            input: Vec::new(),
+            pos: 0,
+            eof: false,
+            finished: false,
+            in_body: false,
+            divs: Vec::new(),
+            pages: 0,
+            embedded: 0,
+            heading: Heading::None,
+            text: Vec::new(),
+            pending: VecDeque::new(),
+            current: Event::new(STREAM_EVENT_END, 0, Vec::new()),
+        }
+    }
+}
+
+impl EventParser {
+    /// Returns the next event, reading from `reader` as needed. Once the input is used
+    /// up, every call returns an end event.
+    pub(crate) fn next(&mut self, reader: &mut impl Read) -> std::io::Result<&Event> {
+        loop {
+            if let Some(event) = self.pending.pop_front() {
+                self.current = event;
+                return Ok(&self.current);
+            }
+            if self.finished {
+                self.current = Event::new(STREAM_EVENT_END, 0, Vec::new());
+                return Ok(&self.current);
+            }
+            self.step(reader)?;
+        }
+    }
+
+    /// Appends up to `READ_CHUNK` bytes of input, setting `eof` at the end of the stream.
+    fn fill(&mut self, reader: &mut impl Read) -> std::io::Result<()> {
+        self.input.drain(..self.pos);
+        self.pos = 0;
+        let len = self.input.len();
+        self.input.resize(len + READ_CHUNK, 0);
+        let result = loop {
+            match reader.read(&mut self.input[len..]) {
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => continue,
+                result => break result,
+            }
+        };
+        let n = *result.as_ref().unwrap_or(&0);
+        self.input.truncate(len + n);
+        self.eof = result? == 0;
+        Ok(())
+    }
+
+    /// Consumes some input, queueing any events it completes.
+    fn step(&mut self, reader: &mut impl Read) -> std::io::Result<()> {
+        match self.mode {
+            Mode::Undecided => self.detect(reader),
+            Mode::Text => self.step_text(reader),
+            Mode::Xhtml => self.step_xhtml(reader),
+        }
+    }
+
+    fn detect(&mut self, reader: &mut impl Read) -> std::io::Result<()> {
+        let rest = &self.input[self.pos..];
+        let start = rest.iter().position(|b| !b.is_ascii_whitespace());
+        let decided = match start {
+            Some(start) if rest.len() - start >= 5 || self.eof => Some(start),
+            _ if self.eof => Some(rest.len()),
+            _ => None,
+        };
+        let Some(start) = decided else {
+            return self.fill(reader);
+        };
+        let head = &rest[start..];
+        self.mode = if head.starts_with(b"<?xml") || head.starts_with(b"<html") {
+            Mode::Xhtml
+        } else {
+            Mode::Text
+        };
+        Ok(())
+    }
+
+    fn step_text(&mut self, reader: &mut impl Read) -> std::io::Result<()> {
+        if self.pos == self.input.len() {
+            if self.eof {
+                self.finish();
+                return Ok(());
+            }
+            return self.fill(reader);
+        }
+        let rest = &self.input[self.pos..];
+        // Hold back a character cut off by the end of the input read so far.
+        let len = if self.eof {
+            rest.len()
+        } else {
+            complete_utf8_len(rest)
+        };
+        if len == 0 {
+            return self.fill(reader);
+        }
+        self.text.extend_from_slice(&rest[..len]);
+        self.pos += len;
+        self.flush_text();
+        Ok(())
+    }
+
+    fn step_xhtml(&mut self, reader: &mut impl Read) -> std::io::Result<()> {
+        let rest = &self.input[self.pos..];
+        if rest.is_empty() {
+            if self.eof {
+                self.finish();
+                return Ok(());
+            }
+            return self.fill(reader);
+        }
+
+        if rest[0] == b'<' {
+            match markup_len(rest) {
+                Some(len) => {
+                    let markup = rest[..len].to_vec();
+                    self.pos += len;
+                    self.markup(&markup);
+                }
+                // Truncated markup at the end of the stream is dropped.
+                None if self.eof => self.pos = self.input.len(),
+                None => self.fill(reader)?,
+            }
+            return Ok(());
+        }
+
+        let mut len = rest.iter().position(|&b| b == b'<').unwrap_or(rest.len());
+        if len == rest.len() && !self.eof {
+            // Leave an entity reference that may continue in the next read.
+            if let Some(amp) = rest.iter().rposition(|&b| b == b'&')
+                && rest.len() - amp < MAX_ENTITY
+                && !rest[amp..].contains(&b';')
+            {
+                len = amp;
+            }
+            if len == 0 {
+                return self.fill(reader);
+            }
+        }
+        let mut decoded = Vec::with_capacity(len);
+        decode_entities(&rest[..len], &mut decoded);
+        self.pos += len;
+        self.characters(&decoded);
+        Ok(())
+    }
+
+    /// Handles one complete piece of markup.
+    fn markup(&mut self, markup: &[u8]) {
+        if let Some(cdata) = markup
+            .strip_prefix(b"<![CDATA[")
+            .and_then(|m| m.strip_suffix(b"]]>"))
+        {
+            self.characters(cdata);
+        } else if let Some(tag) = markup.strip_prefix(b"</") {
+            self.close(tag_name(tag));
+        } else if markup.starts_with(b"<!") || markup.starts_with(b"<?") {
+            // Comments, doctypes and processing instructions carry no content.
+        } else {
+            let tag = &markup[1..];
+            self.open(tag_name(tag), tag, markup.ends_with(b"/>"));
+        }
+    }
+
+    fn open(&mut self, name: &[u8], tag: &[u8], self_closing: bool) {
+        if name.eq_ignore_ascii_case(b"body") {
+            self.in_body = true;
+            return;
+        }
+        if !self.in_body {
+            return;
+        }
+        if name.eq_ignore_ascii_case(b"div") {
+            let class = attribute(tag, b"class").unwrap_or_default();
+            let div = if has_class(class, b"page") || has_class(class, b"slide-content") {
+                self.flush_text();
+                self.pages += 1;
+                self.pending
+                    .push_back(Event::new(STREAM_EVENT_PAGE_START, self.pages, Vec::new()));
+                self.heading = Heading::Expected(STREAM_EVENT_SHEET_NAME, self.pages);
+                Div::Page(self.pages)
+            } else if has_class(class, b"package-entry") {
+                self.flush_text();
+                self.embedded += 1;
+                self.pending.push_back(Event::new(
+                    STREAM_EVENT_EMBEDDED_START,
+                    self.embedded,
+                    Vec::new(),
+                ));
+                self.heading = Heading::Expected(STREAM_EVENT_EMBEDDED_NAME, self.embedded);
+                Div::Embedded(self.embedded)
+            } else {
+                self.heading = Heading::None;
+                Div::Other
+            };
+            self.divs.push(div);
+            if self_closing {
+                self.close(b"div");
+            }
+            return;
+        }
+        if let Heading::Expected(kind, index) = self.heading
+            && name.eq_ignore_ascii_case(b"h1")
+        {
+            self.flush_text();
+            self.heading = Heading::Capturing(kind, index);
+            return;
+        }
+        if !matches!(self.heading, Heading::Capturing(..)) {
+            self.heading = Heading::None;
+        }
+        if name.eq_ignore_ascii_case(b"br") {
+            self.characters(b"\n");
+        }
+    }
+
+    fn close(&mut self, name: &[u8]) {
+        if name.eq_ignore_ascii_case(b"body") {
+            self.flush_text();
+            self.in_body = false;
+        } else if name.eq_ignore_ascii_case(b"div") {
+            if matches!(self.divs.last(), Some(Div::Page(_) | Div::Embedded(_))) {
+                self.flush_text();
+            }
+            let event = match self.divs.pop() {
+                Some(Div::Page(page)) => Event::new(STREAM_EVENT_PAGE_END, page, Vec::new()),
+                Some(Div::Embedded(depth)) => {
+                    self.embedded -= 1;
+                    Event::new(STREAM_EVENT_EMBEDDED_END, depth, Vec::new())
+                }
+                Some(Div::Other) | None => return,
+            };
+            self.heading = Heading::None;
+            self.pending.push_back(event);
+        } else if let Heading::Capturing(kind, index) = self.heading
+            && name.eq_ignore_ascii_case(b"h1")
+        {
+            let heading = std::mem::take(&mut self.text).trim_ascii().to_vec();
+            self.pending.push_back(Event::new(kind, index, heading));
+            self.heading = Heading::None;
+        }
+    }
+
+    /// Adds decoded text from the document body.
+    fn characters(&mut self, text: &[u8]) {
+        if !self.in_body {
+            return;
+        }
+        if matches!(self.heading, Heading::Expected(..)) && !text.trim_ascii().is_empty() {
+            self.heading = Heading::None;
+        }
+        self.text.extend_from_slice(text);
+        if !matches!(self.heading, Heading::Capturing(..)) && self.text.len() >= MAX_TEXT_RUN {
+            let len = complete_utf8_len(&self.text);
+            let rest = self.text.split_off(len);
+            self.flush_text();
+            self.text = rest;
+        }
+    }
+
+    /// Queues the gathered text as a text event. In XHTML, runs that are only whitespace,
+    /// such as the line breaks between tags, are dropped.
+    fn flush_text(&mut self) {
+        let markup = matches!(self.mode, Mode::Xhtml);
+        if self.text.is_empty() || (markup && self.text.trim_ascii().is_empty()) {
+            self.text.clear();
+        } else {
+            let text = std::mem::take(&mut self.text);
+            self.pending
+                .push_back(Event::new(STREAM_EVENT_TEXT, self.page(), text));
+        }
+    }
+
+    fn finish(&mut self) {
+        self.flush_text();
+        self.finished = true;
+    }
+
+    /// Number of the innermost open page, or 0 outside pages.
+    fn page(&self) -> u32 {
+        self.divs
+            .iter()
+            .rev()
+            .find_map(|div| match div {
+                Div::Page(page) => Some(*page),
+                _ => None,
+            })
+            .unwrap_or(0)
+    }
+}
+
+/// Returns the length of the leading part of `bytes` that does not end in a truncated
+/// UTF-8 sequence.
+fn complete_utf8_len(bytes: &[u8]) -> usize {
+    for back in 1..=bytes.len().min(4) {
+        let b = bytes[bytes.len() - back];
+        if b & 0xC0 == 0x80 {
+            continue;
+        }
+        let needed = match b {
+            0xF0..=0xFF => 4,
+            0xE0..=0xEF => 3,
+            0xC0..=0xDF => 2,
+            _ => 1,
+        };
+        return if needed > back {
+            bytes.len() - back
+        } else {
+            bytes.len()
+        };
+    }
+    bytes.len()
+}
+
+/// Returns the length of the markup at the start of `input`, or `None` if it is not
+/// complete yet.
+fn markup_len(input: &[u8]) -> Option<usize> {
+    let find = |pattern: &[u8]| {
+        input
+            .windows(pattern.len())
+            .position(|w| w == pattern)
+            .map(|i| i + pattern.len())
+    };
+    if input.starts_with(b"<!--") {
+        return find(b"-->");
+    }
+    if input.starts_with(b"<![CDATA[") {
+        return find(b"]]>");
+    }
+    if input.len() < 9 && (b"<!--".starts_with(input) || b"<![CDATA[".starts_with(input)) {
+        return None;
+    }
+    let mut quote = None;
+    for (i, &b) in input.iter().enumerate().skip(1) {
+        match (quote, b) {
+            (None, b'"' | b'\'') => quote = Some(b),
+            (Some(q), _) if b == q => quote = None,
+            (None, b'>') => return Some(i + 1),
+            _ => {}
+        }
+    }
+    None
+}
+
+/// Returns the element name at the start of a tag, after its `<` or `</`.
+fn tag_name(tag: &[u8]) -> &[u8] {
+    let end = tag
+        .iter()
+        .position(|&b| b.is_ascii_whitespace() || b == b'/' || b == b'>')
+        .unwrap_or(tag.len());
+    &tag[..end]
+}
+
+/// Returns the raw value of attribute `name` in a start tag.
+fn attribute<'a>(tag: &'a [u8], name: &[u8]) -> Option<&'a [u8]> {
+    let mut i = 0;
+    while let Some(offset) = tag[i..].windows(name.len()).position(|w| w == name) {
+        let start = i + offset;
+        i = start + name.len();
+        if start == 0 || !tag[start - 1].is_ascii_whitespace() {
+            continue;
+        }
+        let rest = tag[i..].trim_ascii_start();
+        let Some(rest) = rest.strip_prefix(b"=") else {
+            continue;
+        };
+        let rest = rest.trim_ascii_start();
+        let (&quote, value) = rest.split_first()?;
+        if quote != b'"' && quote != b'\'' {
+            return None;
+        }
+        let end = value.iter().position(|&b| b == quote)?;
+        return Some(&value[..end]);
+    }
+    None
+}
+
+fn has_class(class: &[u8], token: &[u8]) -> bool {
+    class.split(|b| b.is_ascii_whitespace()).any(|c| c == token)
+}
+
+/// Appends `text` to `out` with character references decoded. Unknown or malformed
+/// references are kept as they are.
+fn decode_entities(text: &[u8], out: &mut Vec<u8>) {
+    let mut i = 0;
+    while i < text.len() {
+        let Some(amp) = text[i..].iter().position(|&b| b == b'&') else {
+            out.extend_from_slice(&text[i..]);
+            return;
+        };
+        out.extend_from_slice(&text[i..i + amp]);
+        i += amp;
+        let reference = &text[i..text.len().min(i + MAX_ENTITY)];
+        let decoded = reference
+            .iter()
+            .position(|&b| b == b';')
+            .and_then(|end| Some((end, decode_entity(&reference[1..end])?)));
+        match decoded {
+            Some((end, c)) => {
+                let mut utf8 = [0; 4];
+                out.extend_from_slice(c.encode_utf8(&mut utf8).as_bytes());
+                i += end + 1;
+            }
+            None => {
+                out.push(b'&');
+                i += 1;
+            }
+        }
+    }
+}
+
+/// Decodes the name of a character reference, without its `&` and `;`.
+fn decode_entity(name: &[u8]) -> Option<char> {
+    match name {
+        b"amp" => Some('&'),
+        b"lt" => Some('<'),
+        b"gt" => Some('>'),
+        b"quot" => Some('"'),
+        b"apos" => Some('\''),
+        [b'#', b'x' | b'X', hex @ ..] => {
+            char::from_u32(u32::from_str_radix(std::str::from_utf8(hex).ok()?, 16).ok()?)
+        }
+        [b'#', dec @ ..] => char::from_u32(std::str::from_utf8(dec).ok()?.parse().ok()?),
+        _ => None,
+    }
+}
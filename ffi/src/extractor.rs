@@ -1,44 +1,60 @@
-use crate::ecore::{CharSet, Extractor as CoreExtractor};
+use crate::buffer;
+use crate::cache;
+use crate::cancel::{self, CancelToken};
+use crate::config::{OcrConfigState, OfficeConfigState, PdfConfigState};
+use crate::ecore::{
+    CharSet, Extractor as CoreExtractor, PdfOcrStrategy, PdfParserConfig,
+    StreamReader as CoreStreamReader,
+};
 use crate::errors::*;
-use crate::metadata::metadata_to_c;
+use crate::memory::read_to_end_fallible;
+use crate::metadata::{metadata_to_c, metadata_to_packed};
+use crate::mmap::MappedFile;
+use crate::shared::{self, ContentOptions, SharedExtractor, Snapshot};
+use crate::stats::{self, CallTimer};
+use crate::stream::{ReleaseGuard, StreamState, stream_to_c};
 use crate::types::*;
+use std::collections::HashMap;
 use std::ffi::{CStr, CString};
 use std::os::raw::c_char;
 use std::ptr;
+use std::sync::Arc;
 
 /// Creates a new `Extractor` with a default configuration.
 /// The returned handle must be freed with `extractous_extractor_free`.
 // #[must_use]
 #[unsafe(no_mangle)]
 pub extern "C" fn extractous_extractor_new() -> *mut CExtractor {
-    let extractor = Box::new(CoreExtractor::new());
+    let extractor = Box::new(SharedExtractor::new(CoreExtractor::new()));
     Box::into_raw(extractor) as *mut CExtractor
 }
 
 /// Frees the memory associated with an `Extractor` handle.
+///
+/// Extractions still running on other threads keep their configuration snapshot alive,
+/// but the handle itself must not be used once this is called.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn extractous_extractor_free(handle: *mut CExtractor) {
     if !handle.is_null() {
         unsafe {
-            drop(Box::from_raw(handle as *mut CoreExtractor));
+            drop(Box::from_raw(handle as *mut SharedExtractor));
         }
     }
 }
 
-/// A macro to safely update an Extractor instance behind a raw pointer.
+/// A macro to publish a reconfigured copy of the Extractor behind a raw pointer.
+///
+/// The new configuration is swapped in atomically; extractions already running on other
+/// threads keep the snapshot they started with. The body records what it sets in the
+/// snapshot's `CoreSettings`.
 macro_rules! update_extractor {
-    ($handle:expr, |$extractor_val:ident| $body:block) => {
+    ($handle:expr, |$extractor_val:ident, $settings:ident| $body:block) => {
         if $handle.is_null() {
             return;
         }
         unsafe {
-            let extractor_ptr = $handle as *mut CoreExtractor;
-            let old_extractor = ptr::read(extractor_ptr);
-            let new_extractor = {
-                let $extractor_val = old_extractor;
-                $body
-            };
-            ptr::write(extractor_ptr, new_extractor);
+            let shared = &*($handle as *const SharedExtractor);
+            shared.update(|$extractor_val, $settings| $body);
         }
     };
 }
@@ -49,7 +65,13 @@ pub unsafe extern "C" fn extractous_extractor_set_extract_string_max_length_mut(
     handle: *mut CExtractor,
     max_length: libc::c_int,
 ) {
-    update_extractor!(handle, |extractor| {
+    if handle.is_null() {
+        return;
+    }
+    // One publish for both, so an extraction never sees the core's limit without the
+    // stream reads' copy of it.
+    unsafe { &*(handle as *const SharedExtractor) }.update_with(|extractor, _, options| {
+        options.string_max_length = max_length;
         extractor.set_extract_string_max_length(max_length as i32)
     });
 }
@@ -60,13 +82,14 @@ pub unsafe extern "C" fn extractous_extractor_set_encoding_mut(
     handle: *mut CExtractor,
     encoding: libc::c_int,
 ) {
-    update_extractor!(handle, |extractor| {
-        let charset = match encoding {
-            CHARSET_UTF_8 => CharSet::UTF_8,
-            CHARSET_US_ASCII => CharSet::US_ASCII,
-            CHARSET_UTF_16BE => CharSet::UTF_16BE,
-            _ => return,
-        };
+    let charset = match encoding {
+        CHARSET_UTF_8 => CharSet::UTF_8,
+        CHARSET_US_ASCII => CharSet::US_ASCII,
+        CHARSET_UTF_16BE => CharSet::UTF_16BE,
+        _ => return,
+    };
+    update_extractor!(handle, |extractor, settings| {
+        settings.encoding = Some(encoding);
         extractor.set_encoding(charset)
     });
 }
@@ -80,9 +103,10 @@ pub unsafe extern "C" fn extractous_extractor_set_pdf_config_mut(
     if config.is_null() {
         return;
     }
-    update_extractor!(handle, |extractor| {
-        let pdf_config = &*(config as *const crate::ecore::PdfParserConfig);
-        extractor.set_pdf_config(pdf_config.clone())
+    update_extractor!(handle, |extractor, settings| {
+        let pdf_config = &*(config as *const PdfConfigState);
+        settings.pdf = Some(pdf_config.settings.clone());
+        extractor.set_pdf_config(pdf_config.core.clone())
     });
 }
 
@@ -95,9 +119,10 @@ pub unsafe extern "C" fn extractous_extractor_set_office_config_mut(
     if config.is_null() {
         return;
     }
-    update_extractor!(handle, |extractor| {
-        let office_config = &*(config as *const crate::ecore::OfficeParserConfig);
-        extractor.set_office_config(office_config.clone())
+    update_extractor!(handle, |extractor, settings| {
+        let office_config = &*(config as *const OfficeConfigState);
+        settings.office = Some(office_config.settings.clone());
+        extractor.set_office_config(office_config.core.clone())
     });
 }
 
@@ -110,9 +135,10 @@ pub unsafe extern "C" fn extractous_extractor_set_ocr_config_mut(
     if config.is_null() {
         return;
     }
-    update_extractor!(handle, |extractor| {
-        let ocr_config = &*(config as *const crate::ecore::TesseractOcrConfig);
-        extractor.set_ocr_config(ocr_config.clone())
+    update_extractor!(handle, |extractor, settings| {
+        let ocr_config = &*(config as *const OcrConfigState);
+        settings.ocr = Some(ocr_config.settings.clone());
+        extractor.set_ocr_config(ocr_config.core.clone())
     });
 }
 
@@ -122,13 +148,102 @@ pub unsafe extern "C" fn extractous_extractor_set_xml_output_mut(
     handle: *mut CExtractor,
     xml_output: bool,
 ) {
-    update_extractor!(handle, |extractor| { extractor.set_xml_output(xml_output) });
+    update_extractor!(handle, |extractor, settings| {
+        settings.xml_output = Some(xml_output);
+        extractor.set_xml_output(xml_output)
+    });
+}
+
+/// Sets a content budget: extractions stop once `max_bytes` of content have been
+/// produced, and the rest of the document is not parsed. Pass 0 to remove the budget.
+///
+/// Unlike `extractous_extractor_set_extract_string_max_length_mut`, which truncates text the
+/// parser has already produced, the budget ends the parse itself, and it is not limited
+/// to 2 GB. It applies to streams, which report the end of the stream once the budget is
+/// spent, and to every to-string and to-buffer call. For those, the budget counts UTF-8
+/// bytes of the result, and the result is also cut at `extract_string_max_length`
+/// bytes if that is smaller; a result cut off inside a multi-byte character is shortened
+/// to the last whole character.
+/// Metadata is not affected.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_set_content_budget_mut(
+    handle: *mut CExtractor,
+    max_bytes: u64,
+) {
+    if handle.is_null() {
+        return;
+    }
+    unsafe { &*(handle as *const SharedExtractor) }
+        .update_options(|options| options.content_budget = max_bytes);
+}
+
+/// Sets a memory limit: an extraction that needs more than `max_bytes` of memory fails
+/// with `ERR_OUT_OF_MEMORY`, and its parse is stopped, without affecting other
+/// extractions. Pass 0 to remove the limit.
+///
+/// The limit covers the extracted content the library holds, and on Linux the growth of
+/// the process's resident memory while the extraction runs, which includes the parser's
+/// heap. That growth is sampled after each read from the parser and is process-wide, so
+/// with concurrent extractions it is charged to whichever extraction observes it. On
+/// other platforms only the content held by the library is limited. To-string calls
+/// read from the content stream under a limit, so that they can be stopped mid-parse,
+/// and are then cut at `extract_string_max_length` bytes rather than characters.
+/// Whether or not a limit is set, `extractous_stream_read_all` and the to-buffer calls
+/// report a failed allocation of their result as `ERR_OUT_OF_MEMORY` instead of aborting.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_set_memory_limit_mut(
+    handle: *mut CExtractor,
+    max_bytes: u64,
+) {
+    if handle.is_null() {
+        return;
+    }
+    unsafe { &*(handle as *const SharedExtractor) }
+        .update_options(|options| options.memory_limit = max_bytes);
+}
+
+/// Sets the normalization stages applied to extracted content, as `NORMALIZE_*` bits.
+/// Pass 0 to turn normalization off; unknown bits are ignored.
+///
+/// The stages run inside the library on each block of content as it is read from the
+/// parser, so normalized text needs no second pass or copy. They apply to every read of
+/// a stream, including through `extractous_stream_next_event`, and to every to-string
+/// and to-buffer call, which then read from the content stream and are cut at
+/// `extract_string_max_length` normalized bytes rather than characters. The content
+/// budget counts normalized bytes. With XML
+/// output the stages also see the markup. Metadata is not affected. The stages work on
+/// UTF-8, so while any are set content is produced in UTF-8 whatever encoding was set
+/// with `extractous_extractor_set_encoding_mut`.
+///
+/// - `NORMALIZE_STRIP_CONTROL` drops ASCII control characters other than tab, `\n` and
+///   `\r`, DEL, and the C1 control characters U+0080 to U+009F.
+/// - `NORMALIZE_DEHYPHENATE` joins words broken across lines with a hyphen, as in
+///   justified PDF text: a hyphen after a letter, followed by a line break and a
+///   lowercase ASCII letter, is removed together with the break.
+/// - `NORMALIZE_COLLAPSE_WHITESPACE` turns each run of whitespace into one space, one
+///   line break, or a blank line if it held two or more line breaks, and trims the
+///   start and end of the content. `\r\n`, `\r`, vertical tab and form feed count as
+///   line breaks.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_set_normalization_mut(
+    handle: *mut CExtractor,
+    stages: u32,
+) {
+    if handle.is_null() {
+        return;
+    }
+    unsafe { &*(handle as *const SharedExtractor) }
+        .update_options(|options| options.normalize = stages & NORMALIZE_ALL);
 }
 
 // Macro to handle the common extraction logic and error wrapping.
+//
+// With `snapshot: name`, the configuration snapshot is bound to `name`, so the call and
+// the success handler can use the content options published with it.
 macro_rules! perform_extraction {
     (
         $handle:expr,
+        snapshot: $snapshot:ident,
         $out_ptr1:expr,
         $out_ptr2:expr,
         $extractor_call:expr,
@@ -138,21 +253,138 @@ macro_rules! perform_extraction {
             return ERR_NULL_POINTER;
         }
 
-        // Safely get a shared reference to the extractor.
-        let extractor = unsafe { &*($handle as *const CoreExtractor) };
+        // Take the current configuration snapshot; setters on other threads cannot change it.
+        let $snapshot = unsafe { shared::snapshot($handle) };
+        let extractor: &CoreExtractor = &$snapshot;
 
+        let mut timer = CallTimer::start();
         match $extractor_call(extractor) {
             Ok((res1, res2)) => {
+                timer.parsed(&res1, &res2);
                 $success_handler($out_ptr1, $out_ptr2, res1, res2);
+                timer.finish_ok();
                 ERR_OK
             }
             Err(e) => {
-                let code = extractous_error_to_code(&e);
+                let code = e.error_code();
+                timer.finish_err(code);
                 set_last_error(e);
                 code
             }
         }
     }};
+    (
+        $handle:expr,
+        $out_ptr1:expr,
+        $out_ptr2:expr,
+        $extractor_call:expr,
+        $success_handler:expr
+    ) => {
+        perform_extraction!(
+            $handle,
+            snapshot: snapshot,
+            $out_ptr1,
+            $out_ptr2,
+            $extractor_call,
+            $success_handler
+        )
+    };
+}
+
+/// Hands the allocation of `content` to the caller as a `(ptr, len)` byte buffer.
+///
+/// Unlike `CString::new`, this neither scans for interior NULs nor copies. The capacity is
+/// trimmed to the length (an in-place shrink for the allocator) so the buffer can be
+/// released with `extractous_buffer_free`, as for `extractous_stream_read_all`.
+/// An empty string yields a NULL pointer and a length of 0.
+pub(crate) unsafe fn string_into_buffer(
+    content: String,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+) {
+    unsafe { bytes_into_buffer(content.into_bytes(), out_buffer, out_len) }
+}
+
+/// Like `string_into_buffer`, for content that is already raw bytes.
+pub(crate) unsafe fn bytes_into_buffer(
+    mut bytes: Vec<u8>,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+) {
+    if bytes.is_empty() {
+        unsafe {
+            *out_buffer = ptr::null_mut();
+            *out_len = 0;
+        }
+        return;
+    }
+
+    bytes.shrink_to_fit();
+    let len = bytes.len();
+    let data = bytes.as_mut_ptr();
+    std::mem::forget(bytes);
+
+    unsafe {
+        *out_buffer = data;
+        *out_len = len;
+    }
+}
+
+/// Runs a to-string extraction under the content options published with `snapshot`.
+///
+/// The core's to-string call parses the whole document however much of it is kept, so
+/// with a budget or memory limit the text is read from the content stream instead, in
+/// UTF-8, and the parse is stopped as soon as the budget is spent or the memory limit is
+/// exceeded. Normalization stages are applied on the same stream, as it is read. The
+/// text is still cut at `extract_string_max_length`, counted in bytes rather than
+/// characters.
+pub(crate) fn extract_to_string_within(
+    snapshot: &Snapshot,
+    stream: impl FnOnce(
+        &CoreExtractor,
+    )
+        -> Result<(CoreStreamReader, HashMap<String, Vec<String>>), crate::ecore::Error>,
+    to_string: impl FnOnce(
+        &CoreExtractor,
+    ) -> Result<(String, HashMap<String, Vec<String>>), crate::ecore::Error>,
+) -> Result<(String, HashMap<String, Vec<String>>), ExtractError> {
+    let options = snapshot.options;
+    if !options.needs_stream() {
+        return Ok(to_string(snapshot)?);
+    }
+    let (reader, metadata) = stream(snapshot.utf8())?;
+    let content = read_content_within(reader, options, None).map_err(ExtractError::Stream)?;
+    Ok((content, metadata))
+}
+
+/// Reads a UTF-8 content stream to the end under `options` and `token`, as a to-string
+/// call would return it.
+///
+/// Besides the content budget, the stream is cut at `extract_string_max_length` like the
+/// core's to-string calls, and the text is truncated to the last whole character. The
+/// parse is stopped before the text is returned.
+fn read_content_within(
+    reader: CoreStreamReader,
+    options: ContentOptions,
+    token: Option<Arc<CancelToken>>,
+) -> std::io::Result<String> {
+    let mut stream = StreamState::new(reader, None);
+    stream.set_cancel(token);
+    stream.set_content_options(options);
+    if let Ok(max_length) = u64::try_from(options.string_max_length) {
+        stream.limit_budget(max_length);
+    }
+    let mut content = Vec::new();
+    read_to_end_fallible(&mut stream, &mut content, options.memory_limit)?;
+    drop(stream);
+
+    Ok(String::from_utf8(content).unwrap_or_else(|e| {
+        let valid = e.utf8_error().valid_up_to();
+        let mut bytes = e.into_bytes();
+        bytes.truncate(valid);
+        // Safe: the bytes were just validated up to `valid`.
+        unsafe { String::from_utf8_unchecked(bytes) }
+    }))
 }
 
 /// Extracts content and metadata from a local file path into a string.
@@ -176,9 +408,16 @@ pub unsafe extern "C" fn extractous_extractor_extract_file_to_string(
 
     perform_extraction!(
         handle,
+        snapshot: snapshot,
         out_content,
         out_metadata,
-        |extractor: &CoreExtractor| extractor.extract_file_to_string(path_str),
+        |_: &CoreExtractor| {
+            extract_to_string_within(
+                &snapshot,
+                |e| e.extract_file(path_str),
+                |e| e.extract_file_to_string(path_str),
+            )
+        },
         |out_c: *mut *mut c_char, out_m: *mut *mut CMetadata, content, metadata| {
             unsafe {
                 *out_c = CString::new(content).map_or(ptr::null_mut(), |s| s.into_raw());
@@ -206,18 +445,143 @@ pub unsafe extern "C" fn extractous_extractor_extract_file(
 
     perform_extraction!(
         handle,
+        snapshot: snapshot,
         out_reader,
         out_metadata,
         |extractor: &CoreExtractor| extractor.extract_file(path_str),
         |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadata, reader, metadata| {
             unsafe {
-                *out_r = Box::into_raw(Box::new(reader)) as *mut CStreamReader;
+                *out_r = stream_to_c(reader, None, snapshot.options);
+                *out_m = metadata_to_c(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content from a local file path into a stream, with packed metadata.
+///
+/// Identical to `extractous_extractor_extract_file`, except that metadata is returned as a
+/// single-allocation `CMetadataPacked` that must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_file_packed(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_reader: *mut *mut CStreamReader,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if path.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_reader,
+        out_metadata,
+        |extractor: &CoreExtractor| extractor.extract_file(path_str),
+        |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadataPacked, reader, metadata| {
+            unsafe {
+                *out_r = stream_to_c(reader, None, snapshot.options);
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content and metadata from a local file path into a length-prefixed buffer.
+///
+/// The content is returned as a UTF-8 byte buffer of `*out_len` bytes that is NOT
+/// null-terminated and may contain interior NUL bytes. This avoids the NUL scan and copy
+/// of `extractous_extractor_extract_file_to_string`. An empty result is returned as
+/// NULL with a length of 0.
+///
+/// Output buffers must be freed with `extractous_buffer_free(buffer, len)`.
+/// Output metadata must be freed with `extractous_metadata_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_file_to_buffer(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadata,
+) -> libc::c_int {
+    if path.is_null() || out_len.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_buffer,
+        out_metadata,
+        |_: &CoreExtractor| {
+            extract_to_string_within(
+                &snapshot,
+                |e| e.extract_file(path_str),
+                |e| e.extract_file_to_string(path_str),
+            )
+        },
+        |out_b: *mut *mut u8, out_m: *mut *mut CMetadata, content, metadata| {
+            unsafe {
+                string_into_buffer(content, out_b, out_len);
                 *out_m = metadata_to_c(metadata);
             }
         }
     )
 }
 
+/// Extracts content from a local file path into a length-prefixed buffer, with packed metadata.
+///
+/// Identical to `extractous_extractor_extract_file_to_buffer`, except that metadata is
+/// returned as a single-allocation `CMetadataPacked`.
+///
+/// Output buffers must be freed with `extractous_buffer_free(buffer, len)`.
+/// Output metadata must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_file_to_buffer_packed(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if path.is_null() || out_len.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_buffer,
+        out_metadata,
+        |_: &CoreExtractor| {
+            extract_to_string_within(
+                &snapshot,
+                |e| e.extract_file(path_str),
+                |e| e.extract_file_to_string(path_str),
+            )
+        },
+        |out_b: *mut *mut u8, out_m: *mut *mut CMetadataPacked, content, metadata| {
+            unsafe {
+                string_into_buffer(content, out_b, out_len);
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
 /// Extracts content and metadata from a byte slice into a string.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn extractous_extractor_extract_bytes_to_string(
@@ -234,9 +598,13 @@ pub unsafe extern "C" fn extractous_extractor_extract_bytes_to_string(
 
     perform_extraction!(
         handle,
+        snapshot: snapshot,
         out_content,
         out_metadata,
-        |extractor: &CoreExtractor| extractor.extract_bytes_to_string(bytes),
+        |_: &CoreExtractor| {
+            stats::record_input(data_len);
+            unsafe { cache::extract_bytes_to_string(handle, &snapshot, bytes) }
+        },
         |out_c: *mut *mut c_char, out_m: *mut *mut CMetadata, content, metadata| {
             unsafe {
                 *out_c = CString::new(content).map_or(ptr::null_mut(), |s| s.into_raw());
@@ -262,54 +630,256 @@ pub unsafe extern "C" fn extractous_extractor_extract_bytes(
 
     perform_extraction!(
         handle,
+        snapshot: snapshot,
         out_reader,
         out_metadata,
-        |extractor: &CoreExtractor| extractor.extract_bytes(bytes),
+        |extractor: &CoreExtractor| {
+            stats::record_input(data_len);
+            extractor.extract_bytes(bytes)
+        },
         |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadata, reader, metadata| {
             unsafe {
-                *out_r = Box::into_raw(Box::new(reader)) as *mut CStreamReader;
+                *out_r = stream_to_c(reader, None, snapshot.options);
                 *out_m = metadata_to_c(metadata);
             }
         }
     )
 }
 
-/// Extracts content and metadata from a URL into a string.
+/// Extracts content from a byte slice into a stream, with packed metadata.
 #[unsafe(no_mangle)]
-pub unsafe extern "C" fn extractous_extractor_extract_url_to_string(
+pub unsafe extern "C" fn extractous_extractor_extract_bytes_packed(
     handle: *mut CExtractor,
-    url: *const c_char,
-    out_content: *mut *mut c_char,
+    data: *const u8,
+    data_len: libc::size_t,
+    out_reader: *mut *mut CStreamReader,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if data.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let bytes = unsafe { std::slice::from_raw_parts(data, data_len) };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_reader,
+        out_metadata,
+        |extractor: &CoreExtractor| {
+            stats::record_input(data_len);
+            extractor.extract_bytes(bytes)
+        },
+        |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadataPacked, reader, metadata| {
+            unsafe {
+                *out_r = stream_to_c(reader, None, snapshot.options);
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content from a caller-owned byte slice into a stream without copying it,
+/// with packed metadata.
+///
+/// The bytes are borrowed rather than duplicated: the caller must keep `data` valid and
+/// unmodified until `release(user_data)` is called. `release` is invoked exactly once, on
+/// any thread: when the returned stream is freed with `extractous_stream_free`, or before
+/// this function returns if it fails. `release` may be NULL if no notification is needed.
+///
+/// Output metadata must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_bytes_borrowed(
+    handle: *mut CExtractor,
+    data: *const u8,
+    data_len: libc::size_t,
+    release: ExtractousReleaseFn,
+    user_data: *mut libc::c_void,
+    out_reader: *mut *mut CStreamReader,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    // Created first so that every early return below also releases the buffer.
+    let guard = ReleaseGuard::new(release, user_data);
+    if data.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let data_slice = unsafe { std::slice::from_raw_parts(data, data_len) };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_reader,
+        out_metadata,
+        |extractor: &CoreExtractor| {
+            stats::record_input(data_len);
+            extractor.extract_bytes(data_slice)
+        },
+        |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadataPacked, reader, metadata| {
+            unsafe {
+                *out_r = stream_to_c(
+                    reader,
+                    Some(Box::new(guard)),
+                    snapshot.options,
+                );
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content and metadata from a byte slice into a length-prefixed buffer.
+///
+/// See `extractous_extractor_extract_file_to_buffer` for the buffer ownership rules.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_bytes_to_buffer(
+    handle: *mut CExtractor,
+    data: *const u8,
+    data_len: libc::size_t,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
     out_metadata: *mut *mut CMetadata,
 ) -> libc::c_int {
-    if url.is_null() {
+    if data.is_null() || out_len.is_null() {
         return ERR_NULL_POINTER;
     }
-    let url_str = match unsafe { CStr::from_ptr(url).to_str() } {
+    let bytes = unsafe { std::slice::from_raw_parts(data, data_len) };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_buffer,
+        out_metadata,
+        |_: &CoreExtractor| {
+            stats::record_input(data_len);
+            unsafe { cache::extract_bytes_to_string(handle, &snapshot, bytes) }
+        },
+        |out_b: *mut *mut u8, out_m: *mut *mut CMetadata, content, metadata| {
+            unsafe {
+                string_into_buffer(content, out_b, out_len);
+                *out_m = metadata_to_c(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content from a byte slice into a length-prefixed buffer, with packed metadata.
+///
+/// See `extractous_extractor_extract_file_to_buffer_packed` for the ownership rules.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_bytes_to_buffer_packed(
+    handle: *mut CExtractor,
+    data: *const u8,
+    data_len: libc::size_t,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if data.is_null() || out_len.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let bytes = unsafe { std::slice::from_raw_parts(data, data_len) };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_buffer,
+        out_metadata,
+        |_: &CoreExtractor| {
+            stats::record_input(data_len);
+            unsafe { cache::extract_bytes_to_string(handle, &snapshot, bytes) }
+        },
+        |out_b: *mut *mut u8, out_m: *mut *mut CMetadataPacked, content, metadata| {
+            unsafe {
+                string_into_buffer(content, out_b, out_len);
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content from a byte slice into a reusable buffer, with packed metadata.
+///
+/// The content replaces the contents of `buffer`, a handle from `extractous_buffer_new`,
+/// as UTF-8 bytes that are NOT null-terminated. Its allocation is reused and only grows
+/// when the content no longer fits, so a caller that keeps one buffer per worker does
+/// not allocate a content buffer, nor copy through a C string, per document. The result
+/// cache and the content budget apply as for `extractous_extractor_extract_bytes_to_buffer`.
+/// On error the buffer is left unchanged.
+///
+/// Output metadata must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_bytes_into(
+    handle: *mut CExtractor,
+    data: *const u8,
+    data_len: libc::size_t,
+    buffer: *mut CBuffer,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if data.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let bytes = unsafe { std::slice::from_raw_parts(data, data_len) };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        buffer,
+        out_metadata,
+        |_: &CoreExtractor| {
+            stats::record_input(data_len);
+            unsafe { cache::extract_bytes_to_string(handle, &snapshot, bytes) }
+        },
+        |buffer: *mut CBuffer, out_m: *mut *mut CMetadataPacked, content: String, metadata| {
+            unsafe {
+                buffer::fill(buffer, content.as_bytes());
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Like `extractous_extractor_extract_bytes_into`, for a local file path.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_file_into(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    buffer: *mut CBuffer,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if path.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
         Ok(s) => s,
         Err(_) => return ERR_INVALID_UTF8,
     };
 
     perform_extraction!(
         handle,
-        out_content,
+        snapshot: snapshot,
+        buffer,
         out_metadata,
-        |extractor: &CoreExtractor| extractor.extract_url_to_string(url_str),
-        |out_c: *mut *mut c_char, out_m: *mut *mut CMetadata, content, metadata| {
+        |_: &CoreExtractor| {
+            extract_to_string_within(
+                &snapshot,
+                |e| e.extract_file(path_str),
+                |e| e.extract_file_to_string(path_str),
+            )
+        },
+        |buffer: *mut CBuffer, out_m: *mut *mut CMetadataPacked, content: String, metadata| {
             unsafe {
-                *out_c = CString::new(content).map_or(ptr::null_mut(), |s| s.into_raw());
-                *out_m = metadata_to_c(metadata);
+                buffer::fill(buffer, content.as_bytes());
+                *out_m = metadata_to_packed(metadata);
             }
         }
     )
 }
 
-/// Extracts content and metadata from a URL into a stream.
+/// Extracts content and metadata from a URL into a string.
 #[unsafe(no_mangle)]
-pub unsafe extern "C" fn extractous_extractor_extract_url(
+pub unsafe extern "C" fn extractous_extractor_extract_url_to_string(
     handle: *mut CExtractor,
     url: *const c_char,
-    out_reader: *mut *mut CStreamReader,
+    out_content: *mut *mut c_char,
     out_metadata: *mut *mut CMetadata,
 ) -> libc::c_int {
     if url.is_null() {
@@ -322,18 +892,683 @@ pub unsafe extern "C" fn extractous_extractor_extract_url(
 
     perform_extraction!(
         handle,
+        snapshot: snapshot,
+        out_content,
+        out_metadata,
+        |_: &CoreExtractor| {
+            extract_to_string_within(
+                &snapshot,
+                |e| e.extract_url(url_str),
+                |e| e.extract_url_to_string(url_str),
+            )
+        },
+        |out_c: *mut *mut c_char, out_m: *mut *mut CMetadata, content, metadata| {
+            unsafe {
+                *out_c = CString::new(content).map_or(ptr::null_mut(), |s| s.into_raw());
+                *out_m = metadata_to_c(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content and metadata from a URL into a stream.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_url(
+    handle: *mut CExtractor,
+    url: *const c_char,
+    out_reader: *mut *mut CStreamReader,
+    out_metadata: *mut *mut CMetadata,
+) -> libc::c_int {
+    if url.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let url_str = match unsafe { CStr::from_ptr(url).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
         out_reader,
         out_metadata,
         |extractor: &CoreExtractor| extractor.extract_url(url_str),
         |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadata, reader, metadata| {
             unsafe {
-                *out_r = Box::into_raw(Box::new(reader)) as *mut CStreamReader;
+                *out_r = stream_to_c(reader, None, snapshot.options);
+                *out_m = metadata_to_c(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content from a URL into a stream, with packed metadata.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_url_packed(
+    handle: *mut CExtractor,
+    url: *const c_char,
+    out_reader: *mut *mut CStreamReader,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if url.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let url_str = match unsafe { CStr::from_ptr(url).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_reader,
+        out_metadata,
+        |extractor: &CoreExtractor| extractor.extract_url(url_str),
+        |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadataPacked, reader, metadata| {
+            unsafe {
+                *out_r = stream_to_c(reader, None, snapshot.options);
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content and metadata from a URL into a length-prefixed buffer.
+///
+/// See `extractous_extractor_extract_file_to_buffer` for the buffer ownership rules.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_url_to_buffer(
+    handle: *mut CExtractor,
+    url: *const c_char,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadata,
+) -> libc::c_int {
+    if url.is_null() || out_len.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let url_str = match unsafe { CStr::from_ptr(url).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_buffer,
+        out_metadata,
+        |_: &CoreExtractor| {
+            extract_to_string_within(
+                &snapshot,
+                |e| e.extract_url(url_str),
+                |e| e.extract_url_to_string(url_str),
+            )
+        },
+        |out_b: *mut *mut u8, out_m: *mut *mut CMetadata, content, metadata| {
+            unsafe {
+                string_into_buffer(content, out_b, out_len);
+                *out_m = metadata_to_c(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content from a URL into a length-prefixed buffer, with packed metadata.
+///
+/// See `extractous_extractor_extract_file_to_buffer_packed` for the ownership rules.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_url_to_buffer_packed(
+    handle: *mut CExtractor,
+    url: *const c_char,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if url.is_null() || out_len.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let url_str = match unsafe { CStr::from_ptr(url).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_buffer,
+        out_metadata,
+        |_: &CoreExtractor| {
+            extract_to_string_within(
+                &snapshot,
+                |e| e.extract_url(url_str),
+                |e| e.extract_url_to_string(url_str),
+            )
+        },
+        |out_b: *mut *mut u8, out_m: *mut *mut CMetadataPacked, content, metadata| {
+            unsafe {
+                string_into_buffer(content, out_b, out_len);
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Write limit of metadata-only extractions. The core stops parsing once the limit is
+/// reached, so the body is parsed no further than its first character.
+const METADATA_ONLY_WRITE_LIMIT: i32 = 1;
+
+/// Derives the configuration of a metadata-only extraction from the handle's current
+/// one: the minimal write limit above, and PDF parsing without OCR or inline images.
+fn metadata_only_config(extractor: &CoreExtractor) -> CoreExtractor {
+    extractor
+        .clone()
+        .set_extract_string_max_length(METADATA_ONLY_WRITE_LIMIT)
+        .set_pdf_config(PdfParserConfig::new().set_ocr_strategy(PdfOcrStrategy::NO_OCR))
+}
+
+/// Shared body of the metadata-only entry points: runs `call` with the metadata-only
+/// configuration, drops the content and stores the converted metadata in `out_metadata`.
+unsafe fn extract_metadata_only<M>(
+    handle: *mut CExtractor,
+    out_metadata: *mut *mut M,
+    call: impl FnOnce(
+        &CoreExtractor,
+    ) -> Result<(String, HashMap<String, Vec<String>>), crate::ecore::Error>,
+    convert: impl FnOnce(HashMap<String, Vec<String>>) -> *mut M,
+) -> libc::c_int {
+    if handle.is_null() || out_metadata.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let snapshot = unsafe { shared::snapshot(handle) };
+    let extractor = metadata_only_config(&snapshot);
+
+    let mut timer = CallTimer::start();
+    match call(&extractor) {
+        Ok((_, metadata)) => {
+            timer.parsed(&String::new(), &metadata);
+            unsafe { *out_metadata = convert(metadata) };
+            timer.finish_ok();
+            ERR_OK
+        }
+        Err(e) => {
+            let code = extractous_error_to_code(&e);
+            timer.finish_err(code);
+            set_last_error(e);
+            code
+        }
+    }
+}
+
+/// Extracts only the metadata of a local file.
+///
+/// Body text is not returned, and the parse stops as soon as the body starts: the
+/// extractor runs with a one-character write limit, and its PDF configuration is
+/// replaced by one without OCR or inline image extraction. The handle's other settings
+/// still apply. Metadata the parser only fills in after reading the body, such as some
+/// per-page statistics, may be missing.
+///
+/// Output metadata must be freed with `extractous_metadata_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_metadata_only(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_metadata: *mut *mut CMetadata,
+) -> libc::c_int {
+    if path.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+    unsafe {
+        extract_metadata_only(
+            handle,
+            out_metadata,
+            |extractor| extractor.extract_file_to_string(path_str),
+            |metadata| metadata_to_c(metadata),
+        )
+    }
+}
+
+/// Like `extractous_extractor_extract_metadata_only`, with packed metadata.
+///
+/// Output metadata must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_metadata_only_packed(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if path.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+    unsafe {
+        extract_metadata_only(
+            handle,
+            out_metadata,
+            |extractor| extractor.extract_file_to_string(path_str),
+            metadata_to_packed,
+        )
+    }
+}
+
+/// Extracts only the metadata of a byte slice, with packed metadata.
+///
+/// See `extractous_extractor_extract_metadata_only` for what is skipped.
+/// Output metadata must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_bytes_metadata_only_packed(
+    handle: *mut CExtractor,
+    data: *const u8,
+    data_len: libc::size_t,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if data.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let bytes = unsafe { std::slice::from_raw_parts(data, data_len) };
+    unsafe {
+        extract_metadata_only(
+            handle,
+            out_metadata,
+            |extractor| {
+                stats::record_input(data_len);
+                extractor.extract_bytes_to_string(bytes)
+            },
+            metadata_to_packed,
+        )
+    }
+}
+
+/// Validates `path` and maps the file read-only for the `extract_mmap` functions.
+///
+/// On failure the error code is returned and I/O errors are recorded as the last error.
+unsafe fn map_path(path: *const c_char) -> Result<MappedFile, libc::c_int> {
+    if path.is_null() {
+        return Err(ERR_NULL_POINTER);
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return Err(ERR_INVALID_UTF8),
+    };
+    MappedFile::open(path_str).map_err(|e| {
+        set_last_error(e);
+        ERR_IO_ERROR
+    })
+}
+
+/// Extracts content and metadata from a memory-mapped local file into a stream.
+///
+/// The file is mapped read-only and the mapping itself is handed to the parser as its
+/// input, so the source is never copied onto the heap. The mapping stays alive until the
+/// stream is freed with `extractous_stream_free`. The file must not be truncated while the
+/// stream is open. On platforms without `mmap` the file is read into memory instead.
+///
+/// Output metadata must be freed with `extractous_metadata_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_mmap(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_reader: *mut *mut CStreamReader,
+    out_metadata: *mut *mut CMetadata,
+) -> libc::c_int {
+    if handle.is_null() || out_reader.is_null() || out_metadata.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let mapping = match unsafe { map_path(path) } {
+        Ok(m) => m,
+        Err(code) => {
+            stats::record_error(code);
+            return code;
+        }
+    };
+    stats::record_input(mapping.as_slice().len());
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_reader,
+        out_metadata,
+        |extractor: &CoreExtractor| extractor.extract_bytes(mapping.as_slice()),
+        |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadata, reader, metadata| {
+            unsafe {
+                *out_r = stream_to_c(
+                    reader,
+                    Some(Box::new(mapping)),
+                    snapshot.options,
+                );
                 *out_m = metadata_to_c(metadata);
             }
         }
     )
 }
 
+/// Extracts content from a memory-mapped local file into a stream, with packed metadata.
+///
+/// Identical to `extractous_extractor_extract_mmap`, except that metadata is returned as a
+/// single-allocation `CMetadataPacked` that must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_mmap_packed(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_reader: *mut *mut CStreamReader,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if handle.is_null() || out_reader.is_null() || out_metadata.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let mapping = match unsafe { map_path(path) } {
+        Ok(m) => m,
+        Err(code) => {
+            stats::record_error(code);
+            return code;
+        }
+    };
+    stats::record_input(mapping.as_slice().len());
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_reader,
+        out_metadata,
+        |extractor: &CoreExtractor| extractor.extract_bytes(mapping.as_slice()),
+        |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadataPacked, reader, metadata| {
+            unsafe {
+                *out_r = stream_to_c(
+                    reader,
+                    Some(Box::new(mapping)),
+                    snapshot.options,
+                );
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Extracts content from a memory-mapped local file into a length-prefixed buffer, with
+/// packed metadata.
+///
+/// The mapping is released before this function returns. See
+/// `extractous_extractor_extract_file_to_buffer_packed` for the ownership rules.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_mmap_to_buffer_packed(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if handle.is_null() || out_buffer.is_null() || out_len.is_null() || out_metadata.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let mapping = match unsafe { map_path(path) } {
+        Ok(m) => m,
+        Err(code) => {
+            stats::record_error(code);
+            return code;
+        }
+    };
+    stats::record_input(mapping.as_slice().len());
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_buffer,
+        out_metadata,
+        |_: &CoreExtractor| unsafe {
+            cache::extract_bytes_to_string(handle, &snapshot, mapping.as_slice())
+        },
+        |out_b: *mut *mut u8, out_m: *mut *mut CMetadataPacked, content, metadata| {
+            unsafe {
+                string_into_buffer(content, out_b, out_len);
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Smallest amount of spare capacity offered to a read callback per call.
+const READ_CHUNK: usize = 64 * 1024;
+
+/// Drains a caller-supplied read callback into memory.
+///
+/// `size_hint` pre-sizes the buffer so that inputs of known length are read without
+/// reallocating. Each call hands the callback the buffer's spare capacity directly, so
+/// the input is written exactly once.
+unsafe fn read_from_callback(
+    read: unsafe extern "C" fn(*mut libc::c_void, *mut u8, libc::size_t) -> isize,
+    user_data: *mut libc::c_void,
+    size_hint: libc::size_t,
+) -> std::io::Result<Vec<u8>> {
+    // One spare byte lets an exact hint reach end of input without growing the buffer.
+    let mut data: Vec<u8> = Vec::with_capacity(size_hint.saturating_add(1).max(READ_CHUNK));
+    loop {
+        if data.capacity() == data.len() {
+            data.reserve(READ_CHUNK.max(data.len()));
+        }
+        let spare = data.spare_capacity_mut();
+        let n = unsafe { read(user_data, spare.as_mut_ptr() as *mut u8, spare.len()) };
+        match n {
+            0 => return Ok(data),
+            n if n < 0 => {
+                return Err(std::io::Error::other(format!(
+                    "read callback failed with status {}",
+                    n
+                )));
+            }
+            n => {
+                let n = (n as usize).min(spare.len());
+                unsafe { data.set_len(data.len() + n) };
+            }
+        }
+    }
+}
+
+/// Extracts content from input pulled through a caller-supplied read callback into a
+/// stream, with packed metadata.
+///
+/// `read(user_data, buf, len)` is called on the calling thread until it returns 0 (end of
+/// input) or a negative value (error, reported as `ERR_IO_ERROR`). No callbacks are made
+/// after this function returns. Pass the input length as `size_hint` if known, or 0.
+///
+/// The core parser needs its whole input up front, so the input is collected into a single
+/// library-owned buffer before parsing starts; that buffer is owned by the returned stream
+/// and released by `extractous_stream_free`. This avoids a temporary file or a second
+/// caller-side copy, but parsing does not overlap with reading.
+///
+/// Output metadata must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_reader(
+    handle: *mut CExtractor,
+    read: ExtractousReadFn,
+    user_data: *mut libc::c_void,
+    size_hint: libc::size_t,
+    out_reader: *mut *mut CStreamReader,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if handle.is_null() || out_reader.is_null() || out_metadata.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let Some(read) = read else {
+        return ERR_NULL_POINTER;
+    };
+    let input = match unsafe { read_from_callback(read, user_data, size_hint) } {
+        Ok(input) => input,
+        Err(e) => {
+            stats::record_error(ERR_IO_ERROR);
+            set_last_error(e);
+            return ERR_IO_ERROR;
+        }
+    };
+    stats::record_input(input.len());
+
+    perform_extraction!(
+        handle,
+        snapshot: snapshot,
+        out_reader,
+        out_metadata,
+        |extractor: &CoreExtractor| extractor.extract_bytes(&input),
+        |out_r: *mut *mut CStreamReader, out_m: *mut *mut CMetadataPacked, reader, metadata| {
+            unsafe {
+                *out_r = stream_to_c(
+                    reader,
+                    Some(Box::new(input)),
+                    snapshot.options,
+                );
+                *out_m = metadata_to_packed(metadata);
+            }
+        }
+    )
+}
+
+/// Drives a streaming extraction to the end under a cancel token, for the
+/// `_to_buffer_cancellable` entry points.
+///
+/// The text is read from the content stream rather than produced by the core's
+/// to-string call, which cannot be interrupted: the token is checked before the parse
+/// starts and between reads, and the parse is stopped as soon as it fires. Otherwise the
+/// content matches what `extract_to_string_within` returns.
+unsafe fn extract_to_buffer_cancellable(
+    handle: *mut CExtractor,
+    token: Option<Arc<CancelToken>>,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadataPacked,
+    start: impl FnOnce(
+        &CoreExtractor,
+    )
+        -> Result<(CoreStreamReader, HashMap<String, Vec<String>>), crate::ecore::Error>,
+) -> libc::c_int {
+    if token.as_ref().is_some_and(|t| t.is_cancelled()) {
+        stats::record_error(ERR_CANCELLED);
+        return ERR_CANCELLED;
+    }
+
+    let snapshot = unsafe { shared::snapshot(handle) };
+    let mut timer = CallTimer::start();
+    let (reader, metadata) = match start(snapshot.utf8()) {
+        Ok(r) => r,
+        Err(e) => {
+            let code = extractous_error_to_code(&e);
+            timer.finish_err(code);
+            set_last_error(e);
+            return code;
+        }
+    };
+    timer.parsed(&reader, &metadata);
+
+    let content = match read_content_within(reader, snapshot.options, token) {
+        Ok(content) => content,
+        Err(e) => {
+            let code = cancel::io_error_to_code(&e);
+            timer.finish_err(code);
+            set_last_error(e);
+            return code;
+        }
+    };
+
+    unsafe {
+        string_into_buffer(content, out_buffer, out_len);
+        *out_metadata = metadata_to_packed(metadata);
+    }
+    timer.finish_ok();
+    ERR_OK
+}
+
+/// Extracts content from a local file into a length-prefixed buffer, with packed metadata,
+/// stopping early with `ERR_CANCELLED` if `token` is cancelled or its deadline passes.
+///
+/// `token` may be NULL, in which case the call cannot be cancelled. The parse is stopped
+/// and its memory released as soon as cancellation is observed, which happens between
+/// reads of the parser's output; a parser that produces no output for a long time is
+/// stopped when it next does.
+///
+/// The content is read from the parser's output stream, but otherwise comes back as from
+/// `extractous_extractor_extract_file_to_buffer`: in UTF-8, cut at the smaller of the
+/// content budget and `extract_string_max_length` (counted in bytes) on a character
+/// boundary.
+///
+/// Output buffers must be freed with `extractous_buffer_free(buffer, len)`.
+/// Output metadata must be freed with `extractous_metadata_packed_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_file_to_buffer_cancellable(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    token: *const CCancelToken,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if handle.is_null()
+        || path.is_null()
+        || out_buffer.is_null()
+        || out_len.is_null()
+        || out_metadata.is_null()
+    {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    unsafe {
+        extract_to_buffer_cancellable(
+            handle,
+            cancel::token_from_c(token),
+            out_buffer,
+            out_len,
+            out_metadata,
+            |extractor| extractor.extract_file(path_str),
+        )
+    }
+}
+
+/// Extracts content from a byte slice into a length-prefixed buffer, with packed metadata,
+/// stopping early with `ERR_CANCELLED` if `token` is cancelled or its deadline passes.
+///
+/// See `extractous_extractor_extract_file_to_buffer_cancellable` for the cancellation
+/// and ownership rules.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_bytes_to_buffer_cancellable(
+    handle: *mut CExtractor,
+    data: *const u8,
+    data_len: libc::size_t,
+    token: *const CCancelToken,
+    out_buffer: *mut *mut u8,
+    out_len: *mut libc::size_t,
+    out_metadata: *mut *mut CMetadataPacked,
+) -> libc::c_int {
+    if handle.is_null()
+        || data.is_null()
+        || out_buffer.is_null()
+        || out_len.is_null()
+        || out_metadata.is_null()
+    {
+        return ERR_NULL_POINTER;
+    }
+    let bytes = unsafe { std::slice::from_raw_parts(data, data_len) };
+
+    unsafe {
+        extract_to_buffer_cancellable(
+            handle,
+            cancel::token_from_c(token),
+            out_buffer,
+            out_len,
+            out_metadata,
+            |extractor| {
+                stats::record_input(data_len);
+                extractor.extract_bytes(bytes)
+            },
+        )
+    }
+}
+
 /// Frees a C-style string that was allocated by this library.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn extractous_string_free(s: *mut c_char) {
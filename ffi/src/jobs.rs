@@ -0,0 +1,222 @@
+use crate::errors::*;
+use crate::extractor::{extract_to_string_within, string_into_buffer};
+use crate::metadata::metadata_to_packed;
+use crate::shared::{self, Snapshot};
+use crate::stats::CallTimer;
+use crate::types::*;
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_int};
+use std::ptr;
+use std::sync::mpsc::{self, Receiver, Sender};
+use std::sync::{Arc, Condvar, Mutex, OnceLock};
+use std::thread;
+
+type Task = Box<dyn FnOnce() + Send>;
+
+/// The library-owned executor behind the `_async` entry points: a fixed set of worker
+/// threads, one per available CPU, pulling tasks from a shared queue.
+///
+/// Workers are spawned on first use and live for the rest of the process, so callers
+/// need no thread of their own per in-flight document.
+static EXECUTOR: OnceLock<Option<Sender<Task>>> = OnceLock::new();
+
+fn executor() -> Option<&'static Sender<Task>> {
+    EXECUTOR
+        .get_or_init(|| {
+            let (tx, rx) = mpsc::channel::<Task>();
+            let rx = Arc::new(Mutex::new(rx));
+            let workers = thread::available_parallelism().map_or(1, |p| p.get());
+            let spawned = (0..workers)
+                .filter(|i| {
+                    let rx = Arc::clone(&rx);
+                    thread::Builder::new()
+                        .name(format!("extractous-worker-{i}"))
+                        .spawn(move || worker_loop(&rx))
+                        .is_ok()
+                })
+                .count();
+            (spawned > 0).then_some(tx)
+        })
+        .as_ref()
+}
+
+/// Starts the executor's workers if they are not running yet. Returns false if no worker
+/// thread could be spawned.
+pub(crate) fn start_workers() -> bool {
+    executor().is_some()
+}
+
+fn worker_loop(rx: &Mutex<Receiver<Task>>) {
+    loop {
+        // The guard is dropped before the task runs, so other workers can dequeue.
+        let task = match rx.lock() {
+            Ok(rx) => rx.recv(),
+            Err(_) => return,
+        };
+        match task {
+            Ok(task) => task(),
+            Err(_) => return,
+        }
+    }
+}
+
+/// Completion state shared between a job handle and the worker running it.
+struct JobState {
+    result: Mutex<Option<c_int>>,
+    done: Condvar,
+}
+
+impl JobState {
+    fn complete(&self, code: c_int) {
+        if let Ok(mut result) = self.result.lock() {
+            *result = Some(code);
+        }
+        self.done.notify_all();
+    }
+}
+
+/// Carries the caller's `user_data` to the worker thread.
+struct UserData(*mut libc::c_void);
+
+// The pointer is only handed back to the caller's callback.
+unsafe impl Send for UserData {}
+
+type JobOutput = (*mut u8, libc::size_t, *mut CMetadataPacked);
+
+/// Runs one extraction to a buffer and packed metadata, recording stats like the
+/// synchronous entry points.
+fn run_file_job(snapshot: &Snapshot, path: &str) -> Result<JobOutput, c_int> {
+    let mut timer = CallTimer::start();
+    let outcome = extract_to_string_within(
+        snapshot,
+        |e| e.extract_file(path),
+        |e| e.extract_file_to_string(path),
+    );
+    match outcome {
+        Ok((content, metadata)) => {
+            timer.parsed(&content, &metadata);
+            let mut buffer = ptr::null_mut();
+            let mut len = 0;
+            unsafe { string_into_buffer(content, &mut buffer, &mut len) };
+            let metadata = metadata_to_packed(metadata);
+            timer.finish_ok();
+            Ok((buffer, len, metadata))
+        }
+        Err(e) => {
+            let code = e.error_code();
+            timer.finish_err(code);
+            Err(code)
+        }
+    }
+}
+
+/// Starts extracting a local file on the library's worker pool and returns immediately.
+///
+/// The job holds the extractor's configuration snapshot and content options from
+/// submission time, so the handle may be reconfigured or freed while the job runs. When
+/// the extraction ends, `callback` is invoked exactly once on a worker thread with
+/// `user_data` and the outcome (see `ExtractousCompletionFn` for ownership). It should
+/// return quickly: it runs on one of a small, fixed set of threads. Errors are reported only through `error_code`;
+/// `extractous_error_get_last_debug` does not cover async jobs.
+///
+/// If `out_job` is not NULL it receives a job handle that can be waited on and must be
+/// freed with `extractous_job_free`; pass NULL to rely on the callback alone.
+/// If this function returns an error, the job was not started and `callback` is never
+/// invoked.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_file_async(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    callback: ExtractousCompletionFn,
+    user_data: *mut libc::c_void,
+    out_job: *mut *mut CAsyncJob,
+) -> c_int {
+    if !out_job.is_null() {
+        unsafe { *out_job = ptr::null_mut() };
+    }
+    let Some(callback) = callback else {
+        return ERR_NULL_POINTER;
+    };
+    if handle.is_null() || path.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s.to_owned(),
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+    let Some(executor) = executor() else {
+        return ERR_IO_ERROR;
+    };
+
+    let snapshot = unsafe { shared::snapshot(handle) };
+    let state = Arc::new(JobState {
+        result: Mutex::new(None),
+        done: Condvar::new(),
+    });
+    let worker_state = Arc::clone(&state);
+    let user_data = UserData(user_data);
+
+    let task: Task = Box::new(move || {
+        let user_data = user_data;
+        let code = match run_file_job(&snapshot, &path) {
+            Ok((content, len, metadata)) => {
+                unsafe { callback(user_data.0, ERR_OK, content, len, metadata) };
+                ERR_OK
+            }
+            Err(code) => {
+                unsafe { callback(user_data.0, code, ptr::null_mut(), 0, ptr::null_mut()) };
+                code
+            }
+        };
+        // Marked done only after the callback, so a waiter sees its effects.
+        worker_state.complete(code);
+    });
+    if executor.send(task).is_err() {
+        return ERR_IO_ERROR;
+    }
+
+    if !out_job.is_null() {
+        unsafe { *out_job = Box::into_raw(Box::new(state)) as *mut CAsyncJob };
+    }
+    ERR_OK
+}
+
+/// Blocks until the job's callback has returned, then returns the job's error code.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_job_wait(job: *mut CAsyncJob) -> c_int {
+    if job.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let state = unsafe { &*(job as *const Arc<JobState>) };
+    let Ok(mut result) = state.result.lock() else {
+        return ERR_EXTRACTION_FAILED;
+    };
+    loop {
+        if let Some(code) = *result {
+            return code;
+        }
+        result = match state.done.wait(result) {
+            Ok(r) => r,
+            Err(_) => return ERR_EXTRACTION_FAILED,
+        };
+    }
+}
+
+/// Returns true once the job's callback has returned. Never blocks.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_job_is_done(job: *const CAsyncJob) -> bool {
+    if job.is_null() {
+        return false;
+    }
+    let state = unsafe { &*(job as *const Arc<JobState>) };
+    state.result.lock().map(|r| r.is_some()).unwrap_or(true)
+}
+
+/// Frees a job handle. A job that is still running is not affected: it runs to
+/// completion and its callback is still invoked.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_job_free(job: *mut CAsyncJob) {
+    if !job.is_null() {
+        unsafe { drop(Box::from_raw(job as *mut Arc<JobState>)) };
+    }
+}
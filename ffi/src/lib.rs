@@ -41,9 +41,13 @@
 //!
 //! ## Thread Safety
 //!
-//! - **Extractor Instances**: `CExtractor` and its associated config/stream objects are
-//!   **NOT thread-safe**. Do not share a handle across threads. The recommended pattern is
-//!   to create one `CExtractor` instance per thread that needs it.
+//! - **Extractor Instances**: A `CExtractor` **IS thread-safe** and can serve every worker
+//!   thread. It holds an immutable configuration snapshot: each extraction runs against the
+//!   snapshot that was current when it started, and setters atomically publish a new one, so
+//!   reconfiguring never disturbs extractions in flight. Freeing a handle must not race with
+//!   other calls on it.
+//! - **Config and Stream Objects**: Parser config objects and `CStreamReader`s are **NOT
+//!   thread-safe**. Do not use one from several threads at once.
 //! - **Error Handling**: The error reporting system **IS thread-safe**. Each thread stores
 //!   its own last error information independently, preventing race conditions. You can safely
 //!   call error-handling functions from any thread.
@@ -112,20 +116,48 @@
 pub use extractous as ecore;
 
 // Module declarations.
+mod batch;
+mod buffer;
+mod cache;
+mod cancel;
+mod chunks;
 mod config;
+mod detect;
+mod embedded;
 mod errors;
+mod events;
 mod extractor;
+mod jobs;
+mod memory;
 mod metadata;
+mod mmap;
+mod normalize;
+mod pool;
+mod result;
+mod shared;
+mod stats;
 mod stream;
 mod types;
+mod warmup;
 
 // Publicly re-export all FFI-safe functions and types for C header generation.
+pub use batch::*;
+pub use buffer::*;
+pub use cache::*;
+pub use cancel::*;
 pub use config::*;
+pub use detect::*;
+pub use embedded::*;
 pub use errors::*;
 pub use extractor::*;
+pub use jobs::*;
 pub use metadata::*;
+pub use pool::*;
+pub use result::*;
+pub use stats::*;
 pub use stream::*;
 pub use types::*;
+pub use warmup::*;
 
 /// Returns the FFI wrapper version as a null-terminated UTF-8 string.
 /// The returned pointer is to a static string and must not be freed.
@@ -0,0 +1,121 @@
+use std::io::{self, Read};
+
+/// Smallest amount `read_to_end_fallible` grows its output by.
+const MIN_GROWTH: usize = 64 * 1024;
+
+/// Marks a read or extraction that stopped because it went over its memory limit, or
+/// because memory for its output could not be allocated.
+#[derive(Debug)]
+pub(crate) struct OutOfMemory;
+
+impl std::fmt::Display for OutOfMemory {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.write_str("extraction ran out of memory: memory limit exceeded or allocation failed")
+    }
+}
+
+impl std::error::Error for OutOfMemory {}
+
+impl OutOfMemory {
+    pub(crate) fn io_error() -> io::Error {
+        io::Error::new(io::ErrorKind::OutOfMemory, OutOfMemory)
+    }
+}
+
+/// The process's current resident set size in bytes, or `None` where it cannot be read.
+pub(crate) fn current_rss_bytes() -> Option<u64> {
+    #[cfg(target_os = "linux")]
+    {
+        // The second field of statm is the resident set, in pages.
+        let statm = std::fs::read_to_string("/proc/self/statm").ok()?;
+        let pages: u64 = statm.split_whitespace().nth(1)?.parse().ok()?;
+        let page_size = unsafe { libc::sysconf(libc::_SC_PAGESIZE) };
+        Some(pages.saturating_mul(u64::try_from(page_size).ok()?))
+    }
+    #[cfg(not(target_os = "linux"))]
+    {
+        None
+    }
+}
+
+/// Enforces a memory limit on one extraction; see
+/// `extractous_extractor_set_memory_limit_mut`.
+///
+/// The parser's memory cannot be attributed to one extraction directly, so it is charged
+/// as the growth of the process's resident set since the extraction started, sampled
+/// after each read from the parser. Once over the limit, the guard stays tripped.
+pub(crate) struct MemoryGuard {
+    max_bytes: u64,
+    rss_start: Option<u64>,
+    exceeded: bool,
+}
+
+impl MemoryGuard {
+    /// Starts accounting for an extraction limited to `max_bytes`, or `None` for no limit.
+    pub(crate) fn new(max_bytes: u64) -> Option<Self> {
+        (max_bytes > 0).then(|| Self {
+            max_bytes,
+            rss_start: current_rss_bytes(),
+            exceeded: false,
+        })
+    }
+
+    pub(crate) fn max_bytes(&self) -> u64 {
+        self.max_bytes
+    }
+
+    /// Whether an earlier `check` found the limit exceeded.
+    pub(crate) fn exceeded(&self) -> bool {
+        self.exceeded
+    }
+
+    /// Fails once the process has grown by more than the limit since the extraction
+    /// started, or if it already has.
+    pub(crate) fn check(&mut self) -> io::Result<()> {
+        if !self.exceeded
+            && let Some(start) = self.rss_start
+            && let Some(now) = current_rss_bytes()
+        {
+            self.exceeded = now.saturating_sub(start) > self.max_bytes;
+        }
+        if self.exceeded {
+            Err(OutOfMemory::io_error())
+        } else {
+            Ok(())
+        }
+    }
+}
+
+/// Reads `reader` to its end into `out`, like `Read::read_to_end`.
+///
+/// `out` is grown with fallible allocations, so running out of memory fails the read
+/// with `OutOfMemory` instead of aborting the process, as does `out` growing past
+/// `max_bytes` unless it is 0.
+pub(crate) fn read_to_end_fallible(
+    reader: &mut impl Read,
+    out: &mut Vec<u8>,
+    max_bytes: u64,
+) -> io::Result<()> {
+    // `out[filled..]` is zeroed room for the next read, each byte zeroed only once.
+    let mut filled = out.len();
+    let result = loop {
+        if max_bytes > 0 && filled as u64 > max_bytes {
+            break Err(OutOfMemory::io_error());
+        }
+        if filled == out.len() {
+            let growth = out.len().max(MIN_GROWTH);
+            if out.try_reserve(growth).is_err() {
+                break Err(OutOfMemory::io_error());
+            }
+            out.resize(filled + growth, 0);
+        }
+        match reader.read(&mut out[filled..]) {
+            Ok(0) => break Ok(()),
+            Ok(n) => filled += n,
+            Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+            Err(e) => break Err(e),
+        }
+    };
+    out.truncate(filled);
+    result
+}
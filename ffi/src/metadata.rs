@@ -1,9 +1,14 @@
-use crate::types::CMetadata;
+use crate::types::{CMetadata, CMetadataPacked};
+use std::alloc::{self, Layout};
 use std::collections::HashMap;
 use std::ffi::CString;
+use std::mem::{align_of, size_of};
 use std::os::raw::c_char;
 use std::ptr;
 
+/// Separator used when a multi-valued entry is flattened into a single value.
+const VALUE_SEPARATOR: &str = ", ";
+
 /// Convert a Rust HashMap to a C-compatible metadata structure.
 pub(crate) unsafe fn metadata_to_c(metadata: HashMap<String, Vec<String>>) -> *mut CMetadata {
     if metadata.is_empty() {
@@ -25,7 +30,7 @@ pub(crate) unsafe fn metadata_to_c(metadata: HashMap<String, Vec<String>>) -> *m
             Err(_) => continue, // Skip metadata with invalid keys.
         };
 
-        let joined_values = value_vec.join(", ");
+        let joined_values = value_vec.join(VALUE_SEPARATOR);
         let c_value = match CString::new(joined_values) {
             Ok(s) => s.into_raw(),
             Err(_) => {
@@ -89,3 +94,114 @@ pub unsafe extern "C" fn extractous_metadata_free(metadata: *mut CMetadata) {
         let _ = unsafe { CString::from_raw(value_ptr) };
     }
 }
+
+/// Bytes needed after a packed metadata header for `len` keys, `value_count` values and
+/// `data_len` bytes of text: the offset tables, then the text.
+pub(crate) fn packed_body_size(len: usize, value_count: usize, data_len: usize) -> usize {
+    let table_entries = 2 * (len + 1) + (value_count + 1);
+    table_entries * size_of::<libc::size_t>() + data_len
+}
+
+/// Layout of a packed metadata block with `len` keys, `value_count` values and
+/// `data_len` bytes of text.
+fn packed_layout(len: usize, value_count: usize, data_len: usize) -> Layout {
+    let size = size_of::<CMetadataPacked>() + packed_body_size(len, value_count, data_len);
+    Layout::from_size_align(size, align_of::<CMetadataPacked>()).expect("packed metadata layout")
+}
+
+/// The key, value and byte counts of `metadata` once packed, as passed to
+/// `packed_body_size`.
+pub(crate) fn packed_counts(metadata: &HashMap<String, Vec<String>>) -> (usize, usize, usize) {
+    let value_count: usize = metadata.values().map(Vec::len).sum();
+    let data_len: usize = metadata
+        .iter()
+        .map(|(key, values)| key.len() + values.iter().map(String::len).sum::<usize>())
+        .sum();
+    (metadata.len(), value_count, data_len)
+}
+
+/// Writes the offset tables and text of `metadata` at `body`, which must be aligned for
+/// `size_t` and hold `packed_body_size` bytes, and returns the header describing them.
+pub(crate) unsafe fn write_packed_body(
+    metadata: &HashMap<String, Vec<String>>,
+    body: *mut u8,
+) -> CMetadataPacked {
+    let (len, value_count, data_len) = packed_counts(metadata);
+    unsafe {
+        let key_offsets = body as *mut libc::size_t;
+        let value_starts = key_offsets.add(len + 1);
+        let value_offsets = value_starts.add(len + 1);
+        let data = value_offsets.add(value_count + 1) as *mut u8;
+
+        let mut cursor = 0usize;
+        let write = |bytes: &[u8], cursor: &mut usize| {
+            ptr::copy_nonoverlapping(bytes.as_ptr(), data.add(*cursor), bytes.len());
+            *cursor += bytes.len();
+        };
+
+        // All keys first, then all values, so each table is a single run of offsets.
+        for (i, key) in metadata.keys().enumerate() {
+            *key_offsets.add(i) = cursor;
+            write(key.as_bytes(), &mut cursor);
+        }
+        *key_offsets.add(len) = cursor;
+
+        let mut value_index = 0usize;
+        for (i, values) in metadata.values().enumerate() {
+            *value_starts.add(i) = value_index;
+            for value in values {
+                *value_offsets.add(value_index) = cursor;
+                write(value.as_bytes(), &mut cursor);
+                value_index += 1;
+            }
+        }
+        *value_starts.add(len) = value_index;
+        *value_offsets.add(value_count) = cursor;
+        debug_assert_eq!(cursor, data_len);
+
+        CMetadataPacked {
+            len,
+            value_count,
+            data_len,
+            key_offsets,
+            value_starts,
+            value_offsets,
+            data,
+        }
+    }
+}
+
+/// Convert a Rust HashMap to a packed, single-allocation metadata block.
+///
+/// The header, the offset tables and the key/value bytes are laid out back to back in one
+/// allocation. Every value of a multi-valued entry is kept as its own table entry, so
+/// nothing is joined and values containing commas survive intact. Unlike `metadata_to_c`,
+/// keys and values containing `\0` are preserved.
+pub(crate) fn metadata_to_packed(metadata: HashMap<String, Vec<String>>) -> *mut CMetadataPacked {
+    let (len, value_count, data_len) = packed_counts(&metadata);
+    let layout = packed_layout(len, value_count, data_len);
+    let base = unsafe { alloc::alloc(layout) };
+    if base.is_null() {
+        alloc::handle_alloc_error(layout);
+    }
+
+    unsafe {
+        let header = base as *mut CMetadataPacked;
+        header.write(write_packed_body(
+            &metadata,
+            base.add(size_of::<CMetadataPacked>()),
+        ));
+        header
+    }
+}
+
+/// Frees a packed metadata block. The whole block is released with a single deallocation.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_metadata_packed_free(metadata: *mut CMetadataPacked) {
+    if metadata.is_null() {
+        return;
+    }
+    let m = unsafe { &*metadata };
+    let layout = packed_layout(m.len, m.value_count, m.data_len);
+    unsafe { alloc::dealloc(metadata as *mut u8, layout) };
+}
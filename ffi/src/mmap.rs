@@ -0,0 +1,86 @@
+use std::fs::File;
+use std::io;
+
+/// A read-only view of a whole file, used as zero-copy parser input.
+///
+/// On Unix the file is mapped with `mmap(PROT_READ, MAP_PRIVATE)`, so its pages are
+/// served straight from the page cache and nothing is copied onto the heap. The file
+/// must not be truncated while mapped: touching pages past its new end raises SIGBUS.
+/// Platforms without `mmap` fall back to reading the file into memory once.
+pub(crate) struct MappedFile {
+    #[cfg(unix)]
+    ptr: *mut libc::c_void,
+    #[cfg(unix)]
+    len: usize,
+    #[cfg(not(unix))]
+    data: Vec<u8>,
+}
+
+// The mapping is read-only and owned exclusively by this value.
+unsafe impl Send for MappedFile {}
+unsafe impl Sync for MappedFile {}
+
+impl MappedFile {
+    /// Maps the file at `path` read-only. Empty files are not mapped.
+    #[cfg(unix)]
+    pub(crate) fn open(path: &str) -> io::Result<Self> {
+        use std::os::unix::io::AsRawFd;
+
+        let file = File::open(path)?;
+        let len = usize::try_from(file.metadata()?.len())
+            .map_err(|_| io::Error::new(io::ErrorKind::InvalidInput, "file is too large to map"))?;
+        if len == 0 {
+            return Ok(Self {
+                ptr: std::ptr::null_mut(),
+                len: 0,
+            });
+        }
+
+        let ptr = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                len,
+                libc::PROT_READ,
+                libc::MAP_PRIVATE,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if ptr == libc::MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+        // The descriptor can be closed now; the mapping keeps its own reference.
+        Ok(Self { ptr, len })
+    }
+
+    #[cfg(not(unix))]
+    pub(crate) fn open(path: &str) -> io::Result<Self> {
+        let mut file = File::open(path)?;
+        let mut data = Vec::new();
+        io::Read::read_to_end(&mut file, &mut data)?;
+        Ok(Self { data })
+    }
+
+    /// Returns the file contents.
+    #[cfg(unix)]
+    pub(crate) fn as_slice(&self) -> &[u8] {
+        if self.len == 0 {
+            return &[];
+        }
+        unsafe { std::slice::from_raw_parts(self.ptr as *const u8, self.len) }
+    }
+
+    #[cfg(not(unix))]
+    pub(crate) fn as_slice(&self) -> &[u8] {
+        &self.data
+    }
+}
+
+#[cfg(unix)]
+impl Drop for MappedFile {
+    fn drop(&mut self) {
+        if self.len != 0 {
+            unsafe { libc::munmap(self.ptr, self.len) };
+        }
+    }
+}
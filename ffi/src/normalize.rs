@@ -0,0 +1,226 @@
+use crate::types::*;
+
+/// Most bytes the dehyphenation stage holds back while deciding whether a hyphen ends a
+/// line: the hyphen, the spaces around the line break and the break itself.
+const MAX_HELD: usize = 32;
+
+/// Bytes checked at a time when looking for the next byte a stage acts on. Checking a
+/// whole block with no early exit lets the compiler use vector compares.
+const BLOCK: usize = 16;
+
+/// Whether `b` can end a word: an ASCII letter, or the last byte of a non-ASCII character.
+fn is_word_byte(b: u8) -> bool {
+    b.is_ascii_alphabetic() || b >= 0x80
+}
+
+/// The `NORMALIZE_*` stages of one stream, applied incrementally as its content is read:
+/// each chunk is passed to `push` as it arrives, and `finish` is called at the end.
+///
+/// Stages run in the order control character stripping, dehyphenation and whitespace
+/// collapsing, each holding back the few bytes it cannot decide on yet. Runs of bytes
+/// that no enabled stage acts on are copied through in bulk.
+pub(crate) struct Normalizer {
+    strip_control: bool,
+    dehyphenate: bool,
+    collapse_whitespace: bool,
+    /// Stripping: a 0xC2 lead byte, held until the next byte shows whether it starts a
+    /// C1 control character.
+    lead_c2: bool,
+    /// Dehyphenation: a hyphen after a letter and the whitespace after it, held until it
+    /// is known whether the hyphen breaks a word across lines.
+    held: Vec<u8>,
+    /// Dehyphenation: whether `held` contains a line break.
+    line_broken: bool,
+    /// The last byte passed on to whitespace collapsing, or written when it is disabled.
+    last: u8,
+    /// Collapsing: whether spaces or tabs were seen since the last byte written.
+    space: bool,
+    /// Collapsing: line breaks seen since the last byte written.
+    line_breaks: u8,
+    /// Collapsing: the last byte was `\r`, so an `\n` right after it is the same break.
+    after_cr: bool,
+    /// Collapsing: whether a byte has been written yet, so leading whitespace is dropped.
+    started: bool,
+}
+
+impl Normalizer {
+    /// Creates the stages selected by `stages`, or returns `None` if none are.
+    pub(crate) fn new(stages: u32) -> Option<Self> {
+        (stages & NORMALIZE_ALL != 0).then(|| Self {
+            strip_control: stages & NORMALIZE_STRIP_CONTROL != 0,
+            dehyphenate: stages & NORMALIZE_DEHYPHENATE != 0,
+            collapse_whitespace: stages & NORMALIZE_COLLAPSE_WHITESPACE != 0,
+            lead_c2: false,
+            held: Vec::new(),
+            line_broken: false,
+            last: 0,
+            space: false,
+            line_breaks: 0,
+            after_cr: false,
+            started: false,
+        })
+    }
+
+    /// Normalizes the next chunk of content, appending the result to `out`.
+    pub(crate) fn push(&mut self, mut input: &[u8], out: &mut Vec<u8>) {
+        out.reserve(input.len());
+        while let Some(&b) = input.first() {
+            if !self.lead_c2 && self.held.is_empty() {
+                let run = self.plain_prefix(input);
+                if run > 0 {
+                    if self.collapse_whitespace {
+                        self.flush_whitespace(out);
+                    }
+                    out.extend_from_slice(&input[..run]);
+                    self.last = input[run - 1];
+                    input = &input[run..];
+                    continue;
+                }
+            }
+            self.strip_stage(b, out);
+            input = &input[1..];
+        }
+    }
+
+    /// Writes what the stages still hold at the end of the content. Trailing whitespace
+    /// is dropped when collapsing.
+    pub(crate) fn finish(&mut self, out: &mut Vec<u8>) {
+        if std::mem::take(&mut self.lead_c2) {
+            self.dehyphen_stage(0xC2, out);
+        }
+        self.release_held(out);
+        self.space = false;
+        self.line_breaks = 0;
+    }
+
+    /// Returns the length of the prefix of `bytes` that no enabled stage acts on.
+    fn plain_prefix(&self, bytes: &[u8]) -> usize {
+        let (strip, dehyphen, collapse) = (
+            self.strip_control,
+            self.dehyphenate,
+            self.collapse_whitespace,
+        );
+        let special = |b: u8| {
+            (strip & ((b < 0x20) | (b == 0x7F) | (b == 0xC2)))
+                | (dehyphen & (b == b'-'))
+                | (collapse & (b <= b' '))
+        };
+        let mut offset = 0;
+        for block in bytes.chunks_exact(BLOCK) {
+            if block.iter().fold(false, |any, &b| any | special(b)) {
+                break;
+            }
+            offset += BLOCK;
+        }
+        offset
+            + bytes[offset..]
+                .iter()
+                .position(|&b| special(b))
+                .unwrap_or(bytes.len() - offset)
+    }
+
+    /// Drops ASCII control characters other than tab and line breaks, DEL, and the C1
+    /// control characters U+0080 to U+009F.
+    fn strip_stage(&mut self, b: u8, out: &mut Vec<u8>) {
+        if self.strip_control {
+            if std::mem::take(&mut self.lead_c2) {
+                if (0x80..=0x9F).contains(&b) {
+                    return;
+                }
+                self.dehyphen_stage(0xC2, out);
+            }
+            if b == 0xC2 {
+                self.lead_c2 = true;
+                return;
+            }
+            if (b < 0x20 && !matches!(b, b'\t' | b'\n' | b'\r')) || b == 0x7F {
+                return;
+            }
+        }
+        self.dehyphen_stage(b, out);
+    }
+
+    /// Joins words hyphenated across a line break, such as PDF text laid out in columns:
+    /// a hyphen after a letter, followed by a line break and a lowercase ASCII letter, is
+    /// removed along with the break and the spaces around it.
+    fn dehyphen_stage(&mut self, b: u8, out: &mut Vec<u8>) {
+        if !self.dehyphenate {
+            return self.collapse_stage(b, out);
+        }
+        if !self.held.is_empty() {
+            match b {
+                b' ' | b'\t' if self.held.len() < MAX_HELD => return self.held.push(b),
+                b'\n' | b'\r' if !self.line_broken => {
+                    self.held.push(b);
+                    self.line_broken = true;
+                    return;
+                }
+                b'\n' if self.held.last() == Some(&b'\r') => return self.held.push(b),
+                b'a'..=b'z' if self.line_broken => {
+                    self.held.clear();
+                    self.line_broken = false;
+                    return self.collapse_stage(b, out);
+                }
+                _ => self.release_held(out),
+            }
+        }
+        if b == b'-' && is_word_byte(self.last) {
+            return self.held.push(b);
+        }
+        self.collapse_stage(b, out);
+    }
+
+    /// Passes on the bytes held by dehyphenation unchanged.
+    fn release_held(&mut self, out: &mut Vec<u8>) {
+        let mut held = std::mem::take(&mut self.held);
+        for &b in &held {
+            self.collapse_stage(b, out);
+        }
+        held.clear();
+        self.held = held;
+        self.line_broken = false;
+    }
+
+    /// Collapses whitespace: a run of spaces and tabs becomes one space, a run containing
+    /// one line break becomes that line break, and one containing more becomes a blank
+    /// line. Whitespace at the start and end of the content is dropped. `\r\n`, `\r`,
+    /// vertical tab and form feed all count as line breaks.
+    fn collapse_stage(&mut self, b: u8, out: &mut Vec<u8>) {
+        self.last = b;
+        if !self.collapse_whitespace {
+            return out.push(b);
+        }
+        match b {
+            b' ' | b'\t' => {
+                self.space = true;
+                self.after_cr = false;
+            }
+            b'\n' if self.after_cr => self.after_cr = false,
+            b'\n' | b'\r' | 0x0B | 0x0C => {
+                self.line_breaks = self.line_breaks.saturating_add(1);
+                self.after_cr = b == b'\r';
+            }
+            _ => {
+                self.flush_whitespace(out);
+                out.push(b);
+            }
+        }
+    }
+
+    /// Writes the collapsed form of the whitespace seen since the last byte written,
+    /// before the next one is.
+    fn flush_whitespace(&mut self, out: &mut Vec<u8>) {
+        if self.started {
+            match self.line_breaks {
+                0 if self.space => out.push(b' '),
+                0 => {}
+                1 => out.push(b'\n'),
+                _ => out.extend_from_slice(b"\n\n"),
+            }
+        }
+        self.started = true;
+        self.space = false;
+        self.line_breaks = 0;
+        self.after_cr = false;
+    }
+}
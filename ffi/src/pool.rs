@@ -0,0 +1,189 @@
+use crate::cache::ResultCache;
+use crate::ecore::Extractor as CoreExtractor;
+use crate::errors::*;
+use crate::shared::{self, SharedExtractor, Snapshot};
+use crate::types::*;
+use crate::warmup;
+use std::os::raw::c_int;
+use std::ptr;
+use std::sync::{Arc, Condvar, Mutex};
+use std::thread;
+
+/// The state behind a `CExtractorPool` handle: a fixed set of extractor handles sharing
+/// one configuration snapshot, handed out one caller at a time.
+pub(crate) struct ExtractorPool {
+    /// The configuration, with its content options, every slot is reset to on release.
+    base: Arc<Snapshot>,
+    /// The result cache every slot is reset to on release.
+    base_cache: Option<Arc<ResultCache>>,
+    /// Every slot the pool owns, as `Box<SharedExtractor>` raw pointers.
+    slots: Vec<usize>,
+    /// Slots not currently acquired.
+    idle: Mutex<Vec<usize>>,
+    available: Condvar,
+}
+
+impl ExtractorPool {
+    fn take(&self, block: bool) -> *mut CExtractor {
+        let mut idle = self.idle.lock().unwrap_or_else(|e| e.into_inner());
+        loop {
+            if let Some(slot) = idle.pop() {
+                return slot as *mut CExtractor;
+            }
+            if !block {
+                return ptr::null_mut();
+            }
+            idle = self.available.wait(idle).unwrap_or_else(|e| e.into_inner());
+        }
+    }
+}
+
+impl Drop for ExtractorPool {
+    fn drop(&mut self) {
+        for &slot in &self.slots {
+            unsafe { drop(Box::from_raw(slot as *mut SharedExtractor)) };
+        }
+    }
+}
+
+/// Creates a pool of `size` extractors configured like `config`.
+///
+/// `config` is only read: the pool takes its current configuration snapshot, result
+/// cache, content budget, memory limit and normalization stages, and the handle may be
+/// reconfigured or freed afterwards without affecting the pool. Pass NULL for the
+/// default configuration. A `size` of 0 selects one extractor per available CPU.
+///
+/// Before returning, each extractor runs a tiny built-in document on its own thread, in
+/// parallel, so start-up costs in the core are paid here and not by the first requests.
+/// Returns NULL if `size` extractors could not be created.
+/// The returned handle must be freed with `extractous_pool_free`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_pool_new(
+    config: *const CExtractor,
+    size: libc::size_t,
+) -> *mut CExtractorPool {
+    let (base, base_cache) = if config.is_null() {
+        (Arc::new(Snapshot::new(CoreExtractor::new())), None)
+    } else {
+        let config = unsafe { &*(config as *const SharedExtractor) };
+        (config.load(), config.cache())
+    };
+    let size = if size == 0 {
+        thread::available_parallelism().map_or(1, |p| p.get())
+    } else {
+        size
+    };
+
+    let slots: Vec<usize> = (0..size)
+        .map(|_| {
+            let slot = Box::new(SharedExtractor::from_snapshot(Arc::clone(&base)));
+            slot.set_cache(base_cache.clone());
+            Box::into_raw(slot) as usize
+        })
+        .collect();
+    let pool = ExtractorPool {
+        base,
+        base_cache,
+        idle: Mutex::new(slots.clone()),
+        slots,
+        available: Condvar::new(),
+    };
+
+    let warmed = thread::scope(|scope| {
+        let workers: Vec<_> = pool
+            .slots
+            .iter()
+            .map(|&slot| {
+                let extractor = unsafe { shared::snapshot(slot as *const CExtractor) };
+                thread::Builder::new()
+                    .name("extractous-pool-warmup".to_owned())
+                    // The outcome is ignored: a slot that fails to warm up is still
+                    // usable, it just pays the start-up cost on first use.
+                    .spawn_scoped(scope, move || {
+                        warmup::run_sample(&extractor, warmup::RUNTIME_SAMPLE);
+                    })
+            })
+            .collect();
+        workers
+            .into_iter()
+            .all(|w| w.is_ok_and(|w| w.join().is_ok()))
+    });
+    if !warmed {
+        return ptr::null_mut();
+    }
+    Box::into_raw(Box::new(pool)) as *mut CExtractorPool
+}
+
+/// Takes an extractor from the pool, blocking until one is idle.
+///
+/// The returned handle is used with the regular `extractous_extractor_*` functions and
+/// must be given back with `extractous_pool_release`, never freed directly. Setters may
+/// be called on it; the pool restores its configuration on release.
+/// Returns NULL if `pool` is NULL.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_pool_acquire(pool: *mut CExtractorPool) -> *mut CExtractor {
+    if pool.is_null() {
+        return ptr::null_mut();
+    }
+    unsafe { &*(pool as *const ExtractorPool) }.take(true)
+}
+
+/// Like `extractous_pool_acquire`, but returns NULL instead of blocking when every
+/// extractor is in use.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_pool_try_acquire(pool: *mut CExtractorPool) -> *mut CExtractor {
+    if pool.is_null() {
+        return ptr::null_mut();
+    }
+    unsafe { &*(pool as *const ExtractorPool) }.take(false)
+}
+
+/// Returns an acquired extractor to the pool and wakes one waiting caller.
+///
+/// Returns `ERR_INVALID_CONFIG` if `extractor` was not acquired from this pool, or is
+/// already idle.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_pool_release(
+    pool: *mut CExtractorPool,
+    extractor: *mut CExtractor,
+) -> c_int {
+    if pool.is_null() || extractor.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let pool = unsafe { &*(pool as *const ExtractorPool) };
+    let slot = extractor as usize;
+    if !pool.slots.contains(&slot) {
+        return ERR_INVALID_CONFIG;
+    }
+    let mut idle = pool.idle.lock().unwrap_or_else(|e| e.into_inner());
+    if idle.contains(&slot) {
+        return ERR_INVALID_CONFIG;
+    }
+    let shared = unsafe { &*(slot as *const SharedExtractor) };
+    shared.store(Arc::clone(&pool.base));
+    shared.set_cache(pool.base_cache.clone());
+    idle.push(slot);
+    drop(idle);
+    pool.available.notify_one();
+    ERR_OK
+}
+
+/// Returns the number of extractors the pool owns, idle or not.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_pool_size(pool: *const CExtractorPool) -> libc::size_t {
+    if pool.is_null() {
+        return 0;
+    }
+    unsafe { &*(pool as *const ExtractorPool) }.slots.len()
+}
+
+/// Frees a pool and all of its extractors.
+///
+/// Every acquired extractor must have been released first: handles still out are freed
+/// with the pool. Extractions still running keep their configuration snapshot alive.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_pool_free(pool: *mut CExtractorPool) {
+    if !pool.is_null() {
+        unsafe { drop(Box::from_raw(pool as *mut ExtractorPool)) };
+    }
+}
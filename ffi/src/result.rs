@@ -0,0 +1,148 @@
+use crate::cache;
+use crate::errors::*;
+use crate::extractor::extract_to_string_within;
+use crate::metadata::{packed_body_size, packed_counts, write_packed_body};
+use crate::shared::{self, Snapshot};
+use crate::stats::{self, CallTimer};
+use crate::types::*;
+use std::alloc::{self, Layout};
+use std::collections::HashMap;
+use std::ffi::CStr;
+use std::mem::{align_of, size_of};
+use std::os::raw::{c_char, c_int};
+use std::ptr;
+
+type Metadata = HashMap<String, Vec<String>>;
+
+/// Layout of a result block holding `content_len` bytes of content and metadata with
+/// `len` keys, `value_count` values and `data_len` bytes of text.
+fn result_layout(content_len: usize, len: usize, value_count: usize, data_len: usize) -> Layout {
+    let size = size_of::<CExtractionResult>()
+        + packed_body_size(len, value_count, data_len)
+        + content_len
+        + 1;
+    Layout::from_size_align(size, align_of::<CExtractionResult>()).expect("result layout")
+}
+
+/// Lays out `content` and `metadata` in one allocation: the header, the metadata offset
+/// tables and text, then the null-terminated content.
+fn result_to_c(content: String, metadata: Metadata) -> *mut CExtractionResult {
+    let (len, value_count, data_len) = packed_counts(&metadata);
+    let layout = result_layout(content.len(), len, value_count, data_len);
+    let base = unsafe { alloc::alloc(layout) };
+    if base.is_null() {
+        alloc::handle_alloc_error(layout);
+    }
+
+    unsafe {
+        let body = base.add(size_of::<CExtractionResult>());
+        let packed = write_packed_body(&metadata, body);
+        let text = body.add(packed_body_size(len, value_count, data_len));
+        ptr::copy_nonoverlapping(content.as_ptr(), text, content.len());
+        *text.add(content.len()) = 0;
+
+        let header = base as *mut CExtractionResult;
+        header.write(CExtractionResult {
+            content: text as *const c_char,
+            content_len: content.len(),
+            metadata: packed,
+        });
+        header
+    }
+}
+
+/// Runs a to-string extraction and hands its outcome to the caller as one result block.
+unsafe fn extract_to_result(
+    handle: *mut CExtractor,
+    out_result: *mut *mut CExtractionResult,
+    extract: impl FnOnce(&Snapshot) -> Result<(String, Metadata), ExtractError>,
+) -> c_int {
+    if handle.is_null() || out_result.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let snapshot = unsafe { shared::snapshot(handle) };
+
+    let mut timer = CallTimer::start();
+    match extract(&snapshot) {
+        Ok((content, metadata)) => {
+            timer.parsed(&content, &metadata);
+            unsafe { *out_result = result_to_c(content, metadata) };
+            timer.finish_ok();
+            ERR_OK
+        }
+        Err(e) => {
+            let code = e.error_code();
+            timer.finish_err(code);
+            set_last_error(e);
+            code
+        }
+    }
+}
+
+/// Extracts content and metadata from a local file into a single result block.
+///
+/// The content, the packed metadata and all of their tables live in one allocation, so
+/// the whole result is released with one call to `extractous_result_free`, however many
+/// metadata entries it has. The content is null-terminated for convenience, but may
+/// contain interior NUL bytes: `content_len` is authoritative. The metadata is read like
+/// a `CMetadataPacked`, through `&result->metadata`, and must not be freed on its own.
+///
+/// The content budget applies as for `extractous_extractor_extract_file_to_buffer`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_file_to_result(
+    handle: *mut CExtractor,
+    path: *const c_char,
+    out_result: *mut *mut CExtractionResult,
+) -> c_int {
+    if path.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let path_str = match unsafe { CStr::from_ptr(path).to_str() } {
+        Ok(s) => s,
+        Err(_) => return ERR_INVALID_UTF8,
+    };
+
+    unsafe {
+        extract_to_result(handle, out_result, |snapshot| {
+            extract_to_string_within(
+                snapshot,
+                |e| e.extract_file(path_str),
+                |e| e.extract_file_to_string(path_str),
+            )
+        })
+    }
+}
+
+/// Like `extractous_extractor_extract_file_to_result`, for a byte slice. The result cache
+/// applies as for `extractous_extractor_extract_bytes_to_buffer`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_extractor_extract_bytes_to_result(
+    handle: *mut CExtractor,
+    data: *const u8,
+    data_len: libc::size_t,
+    out_result: *mut *mut CExtractionResult,
+) -> c_int {
+    if data.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let bytes = unsafe { std::slice::from_raw_parts(data, data_len) };
+
+    unsafe {
+        extract_to_result(handle, out_result, |snapshot| {
+            stats::record_input(data_len);
+            cache::extract_bytes_to_string(handle, snapshot, bytes)
+        })
+    }
+}
+
+/// Frees a result block, with its content and metadata, in a single deallocation.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_result_free(result: *mut CExtractionResult) {
+    if result.is_null() {
+        return;
+    }
+    let r = unsafe { &*result };
+    let m = &r.metadata;
+    let layout = result_layout(r.content_len, m.len, m.value_count, m.data_len);
+    unsafe { alloc::dealloc(result as *mut u8, layout) };
+}
@@ -0,0 +1,250 @@
+use crate::cache::ResultCache;
+use crate::config::{OcrSettings, OfficeSettings, PdfSettings};
+use crate::ecore::{CharSet, Extractor as CoreExtractor};
+use crate::types::*;
+use std::ops::Deref;
+use std::sync::atomic::{AtomicPtr, AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex};
+
+/// The state behind a `CExtractor` handle: an immutable, reference-counted configuration
+/// snapshot that setters replace read-copy-update style.
+///
+/// Extractions take a snapshot with `load` and run against it, so one handle can be used
+/// from any number of threads, and setters may run concurrently with extractions. An
+/// extraction always sees one consistent configuration: the one current when it started.
+///
+/// The read side takes no lock: it registers in one of two reader counts, picked by the
+/// current epoch, around an `Arc` clone. A writer swaps the snapshot, flips the epoch and
+/// waits for the count of the old epoch to drain, which only readers that may have loaded
+/// the old pointer are in; readers arriving later register in the other count, so a
+/// steady stream of reads cannot hold a writer up.
+pub(crate) struct SharedExtractor {
+    /// Raw form of an `Arc<Snapshot>` that this cell holds one reference to.
+    current: AtomicPtr<Snapshot>,
+    /// Selects the reader count new readers register in; bumped by every publish.
+    epoch: AtomicUsize,
+    /// Readers currently inside `load`, per epoch parity.
+    readers: [AtomicUsize; 2],
+    /// Serializes setters, so concurrent updates are not lost.
+    writer: Mutex<()>,
+    /// Result cache consulted by the cached entry points. Only those take this lock.
+    cache: Mutex<Option<Arc<ResultCache>>>,
+}
+
+/// The core's default `extract_string_max_length`, until a handle sets its own.
+pub(crate) const DEFAULT_STRING_MAX_LENGTH: i32 = 500_000;
+
+/// The settings of an extractor handle that apply to the content of an extraction
+/// rather than to the parser.
+#[derive(Clone, Copy)]
+pub(crate) struct ContentOptions {
+    /// Content budget in bytes, or 0 for none.
+    pub(crate) content_budget: u64,
+    /// Memory limit in bytes, or 0 for none.
+    pub(crate) memory_limit: u64,
+    /// `NORMALIZE_*` stages, or 0 for none.
+    pub(crate) normalize: u32,
+    /// The `extract_string_max_length` the core was configured with, which to-string
+    /// calls read from the content stream apply themselves; negative for none.
+    pub(crate) string_max_length: i32,
+}
+
+impl Default for ContentOptions {
+    fn default() -> Self {
+        Self {
+            content_budget: 0,
+            memory_limit: 0,
+            normalize: 0,
+            string_max_length: DEFAULT_STRING_MAX_LENGTH,
+        }
+    }
+}
+
+impl ContentOptions {
+    /// Whether to-string extractions must be read from the content stream, so the
+    /// options can be applied while the document is parsed.
+    pub(crate) fn needs_stream(&self) -> bool {
+        self.content_budget > 0 || self.memory_limit > 0 || self.normalize != 0
+    }
+}
+
+/// The core settings of a handle as they were set, since the core does not expose them.
+/// The result cache keys on these; `extract_string_max_length` is in `ContentOptions`.
+#[derive(Clone, Default)]
+pub(crate) struct CoreSettings {
+    /// A `CHARSET_*` value.
+    pub(crate) encoding: Option<libc::c_int>,
+    pub(crate) xml_output: Option<bool>,
+    pub(crate) pdf: Option<PdfSettings>,
+    pub(crate) office: Option<OfficeSettings>,
+    pub(crate) ocr: Option<OcrSettings>,
+}
+
+/// One published configuration: the core extractor settings together with the content
+/// options, so an extraction reads both from the same setter state.
+pub(crate) struct Snapshot {
+    /// The core configuration as set.
+    configured: CoreExtractor,
+    /// `configured` switched to UTF-8 output, built once here rather than per call for
+    /// the normalization stages, which work on UTF-8 text whatever encoding was set, and
+    /// for the calls that always return UTF-8.
+    utf8: CoreExtractor,
+    pub(crate) settings: CoreSettings,
+    pub(crate) options: ContentOptions,
+}
+
+impl Snapshot {
+    /// A snapshot of `configured` with default settings and content options.
+    pub(crate) fn new(configured: CoreExtractor) -> Self {
+        Self::build(
+            configured,
+            CoreSettings::default(),
+            ContentOptions::default(),
+        )
+    }
+
+    fn build(configured: CoreExtractor, settings: CoreSettings, options: ContentOptions) -> Self {
+        let utf8 = configured.clone().set_encoding(CharSet::UTF_8);
+        Self {
+            configured,
+            utf8,
+            settings,
+            options,
+        }
+    }
+
+    /// The configuration with UTF-8 output.
+    pub(crate) fn utf8(&self) -> &CoreExtractor {
+        &self.utf8
+    }
+}
+
+impl Deref for Snapshot {
+    type Target = CoreExtractor;
+
+    /// The configuration extractions run with: UTF-8 output while normalization stages
+    /// are set, the configuration as set otherwise.
+    fn deref(&self) -> &CoreExtractor {
+        if self.options.normalize != 0 {
+            &self.utf8
+        } else {
+            &self.configured
+        }
+    }
+}
+
+impl SharedExtractor {
+    pub(crate) fn new(extractor: CoreExtractor) -> Self {
+        Self::from_snapshot(Arc::new(Snapshot::new(extractor)))
+    }
+
+    /// Creates a cell whose first snapshot is shared with other owners.
+    pub(crate) fn from_snapshot(snapshot: Arc<Snapshot>) -> Self {
+        Self {
+            current: AtomicPtr::new(Arc::into_raw(snapshot) as *mut Snapshot),
+            epoch: AtomicUsize::new(0),
+            readers: [AtomicUsize::new(0), AtomicUsize::new(0)],
+            writer: Mutex::new(()),
+            cache: Mutex::new(None),
+        }
+    }
+
+    /// Returns the attached result cache, if any.
+    pub(crate) fn cache(&self) -> Option<Arc<ResultCache>> {
+        self.cache.lock().unwrap_or_else(|e| e.into_inner()).clone()
+    }
+
+    /// Attaches `cache`, or detaches the current one when it is `None`.
+    pub(crate) fn set_cache(&self, cache: Option<Arc<ResultCache>>) {
+        *self.cache.lock().unwrap_or_else(|e| e.into_inner()) = cache;
+    }
+
+    /// Returns the current configuration snapshot.
+    pub(crate) fn load(&self) -> Arc<Snapshot> {
+        let readers = loop {
+            let epoch = self.epoch.load(Ordering::SeqCst);
+            let readers = &self.readers[epoch & 1];
+            readers.fetch_add(1, Ordering::SeqCst);
+            if self.epoch.load(Ordering::SeqCst) == epoch {
+                break readers;
+            }
+            // A writer flipped the epoch meanwhile and may already have seen this count
+            // drained; register in the new epoch instead.
+            readers.fetch_sub(1, Ordering::SeqCst);
+        };
+        let ptr = self.current.load(Ordering::SeqCst);
+        // Safe: a writer that replaced `ptr` after the load above waits for this reader's
+        // count to drain before releasing the cell's reference to it.
+        let snapshot = unsafe {
+            Arc::increment_strong_count(ptr);
+            Arc::from_raw(ptr)
+        };
+        readers.fetch_sub(1, Ordering::SeqCst);
+        snapshot
+    }
+
+    /// Publishes a new snapshot built from a copy of the current core configuration, with
+    /// the settings `f` records for it.
+    ///
+    /// Extractions already running keep the snapshot they started with.
+    pub(crate) fn update(&self, f: impl FnOnce(CoreExtractor, &mut CoreSettings) -> CoreExtractor) {
+        self.update_with(|extractor, settings, _| f(extractor, settings));
+    }
+
+    /// Publishes a new snapshot with changed content options.
+    pub(crate) fn update_options(&self, f: impl FnOnce(&mut ContentOptions)) {
+        self.update_with(|extractor, _, options| {
+            f(options);
+            extractor
+        });
+    }
+
+    /// Publishes a new snapshot built from copies of the core configuration, its settings
+    /// and the content options, for settings that live in more than one of them.
+    pub(crate) fn update_with(
+        &self,
+        f: impl FnOnce(CoreExtractor, &mut CoreSettings, &mut ContentOptions) -> CoreExtractor,
+    ) {
+        let _writer = self.writer.lock().unwrap_or_else(|e| e.into_inner());
+        let current = self.load();
+        let mut settings = current.settings.clone();
+        let mut options = current.options;
+        let configured = f(current.configured.clone(), &mut settings, &mut options);
+        self.publish(Arc::new(Snapshot::build(configured, settings, options)));
+    }
+
+    /// Replaces the current snapshot with `snapshot`, unless it already is that snapshot.
+    pub(crate) fn store(&self, snapshot: Arc<Snapshot>) {
+        let _writer = self.writer.lock().unwrap_or_else(|e| e.into_inner());
+        if !Arc::ptr_eq(&self.load(), &snapshot) {
+            self.publish(snapshot);
+        }
+    }
+
+    /// Swaps in `next`. Callers hold the writer lock.
+    fn publish(&self, next: Arc<Snapshot>) {
+        let next = Arc::into_raw(next) as *mut Snapshot;
+        let old = self.current.swap(next, Ordering::SeqCst);
+        // Grace period: wait out readers of the old epoch, which may have loaded `old`
+        // but not yet taken their reference. Each is a few instructions from leaving,
+        // and no new reader joins them once the epoch has moved on.
+        let epoch = self.epoch.fetch_add(1, Ordering::SeqCst);
+        while self.readers[epoch & 1].load(Ordering::SeqCst) != 0 {
+            std::hint::spin_loop();
+        }
+        unsafe { drop(Arc::from_raw(old)) };
+    }
+}
+
+impl Drop for SharedExtractor {
+    fn drop(&mut self) {
+        unsafe { drop(Arc::from_raw(*self.current.get_mut())) };
+    }
+}
+
+/// Returns the configuration snapshot an extraction of a non-NULL extractor handle runs
+/// with. It dereferences to the core configuration, switched to UTF-8 output while
+/// normalization stages are set, and carries the content options set with it.
+pub(crate) unsafe fn snapshot(handle: *const CExtractor) -> Arc<Snapshot> {
+    unsafe { &*(handle as *const SharedExtractor) }.load()
+}
@@ -0,0 +1,457 @@
+use crate::ecore::StreamReader as CoreStreamReader;
+use crate::errors::*;
+use crate::memory::current_rss_bytes;
+use crate::types::*;
+use std::cell::Cell;
+use std::collections::HashMap;
+use std::os::raw::c_int;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::time::Instant;
+
+/// Metadata key under which the PDF parser reports how many pages it sent to OCR.
+const OCR_PAGE_COUNT_KEY: &str = "pdf:ocrPageCount";
+
+/// Upper bounds of the call latency histogram buckets, in nanoseconds.
+/// The last bucket catches everything slower than the previous bound.
+const LATENCY_BOUNDS_NS: [u64; STATS_LATENCY_BUCKETS] = [
+    1_000_000,
+    5_000_000,
+    10_000_000,
+    50_000_000,
+    100_000_000,
+    500_000_000,
+    1_000_000_000,
+    5_000_000_000,
+    10_000_000_000,
+    30_000_000_000,
+    60_000_000_000,
+    u64::MAX,
+];
+
+/// Process-wide counters behind `extractous_stats_snapshot`.
+struct Stats {
+    calls: AtomicU64,
+    errors: AtomicU64,
+    errors_by_code: [AtomicU64; STATS_ERROR_CODE_SLOTS],
+    bytes_in: AtomicU64,
+    bytes_out: AtomicU64,
+    metadata_entries: AtomicU64,
+    ocr_pages: AtomicU64,
+    parse_ns: AtomicU64,
+    convert_ns: AtomicU64,
+    stream_reads: AtomicU64,
+    stream_read_ns: AtomicU64,
+    latency_buckets: [AtomicU64; STATS_LATENCY_BUCKETS],
+    cache_hits: AtomicU64,
+    cache_disk_hits: AtomicU64,
+    cache_misses: AtomicU64,
+}
+
+static ENABLED: AtomicBool = AtomicBool::new(false);
+
+static STATS: Stats = Stats {
+    calls: AtomicU64::new(0),
+    errors: AtomicU64::new(0),
+    errors_by_code: [const { AtomicU64::new(0) }; STATS_ERROR_CODE_SLOTS],
+    bytes_in: AtomicU64::new(0),
+    bytes_out: AtomicU64::new(0),
+    metadata_entries: AtomicU64::new(0),
+    ocr_pages: AtomicU64::new(0),
+    parse_ns: AtomicU64::new(0),
+    convert_ns: AtomicU64::new(0),
+    stream_reads: AtomicU64::new(0),
+    stream_read_ns: AtomicU64::new(0),
+    latency_buckets: [const { AtomicU64::new(0) }; STATS_LATENCY_BUCKETS],
+    cache_hits: AtomicU64::new(0),
+    cache_disk_hits: AtomicU64::new(0),
+    cache_misses: AtomicU64::new(0),
+};
+
+#[inline]
+fn enabled() -> bool {
+    ENABLED.load(Ordering::Relaxed)
+}
+
+#[inline]
+fn add(counter: &AtomicU64, n: u64) {
+    counter.fetch_add(n, Ordering::Relaxed);
+}
+
+fn elapsed_ns(since: Instant) -> u64 {
+    u64::try_from(since.elapsed().as_nanos()).unwrap_or(u64::MAX)
+}
+
+impl CExtractionStats {
+    pub(crate) const ZERO: Self = Self {
+        code: ERR_OK,
+        total_ns: 0,
+        parse_ns: 0,
+        convert_ns: 0,
+        cpu_ns: 0,
+        bytes_out: 0,
+        metadata_entries: 0,
+        ocr_pages: 0,
+        rss_bytes: 0,
+        rss_growth_bytes: 0,
+    };
+}
+
+thread_local! {
+    /// The accounting of the last call completed on this thread.
+    static LAST_CALL: Cell<CExtractionStats> = const { Cell::new(CExtractionStats::ZERO) };
+}
+
+/// CPU time consumed by the calling thread, in nanoseconds; 0 where unsupported.
+fn thread_cpu_ns() -> u64 {
+    #[cfg(unix)]
+    {
+        let mut ts = libc::timespec {
+            tv_sec: 0,
+            tv_nsec: 0,
+        };
+        if unsafe { libc::clock_gettime(libc::CLOCK_THREAD_CPUTIME_ID, &mut ts) } == 0 {
+            return (ts.tv_sec as u64)
+                .saturating_mul(1_000_000_000)
+                .saturating_add(ts.tv_nsec as u64);
+        }
+    }
+    0
+}
+
+/// The calling thread's CPU time and the process's RSS at one point in time.
+#[derive(Clone, Copy)]
+struct Usage {
+    cpu_ns: u64,
+    rss: u64,
+}
+
+impl Usage {
+    fn now() -> Self {
+        Self {
+            cpu_ns: thread_cpu_ns(),
+            rss: current_rss_bytes().unwrap_or(0),
+        }
+    }
+
+    /// Adds what was used since `self` to `record`.
+    fn charge(self, record: &mut CExtractionStats) {
+        let now = Usage::now();
+        record.cpu_ns += now.cpu_ns.saturating_sub(self.cpu_ns);
+        record.rss_growth_bytes += now.rss.saturating_sub(self.rss);
+        record.rss_bytes = now.rss;
+    }
+}
+
+/// Size in bytes of the content an extraction call returns directly.
+pub(crate) trait OutputSize {
+    fn output_size(&self) -> u64;
+}
+
+impl OutputSize for String {
+    fn output_size(&self) -> u64 {
+        self.len() as u64
+    }
+}
+
+impl OutputSize for CoreStreamReader {
+    /// Streamed bytes are counted as they are read.
+    fn output_size(&self) -> u64 {
+        0
+    }
+}
+
+/// Times one extraction call, adding it to the process-wide counters and recording its
+/// accounting for `extractous_stats_last_call`. Does nothing unless stats are enabled.
+pub(crate) struct CallTimer {
+    start: Option<(Instant, Usage)>,
+    parsed: Option<Instant>,
+    record: CExtractionStats,
+}
+
+impl CallTimer {
+    pub(crate) fn start() -> Self {
+        let start = enabled().then(|| (Instant::now(), Usage::now()));
+        if start.is_none() {
+            // Do not leave an earlier call's record behind for this one.
+            LAST_CALL.set(CExtractionStats::ZERO);
+        }
+        Self {
+            start,
+            parsed: None,
+            record: CExtractionStats::ZERO,
+        }
+    }
+
+    /// Marks the end of the core parse and records what it produced.
+    pub(crate) fn parsed(
+        &mut self,
+        output: &impl OutputSize,
+        metadata: &HashMap<String, Vec<String>>,
+    ) {
+        if let Some((start, _)) = self.start {
+            let record = &mut self.record;
+            record.parse_ns = elapsed_ns(start);
+            record.bytes_out = output.output_size();
+            record.metadata_entries = metadata.len() as u64;
+            record.ocr_pages = metadata
+                .get(OCR_PAGE_COUNT_KEY)
+                .and_then(|values| values.first())
+                .and_then(|value| value.trim().parse().ok())
+                .unwrap_or(0);
+            add(&STATS.parse_ns, record.parse_ns);
+            add(&STATS.bytes_out, record.bytes_out);
+            add(&STATS.metadata_entries, record.metadata_entries);
+            add(&STATS.ocr_pages, record.ocr_pages);
+            self.parsed = Some(Instant::now());
+        }
+    }
+
+    /// Records the end of a successful call, including FFI conversion time.
+    pub(crate) fn finish_ok(mut self) {
+        let Some((start, usage)) = self.start else {
+            return;
+        };
+        if let Some(parsed) = self.parsed {
+            self.record.convert_ns = elapsed_ns(parsed);
+            add(&STATS.convert_ns, self.record.convert_ns);
+        }
+        self.finish(start, usage);
+    }
+
+    /// Records the end of a failed call.
+    pub(crate) fn finish_err(mut self, code: c_int) {
+        let Some((start, usage)) = self.start else {
+            return;
+        };
+        record_error(code);
+        self.record.code = code;
+        self.finish(start, usage);
+    }
+
+    fn finish(mut self, start: Instant, usage: Usage) {
+        let total = elapsed_ns(start);
+        add(&STATS.calls, 1);
+        let bucket = LATENCY_BOUNDS_NS
+            .iter()
+            .position(|&b| total <= b)
+            .unwrap_or(0);
+        add(&STATS.latency_buckets[bucket], 1);
+
+        self.record.total_ns = total;
+        usage.charge(&mut self.record);
+        LAST_CALL.set(self.record);
+    }
+}
+
+/// Records an extraction error that happened outside a `CallTimer`, such as failing to
+/// map or read the input.
+pub(crate) fn record_error(code: c_int) {
+    if !enabled() {
+        return;
+    }
+    add(&STATS.errors, 1);
+    let slot = code.unsigned_abs() as usize;
+    if slot < STATS_ERROR_CODE_SLOTS {
+        add(&STATS.errors_by_code[slot], 1);
+    }
+}
+
+/// Records the size of an in-memory, mapped or callback-supplied input.
+pub(crate) fn record_input(len: usize) {
+    if enabled() {
+        add(&STATS.bytes_in, len as u64);
+    }
+}
+
+/// Records a result cache hit, from a disk tier if `disk` is set.
+pub(crate) fn record_cache_hit(disk: bool) {
+    if enabled() {
+        add(&STATS.cache_hits, 1);
+        if disk {
+            add(&STATS.cache_disk_hits, 1);
+        }
+    }
+}
+
+/// Records a result cache miss.
+pub(crate) fn record_cache_miss() {
+    if enabled() {
+        add(&STATS.cache_misses, 1);
+    }
+}
+
+/// The accounting of the reads made on one stream.
+///
+/// Wall-clock and CPU time are charged per read. RSS is sampled only at the stream's
+/// boundaries, its first accounted read and the end of its content or a failed read,
+/// and when the accounting is copied out, since on Linux each sample reads `/proc`.
+pub(crate) struct StreamUsage {
+    record: CExtractionStats,
+    /// RSS at the last sample, or `None` before the first one.
+    rss: Option<u64>,
+}
+
+impl StreamUsage {
+    pub(crate) const fn new() -> Self {
+        Self {
+            record: CExtractionStats::ZERO,
+            rss: None,
+        }
+    }
+
+    fn sample_rss(&mut self) {
+        if let Some(now) = current_rss_bytes() {
+            if let Some(last) = self.rss {
+                self.record.rss_growth_bytes += now.saturating_sub(last);
+            }
+            self.record.rss_bytes = now;
+            self.rss = Some(now);
+        }
+    }
+
+    /// The accounting so far, with RSS as of now.
+    pub(crate) fn snapshot(&self) -> CExtractionStats {
+        let mut record = self.record;
+        if enabled()
+            && let Some(last) = self.rss
+            && let Some(now) = current_rss_bytes()
+        {
+            record.rss_growth_bytes += now.saturating_sub(last);
+            record.rss_bytes = now;
+        }
+        record
+    }
+}
+
+/// Runs one read against the core stream reader and records its time and size, in the
+/// process-wide counters and in the stream's own `usage`.
+pub(crate) fn timed_read(
+    usage: &mut StreamUsage,
+    read: impl FnOnce() -> std::io::Result<usize>,
+) -> std::io::Result<usize> {
+    if !enabled() {
+        return read();
+    }
+    if usage.rss.is_none() {
+        usage.sample_rss();
+    }
+    let start = Instant::now();
+    let cpu = thread_cpu_ns();
+    let result = read();
+    let ns = elapsed_ns(start);
+    add(&STATS.stream_reads, 1);
+    add(&STATS.stream_read_ns, ns);
+    let record = &mut usage.record;
+    record.total_ns += ns;
+    record.parse_ns += ns;
+    record.cpu_ns += thread_cpu_ns().saturating_sub(cpu);
+    match result {
+        Ok(0) => usage.sample_rss(),
+        Ok(n) => {
+            add(&STATS.bytes_out, n as u64);
+            record.bytes_out += n as u64;
+        }
+        Err(ref e) => {
+            record.code = crate::cancel::io_error_to_code(e);
+            usage.sample_rss();
+        }
+    }
+    result
+}
+
+/// Turns statistics collection on or off.
+///
+/// Collection is off by default. While off, instrumented calls only pay for one relaxed
+/// atomic load. Counters keep their values while collection is off.
+#[unsafe(no_mangle)]
+pub extern "C" fn extractous_stats_enable(enabled: bool) {
+    ENABLED.store(enabled, Ordering::Relaxed);
+}
+
+/// Resets all counters to zero.
+#[unsafe(no_mangle)]
+pub extern "C" fn extractous_stats_reset() {
+    let counters = [
+        &STATS.calls,
+        &STATS.errors,
+        &STATS.bytes_in,
+        &STATS.bytes_out,
+        &STATS.metadata_entries,
+        &STATS.ocr_pages,
+        &STATS.parse_ns,
+        &STATS.convert_ns,
+        &STATS.stream_reads,
+        &STATS.stream_read_ns,
+        &STATS.cache_hits,
+        &STATS.cache_disk_hits,
+        &STATS.cache_misses,
+    ];
+    for counter in counters
+        .into_iter()
+        .chain(&STATS.errors_by_code)
+        .chain(&STATS.latency_buckets)
+    {
+        counter.store(0, Ordering::Relaxed);
+    }
+}
+
+/// Copies the accounting of the last extraction call completed on the calling thread
+/// into `out`, successful or not.
+///
+/// This covers the synchronous extraction entry points and async jobs: a job's
+/// completion callback runs on the worker thread right after the job, so it can read
+/// the job's record with this function. Batch items run on the batch's own threads and
+/// are only counted in `extractous_stats_snapshot`.
+/// Calls are only measured while statistics collection is enabled: for a call made while
+/// it is off, before the first call and after `extractous_stats_last_call_reset`, every
+/// field is 0. For streams, the record covers the call that created the stream; see
+/// `extractous_stream_get_stats` for the reads made on it.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stats_last_call(out: *mut CExtractionStats) -> c_int {
+    if out.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    unsafe { out.write(LAST_CALL.get()) };
+    ERR_OK
+}
+
+/// Clears the calling thread's record of its last extraction call, so that a call which
+/// returns before it is measured, such as one given a NULL pointer, reads as all zeros
+/// from `extractous_stats_last_call` instead of as the call before it.
+#[unsafe(no_mangle)]
+pub extern "C" fn extractous_stats_last_call_reset() {
+    LAST_CALL.set(CExtractionStats::ZERO);
+}
+
+/// Copies the current counters into `out`.
+///
+/// Each counter is read atomically, but the snapshot as a whole is not: calls that finish
+/// while it is taken may be only partly included.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stats_snapshot(out: *mut CStats) -> c_int {
+    if out.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let load = |c: &AtomicU64| c.load(Ordering::Relaxed);
+    let stats = CStats {
+        enabled: enabled(),
+        calls: load(&STATS.calls),
+        errors: load(&STATS.errors),
+        errors_by_code: STATS.errors_by_code.each_ref().map(load),
+        bytes_in: load(&STATS.bytes_in),
+        bytes_out: load(&STATS.bytes_out),
+        metadata_entries: load(&STATS.metadata_entries),
+        ocr_pages: load(&STATS.ocr_pages),
+        parse_ns: load(&STATS.parse_ns),
+        convert_ns: load(&STATS.convert_ns),
+        stream_reads: load(&STATS.stream_reads),
+        stream_read_ns: load(&STATS.stream_read_ns),
+        latency_bounds_ns: LATENCY_BOUNDS_NS,
+        latency_buckets: STATS.latency_buckets.each_ref().map(load),
+        cache_hits: load(&STATS.cache_hits),
+        cache_disk_hits: load(&STATS.cache_disk_hits),
+        cache_misses: load(&STATS.cache_misses),
+    };
+    unsafe { out.write(stats) };
+    ERR_OK
+}
@@ -1,7 +1,361 @@
+use crate::cancel::{self, CancelToken, Cancelled};
+use crate::chunks::Chunker;
 use crate::ecore::StreamReader as CoreStreamReader;
 use crate::errors::*;
+use crate::events::EventParser;
+use crate::memory::{MemoryGuard, OutOfMemory, read_to_end_fallible};
+use crate::normalize::Normalizer;
+use crate::shared::ContentOptions;
+use crate::stats::{self, StreamUsage};
 use crate::types::*;
 use std::io::Read;
+use std::sync::Arc;
+
+/// Calls a caller-supplied release callback when dropped.
+///
+/// Used as the source of a stream that reads from borrowed memory, so the caller is told
+/// when the buffer may be reused: after the stream is freed, or as soon as extraction fails.
+pub(crate) struct ReleaseGuard {
+    release: ExtractousReleaseFn,
+    user_data: *mut libc::c_void,
+}
+
+// The callback contract requires it to be callable from any thread.
+unsafe impl Send for ReleaseGuard {}
+
+impl ReleaseGuard {
+    pub(crate) fn new(release: ExtractousReleaseFn, user_data: *mut libc::c_void) -> Self {
+        Self { release, user_data }
+    }
+}
+
+impl Drop for ReleaseGuard {
+    fn drop(&mut self) {
+        if let Some(release) = self.release {
+            unsafe { release(self.user_data) };
+        }
+    }
+}
+
+/// The state behind a `CStreamReader` handle.
+///
+/// Small reads are served from a read-ahead buffer so that each one does not cross into
+/// the core reader (and through it, the JNI bridge). Reads at least as large as the
+/// buffer bypass it.
+///
+/// With a cancel token attached, every read first checks the token. Once it fires, the
+/// core reader is dropped, which stops the parse behind it and frees its memory, and
+/// this and every later read fail with `Cancelled`.
+///
+/// With a content budget, the stream ends once that many bytes have been handed out, and
+/// the core reader is dropped at that point, so the rest of the document is never parsed.
+///
+/// With a memory limit, the limit is checked after every read from the core reader. Once
+/// it is exceeded, the core reader is dropped as on cancellation, and this and every later
+/// read fail with `OutOfMemory`.
+///
+/// With normalization stages, reads are served from normalized content produced one
+/// read-ahead block at a time; the content budget counts normalized bytes.
+pub(crate) struct StreamState {
+    /// `None` once the stream has been cancelled.
+    reader: Option<CoreStreamReader>,
+    /// Read-ahead bytes; `buffer[pos..filled]` has not been handed out yet.
+    /// Allocated on first use, so streams that only see large reads never pay for it.
+    buffer: Vec<u8>,
+    pos: usize,
+    filled: usize,
+    /// Configured read-ahead size; 0 disables buffering.
+    capacity: usize,
+    cancel: Option<Arc<CancelToken>>,
+    /// Bytes still allowed under the content budget; `None` when there is no budget.
+    remaining: Option<u64>,
+    /// `None` when there is no memory limit.
+    memory: Option<MemoryGuard>,
+    /// `None` when there are no normalization stages.
+    normalized: Option<Box<Normalized>>,
+    /// Created by the first `extractous_stream_next_event` call.
+    events: Option<Box<EventParser>>,
+    /// Created by the first `extractous_stream_next_chunk` call.
+    chunks: Option<Box<Chunker>>,
+    /// Accounting of the reads made against the core reader, while stats are enabled.
+    usage: StreamUsage,
+    /// Input the parser may still be reading from, such as a file mapping.
+    /// Declared after `reader` so that it is dropped last.
+    _source: Option<Box<dyn Send>>,
+}
+
+/// Normalized content waiting to be handed out, and the raw content it is made from.
+struct Normalized {
+    normalizer: Normalizer,
+    /// Raw content is read into this, at least as large as the read-ahead buffer so that
+    /// reads bypass it.
+    raw: Vec<u8>,
+    /// `pending[pos..]` has not been handed out yet.
+    pending: Vec<u8>,
+    pos: usize,
+    /// Whether the raw content has ended and the normalizer has been finished.
+    finished: bool,
+}
+
+/// Reads once from the core reader, or fails if the stream has been cancelled.
+fn read_core(
+    reader: &mut Option<CoreStreamReader>,
+    usage: &mut StreamUsage,
+    buf: &mut [u8],
+) -> std::io::Result<usize> {
+    match reader {
+        Some(reader) => stats::timed_read(usage, || reader.read(buf)),
+        None => Err(Cancelled::io_error()),
+    }
+}
+
+impl StreamState {
+    pub(crate) fn new(reader: CoreStreamReader, source: Option<Box<dyn Send>>) -> Self {
+        Self {
+            reader: Some(reader),
+            buffer: Vec::new(),
+            pos: 0,
+            filled: 0,
+            capacity: STREAM_DEFAULT_BUFFER_SIZE,
+            cancel: None,
+            remaining: None,
+            memory: None,
+            normalized: None,
+            events: None,
+            chunks: None,
+            usage: StreamUsage::new(),
+            _source: source,
+        }
+    }
+
+    pub(crate) fn set_cancel(&mut self, token: Option<Arc<CancelToken>>) {
+        self.cancel = token;
+    }
+
+    /// Ends the stream after `max_bytes` more bytes; 0 leaves it unbounded.
+    pub(crate) fn set_budget(&mut self, max_bytes: u64) {
+        self.remaining = (max_bytes > 0).then_some(max_bytes);
+    }
+
+    /// Lowers the content budget to at most `max_bytes`; 0 ends the stream at once.
+    pub(crate) fn limit_budget(&mut self, max_bytes: u64) {
+        self.remaining = Some(self.remaining.map_or(max_bytes, |r| r.min(max_bytes)));
+    }
+
+    /// Applies an extractor's content options, counting memory use from now.
+    pub(crate) fn set_content_options(&mut self, options: ContentOptions) {
+        self.set_budget(options.content_budget);
+        self.memory = MemoryGuard::new(options.memory_limit);
+        self.normalized = Normalizer::new(options.normalize).map(|normalizer| {
+            Box::new(Normalized {
+                normalizer,
+                raw: Vec::new(),
+                pending: Vec::new(),
+                pos: 0,
+                finished: false,
+            })
+        });
+    }
+
+    /// The memory limit in bytes, or 0 when there is none.
+    pub(crate) fn memory_limit(&self) -> u64 {
+        self.memory.as_ref().map_or(0, MemoryGuard::max_bytes)
+    }
+
+    /// Whether the stream ended because its content budget was spent.
+    pub(crate) fn budget_spent(&self) -> bool {
+        self.remaining == Some(0)
+    }
+
+    /// Whether the next read is served from bytes already buffered, without reading from
+    /// the core.
+    fn has_buffered(&self) -> bool {
+        self.remaining == Some(0)
+            || self.pos < self.filled
+            || self
+                .normalized
+                .as_ref()
+                .is_some_and(|n| n.pos < n.pending.len() || n.finished)
+    }
+
+    /// Drops the core reader and any buffered bytes.
+    fn release_reader(&mut self) {
+        self.reader = None;
+        self.buffer = Vec::new();
+        self.pos = 0;
+        self.filled = 0;
+    }
+
+    /// Checks the cancel token, dropping the core reader and any buffered bytes the
+    /// first time it is found cancelled.
+    fn check_cancelled(&mut self) -> std::io::Result<()> {
+        if self.cancel.as_ref().is_some_and(|t| t.is_cancelled()) && self.reader.is_some() {
+            self.release_reader();
+        }
+        if self.reader.is_none() {
+            return Err(Cancelled::io_error());
+        }
+        Ok(())
+    }
+
+    /// Checks the memory limit, dropping the core reader and any buffered bytes the first
+    /// time it is found exceeded.
+    fn check_memory(&mut self) -> std::io::Result<()> {
+        if let Some(memory) = &mut self.memory
+            && let Err(e) = memory.check()
+        {
+            self.release_reader();
+            return Err(e);
+        }
+        Ok(())
+    }
+
+    /// Refills the read-ahead buffer. Only called once it has been drained.
+    fn fill(&mut self) -> std::io::Result<()> {
+        if self.buffer.len() != self.capacity {
+            self.buffer.resize(self.capacity, 0);
+            self.buffer.shrink_to_fit();
+        }
+        self.pos = 0;
+        self.filled = 0;
+        self.filled = loop {
+            match read_core(&mut self.reader, &mut self.usage, &mut self.buffer) {
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => continue,
+                result => break result?,
+            }
+        };
+        Ok(())
+    }
+
+    /// Changes the read-ahead size without discarding bytes that are already buffered.
+    fn set_capacity(&mut self, capacity: usize) {
+        if self.pos > 0 {
+            self.buffer.copy_within(self.pos..self.filled, 0);
+            self.filled -= self.pos;
+            self.pos = 0;
+        }
+        if self.filled == 0 && capacity == 0 {
+            self.buffer = Vec::new();
+        }
+        self.capacity = capacity;
+    }
+
+    /// Serves one read, from the read-ahead buffer when it is enabled.
+    fn read_buffered(&mut self, out: &mut [u8]) -> std::io::Result<usize> {
+        if self.memory.as_ref().is_some_and(MemoryGuard::exceeded) {
+            return Err(OutOfMemory::io_error());
+        }
+        if self.cancel.is_some() {
+            self.check_cancelled()?;
+        }
+        if self.pos == self.filled {
+            if out.len() >= self.capacity {
+                let n = read_core(&mut self.reader, &mut self.usage, out)?;
+                self.check_memory()?;
+                return Ok(n);
+            }
+            self.fill()?;
+            self.check_memory()?;
+        }
+        let n = out.len().min(self.filled - self.pos);
+        out[..n].copy_from_slice(&self.buffer[self.pos..self.pos + n]);
+        self.pos += n;
+        Ok(n)
+    }
+
+    /// Serves one read of normalized content, or a plain read when there are no stages.
+    fn read_normalized(&mut self, out: &mut [u8]) -> std::io::Result<usize> {
+        let Some(mut normalized) = self.normalized.take() else {
+            return self.read_buffered(out);
+        };
+        let result = loop {
+            let n = &mut *normalized;
+            if n.pos < n.pending.len() || n.finished || out.is_empty() {
+                let len = out.len().min(n.pending.len() - n.pos);
+                out[..len].copy_from_slice(&n.pending[n.pos..n.pos + len]);
+                n.pos += len;
+                break Ok(len);
+            }
+            let raw_len = self.capacity.max(STREAM_DEFAULT_BUFFER_SIZE);
+            if n.raw.len() < raw_len {
+                n.raw.resize(raw_len, 0);
+            }
+            let read = match self.read_buffered(&mut n.raw) {
+                Ok(read) => read,
+                Err(e) => break Err(e),
+            };
+            n.pending.clear();
+            n.pos = 0;
+            if read == 0 {
+                n.normalizer.finish(&mut n.pending);
+                n.finished = true;
+            } else {
+                n.normalizer.push(&n.raw[..read], &mut n.pending);
+            }
+        };
+        self.normalized = Some(normalized);
+        result
+    }
+}
+
+impl Read for StreamState {
+    fn read(&mut self, out: &mut [u8]) -> std::io::Result<usize> {
+        let Some(remaining) = self.remaining else {
+            return self.read_normalized(out);
+        };
+        if remaining == 0 {
+            return Ok(0);
+        }
+        let len = out
+            .len()
+            .min(usize::try_from(remaining).unwrap_or(usize::MAX));
+        let n = self.read_normalized(&mut out[..len])?;
+        let remaining = remaining - n as u64;
+        self.remaining = Some(remaining);
+        if remaining == 0 {
+            // Budget spent: stop the parse now rather than when the stream is freed.
+            self.release_reader();
+        }
+        Ok(n)
+    }
+}
+
+/// Boxes a core stream reader into a `CStreamReader` handle, keeping `source` alive
+/// until the handle is freed with `extractous_stream_free`. The stream applies the
+/// content budget, memory limit and normalization in `options`.
+pub(crate) fn stream_to_c(
+    reader: CoreStreamReader,
+    source: Option<Box<dyn Send>>,
+    options: ContentOptions,
+) -> *mut CStreamReader {
+    let mut stream = StreamState::new(reader, source);
+    stream.set_content_options(options);
+    Box::into_raw(Box::new(stream)) as *mut CStreamReader
+}
+
+/// Reads until `buf` is full or the end of the stream is reached, returning the number
+/// of bytes read. A count shorter than `buf` means the end of the stream was reached.
+fn read_full(reader: &mut StreamState, buf: &mut [u8]) -> std::io::Result<usize> {
+    let mut total_bytes_read = 0;
+    while total_bytes_read < buf.len() {
+        // In each loop, we try to read into the remaining part of the buffer
+        match reader.read(&mut buf[total_bytes_read..]) {
+            Ok(0) => {
+                // `read` returned 0, which signifies the end of the stream
+                break;
+            }
+            Ok(n) => {
+                total_bytes_read += n;
+            }
+            Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {
+                // The read was interrupted by a signal. This is recoverable so we just continue
+                continue;
+            }
+            Err(e) => return Err(e),
+        }
+    }
+    Ok(total_bytes_read)
+}
 
 /// Reads data from a stream into a user-provided buffer.
 ///
@@ -24,7 +378,7 @@ pub unsafe extern "C" fn extractous_stream_read(
         return ERR_OK;
     }
 
-    let reader = unsafe { &mut *(handle as *mut CoreStreamReader) };
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
     let buf_slice = unsafe { std::slice::from_raw_parts_mut(buffer, buffer_size) };
 
     match reader.read(buf_slice) {
@@ -34,7 +388,7 @@ pub unsafe extern "C" fn extractous_stream_read(
             }
             ERR_OK
         }
-        Err(_) => ERR_IO_ERROR,
+        Err(e) => cancel::io_error_to_code(&e),
     }
 }
 
@@ -58,36 +412,232 @@ pub unsafe extern "C" fn extractous_stream_read_exact(
 
     unsafe { *bytes_read = 0 };
 
-    let reader = unsafe { &mut *(handle as *mut CoreStreamReader) };
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
     // slice representing the user-provided buffer
     let total_buf_slice = unsafe { std::slice::from_raw_parts_mut(buffer, buffer_size) };
 
-    let mut total_bytes_read = 0;
-    while total_bytes_read < buffer_size {
-        // In each loop, we try to read into the remaining part of the buffer
-        let remaining_buf = &mut total_buf_slice[total_bytes_read..];
+    match read_full(reader, total_buf_slice) {
+        Ok(n) => {
+            unsafe { *bytes_read = n };
+            ERR_OK
+        }
+        // A non-recoverable I/O error occurred, or the stream was cancelled.
+        Err(e) => cancel::io_error_to_code(&e),
+    }
+}
 
-        match reader.read(remaining_buf) {
-            Ok(0) => {
-                // `read` returned 0, which signifies the end of the stream
-                // We break the loop and will return the total bytes we've read
-                break;
-            }
-            Ok(n) => {
-                total_bytes_read += n;
-            }
-            Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {
-                // The read was interrupted by a signal. This is recoverable so we just continue
-                continue;
+/// Reads into several caller buffers with one call, in order, like POSIX `readv`.
+///
+/// The call reads from the core at most once: it blocks until some content is available,
+/// then fills the buffers with that content and whatever is already buffered, returning
+/// early rather than waiting for more. The total number of bytes read is returned via
+/// `bytes_read`, also when an I/O error interrupts the call. A total of 0 with `ERR_OK`
+/// means the end of the stream was reached; a short total does not. Buffers with a length
+/// of 0 may be NULL.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stream_read_into_iov(
+    handle: *mut CStreamReader,
+    iov: *const CIoVec,
+    iovcnt: libc::size_t,
+    bytes_read: *mut libc::size_t,
+) -> libc::c_int {
+    if handle.is_null() || bytes_read.is_null() || (iov.is_null() && iovcnt > 0) {
+        return ERR_NULL_POINTER;
+    }
+    unsafe { *bytes_read = 0 };
+    if iovcnt == 0 {
+        return ERR_OK;
+    }
+
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
+    let iovs = unsafe { std::slice::from_raw_parts(iov, iovcnt) };
+    if iovs.iter().any(|v| v.base.is_null() && v.len > 0) {
+        return ERR_NULL_POINTER;
+    }
+
+    let mut total = 0;
+    for v in iovs.iter().filter(|v| v.len > 0) {
+        let buf = unsafe { std::slice::from_raw_parts_mut(v.base, v.len) };
+        let mut filled = 0;
+        // The first read may reach the core; later ones only drain what is buffered.
+        while filled < buf.len() && (total + filled == 0 || reader.has_buffered()) {
+            match reader.read(&mut buf[filled..]) {
+                Ok(0) => break,
+                Ok(n) => filled += n,
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => continue,
+                Err(e) => {
+                    unsafe { *bytes_read = total + filled };
+                    return cancel::io_error_to_code(&e);
+                }
             }
-            Err(_) => {
-                // A non-recoverable I/O error occurred.
-                return ERR_IO_ERROR;
+        }
+        total += filled;
+        if filled < buf.len() {
+            break;
+        }
+    }
+
+    unsafe { *bytes_read = total };
+    ERR_OK
+}
+
+/// Returns the next structural event of the stream: the start and end of pages, slides
+/// and sheets, sheet names, the boundaries of embedded documents, and runs of text.
+///
+/// Events come from the XHTML the core produces with
+/// `extractous_extractor_set_xml_output_mut(handle, true)`, which is tokenized as it is
+/// read, in one pass: the markup is not returned, and character references in text are
+/// decoded. A stream of plain text yields text events only. Text runs hold whole UTF-8
+/// characters and never span a page boundary. Whitespace between XHTML tags is dropped.
+///
+/// The end of the stream is reported as a `STREAM_EVENT_END` event with `ERR_OK`. The
+/// event's `data` is owned by the stream and valid until the next call on it or until it
+/// is freed. Do not mix this with the `extractous_stream_read*` functions on one stream:
+/// events are parsed from input read ahead of them.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stream_next_event(
+    handle: *mut CStreamReader,
+    out_event: *mut CStreamEvent,
+) -> libc::c_int {
+    if handle.is_null() || out_event.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let out = unsafe { &mut *out_event };
+    *out = CStreamEvent {
+        kind: STREAM_EVENT_END,
+        index: 0,
+        data: std::ptr::null(),
+        len: 0,
+    };
+
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
+    let mut parser = reader.events.take().unwrap_or_default();
+    let code = match parser.next(reader) {
+        Ok(event) => {
+            out.kind = event.kind;
+            out.index = event.index;
+            if !event.data.is_empty() {
+                out.data = event.data.as_ptr();
+                out.len = event.data.len();
             }
+            ERR_OK
         }
+        Err(e) => cancel::io_error_to_code(&e),
+    };
+    reader.events = Some(parser);
+    code
+}
+
+/// Returns the next chunk of the stream's content, for splitting documents into
+/// overlapping segments, such as for embedding, as they are extracted.
+///
+/// Each chunk holds at most `max_bytes` bytes and starts with up to `overlap` bytes from
+/// the end of the one before it. Chunks end after the last paragraph break, sentence end,
+/// line break or space in their second half, in that order of preference, or else on a
+/// UTF-8 character boundary; overlaps start at a word where they can. The stream is read
+/// only as far as the current chunk, so chunks arrive while the document is still being
+/// parsed, and memory stays bounded by `max_bytes`. Normalization and the content budget
+/// apply to the content as for other reads.
+///
+/// The end of the stream is reported as a chunk with NULL `data` and `len` 0, with
+/// `ERR_OK`. The chunk's `data` is owned by the stream and valid until the next call on it
+/// or until it is freed. `max_bytes` and `overlap` may change between calls. Returns
+/// `ERR_INVALID_CONFIG` if `max_bytes` is below 4, the longest UTF-8 character, or if
+/// `overlap` is not below `max_bytes`. Do not mix this with the other
+/// `extractous_stream_read*` and event functions on one stream: content past the
+/// current chunk is read ahead.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stream_next_chunk(
+    handle: *mut CStreamReader,
+    max_bytes: libc::size_t,
+    overlap: libc::size_t,
+    out_chunk: *mut CStreamChunk,
+) -> libc::c_int {
+    if handle.is_null() || out_chunk.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let out = unsafe { &mut *out_chunk };
+    *out = CStreamChunk {
+        data: std::ptr::null(),
+        len: 0,
+        offset: 0,
+    };
+    if max_bytes < 4 || overlap >= max_bytes {
+        return ERR_INVALID_CONFIG;
+    }
+
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
+    let mut chunker = reader.chunks.take().unwrap_or_default();
+    let code = match chunker.next(reader, max_bytes, overlap) {
+        Ok(Some((offset, data))) => {
+            out.data = data.as_ptr();
+            out.len = data.len();
+            out.offset = offset;
+            ERR_OK
+        }
+        Ok(None) => ERR_OK,
+        Err(e) => cancel::io_error_to_code(&e),
+    };
+    reader.chunks = Some(chunker);
+    code
+}
+
+/// Sets the size of the stream's read-ahead buffer.
+///
+/// Reads smaller than this are served from the buffer, which is refilled with one large
+/// read from the parser; larger reads bypass it. A size of 0 disables read-ahead.
+/// Already buffered bytes are never discarded. Defaults to `STREAM_DEFAULT_BUFFER_SIZE`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stream_set_buffer_size(
+    handle: *mut CStreamReader,
+    size: libc::size_t,
+) -> libc::c_int {
+    if handle.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
+    reader.set_capacity(size);
+    ERR_OK
+}
+
+/// Attaches a cancel token to the stream, replacing any earlier one; NULL detaches it.
+///
+/// Once the token is cancelled or its deadline passes, the next read of any kind
+/// returns `ERR_CANCELLED`, as does every read after it. The parse behind the stream is
+/// stopped and its memory released at that point, without waiting for
+/// `extractous_stream_free`. Cancellation is observed between reads: a single read that
+/// is blocked inside the parser returns when the parser next produces output.
+/// The stream keeps its own reference, so the token handle may be freed afterwards.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stream_set_cancel_token(
+    handle: *mut CStreamReader,
+    token: *const CCancelToken,
+) -> libc::c_int {
+    if handle.is_null() {
+        return ERR_NULL_POINTER;
     }
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
+    reader.set_cancel(unsafe { cancel::token_from_c(token) });
+    ERR_OK
+}
 
-    unsafe { *bytes_read = total_bytes_read };
+/// Copies the accounting of the reads made on the stream so far into `out`.
+///
+/// Streamed content is parsed while it is read, so this is where the cost of a streamed
+/// extraction shows up; the call that created the stream is covered by
+/// `extractous_stats_last_call`. Reads served from the read-ahead buffer cost nothing
+/// here. `convert_ns` and `metadata_entries` are always 0, and `code` is that of the
+/// last failed read. Reads are only accounted while statistics collection is enabled.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stream_get_stats(
+    handle: *const CStreamReader,
+    out: *mut CExtractionStats,
+) -> libc::c_int {
+    if handle.is_null() || out.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    let reader = unsafe { &*(handle as *const StreamState) };
+    unsafe { out.write(reader.usage.snapshot()) };
     ERR_OK
 }
 
@@ -103,10 +653,11 @@ pub unsafe extern "C" fn extractous_stream_read_all(
         return ERR_NULL_POINTER;
     }
 
-    let reader = unsafe { &mut *(handle as *mut CoreStreamReader) };
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
     let mut data_vec = Vec::new();
 
-    match reader.read_to_end(&mut data_vec) {
+    let max_bytes = reader.memory_limit();
+    match read_to_end_fallible(reader, &mut data_vec, max_bytes) {
         Ok(_) => {
             data_vec.shrink_to_fit();
 
@@ -118,11 +669,67 @@ pub unsafe extern "C" fn extractous_stream_read_all(
             unsafe { *out_size = size };
             ERR_OK
         }
-        Err(_) => ERR_IO_ERROR,
+        Err(e) => cancel::io_error_to_code(&e),
+    }
+}
+
+/// Size of the intermediate buffer used by `extractous_stream_copy_to_fd`.
+const COPY_CHUNK: usize = 256 * 1024;
+
+/// Copies the rest of the stream to a file descriptor without returning to the caller.
+///
+/// The read/write loop runs entirely inside the library with a large buffer, so the
+/// extracted text never passes through caller memory. Writes are retried until complete.
+/// The number of bytes written is returned via `bytes_written`, also on failure. The
+/// descriptor is not closed. Write failures are reported as `ERR_IO_ERROR` and recorded
+/// for `extractous_error_get_last_debug`.
+///
+/// Only POSIX file descriptors are supported; on Windows this returns `ERR_IO_ERROR`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_stream_copy_to_fd(
+    handle: *mut CStreamReader,
+    fd: libc::c_int,
+    bytes_written: *mut libc::size_t,
+) -> libc::c_int {
+    if handle.is_null() || bytes_written.is_null() {
+        return ERR_NULL_POINTER;
+    }
+    unsafe { *bytes_written = 0 };
+    let reader = unsafe { &mut *(handle as *mut StreamState) };
+
+    #[cfg(unix)]
+    {
+        use std::io::Write;
+        use std::os::unix::io::FromRawFd;
+
+        // Borrow the descriptor; ManuallyDrop keeps it open when `file` goes out of scope.
+        let mut file = std::mem::ManuallyDrop::new(unsafe { std::fs::File::from_raw_fd(fd) });
+        let mut buf = vec![0u8; COPY_CHUNK.max(reader.capacity)];
+        loop {
+            let n = match reader.read(&mut buf) {
+                Ok(0) => return ERR_OK,
+                Ok(n) => n,
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => continue,
+                Err(e) => return cancel::io_error_to_code(&e),
+            };
+            if let Err(e) = file.write_all(&buf[..n]) {
+                set_last_error(e);
+                return ERR_IO_ERROR;
+            }
+            unsafe { *bytes_written += n };
+        }
+    }
+
+    #[cfg(not(unix))]
+    {
+        let _ = (reader, fd);
+        set_last_error(std::io::Error::from(std::io::ErrorKind::Unsupported));
+        ERR_IO_ERROR
     }
 }
 
-/// Frees a buffer allocated by `extractous_stream_read_all`.
+/// Frees a buffer allocated by `extractous_stream_read_all` or one of the
+/// `extractous_extractor_extract_*_to_buffer` functions.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn extractous_buffer_free(buffer: *mut u8, size: libc::size_t) {
     if buffer.is_null() || size == 0 {
@@ -136,6 +743,6 @@ pub unsafe extern "C" fn extractous_buffer_free(buffer: *mut u8, size: libc::siz
 pub unsafe extern "C" fn extractous_stream_free(handle: *mut CStreamReader) {
     if !handle.is_null() {
         // Reconstruct the Box and let Rust's drop handler deallocate it.
-        let _ = unsafe { Box::from_raw(handle as *mut CoreStreamReader) };
+        let _ = unsafe { Box::from_raw(handle as *mut StreamState) };
     }
 }
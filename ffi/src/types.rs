@@ -9,6 +9,22 @@ pub struct CStreamReader {
     _private: [u8; 0],
 }
 #[repr(C)]
+pub struct CAsyncJob {
+    _private: [u8; 0],
+}
+#[repr(C)]
+pub struct CCancelToken {
+    _private: [u8; 0],
+}
+#[repr(C)]
+pub struct CExtractorPool {
+    _private: [u8; 0],
+}
+#[repr(C)]
+pub struct CResultCache {
+    _private: [u8; 0],
+}
+#[repr(C)]
 pub struct CPdfParserConfig {
     _private: [u8; 0],
 }
@@ -31,6 +47,30 @@ pub struct CMetadata {
     pub len: libc::size_t,
 }
 
+/// Metadata packed into a single allocation: this header, three offset tables and one
+/// contiguous arena of key/value bytes. Freed with one call to `extractous_metadata_packed_free`.
+///
+/// Multi-valued entries are preserved: key `i` spans `key_offsets[i]..key_offsets[i+1]` in
+/// `data` and owns values `value_starts[i]..value_starts[i+1]` of the value table, where
+/// value `j` spans `value_offsets[j]..value_offsets[j+1]` in `data`.
+#[repr(C)]
+pub struct CMetadataPacked {
+    /// The number of keys
+    pub len: libc::size_t,
+    /// The total number of values across all keys
+    pub value_count: libc::size_t,
+    /// The total number of bytes in `data`
+    pub data_len: libc::size_t,
+    /// `len + 1` byte offsets of the keys in `data`
+    pub key_offsets: *const libc::size_t,
+    /// `len + 1` indices into the value table; key `i` has `value_starts[i+1] - value_starts[i]` values
+    pub value_starts: *const libc::size_t,
+    /// `value_count + 1` byte offsets of the values in `data`
+    pub value_offsets: *const libc::size_t,
+    /// UTF-8 key and value bytes back to back, without separators or null terminators
+    pub data: *const u8,
+}
+
 pub const CHARSET_UTF_8: c_int = 0;
 pub const CHARSET_US_ASCII: c_int = 1;
 pub const CHARSET_UTF_16BE: c_int = 3;
@@ -39,3 +79,257 @@ pub const PDF_OCR_STRATEGY_NO_OCR: c_int = 0;
 pub const PDF_OCR_STRATEGY_OCR_ONLY: c_int = 1;
 pub const PDF_OCR_STRATEGY_OCR_AND_TEXT_EXTRACTION: c_int = 2;
 pub const PDF_OCR_STRATEGY_AUTO: c_int = 3;
+
+/// Default size of a stream's read-ahead buffer, in bytes.
+pub const STREAM_DEFAULT_BUFFER_SIZE: libc::size_t = 64 * 1024;
+
+/// `CStreamEvent` kind: the end of the stream. Every later call returns it again.
+pub const STREAM_EVENT_END: c_int = 0;
+/// `CStreamEvent` kind: a run of text, in `data`.
+pub const STREAM_EVENT_TEXT: c_int = 1;
+/// `CStreamEvent` kind: a page, slide or sheet begins; `index` is its number, from 1.
+pub const STREAM_EVENT_PAGE_START: c_int = 2;
+/// `CStreamEvent` kind: the page, slide or sheet numbered `index` ends.
+pub const STREAM_EVENT_PAGE_END: c_int = 3;
+/// `CStreamEvent` kind: the name of the sheet numbered `index`, in `data`.
+pub const STREAM_EVENT_SHEET_NAME: c_int = 4;
+/// `CStreamEvent` kind: an embedded document begins; `index` is its nesting depth, from 1.
+pub const STREAM_EVENT_EMBEDDED_START: c_int = 5;
+/// `CStreamEvent` kind: the embedded document at nesting depth `index` ends.
+pub const STREAM_EVENT_EMBEDDED_END: c_int = 6;
+/// `CStreamEvent` kind: the name of the embedded document at nesting depth `index`, in
+/// `data`, such as its path inside an archive or its attachment file name.
+pub const STREAM_EVENT_EMBEDDED_NAME: c_int = 7;
+
+/// Number of entries in `CStats::errors_by_code`, indexed by the negated error code.
+pub const STATS_ERROR_CODE_SLOTS: usize = 16;
+/// Number of buckets in the `CStats` latency histogram.
+pub const STATS_LATENCY_BUCKETS: usize = 12;
+
+/// `extractous_warmup` format bit: the PDF parser.
+pub const WARMUP_FORMAT_PDF: u32 = 1 << 0;
+/// `extractous_warmup` format bit: the Office Open XML (DOCX) parser.
+pub const WARMUP_FORMAT_OFFICE: u32 = 1 << 1;
+/// `extractous_warmup` format bit: the HTML parser.
+pub const WARMUP_FORMAT_HTML: u32 = 1 << 2;
+/// Every `extractous_warmup` format bit.
+pub const WARMUP_FORMAT_ALL: u32 = WARMUP_FORMAT_PDF | WARMUP_FORMAT_OFFICE | WARMUP_FORMAT_HTML;
+
+/// `extractous_extractor_set_normalization_mut` stage: drop control characters other
+/// than tab and line breaks.
+pub const NORMALIZE_STRIP_CONTROL: u32 = 1 << 0;
+/// `extractous_extractor_set_normalization_mut` stage: collapse runs of whitespace.
+pub const NORMALIZE_COLLAPSE_WHITESPACE: u32 = 1 << 1;
+/// `extractous_extractor_set_normalization_mut` stage: join words hyphenated across
+/// line breaks.
+pub const NORMALIZE_DEHYPHENATE: u32 = 1 << 2;
+/// Every `extractous_extractor_set_normalization_mut` stage.
+pub const NORMALIZE_ALL: u32 =
+    NORMALIZE_STRIP_CONTROL | NORMALIZE_COLLAPSE_WHITESPACE | NORMALIZE_DEHYPHENATE;
+
+/// A caller buffer for `extractous_stream_read_into_iov`, laid out like POSIX `struct iovec`.
+#[repr(C)]
+pub struct CIoVec {
+    /// Start of the buffer
+    pub base: *mut u8,
+    /// Length of the buffer in bytes
+    pub len: libc::size_t,
+}
+
+/// Content and metadata of one extraction, laid out in a single allocation.
+///
+/// Returned by `extractous_extractor_extract_file_to_result` and
+/// `extractous_extractor_extract_bytes_to_result`; freed with one call to
+/// `extractous_result_free`.
+#[repr(C)]
+pub struct CExtractionResult {
+    /// Extracted content, null-terminated; may contain interior NUL bytes
+    pub content: *const c_char,
+    /// Length of `content` in bytes, excluding the terminator
+    pub content_len: libc::size_t,
+    /// Extracted metadata, read through `&result->metadata`; not freed on its own
+    pub metadata: CMetadataPacked,
+}
+
+/// A reusable, growable output buffer created by `extractous_buffer_new`.
+///
+/// Callers read `data[0..len]`; the fields are managed by the library.
+#[repr(C)]
+pub struct CBuffer {
+    /// Start of the contents, or NULL while nothing has been allocated
+    pub data: *mut u8,
+    /// Length of the contents in bytes
+    pub len: libc::size_t,
+    /// Size of the allocation in bytes
+    pub capacity: libc::size_t,
+}
+
+/// One event returned by `extractous_stream_next_event`.
+#[repr(C)]
+pub struct CStreamEvent {
+    /// One of the `STREAM_EVENT_*` kinds
+    pub kind: c_int,
+    /// Page number for page, sheet-name and text events (0 outside pages), or nesting
+    /// depth for embedded-document events
+    pub index: u32,
+    /// UTF-8 payload, not null-terminated; owned by the stream and valid until its next
+    /// call or until it is freed. NULL when the event has no payload.
+    pub data: *const u8,
+    /// Length of `data` in bytes
+    pub len: libc::size_t,
+}
+
+/// One chunk returned by `extractous_stream_next_chunk`.
+#[repr(C)]
+pub struct CStreamChunk {
+    /// Content bytes, not null-terminated; owned by the stream and valid until its next
+    /// call or until it is freed. NULL at the end of the stream.
+    pub data: *const u8,
+    /// Length of `data` in bytes; 0 at the end of the stream
+    pub len: libc::size_t,
+    /// Offset of `data` in the stream's content, in bytes
+    pub offset: u64,
+}
+
+/// A snapshot of the library's process-wide extraction statistics.
+///
+/// A call is one extraction entry point (or one batch item), from the start of the core
+/// parse to the end of the FFI conversion of its results. Streamed content is parsed
+/// lazily, so for streams most of the parse time shows up in `stream_read_ns`.
+#[repr(C)]
+pub struct CStats {
+    /// Whether collection is currently enabled
+    pub enabled: bool,
+    /// Completed extraction calls, successful or not
+    pub calls: u64,
+    /// Failed extraction calls, including input errors such as a failed mapping
+    pub errors: u64,
+    /// Failures per error code: `errors_by_code[-code]`
+    pub errors_by_code: [u64; STATS_ERROR_CODE_SLOTS],
+    /// Bytes of in-memory, mapped or callback-supplied input; path and URL inputs are not counted
+    pub bytes_in: u64,
+    /// Bytes of extracted content returned as strings or buffers, or read from streams
+    pub bytes_out: u64,
+    /// Metadata keys returned
+    pub metadata_entries: u64,
+    /// Pages the PDF parser sent to OCR, from the `pdf:ocrPageCount` metadata value
+    pub ocr_pages: u64,
+    /// Time spent in the core library parsing, including parser setup
+    pub parse_ns: u64,
+    /// Time spent converting results into C structures
+    pub convert_ns: u64,
+    /// Reads made against core stream readers (read-ahead hits are not counted)
+    pub stream_reads: u64,
+    /// Time spent in those reads
+    pub stream_read_ns: u64,
+    /// Inclusive upper bound of each latency bucket; the last one is `UINT64_MAX`
+    pub latency_bounds_ns: [u64; STATS_LATENCY_BUCKETS],
+    /// Calls per latency bucket
+    pub latency_buckets: [u64; STATS_LATENCY_BUCKETS],
+    /// Result cache lookups answered from a cache, from memory or disk
+    pub cache_hits: u64,
+    /// Those of `cache_hits` answered from a disk tier
+    pub cache_disk_hits: u64,
+    /// Result cache lookups that fell through to a full extraction
+    pub cache_misses: u64,
+}
+
+/// The resource accounting of one extraction call, or of the reads made on one stream.
+///
+/// Filled while statistics collection is enabled; see `extractous_stats_last_call` and
+/// `extractous_stream_get_stats`. CPU time is that of the thread running the call; the
+/// core parses on it, but any helper threads the core uses are not included. RSS is
+/// sampled before and after the call, or for a stream at its first read, at the end of
+/// its content or a failed read, and when its stats are copied out, so memory
+/// allocated and released again in between is not seen; it is process-wide, so with
+/// several extractions running at once, each is charged the growth made by all of them
+/// meanwhile.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct CExtractionStats {
+    /// `ERR_OK`, or the error code the call (or the last failed read) returned
+    pub code: c_int,
+    /// Wall-clock time of the call, or of the stream's reads
+    pub total_ns: u64,
+    /// Time spent in the core library parsing, including parser setup
+    pub parse_ns: u64,
+    /// Time spent converting results into C structures
+    pub convert_ns: u64,
+    /// CPU time of the calling thread
+    pub cpu_ns: u64,
+    /// Bytes of extracted content returned, or read from the stream
+    pub bytes_out: u64,
+    /// Metadata keys returned
+    pub metadata_entries: u64,
+    /// Pages the PDF parser sent to OCR, from the `pdf:ocrPageCount` metadata value
+    pub ocr_pages: u64,
+    /// The process's resident set size when the call ended, in bytes
+    pub rss_bytes: u64,
+    /// How much the process's resident set grew during the call, in bytes
+    pub rss_growth_bytes: u64,
+}
+
+/// Options for `extractous_init`.
+#[repr(C)]
+pub struct CInitOptions {
+    /// `WARMUP_FORMAT_*` bits to warm up, as with `extractous_warmup`; 0 skips the warm-up
+    pub warmup_formats: u32,
+    /// Start the async worker threads now rather than on the first `_async` call
+    pub start_workers: bool,
+}
+
+/// Outcome of extracting a single item of a batch.
+#[repr(C)]
+pub struct CBatchResult {
+    /// Extracted content, as a UTF-8 buffer of `content_len` bytes, or NULL if the item
+    /// failed or the content is empty
+    pub content: *mut u8,
+    pub content_len: libc::size_t,
+    /// Extracted metadata, or NULL if the item failed
+    pub metadata: *mut CMetadataPacked,
+    /// `ERR_OK` on success, otherwise the error code for this item
+    pub error_code: c_int,
+}
+
+/// One document returned by `extractous_extractor_extract_file_recursive`
+#[repr(C)]
+pub struct CEmbeddedResult {
+    /// Path inside the container, entry names joined with `/`; empty for the container
+    pub path: *mut c_char,
+    /// Nesting depth: 0 for the container, 1 for its direct children
+    pub depth: u32,
+    /// Index of the parent result; 0 for the container itself
+    pub parent: libc::size_t,
+    /// The document's own text, as a UTF-8 buffer of `content_len` bytes, or NULL if empty
+    pub content: *mut u8,
+    pub content_len: libc::size_t,
+    /// Metadata of the container, for the first result only; NULL for embedded documents
+    pub metadata: *mut CMetadataPacked,
+    /// True if a count limit or the content budget stopped extraction inside this document
+    pub truncated: bool,
+}
+
+/// Callback invoked exactly once when the library no longer needs a caller-owned buffer.
+pub type ExtractousReleaseFn = Option<unsafe extern "C" fn(user_data: *mut libc::c_void)>;
+
+/// Callback that fills `buf` with up to `len` bytes of input.
+///
+/// Returns the number of bytes written, 0 at end of input, or a negative value on error.
+pub type ExtractousReadFn = Option<
+    unsafe extern "C" fn(user_data: *mut libc::c_void, buf: *mut u8, len: libc::size_t) -> isize,
+>;
+
+/// Callback invoked exactly once, on a library worker thread, when an async extraction ends.
+///
+/// On success `error_code` is `ERR_OK` and the callback takes ownership of `content`
+/// (free with `extractous_buffer_free(content, content_len)`; NULL when empty) and
+/// `metadata` (free with `extractous_metadata_packed_free`). On failure both are NULL.
+pub type ExtractousCompletionFn = Option<
+    unsafe extern "C" fn(
+        user_data: *mut libc::c_void,
+        error_code: c_int,
+        content: *mut u8,
+        content_len: libc::size_t,
+        metadata: *mut CMetadataPacked,
+    ),
+>;
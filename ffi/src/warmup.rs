@@ -0,0 +1,91 @@
+use crate::ecore::Extractor as CoreExtractor;
+use crate::errors::*;
+use crate::jobs;
+use crate::types::*;
+use std::os::raw::c_int;
+
+/// A tiny plain-text document. Any extraction brings up the core's embedded runtime; this
+/// one does so without loading a format-specific parser.
+pub(crate) const RUNTIME_SAMPLE: &[u8] = b"extractous warm-up";
+
+/// One built-in sample document per `WARMUP_FORMAT_*` bit.
+const FORMAT_SAMPLES: [(u32, &[u8]); 3] = [
+    (WARMUP_FORMAT_PDF, include_bytes!("../samples/warmup.pdf")),
+    (
+        WARMUP_FORMAT_OFFICE,
+        include_bytes!("../samples/warmup.docx"),
+    ),
+    (WARMUP_FORMAT_HTML, include_bytes!("../samples/warmup.html")),
+];
+
+/// Extracts `sample` with `extractor`, bypassing statistics.
+pub(crate) fn run_sample(extractor: &CoreExtractor, sample: &[u8]) -> c_int {
+    match extractor.extract_bytes_to_string(sample) {
+        Ok(_) => ERR_OK,
+        Err(e) => extractous_error_to_code(&e),
+    }
+}
+
+/// Runs the samples selected by `formats`, returning the first error.
+fn warm_up_formats(formats: u32) -> c_int {
+    let extractor = CoreExtractor::new();
+    let mut first_error = ERR_OK;
+    for (format, sample) in FORMAT_SAMPLES {
+        if formats & format != 0 {
+            let code = run_sample(&extractor, sample);
+            if first_error == ERR_OK {
+                first_error = code;
+            }
+        }
+    }
+    first_error
+}
+
+/// Performs the library's one-time initialization up front, so it does not land on the
+/// first real request.
+///
+/// This brings up the core's embedded runtime by extracting a tiny plain-text document,
+/// optionally starts the async worker threads, and then warms up the parsers selected by
+/// `opts->warmup_formats` like `extractous_warmup`. Pass NULL to start the workers and
+/// warm up every format.
+///
+/// Everything done here would otherwise happen lazily, so calling it is optional, and it
+/// is safe to call more than once or from several threads. Returns `ERR_INVALID_ENUM` for
+/// unknown format bits, without doing anything. Otherwise returns the first error met;
+/// initialization still runs to the end, and a failed step is retried lazily on use.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn extractous_init(opts: *const CInitOptions) -> c_int {
+    let (formats, start_workers) = if opts.is_null() {
+        (WARMUP_FORMAT_ALL, true)
+    } else {
+        let opts = unsafe { &*opts };
+        (opts.warmup_formats, opts.start_workers)
+    };
+    if formats & !WARMUP_FORMAT_ALL != 0 {
+        return ERR_INVALID_ENUM;
+    }
+
+    let mut first_error = run_sample(&CoreExtractor::new(), RUNTIME_SAMPLE);
+    if start_workers && !jobs::start_workers() && first_error == ERR_OK {
+        first_error = ERR_IO_ERROR;
+    }
+    let code = warm_up_formats(formats);
+    if first_error == ERR_OK {
+        first_error = code;
+    }
+    first_error
+}
+
+/// Pre-loads the parsers selected by `formats_mask` (`WARMUP_FORMAT_*` bits) by running a
+/// tiny built-in sample document through each of them.
+///
+/// Samples run with the default configuration and are not counted in the statistics.
+/// Returns `ERR_INVALID_ENUM` for unknown bits, without running anything, or else the
+/// first error a sample produced.
+#[unsafe(no_mangle)]
+pub extern "C" fn extractous_warmup(formats_mask: u32) -> c_int {
+    if formats_mask & !WARMUP_FORMAT_ALL != 0 {
+        return ERR_INVALID_ENUM;
+    }
+    warm_up_formats(formats_mask)
+}
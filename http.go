@@ -0,0 +1,242 @@
+package extractous
+
+import (
+	"bytes"
+	"context"
+	"errors"
+	"fmt"
+	"io"
+	"net"
+	"net/http"
+	"sync"
+	"time"
+)
+
+// HTTPConfig configures how ExtractURL and ExtractURLToString fetch documents
+// once attached with Extractor.SetHTTPConfig.
+//
+// Without it, the native library hands each URL to the core, which opens a new
+// connection per document with no timeout control. With it, documents are
+// fetched in Go over a keep-alive connection pool shared by every extraction
+// of the extractor, then parsed from memory like ExtractBytes, so repeated
+// requests to the same hosts skip the TCP and TLS handshakes.
+//
+// Zero fields take the defaults of NewHTTPConfig where noted, or mean no limit.
+type HTTPConfig struct {
+	// ConnectTimeout bounds dialing and the TLS handshake. Default 10s.
+	ConnectTimeout time.Duration
+	// ReadTimeout bounds the wait for the response headers, and then for each
+	// read of the body, so a stalled server fails without limiting the total
+	// time of a large download. Default 30s.
+	ReadTimeout time.Duration
+	// IdleConnTimeout is how long an idle keep-alive connection is kept.
+	// Default 90s.
+	IdleConnTimeout time.Duration
+	// MaxBodySize is the largest response body accepted, in bytes; larger
+	// documents fail with ErrIO before being parsed. 0 means no limit.
+	MaxBodySize int64
+	// MaxPerHost limits the fetches in flight to one host, across all
+	// goroutines using the extractor; further fetches wait. It also sets how
+	// many idle connections are kept per host. 0 means no limit, with the
+	// idle pool defaulting to 16 connections per host.
+	MaxPerHost int
+}
+
+// NewHTTPConfig returns an HTTPConfig with default timeouts and no size or
+// concurrency limits.
+func NewHTTPConfig() *HTTPConfig {
+	return &HTTPConfig{
+		ConnectTimeout:  10 * time.Second,
+		ReadTimeout:     30 * time.Second,
+		IdleConnTimeout: 90 * time.Second,
+	}
+}
+
+// defaultIdleConnsPerHost is the idle pool size per host when MaxPerHost is 0.
+const defaultIdleConnsPerHost = 16
+
+// maxBodyReserve is the most buffer reserved from Content-Length when
+// MaxBodySize is 0.
+const maxBodyReserve = 1 << 20
+
+var errReadTimeout = errors.New("read timeout")
+
+// httpFetcher downloads documents for an extractor with an HTTPConfig.
+type httpFetcher struct {
+	client      *http.Client
+	readTimeout time.Duration
+	maxBody     int64
+	maxPerHost  int
+
+	mu    sync.Mutex
+	hosts map[string]chan struct{}
+}
+
+func newHTTPFetcher(cfg HTTPConfig) *httpFetcher {
+	defaults := NewHTTPConfig()
+	if cfg.ConnectTimeout <= 0 {
+		cfg.ConnectTimeout = defaults.ConnectTimeout
+	}
+	if cfg.ReadTimeout <= 0 {
+		cfg.ReadTimeout = defaults.ReadTimeout
+	}
+	if cfg.IdleConnTimeout <= 0 {
+		cfg.IdleConnTimeout = defaults.IdleConnTimeout
+	}
+	idlePerHost := cfg.MaxPerHost
+	if idlePerHost <= 0 {
+		idlePerHost = defaultIdleConnsPerHost
+	}
+
+	dialer := &net.Dialer{Timeout: cfg.ConnectTimeout, KeepAlive: 30 * time.Second}
+	transport := &http.Transport{
+		Proxy:                 http.ProxyFromEnvironment,
+		DialContext:           dialer.DialContext,
+		ForceAttemptHTTP2:     true,
+		TLSHandshakeTimeout:   cfg.ConnectTimeout,
+		ResponseHeaderTimeout: cfg.ReadTimeout,
+		IdleConnTimeout:       cfg.IdleConnTimeout,
+		MaxIdleConnsPerHost:   idlePerHost,
+	}
+	return &httpFetcher{
+		client:      &http.Client{Transport: transport},
+		readTimeout: cfg.ReadTimeout,
+		maxBody:     cfg.MaxBodySize,
+		maxPerHost:  cfg.MaxPerHost,
+		hosts:       make(map[string]chan struct{}),
+	}
+}
+
+// acquireHost waits for a fetch slot for host and returns its release func.
+func (f *httpFetcher) acquireHost(ctx context.Context, host string) (func(), error) {
+	if f.maxPerHost <= 0 {
+		return func() {}, nil
+	}
+	f.mu.Lock()
+	slots, ok := f.hosts[host]
+	if !ok {
+		slots = make(chan struct{}, f.maxPerHost)
+		f.hosts[host] = slots
+	}
+	f.mu.Unlock()
+
+	select {
+	case slots <- struct{}{}:
+		return func() { <-slots }, nil
+	case <-ctx.Done():
+		return nil, ctx.Err()
+	}
+}
+
+// fetch downloads url into memory within the configured limits. Errors wrap
+// ErrIO.
+func (f *httpFetcher) fetch(url string) ([]byte, error) {
+	ctx, cancel := context.WithCancelCause(context.Background())
+	defer cancel(nil)
+	fail := func(err error) error {
+		if cause := context.Cause(ctx); cause != nil {
+			err = cause
+		}
+		return fmt.Errorf("%w: %w", newError(errIOError), err)
+	}
+
+	req, err := http.NewRequestWithContext(ctx, http.MethodGet, url, nil)
+	if err != nil {
+		return nil, fail(err)
+	}
+	release, err := f.acquireHost(ctx, req.URL.Host)
+	if err != nil {
+		return nil, fail(err)
+	}
+	defer release()
+
+	resp, err := f.client.Do(req)
+	if err != nil {
+		return nil, fail(err)
+	}
+	defer resp.Body.Close()
+
+	if resp.StatusCode < 200 || resp.StatusCode > 299 {
+		// Drain a little so the connection can be reused.
+		io.CopyN(io.Discard, resp.Body, 4<<10)
+		return nil, fmt.Errorf("%w: %s: HTTP %s", newError(errIOError), url, resp.Status)
+	}
+	if f.maxBody > 0 && resp.ContentLength > f.maxBody {
+		return nil, f.tooLarge(url)
+	}
+
+	// Each read of the body must make progress within the read timeout.
+	idle := time.AfterFunc(f.readTimeout, func() { cancel(errReadTimeout) })
+	defer idle.Stop()
+	body := io.Reader(&progressReader{r: resp.Body, timer: idle, timeout: f.readTimeout})
+	if f.maxBody > 0 {
+		body = io.LimitReader(body, f.maxBody+1)
+	}
+
+	// Content-Length is up to the server, so without a body limit only a
+	// bounded amount is reserved up front; the rest grows as bytes arrive.
+	var data bytes.Buffer
+	if resp.ContentLength > 0 {
+		reserve := int64(maxBodyReserve)
+		if f.maxBody > 0 {
+			reserve = f.maxBody
+		}
+		data.Grow(int(min(resp.ContentLength, reserve)) + 1)
+	}
+	if _, err := data.ReadFrom(body); err != nil {
+		return nil, fail(err)
+	}
+	if f.maxBody > 0 && int64(data.Len()) > f.maxBody {
+		return nil, f.tooLarge(url)
+	}
+	return data.Bytes(), nil
+}
+
+func (f *httpFetcher) tooLarge(url string) error {
+	return fmt.Errorf("%w: %s: response body exceeds %d bytes", newError(errIOError), url, f.maxBody)
+}
+
+// progressReader pushes back timer by timeout after every read.
+type progressReader struct {
+	r       io.Reader
+	timer   *time.Timer
+	timeout time.Duration
+}
+
+func (p *progressReader) Read(buf []byte) (int, error) {
+	n, err := p.r.Read(buf)
+	p.timer.Reset(p.timeout)
+	return n, err
+}
+
+// SetHTTPConfig makes ExtractURL and ExtractURLToString fetch documents in Go
+// according to cfg, instead of leaving the download to the core. A nil cfg
+// restores the core's fetching.
+//
+// All goroutines using the extractor share one keep-alive connection pool and
+// the per-host limit. Fetched documents are parsed like ExtractBytes, so the
+// result cache and the content budget apply to them. cfg is copied; changing
+// it afterwards has no effect. Pools created from the extractor with NewPool
+// share its HTTP configuration.
+//
+// Example:
+//
+//	cfg := extractous.NewHTTPConfig()
+//	cfg.MaxBodySize = 64 << 20
+//	cfg.MaxPerHost = 8
+//	extractor := extractous.New().SetHTTPConfig(cfg)
+//
+// Returns nil if the extractor is closed.
+func (e *Extractor) SetHTTPConfig(cfg *HTTPConfig) *Extractor {
+	if e == nil || e.ptr == nil {
+		return nil
+	}
+	var f *httpFetcher
+	if cfg != nil {
+		f = newHTTPFetcher(*cfg)
+	}
+	if old := e.http.Swap(f); old != nil {
+		old.client.CloseIdleConnections()
+	}
+	return e
+}
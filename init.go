@@ -0,0 +1,66 @@
+package extractous
+
+/*
+#include <extractous.h>
+*/
+import "C"
+
+// WarmupFormat selects parsers for Warmup and InitOptions. Values can be
+// combined with |.
+type WarmupFormat uint32
+
+const (
+	WarmupPDF    WarmupFormat = C.WARMUP_FORMAT_PDF    // The PDF parser
+	WarmupOffice WarmupFormat = C.WARMUP_FORMAT_OFFICE // The Office Open XML (DOCX) parser
+	WarmupHTML   WarmupFormat = C.WARMUP_FORMAT_HTML   // The HTML parser
+	WarmupAll    WarmupFormat = C.WARMUP_FORMAT_ALL    // Every parser above
+)
+
+// InitOptions configures Init.
+type InitOptions struct {
+	WarmupFormats WarmupFormat // Parsers to warm up, as with Warmup; 0 skips the warm-up
+	StartWorkers  bool         // Start the async worker threads now rather than on first use
+}
+
+// Init performs the native library's one-time initialization up front, so it
+// does not land on the first real request. Call it during process or
+// container start-up:
+//
+//	func main() {
+//	    if err := extractous.Init(nil); err != nil {
+//	        log.Printf("extractous warm-up: %v", err)
+//	    }
+//	    // ... start serving ...
+//	}
+//
+// It brings up the embedded runtime, optionally starts the workers behind
+// ExtractFileAsync, and warms up the selected parsers. A nil opts starts the
+// workers and warms up every parser.
+//
+// Calling Init is optional: everything it does would otherwise happen lazily.
+// It is safe to call more than once. An error reports the first step that
+// failed; the remaining steps still ran.
+func Init(opts *InitOptions) error {
+	var cOpts *C.struct_CInitOptions
+	if opts != nil {
+		cOpts = &C.struct_CInitOptions{
+			warmup_formats: C.uint32_t(opts.WarmupFormats),
+			start_workers:  C.bool(opts.StartWorkers),
+		}
+	}
+	if code := C.extractous_init(cOpts); code != errOK {
+		return newError(code)
+	}
+	return nil
+}
+
+// Warmup pre-loads the selected parsers by running a tiny built-in sample
+// document through each of them. Samples are not counted in Stats.
+//
+// Returns ErrInvalidEnum for unknown format bits, without running anything.
+func Warmup(formats WarmupFormat) error {
+	if code := C.extractous_warmup(C.uint32_t(formats)); code != errOK {
+		return newError(code)
+	}
+	return nil
+}
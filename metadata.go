@@ -5,11 +5,7 @@ package extractous
 #include <stdlib.h>
 */
 import "C"
-import (
-	"runtime"
-	"strings"
-	"unsafe"
-)
+import "unsafe"
 
 // Metadata represents document metadata as key-value pairs.
 //
@@ -87,77 +83,67 @@ import (
 // Always safe to call methods on Metadata even when empty.
 type Metadata map[string][]string
 
-// metadataWrapper wraps C metadata for proper cleanup.
+// newPackedMetadata converts packed C metadata to Go and frees it.
 //
-// This is an internal type used to manage the lifecycle of C metadata pointers.
-// It ensures that C resources are freed when the Go garbage collector determines
-// they are no longer needed.
+// The packed block is released as soon as it has been copied, so no finalizer
+// is needed.
+//
+// Returns an empty Metadata map if the C pointer is nil.
 //
 // Internal use only.
-type metadataWrapper struct {
-	ptr *C.struct_CMetadata
+func newPackedMetadata(cMeta *C.struct_CMetadataPacked) Metadata {
+	if cMeta == nil {
+		return make(Metadata)
+	}
+	defer C.extractous_metadata_packed_free(cMeta)
+
+	return packedMetadataFromC(cMeta)
 }
 
-// newMetadata converts C metadata to Go and sets up cleanup.
-//
-// This function:
-//  1. Converts C metadata structure to Go map
-//  2. Sets up a finalizer to free C resources
-//  3. Splits comma-separated values into slices
-//  4. Trims whitespace from values
+// packedMetadataFromC copies packed C metadata into a Go map without taking
+// ownership.
 //
-// Returns an empty Metadata map if the C pointer is nil.
+// The key/value arena is copied into Go memory with a single C.GoBytes call.
+// Keys and values are then sliced out of that one copy using the offset tables,
+// so multi-valued fields keep their original values exactly, including any
+// commas they contain. The caller remains responsible for freeing cMeta.
 //
 // Internal use only.
-func newMetadata(cMeta *C.struct_CMetadata) Metadata {
+func packedMetadataFromC(cMeta *C.struct_CMetadataPacked) Metadata {
 	if cMeta == nil {
 		return make(Metadata)
 	}
 
-	// Create wrapper for proper cleanup
-	wrapper := &metadataWrapper{ptr: cMeta}
-	runtime.SetFinalizer(wrapper, (*metadataWrapper).free)
-
-	// Convert to Go map
-	result := make(Metadata, int(cMeta.len))
-
-	if cMeta.len == 0 {
+	n := int(cMeta.len)
+	result := make(Metadata, n)
+	if n == 0 {
 		return result
 	}
 
-	// Convert C arrays to Go slices
-	keys := unsafe.Slice(cMeta.keys, cMeta.len)
-	values := unsafe.Slice(cMeta.values, cMeta.len)
-
-	for i := 0; i < int(cMeta.len); i++ {
-		key := C.GoString(keys[i])
-		value := C.GoString(values[i])
+	// One copy of the whole arena; the byte slice is never mutated, so it can
+	// back every key and value string without further copies.
+	var arena string
+	if cMeta.data_len > 0 {
+		data := C.GoBytes(unsafe.Pointer(cMeta.data), C.int(cMeta.data_len))
+		arena = unsafe.String(&data[0], len(data))
+	}
+	keyOffsets := unsafe.Slice(cMeta.key_offsets, n+1)
+	valueStarts := unsafe.Slice(cMeta.value_starts, n+1)
+	valueOffsets := unsafe.Slice(cMeta.value_offsets, int(cMeta.value_count)+1)
 
-		// Values are comma-separated in C, split them into individual values
-		valueSlice := strings.Split(value, ",")
-		// Trim whitespace from each value
-		for j := range valueSlice {
-			valueSlice[j] = strings.TrimSpace(valueSlice[j])
+	for i := 0; i < n; i++ {
+		key := arena[keyOffsets[i]:keyOffsets[i+1]]
+		first, last := int(valueStarts[i]), int(valueStarts[i+1])
+		values := make([]string, last-first)
+		for j := range values {
+			values[j] = arena[valueOffsets[first+j]:valueOffsets[first+j+1]]
 		}
-		result[key] = valueSlice
+		result[key] = values
 	}
 
 	return result
 }
 
-// free releases C metadata resources.
-//
-// This is called automatically by the garbage collector via the finalizer.
-// Application code should not call this directly.
-//
-// Internal use only.
-func (m *metadataWrapper) free() {
-	if m.ptr != nil {
-		C.extractous_metadata_free(m.ptr)
-		m.ptr = nil
-	}
-}
-
 // Get returns the first value for a metadata key.
 //
 // If the key exists and has one or more values, the first value is returned.
@@ -0,0 +1,213 @@
+package extractous
+
+/*
+#include <extractous.h>
+*/
+import "C"
+import (
+	"math"
+	"runtime"
+	"time"
+)
+
+// StatsSnapshot is a point-in-time copy of the library's process-wide
+// extraction statistics.
+//
+// A call is one extraction method (or one item of ExtractFilesBatch), from the
+// start of the native parse to the end of converting its results for Go.
+// Streamed content is parsed lazily while it is read, so for ExtractFile and
+// friends most of the parse time shows up in StreamReadTime.
+//
+// Counters only move while collection is enabled with EnableStats.
+type StatsSnapshot struct {
+	Enabled bool // Whether collection is currently enabled
+
+	Calls  uint64 // Completed extraction calls, successful or not
+	Errors uint64 // Failed calls, including input errors such as a failed mmap
+	// Failures per error code, keyed by the (negative) native error code
+	ErrorsByCode map[int]uint64
+
+	BytesIn         uint64 // In-memory, mapped or io.Reader input; paths and URLs are not counted
+	BytesOut        uint64 // Extracted content returned as strings or read from streams
+	MetadataEntries uint64 // Metadata keys returned
+	OCRPages        uint64 // Pages the PDF parser sent to OCR (pdf:ocrPageCount)
+
+	ParseTime   time.Duration // Time spent parsing in the native core, including setup
+	ConvertTime time.Duration // Time spent converting results into C structures
+
+	StreamReads    uint64        // Reads made against native stream readers
+	StreamReadTime time.Duration // Time spent in those reads
+
+	CacheHits     uint64 // Result cache lookups answered from a Cache, from memory or disk
+	CacheDiskHits uint64 // Those of CacheHits answered from a disk tier
+	CacheMisses   uint64 // Result cache lookups that fell through to a full extraction
+
+	// Calls per latency bucket, in increasing order of UpperBound. Counts are
+	// per bucket, not cumulative.
+	Latency []LatencyBucket
+}
+
+// LatencyBucket is one bucket of the call latency histogram.
+type LatencyBucket struct {
+	// Inclusive upper bound; math.MaxInt64 for the final, unbounded bucket
+	UpperBound time.Duration
+	Count      uint64
+}
+
+// EnableStats turns statistics collection on or off for the whole process.
+//
+// Collection is off by default and costs one atomic load per call while off.
+// Counters keep their values while collection is off.
+//
+// Example:
+//
+//	extractous.EnableStats(true)
+//	// ... run extractions ...
+//	s := extractous.Stats()
+//	fmt.Printf("%d calls, %v parsing\n", s.Calls, s.ParseTime)
+func EnableStats(enabled bool) {
+	C.extractous_stats_enable(C.bool(enabled))
+}
+
+// ResetStats sets all statistics counters back to zero.
+func ResetStats() {
+	C.extractous_stats_reset()
+}
+
+// Stats returns a snapshot of the process-wide extraction statistics.
+//
+// Each counter is read atomically, but calls that finish while the snapshot
+// is taken may be only partly included.
+func Stats() StatsSnapshot {
+	var cs C.struct_CStats
+	C.extractous_stats_snapshot(&cs)
+
+	s := StatsSnapshot{
+		Enabled:         bool(cs.enabled),
+		Calls:           uint64(cs.calls),
+		Errors:          uint64(cs.errors),
+		ErrorsByCode:    make(map[int]uint64),
+		BytesIn:         uint64(cs.bytes_in),
+		BytesOut:        uint64(cs.bytes_out),
+		MetadataEntries: uint64(cs.metadata_entries),
+		OCRPages:        uint64(cs.ocr_pages),
+		ParseTime:       nanos(cs.parse_ns),
+		ConvertTime:     nanos(cs.convert_ns),
+		StreamReads:     uint64(cs.stream_reads),
+		StreamReadTime:  nanos(cs.stream_read_ns),
+		CacheHits:       uint64(cs.cache_hits),
+		CacheDiskHits:   uint64(cs.cache_disk_hits),
+		CacheMisses:     uint64(cs.cache_misses),
+		Latency:         make([]LatencyBucket, len(cs.latency_buckets)),
+	}
+	for slot, n := range cs.errors_by_code {
+		if n != 0 {
+			s.ErrorsByCode[-slot] = uint64(n)
+		}
+	}
+	for i := range cs.latency_buckets {
+		s.Latency[i] = LatencyBucket{
+			UpperBound: nanos(cs.latency_bounds_ns[i]),
+			Count:      uint64(cs.latency_buckets[i]),
+		}
+	}
+	return s
+}
+
+// ExtractionStats is the resource accounting of one extraction call, or of the
+// reads made on one stream. It is only filled while collection is enabled with
+// EnableStats; otherwise every field is zero.
+//
+// CPU is the CPU time of the thread that ran the call; the native core parses
+// on it, but helper threads it may use are not included. RSS is sampled
+// before and after the call, or for a stream at its first read, at the end of
+// its content or a failed read, and by Stats, so memory allocated and released
+// again in between is not seen. It is process-wide, so with several
+// extractions running at once, each is charged the growth made by all of them
+// meanwhile. A document whose calls keep showing growth is one that drives
+// worker memory up.
+type ExtractionStats struct {
+	Err error // Error the call (or the stream's last failed read) returned, or nil
+
+	Total   time.Duration // Wall-clock time, or time spent in the stream's reads
+	Parse   time.Duration // Time spent parsing in the native core, including setup
+	Convert time.Duration // Time spent converting results into C structures
+	CPU     time.Duration // CPU time of the thread that ran the call
+
+	BytesOut        uint64 // Extracted content returned, or read from the stream
+	MetadataEntries uint64 // Metadata keys returned
+	OCRPages        uint64 // Pages the PDF parser sent to OCR (pdf:ocrPageCount)
+
+	RSS       uint64 // The process's resident set size when the call ended, in bytes
+	RSSGrowth uint64 // How much the process's resident set grew during the call, in bytes
+}
+
+// newExtractionStats converts a native CExtractionStats.
+//
+// Internal use only.
+func newExtractionStats(cs *C.struct_CExtractionStats) ExtractionStats {
+	s := ExtractionStats{
+		Total:           nanos(cs.total_ns),
+		Parse:           nanos(cs.parse_ns),
+		Convert:         nanos(cs.convert_ns),
+		CPU:             nanos(cs.cpu_ns),
+		BytesOut:        uint64(cs.bytes_out),
+		MetadataEntries: uint64(cs.metadata_entries),
+		OCRPages:        uint64(cs.ocr_pages),
+		RSS:             uint64(cs.rss_bytes),
+		RSSGrowth:       uint64(cs.rss_growth_bytes),
+	}
+	if cs.code != errOK {
+		s.Err = newError(cs.code)
+	}
+	return s
+}
+
+// lastCallStats returns the accounting of the last extraction call made on
+// the current OS thread. The caller must be locked to its thread.
+//
+// Internal use only.
+func lastCallStats() ExtractionStats {
+	var cs C.struct_CExtractionStats
+	C.extractous_stats_last_call(&cs)
+	return newExtractionStats(&cs)
+}
+
+// Measure runs fn and returns the accounting of the last extraction call it
+// made, along with fn's error.
+//
+// fn runs with the calling goroutine locked to its OS thread, so that the
+// native per-thread record read afterwards is the one of fn's call; fn should
+// make its extraction call on this goroutine, not on one it starts. If fn
+// returns before any native call is measured, for example on a closed
+// extractor, every field of the result is zero. For
+// streams, the result covers opening the stream; the cost of reading it is in
+// StreamReader.Stats. Results of ExtractFileAsync carry their own Stats.
+//
+// Example:
+//
+//	extractous.EnableStats(true)
+//	var content string
+//	stats, err := extractous.Measure(func() (err error) {
+//	    content, _, err = extractor.ExtractFileToString("scan.pdf")
+//	    return err
+//	})
+//	log.Printf("%v CPU, %d OCR pages, RSS +%d bytes", stats.CPU, stats.OCRPages, stats.RSSGrowth)
+func Measure(fn func() error) (ExtractionStats, error) {
+	runtime.LockOSThread()
+	defer runtime.UnlockOSThread()
+	C.extractous_stats_last_call_reset()
+	err := fn()
+	return lastCallStats(), err
+}
+
+// nanos converts a native nanosecond counter to a Duration, saturating at
+// math.MaxInt64.
+//
+// Internal use only.
+func nanos(ns C.uint64_t) time.Duration {
+	if uint64(ns) > math.MaxInt64 {
+		return math.MaxInt64
+	}
+	return time.Duration(ns)
+}
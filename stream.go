@@ -9,6 +9,8 @@ package extractous
 import "C"
 import (
 	"io"
+	"iter"
+	"os"
 	"runtime"
 	"unsafe"
 )
@@ -24,6 +26,7 @@ import (
 //
 // StreamReader implements:
 //   - io.Reader: Read(p []byte) (n int, err error)
+//   - io.WriterTo: WriteTo(w io.Writer) (n int64, err error)
 //   - io.Closer: Close() error
 //
 // This means it can be used with:
@@ -90,12 +93,15 @@ import (
 //
 // # Performance Considerations
 //
-// StreamReader is buffered at the FFI layer, so you don't need to wrap it with
-// bufio.Reader for basic read operations. However, bufio.Scanner can still be
-// useful for line-oriented processing.
+// StreamReader keeps an internal buffer of DefaultStreamBufferSize bytes (see
+// SetBufferSize), so you don't need to wrap it with bufio.Reader. A Read that
+// finds the buffer empty makes a single cgo call that fills the caller's slice
+// and refills the buffer at the same time; subsequent small reads are served
+// from Go memory without crossing into C. bufio.Scanner can still be useful for
+// line-oriented processing.
 //
 // Typical buffer sizes:
-//   - Small reads (< 512 bytes): May have overhead, prefer larger reads
+//   - Small reads (< 512 bytes): Served from the internal buffer
 //   - Medium reads (4KB - 64KB): Optimal for most use cases
 //   - Large reads (> 1MB): Generally no advantage over medium reads
 //
@@ -106,8 +112,20 @@ import (
 type StreamReader struct {
 	ptr    *C.struct_CStreamReader // FFI stream pointer
 	closed bool                    // Whether Close() has been called
+
+	buf        []byte             // Read-ahead bytes served without a cgo call
+	start, end int                // Bounds of the unread bytes in buf
+	bufSize    int                // Size for buf on its next refill; 0 disables buffering
+	eof        bool               // Whether the native stream is exhausted
+	pinner     runtime.Pinner     // Pins the read targets during a vectored read
+	iov        [2]C.struct_CIoVec // Read targets handed to C; cleared after each call
+	cancel     *cancelToken       // Context the stream follows; nil if none
 }
 
+// DefaultStreamBufferSize is the default size of a StreamReader's internal
+// read-ahead buffer, in bytes.
+const DefaultStreamBufferSize = 64 * 1024
+
 // newStreamReader creates a StreamReader from a C pointer.
 //
 // This is an internal function used to wrap FFI stream pointers. It sets up
@@ -121,7 +139,9 @@ func newStreamReader(ptr *C.struct_CStreamReader) *StreamReader {
 		return nil
 	}
 
-	reader := &StreamReader{ptr: ptr}
+	reader := &StreamReader{ptr: ptr, bufSize: DefaultStreamBufferSize}
+	// The Go-side buffer takes over read-ahead; a second native copy would be wasted.
+	C.extractous_stream_set_buffer_size(ptr, 0)
 	runtime.SetFinalizer(reader, (*StreamReader).Close)
 	return reader
 }
@@ -148,6 +168,10 @@ func newStreamReader(ptr *C.struct_CStreamReader) *StreamReader {
 //
 // If the reader has been closed, Read returns (0, io.EOF).
 //
+// For a reader returned by ExtractFileContext, Read fails with ErrCancelled
+// (wrapping the context's error) once the context is done, and the parse behind
+// the stream is stopped.
+//
 // # Example
 //
 //	reader, _, err := extractor.ExtractFile("document.pdf")
@@ -189,23 +213,331 @@ func (r *StreamReader) Read(p []byte) (n int, err error) {
 		return 0, nil
 	}
 
+	if r.cancel.cancelled() {
+		return 0, cancelledError(r.cancel.ctx)
+	}
+
+	if r.start < r.end {
+		n = copy(p, r.buf[r.start:r.end])
+		r.start += n
+		return n, nil
+	}
+
+	if r.eof {
+		return 0, io.EOF
+	}
+
+	return r.fill(p)
+}
+
+// fill reads into p and refills the internal buffer with a single cgo call to
+// extractous_stream_read_into_iov. It is only called once the buffer is empty.
+// The call returns after one native read, so it may fill less than p; only a
+// read of 0 bytes marks the stream as exhausted.
+//
+// Internal use only.
+func (r *StreamReader) fill(p []byte) (n int, err error) {
+	if len(r.buf) != r.bufSize {
+		r.buf = make([]byte, r.bufSize)
+	}
+	r.start, r.end = 0, 0
+
+	// C may only hold Go pointers that are pinned, so pin both targets for the
+	// duration of the call and drop them from iov afterwards.
+	r.pinner.Pin(&p[0])
+	r.iov[0] = C.struct_CIoVec{base: (*C.uint8_t)(unsafe.Pointer(&p[0])), len: C.size_t(len(p))}
+	iovcnt := 1
+	// Reads at least as large as the buffer bypass it, as in bufio.Reader.
+	if len(p) < len(r.buf) {
+		r.pinner.Pin(&r.buf[0])
+		r.iov[1] = C.struct_CIoVec{base: (*C.uint8_t)(unsafe.Pointer(&r.buf[0])), len: C.size_t(len(r.buf))}
+		iovcnt = 2
+	}
+
 	var bytesRead C.size_t
-	code := C.extractous_stream_read(
-		r.ptr,
-		(*C.uint8_t)(unsafe.Pointer(&p[0])),
-		C.size_t(len(p)),
-		&bytesRead,
-	)
+	code := C.extractous_stream_read_into_iov(r.ptr, &r.iov[0], C.size_t(iovcnt), &bytesRead)
+	r.pinner.Unpin()
+	r.iov = [2]C.struct_CIoVec{}
+
+	total := int(bytesRead)
+	n = min(total, len(p))
+	r.end = total - n // Bytes beyond len(p) landed in r.buf
 
 	if code != errOK {
-		return 0, newError(code)
+		return n, r.cancel.err(code)
 	}
-
-	if bytesRead == 0 {
+	if n == 0 {
+		r.eof = true
 		return 0, io.EOF
 	}
+	return n, nil
+}
+
+// Stats returns the accounting of the native reads made on the stream so far,
+// while EnableStats is on. Streamed content is parsed as it is read, so this
+// is where most of a streamed extraction's cost shows up; the call that opened
+// the stream can be measured with Measure. Convert and MetadataEntries are
+// always zero.
+//
+// Returns the zero value once the stream is closed.
+func (r *StreamReader) Stats() ExtractionStats {
+	if r == nil || r.closed || r.ptr == nil {
+		return ExtractionStats{}
+	}
+	var cs C.struct_CExtractionStats
+	C.extractous_stream_get_stats(r.ptr, &cs)
+	return newExtractionStats(&cs)
+}
+
+// SetBufferSize sets the size of the reader's internal read-ahead buffer.
+//
+// Larger buffers mean fewer cgo calls; the default is DefaultStreamBufferSize.
+// A size of 0 disables Go-side buffering, in which case every Read makes one
+// cgo call and the native library's own read-ahead buffer is used instead.
+// Bytes that are already buffered are never discarded; the new size takes
+// effect on the next refill.
+//
+// Returns the reader for method chaining.
+func (r *StreamReader) SetBufferSize(size int) *StreamReader {
+	if r == nil || r.closed || r.ptr == nil {
+		return r
+	}
+	if size < 0 {
+		size = 0
+	}
+	r.bufSize = size
+
+	nativeSize := C.size_t(0)
+	if size == 0 {
+		nativeSize = C.STREAM_DEFAULT_BUFFER_SIZE
+	}
+	C.extractous_stream_set_buffer_size(r.ptr, nativeSize)
+	return r
+}
+
+// WriteTo writes the rest of the stream to w.
+//
+// This implements io.WriterTo, so io.Copy uses it automatically. When w is an
+// *os.File on a Unix system, the whole copy runs inside the native library via
+// extractous_stream_copy_to_fd: extracted text goes straight from the parser
+// to the file descriptor in large blocks and never passes through Go memory.
+// For any other writer the stream is copied through a large Go buffer.
+//
+// Like (*os.File).Fd, the fast path puts the file's descriptor into blocking
+// mode.
+//
+// Example:
+//
+//	reader, _, err := extractor.ExtractFile("document.pdf")
+//	if err != nil {
+//	    log.Fatal(err)
+//	}
+//	defer reader.Close()
+//
+//	out, _ := os.Create("document.txt")
+//	defer out.Close()
+//	io.Copy(out, reader) // Calls WriteTo, which copies natively
+func (r *StreamReader) WriteTo(w io.Writer) (n int64, err error) {
+	if r.closed || r.ptr == nil {
+		return 0, nil
+	}
+
+	if r.cancel.cancelled() {
+		return 0, cancelledError(r.cancel.ctx)
+	}
+
+	// Bytes already read ahead into Go memory go first.
+	if r.start < r.end {
+		written, err := w.Write(r.buf[r.start:r.end])
+		r.start += written
+		n += int64(written)
+		if err != nil {
+			return n, err
+		}
+	}
+	if r.eof {
+		return n, nil
+	}
+
+	if f, ok := w.(*os.File); ok && runtime.GOOS != "windows" {
+		var written C.size_t
+		code := C.extractous_stream_copy_to_fd(r.ptr, C.int(f.Fd()), &written)
+		runtime.KeepAlive(f)
+		n += int64(written)
+		if code != errOK {
+			return n, r.cancel.err(code)
+		}
+		r.eof = true
+		return n, nil
+	}
 
-	return int(bytesRead), nil
+	buf := make([]byte, max(r.bufSize, DefaultStreamBufferSize))
+	for {
+		read, err := r.Read(buf)
+		if read > 0 {
+			written, werr := w.Write(buf[:read])
+			n += int64(written)
+			if werr != nil {
+				return n, werr
+			}
+		}
+		if err == io.EOF {
+			return n, nil
+		}
+		if err != nil {
+			return n, err
+		}
+	}
+}
+
+// StreamEventKind identifies the kind of a StreamEvent.
+type StreamEventKind int
+
+const (
+	EventText          StreamEventKind = C.STREAM_EVENT_TEXT           // A run of text, in Data
+	EventPageStart     StreamEventKind = C.STREAM_EVENT_PAGE_START     // A page, slide or sheet begins
+	EventPageEnd       StreamEventKind = C.STREAM_EVENT_PAGE_END       // A page, slide or sheet ends
+	EventSheetName     StreamEventKind = C.STREAM_EVENT_SHEET_NAME     // The name of the current sheet, in Data
+	EventEmbeddedStart StreamEventKind = C.STREAM_EVENT_EMBEDDED_START // An embedded document begins
+	EventEmbeddedEnd   StreamEventKind = C.STREAM_EVENT_EMBEDDED_END   // An embedded document ends
+	EventEmbeddedName  StreamEventKind = C.STREAM_EVENT_EMBEDDED_NAME  // The name of the current embedded document, in Data
+)
+
+// StreamEvent is one structural event of a stream, returned by NextEvent.
+type StreamEvent struct {
+	Kind StreamEventKind
+	// Index is the page number, from 1, for page, sheet-name and text events
+	// (0 outside pages), and the nesting depth, from 1, for embedded-document
+	// events.
+	Index int
+	// Data holds the text, sheet name or embedded-document name; nil if the
+	// event has none.
+	Data []byte
+}
+
+// NextEvent returns the next structural event of the stream, or io.EOF at its
+// end. Events mark where pages, slides and sheets begin and end, name sheets,
+// bound embedded documents, and carry the text between them, so content can be
+// split per page without parsing the output a second time.
+//
+// Events come from XML output, which is tokenized natively as it is read; the
+// markup itself is not returned. Enable it with SetXmlOutput:
+//
+//	extractor := extractous.New().SetXmlOutput(true)
+//	reader, _, err := extractor.ExtractFile("report.pdf")
+//	// ...
+//	for {
+//	    event, err := reader.NextEvent()
+//	    if err == io.EOF {
+//	        break
+//	    }
+//	    if err != nil {
+//	        return err
+//	    }
+//	    if event.Kind == extractous.EventText {
+//	        index(event.Index, event.Data)
+//	    }
+//	}
+//
+// A plain-text stream yields text events only. Text events never span a page
+// boundary. Do not mix NextEvent with Read or WriteTo on one reader.
+func (r *StreamReader) NextEvent() (StreamEvent, error) {
+	if r.closed || r.ptr == nil {
+		return StreamEvent{}, io.EOF
+	}
+
+	if r.cancel.cancelled() {
+		return StreamEvent{}, cancelledError(r.cancel.ctx)
+	}
+
+	var event C.struct_CStreamEvent
+	if code := C.extractous_stream_next_event(r.ptr, &event); code != errOK {
+		return StreamEvent{}, r.cancel.err(code)
+	}
+	if event.kind == C.STREAM_EVENT_END {
+		return StreamEvent{}, io.EOF
+	}
+
+	result := StreamEvent{Kind: StreamEventKind(event.kind), Index: int(event.index)}
+	if event.data != nil {
+		result.Data = C.GoBytes(unsafe.Pointer(event.data), C.int(event.len))
+	}
+	return result, nil
+}
+
+// Chunk is one segment of a stream's content, returned by NextChunk and
+// Chunks.
+type Chunk struct {
+	// Offset is the position of Data in the stream's content, in bytes.
+	Offset int64
+	// Data holds the chunk's content.
+	Data []byte
+}
+
+// NextChunk returns the next chunk of the stream's content, of at most
+// maxBytes bytes and starting with up to overlap bytes from the end of the
+// previous chunk, or io.EOF at its end. maxBytes must be at least 4 and
+// overlap below it, or ErrInvalidConfig is returned.
+//
+// Chunks end after a paragraph break, sentence end, line break or space in
+// their second half, in that order of preference, and never split a UTF-8
+// character. The native side reads only as far as the current chunk, so
+// chunks arrive while the document is still being parsed and memory stays
+// bounded by maxBytes. Do not mix NextChunk with Read, WriteTo or NextEvent
+// on one reader.
+func (r *StreamReader) NextChunk(maxBytes, overlap int) (Chunk, error) {
+	if r.closed || r.ptr == nil {
+		return Chunk{}, io.EOF
+	}
+	if maxBytes < 0 || overlap < 0 {
+		return Chunk{}, newError(errInvalidConfig)
+	}
+
+	if r.cancel.cancelled() {
+		return Chunk{}, cancelledError(r.cancel.ctx)
+	}
+
+	var chunk C.struct_CStreamChunk
+	code := C.extractous_stream_next_chunk(r.ptr, C.size_t(maxBytes), C.size_t(overlap), &chunk)
+	if code != errOK {
+		return Chunk{}, r.cancel.err(code)
+	}
+	if chunk.len == 0 {
+		return Chunk{}, io.EOF
+	}
+	return Chunk{
+		Offset: int64(chunk.offset),
+		Data:   C.GoBytes(unsafe.Pointer(chunk.data), C.int(chunk.len)),
+	}, nil
+}
+
+// Chunks returns an iterator over the stream's content in chunks, as
+// returned by NextChunk. Iteration ends at the end of the stream, or after
+// yielding the first error.
+//
+// Example:
+//
+//	reader, _, err := extractor.ExtractFile("report.pdf")
+//	// ...
+//	defer reader.Close()
+//	for chunk, err := range reader.Chunks(4<<10, 512) {
+//	    if err != nil {
+//	        return err
+//	    }
+//	    embed(chunk.Offset, chunk.Data)
+//	}
+func (r *StreamReader) Chunks(maxBytes, overlap int) iter.Seq2[Chunk, error] {
+	return func(yield func(Chunk, error) bool) {
+		for {
+			chunk, err := r.NextChunk(maxBytes, overlap)
+			if err == io.EOF {
+				return
+			}
+			if !yield(chunk, err) || err != nil {
+				return
+			}
+		}
+	}
 }
 
 // Close closes the stream and releases underlying resources.
@@ -267,5 +599,9 @@ func (r *StreamReader) Close() error {
 	C.extractous_stream_free(r.ptr)
 	r.ptr = nil
 	r.closed = true
+	r.buf = nil
+	r.start, r.end = 0, 0
+	r.cancel.release()
+	r.cancel = nil
 	return nil
 }
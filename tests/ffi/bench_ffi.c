@@ -0,0 +1,695 @@
+/**
+ * FFI Benchmarks for Extractous
+ *
+ * Runs every extraction entry point over a corpus of documents and reports,
+ * per (entry point, document): documents/s, MB/s of input, p50/p99 latency,
+ * C heap allocations per call and the process's peak RSS.
+ *
+ * Usage: bench_ffi [-n iterations] [-w warmup] [-f filter] [-o out.json] [file...]
+ *
+ * Without files, the corpus is the library's warm-up samples (PDF, DOCX, HTML)
+ * plus generated HTML and plain-text documents of 16 KiB, 256 KiB and 4 MiB.
+ * Files given on the command line are added to it, e.g. larger PDFs, XLSX
+ * workbooks or scanned PDFs. Results are written as JSON to stdout (or the -o
+ * file), and as a table to stderr.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include "../../include/extractous.h"
+
+#define SAMPLES_DIR "../../ffi/samples"
+#define READ_CHUNK (64 * 1024)
+
+// ============================================================================
+// Allocation Counting
+// ============================================================================
+
+// Calls into malloc and friends from the library resolve to these definitions,
+// which count them and forward to glibc. Memory the core runtime manages on its
+// own heap is not seen here, only allocations made through the C allocator.
+#if defined(__GLIBC__) && !defined(BENCH_NO_ALLOC_COUNT)
+#define ALLOC_COUNTING 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+static uint64_t alloc_count = 0;
+
+#define COUNT_ALLOC() __atomic_fetch_add(&alloc_count, 1, __ATOMIC_RELAXED)
+
+void *malloc(size_t size) {
+    COUNT_ALLOC();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    COUNT_ALLOC();
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    COUNT_ALLOC();
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    COUNT_ALLOC();
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    COUNT_ALLOC();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    COUNT_ALLOC();
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr == NULL) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+static uint64_t allocs_now(void) {
+    return __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
+}
+#else
+#define ALLOC_COUNTING 0
+
+static uint64_t allocs_now(void) {
+    return 0;
+}
+#endif
+
+// ============================================================================
+// Corpus
+// ============================================================================
+
+struct bench_doc {
+    char name[64];
+    char path[4096];
+    uint8_t *data;
+    size_t len;
+};
+
+static int load_doc(struct bench_doc *doc, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0 || st.st_size <= 0) {
+        fclose(f);
+        return -1;
+    }
+    doc->len = (size_t)st.st_size;
+    doc->data = malloc(doc->len);
+    if (doc->data == NULL || fread(doc->data, 1, doc->len, f) != doc->len) {
+        free(doc->data);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+
+    snprintf(doc->path, sizeof(doc->path), "%s", path);
+    const char *base = strrchr(path, '/');
+    snprintf(doc->name, sizeof(doc->name), "%s", base ? base + 1 : path);
+    return 0;
+}
+
+// Writes a document of about `size` bytes of repeated paragraphs to `path`.
+static int generate_doc(const char *path, size_t size, int html) {
+    static const char *para =
+        "The quick brown fox jumps over the lazy dog while extraction keeps pace "
+        "with every paragraph, table and heading it is given.";
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        return -1;
+    }
+    size_t written = 0;
+    if (html) {
+        written += fprintf(f, "<html><head><title>Benchmark</title></head><body>\n");
+    }
+    for (int i = 0; written < size; i++) {
+        if (html) {
+            written += i % 16 == 0 ? fprintf(f, "<h2>Section %d</h2>\n", i / 16) : 0;
+            written += fprintf(f, "<p>%s</p>\n", para);
+        } else {
+            written += fprintf(f, "%s\n", para);
+        }
+    }
+    if (html) {
+        fprintf(f, "</body></html>\n");
+    }
+    return fclose(f);
+}
+
+// ============================================================================
+// Entry Points
+// ============================================================================
+
+// Each variant runs one extraction of `doc` and frees its results, storing
+// the number of content bytes produced in `out_len`.
+typedef int (*bench_fn)(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len);
+
+static struct CBuffer *reused_buffer = NULL;
+
+static int drain_stream(struct CStreamReader *reader, size_t *out_len) {
+    static uint8_t chunk[READ_CHUNK];
+    size_t total = 0, n = 0;
+    int code;
+    while ((code = extractous_stream_read(reader, chunk, sizeof(chunk), &n)) == ERR_OK && n > 0) {
+        total += n;
+    }
+    extractous_stream_free(reader);
+    *out_len = total;
+    return code;
+}
+
+static int bench_file_to_string(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    char *content = NULL;
+    struct CMetadata *meta = NULL;
+    int code = extractous_extractor_extract_file_to_string(ex, doc->path, &content, &meta);
+    if (code == ERR_OK) {
+        *out_len = content ? strlen(content) : 0;
+        extractous_string_free(content);
+        extractous_metadata_free(meta);
+    }
+    return code;
+}
+
+static int bench_file_to_buffer(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    uint8_t *buf = NULL;
+    struct CMetadata *meta = NULL;
+    int code = extractous_extractor_extract_file_to_buffer(ex, doc->path, &buf, out_len, &meta);
+    if (code == ERR_OK) {
+        extractous_buffer_free(buf, *out_len);
+        extractous_metadata_free(meta);
+    }
+    return code;
+}
+
+static int bench_file_to_buffer_packed(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    uint8_t *buf = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_file_to_buffer_packed(ex, doc->path, &buf, out_len, &meta);
+    if (code == ERR_OK) {
+        extractous_buffer_free(buf, *out_len);
+        extractous_metadata_packed_free(meta);
+    }
+    return code;
+}
+
+static int bench_file_into(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_file_into(ex, doc->path, reused_buffer, &meta);
+    if (code == ERR_OK) {
+        *out_len = reused_buffer->len;
+        extractous_metadata_packed_free(meta);
+    }
+    return code;
+}
+
+static int bench_file_to_result(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CExtractionResult *result = NULL;
+    int code = extractous_extractor_extract_file_to_result(ex, doc->path, &result);
+    if (code == ERR_OK) {
+        *out_len = result->content_len;
+        extractous_result_free(result);
+    }
+    return code;
+}
+
+static int bench_file_stream(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CStreamReader *reader = NULL;
+    struct CMetadata *meta = NULL;
+    int code = extractous_extractor_extract_file(ex, doc->path, &reader, &meta);
+    if (code != ERR_OK) {
+        return code;
+    }
+    extractous_metadata_free(meta);
+    return drain_stream(reader, out_len);
+}
+
+static int bench_file_stream_packed(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_file_packed(ex, doc->path, &reader, &meta);
+    if (code != ERR_OK) {
+        return code;
+    }
+    extractous_metadata_packed_free(meta);
+    return drain_stream(reader, out_len);
+}
+
+static int bench_file_stream_read_all(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_file_packed(ex, doc->path, &reader, &meta);
+    if (code != ERR_OK) {
+        return code;
+    }
+    extractous_metadata_packed_free(meta);
+    uint8_t *buf = NULL;
+    code = extractous_stream_read_all(reader, &buf, out_len);
+    if (code == ERR_OK) {
+        extractous_buffer_free(buf, *out_len);
+    }
+    extractous_stream_free(reader);
+    return code;
+}
+
+static int bench_mmap_stream(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_mmap_packed(ex, doc->path, &reader, &meta);
+    if (code != ERR_OK) {
+        return code;
+    }
+    extractous_metadata_packed_free(meta);
+    return drain_stream(reader, out_len);
+}
+
+static int bench_mmap_to_buffer_packed(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    uint8_t *buf = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_mmap_to_buffer_packed(ex, doc->path, &buf, out_len, &meta);
+    if (code == ERR_OK) {
+        extractous_buffer_free(buf, *out_len);
+        extractous_metadata_packed_free(meta);
+    }
+    return code;
+}
+
+static int bench_file_metadata_only(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_metadata_only_packed(ex, doc->path, &meta);
+    if (code == ERR_OK) {
+        *out_len = 0;
+        extractous_metadata_packed_free(meta);
+    }
+    return code;
+}
+
+static int bench_bytes_to_string(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    char *content = NULL;
+    struct CMetadata *meta = NULL;
+    int code = extractous_extractor_extract_bytes_to_string(ex, doc->data, doc->len, &content, &meta);
+    if (code == ERR_OK) {
+        *out_len = content ? strlen(content) : 0;
+        extractous_string_free(content);
+        extractous_metadata_free(meta);
+    }
+    return code;
+}
+
+static int bench_bytes_to_buffer(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    uint8_t *buf = NULL;
+    struct CMetadata *meta = NULL;
+    int code = extractous_extractor_extract_bytes_to_buffer(ex, doc->data, doc->len, &buf, out_len, &meta);
+    if (code == ERR_OK) {
+        extractous_buffer_free(buf, *out_len);
+        extractous_metadata_free(meta);
+    }
+    return code;
+}
+
+static int bench_bytes_to_buffer_packed(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    uint8_t *buf = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_bytes_to_buffer_packed(ex, doc->data, doc->len, &buf, out_len, &meta);
+    if (code == ERR_OK) {
+        extractous_buffer_free(buf, *out_len);
+        extractous_metadata_packed_free(meta);
+    }
+    return code;
+}
+
+static int bench_bytes_into(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_bytes_into(ex, doc->data, doc->len, reused_buffer, &meta);
+    if (code == ERR_OK) {
+        *out_len = reused_buffer->len;
+        extractous_metadata_packed_free(meta);
+    }
+    return code;
+}
+
+static int bench_bytes_to_result(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CExtractionResult *result = NULL;
+    int code = extractous_extractor_extract_bytes_to_result(ex, doc->data, doc->len, &result);
+    if (code == ERR_OK) {
+        *out_len = result->content_len;
+        extractous_result_free(result);
+    }
+    return code;
+}
+
+static int bench_bytes_stream(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CStreamReader *reader = NULL;
+    struct CMetadata *meta = NULL;
+    int code = extractous_extractor_extract_bytes(ex, doc->data, doc->len, &reader, &meta);
+    if (code != ERR_OK) {
+        return code;
+    }
+    extractous_metadata_free(meta);
+    return drain_stream(reader, out_len);
+}
+
+static int bench_bytes_stream_packed(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_bytes_packed(ex, doc->data, doc->len, &reader, &meta);
+    if (code != ERR_OK) {
+        return code;
+    }
+    extractous_metadata_packed_free(meta);
+    return drain_stream(reader, out_len);
+}
+
+static int bench_bytes_borrowed(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_bytes_borrowed(ex, doc->data, doc->len, NULL, NULL, &reader, &meta);
+    if (code != ERR_OK) {
+        return code;
+    }
+    extractous_metadata_packed_free(meta);
+    return drain_stream(reader, out_len);
+}
+
+struct reader_state {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+};
+
+static intptr_t bench_read_cb(void *user_data, uint8_t *buf, size_t len) {
+    struct reader_state *state = user_data;
+    size_t n = state->len - state->pos;
+    if (n > len) {
+        n = len;
+    }
+    memcpy(buf, state->data + state->pos, n);
+    state->pos += n;
+    return (intptr_t)n;
+}
+
+static int bench_reader(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct reader_state state = { doc->data, doc->len, 0 };
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_reader(ex, bench_read_cb, &state, doc->len, &reader, &meta);
+    if (code != ERR_OK) {
+        return code;
+    }
+    extractous_metadata_packed_free(meta);
+    return drain_stream(reader, out_len);
+}
+
+static int bench_bytes_metadata_only(struct CExtractor *ex, const struct bench_doc *doc, size_t *out_len) {
+    struct CMetadataPacked *meta = NULL;
+    int code = extractous_extractor_extract_bytes_metadata_only_packed(ex, doc->data, doc->len, &meta);
+    if (code == ERR_OK) {
+        *out_len = 0;
+        extractous_metadata_packed_free(meta);
+    }
+    return code;
+}
+
+static const struct {
+    const char *name;
+    bench_fn fn;
+} variants[] = {
+    { "file_to_string", bench_file_to_string },
+    { "file_to_buffer", bench_file_to_buffer },
+    { "file_to_buffer_packed", bench_file_to_buffer_packed },
+    { "file_into", bench_file_into },
+    { "file_to_result", bench_file_to_result },
+    { "file_stream", bench_file_stream },
+    { "file_stream_packed", bench_file_stream_packed },
+    { "file_stream_read_all", bench_file_stream_read_all },
+    { "mmap_stream", bench_mmap_stream },
+    { "mmap_to_buffer_packed", bench_mmap_to_buffer_packed },
+    { "file_metadata_only", bench_file_metadata_only },
+    { "bytes_to_string", bench_bytes_to_string },
+    { "bytes_to_buffer", bench_bytes_to_buffer },
+    { "bytes_to_buffer_packed", bench_bytes_to_buffer_packed },
+    { "bytes_into", bench_bytes_into },
+    { "bytes_to_result", bench_bytes_to_result },
+    { "bytes_stream", bench_bytes_stream },
+    { "bytes_stream_packed", bench_bytes_stream_packed },
+    { "bytes_borrowed", bench_bytes_borrowed },
+    { "reader", bench_reader },
+    { "bytes_metadata_only", bench_bytes_metadata_only },
+};
+
+#define NUM_VARIANTS (sizeof(variants) / sizeof(variants[0]))
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+struct bench_result {
+    int code;
+    int iterations;
+    double total_s;
+    double p50_ms;
+    double p99_ms;
+    double allocs_per_op;
+    size_t content_len;
+    long peak_rss_kb;
+};
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples.
+static double percentile(const double *sorted, int n, double p) {
+    int rank = (int)(p / 100.0 * n + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static void run_case(struct CExtractor *ex, bench_fn fn, const struct bench_doc *doc,
+                     int warmup, int iterations, double *samples, struct bench_result *res) {
+    memset(res, 0, sizeof(*res));
+    for (int i = 0; i < warmup; i++) {
+        size_t len = 0;
+        if ((res->code = fn(ex, doc, &len)) != ERR_OK) {
+            return;
+        }
+    }
+
+    uint64_t allocs = 0;
+    for (int i = 0; i < iterations; i++) {
+        size_t len = 0;
+        uint64_t a0 = allocs_now();
+        double t0 = now_s();
+        res->code = fn(ex, doc, &len);
+        samples[i] = now_s() - t0;
+        allocs += allocs_now() - a0;
+        if (res->code != ERR_OK) {
+            return;
+        }
+        res->total_s += samples[i];
+        res->content_len = len;
+    }
+
+    qsort(samples, iterations, sizeof(double), cmp_double);
+    res->iterations = iterations;
+    res->p50_ms = percentile(samples, iterations, 50) * 1e3;
+    res->p99_ms = percentile(samples, iterations, 99) * 1e3;
+    res->allocs_per_op = (double)allocs / iterations;
+    res->peak_rss_kb = peak_rss_kb();
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+// Writes `s` as a JSON string literal.
+static void json_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fprintf(out, "\\%c", *s);
+        } else if ((unsigned char)*s < 0x20) {
+            fprintf(out, "\\u%04x", *s);
+        } else {
+            fputc(*s, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n iterations] [-w warmup] [-f filter] [-o out.json] [file...]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    int iterations = 20, warmup = 2;
+    const char *filter = NULL, *out_path = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:w:f:o:h")) != -1) {
+        switch (opt) {
+        case 'n': iterations = atoi(optarg); break;
+        case 'w': warmup = atoi(optarg); break;
+        case 'f': filter = optarg; break;
+        case 'o': out_path = optarg; break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (iterations < 1 || warmup < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (out == NULL) {
+        perror(out_path);
+        return 1;
+    }
+
+    char tmpdir[] = "/tmp/extractous-bench-XXXXXX";
+    if (mkdtemp(tmpdir) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    // Build the corpus: samples, generated documents, then the caller's files.
+    static const char *samples_files[] = { "warmup.pdf", "warmup.docx", "warmup.html" };
+    static const size_t gen_sizes[] = { 16 << 10, 256 << 10, 4 << 20 };
+    size_t max_docs = 3 + 2 * 3 + (size_t)(argc - optind);
+    struct bench_doc *docs = calloc(max_docs, sizeof(*docs));
+    char generated[6][4096];
+    int num_generated = 0;
+    size_t num_docs = 0;
+    char path[4096];
+
+    for (size_t i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "%s/%s", SAMPLES_DIR, samples_files[i]);
+        if (load_doc(&docs[num_docs], path) == 0) {
+            num_docs++;
+        } else {
+            fprintf(stderr, "skipping %s: cannot read it\n", path);
+        }
+    }
+    for (size_t i = 0; i < 3; i++) {
+        for (int html = 1; html >= 0; html--) {
+            snprintf(path, sizeof(path), "%s/generated-%zuk.%s", tmpdir, gen_sizes[i] >> 10, html ? "html" : "txt");
+            if (generate_doc(path, gen_sizes[i], html) == 0 && load_doc(&docs[num_docs], path) == 0) {
+                snprintf(generated[num_generated++], sizeof(generated[0]), "%s", path);
+                num_docs++;
+            }
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        if (load_doc(&docs[num_docs], argv[i]) == 0) {
+            num_docs++;
+        } else {
+            fprintf(stderr, "skipping %s: cannot read it\n", argv[i]);
+        }
+    }
+
+    extractous_init(NULL);
+    struct CExtractor *ex = extractous_extractor_new();
+    reused_buffer = extractous_buffer_new(0);
+    double *samples = malloc((size_t)iterations * sizeof(double));
+    if (ex == NULL || reused_buffer == NULL || samples == NULL) {
+        fprintf(stderr, "failed to create the extractor\n");
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"ffi_version\": \"%s\",\n  \"core_version\": \"%s\",\n",
+            extractous_ffi_version(), extractous_core_version());
+    fprintf(out, "  \"iterations\": %d,\n  \"warmup\": %d,\n  \"alloc_counting\": %s,\n  \"results\": [",
+            iterations, warmup, ALLOC_COUNTING ? "true" : "false");
+    fprintf(stderr, "%-24s %-24s %10s %10s %10s %10s %10s %10s\n",
+            "variant", "document", "docs/s", "MB/s", "p50 ms", "p99 ms", "allocs/op", "rss KiB");
+
+    int first = 1;
+    for (size_t d = 0; d < num_docs; d++) {
+        for (size_t v = 0; v < NUM_VARIANTS; v++) {
+            if (filter != NULL && strstr(variants[v].name, filter) == NULL) {
+                continue;
+            }
+            struct bench_result res;
+            run_case(ex, variants[v].fn, &docs[d], warmup, iterations, samples, &res);
+
+            fprintf(out, "%s\n    {\"variant\": \"%s\", \"document\": ", first ? "" : ",", variants[v].name);
+            json_string(out, docs[d].name);
+            fprintf(out, ", \"input_bytes\": %zu, \"code\": %d", docs[d].len, res.code);
+            first = 0;
+            if (res.code != ERR_OK) {
+                fprintf(out, "}");
+                fprintf(stderr, "%-24s %-24s failed with code %d\n", variants[v].name, docs[d].name, res.code);
+                continue;
+            }
+
+            double docs_per_s = res.total_s > 0 ? res.iterations / res.total_s : 0;
+            double mb_per_s = docs_per_s * (double)docs[d].len / 1e6;
+            fprintf(out, ", \"content_bytes\": %zu, \"docs_per_s\": %.2f, \"mb_per_s\": %.3f, "
+                         "\"p50_ms\": %.4f, \"p99_ms\": %.4f, \"allocs_per_op\": %.1f, \"peak_rss_kb\": %ld}",
+                    res.content_len, docs_per_s, mb_per_s, res.p50_ms, res.p99_ms, res.allocs_per_op, res.peak_rss_kb);
+            fprintf(stderr, "%-24s %-24s %10.1f %10.2f %10.3f %10.3f %10.1f %10ld\n",
+                    variants[v].name, docs[d].name, docs_per_s, mb_per_s, res.p50_ms, res.p99_ms,
+                    res.allocs_per_op, res.peak_rss_kb);
+        }
+    }
+    fprintf(out, "\n  ],\n  \"peak_rss_kb\": %ld\n}\n", peak_rss_kb());
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    free(samples);
+    extractous_buffer_destroy(reused_buffer);
+    extractous_extractor_free(ex);
+    for (size_t d = 0; d < num_docs; d++) {
+        free(docs[d].data);
+    }
+    free(docs);
+    for (int i = 0; i < num_generated; i++) {
+        unlink(generated[i]);
+    }
+    rmdir(tmpdir);
+    return 0;
+}
@@ -9,6 +9,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "../../include/extractous.h"
 
 // Test result tracking
@@ -312,38 +315,1959 @@ TEST(string_free_null) {
     extractous_string_free(NULL);
 }
 
+TEST(to_buffer_null_checks) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    struct CMetadata *metadata = NULL;
+    const uint8_t data[] = "hello";
+
+    int result = extractous_extractor_extract_file_to_buffer(
+        extractor, NULL, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null path error code");
+
+    result = extractous_extractor_extract_file_to_buffer(
+        extractor, "test.txt", &buffer, NULL, &metadata
+    );
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null length error code");
+
+    result = extractous_extractor_extract_bytes_to_buffer(
+        NULL, data, sizeof(data) - 1, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null extractor error code");
+
+    result = extractous_extractor_extract_url_to_buffer(
+        extractor, "http://example.com", NULL, &len, &metadata
+    );
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null buffer error code");
+
+    extractous_extractor_free(extractor);
+}
+
+TEST(buffer_free_null) {
+    // Should not crash
+    extractous_buffer_free(NULL, 0);
+}
+
+// ============================================================================
+// Test: Metadata Functions
+// ============================================================================
+
+TEST(metadata_free_null) {
+    // Should not crash
+    extractous_metadata_free(NULL);
+}
+
+TEST(metadata_packed_free_null) {
+    // Should not crash
+    extractous_metadata_packed_free(NULL);
+}
+
+TEST(metadata_packed_layout) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const uint8_t data[] = "Packed metadata layout test";
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    struct CMetadataPacked *metadata = NULL;
+
+    int result = extractous_extractor_extract_bytes_to_buffer_packed(
+        extractor, data, sizeof(data) - 1, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+    ASSERT_NOT_NULL(metadata, "metadata");
+
+    // Key and value tables must be monotonic and end exactly at value_count/data_len.
+    for (size_t i = 0; i < metadata->len; i++) {
+        ASSERT_TRUE(metadata->key_offsets[i] <= metadata->key_offsets[i + 1], "key offsets are monotonic");
+        ASSERT_TRUE(metadata->value_starts[i] <= metadata->value_starts[i + 1], "value starts are monotonic");
+    }
+    ASSERT_TRUE(metadata->value_starts[metadata->len] == metadata->value_count, "value starts end at value_count");
+    for (size_t j = 0; j < metadata->value_count; j++) {
+        ASSERT_TRUE(metadata->value_offsets[j] <= metadata->value_offsets[j + 1], "value offsets are monotonic");
+    }
+    ASSERT_TRUE(metadata->value_offsets[metadata->value_count] == metadata->data_len, "last value offset is data_len");
+
+    extractous_metadata_packed_free(metadata);
+    extractous_buffer_free(buffer, len);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: URL Extraction Functions (if they exist)
+// ============================================================================
+
+TEST(url_extraction_null_checks) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+    
+    char *content = NULL;
+    struct CMetadata *metadata = NULL;
+    
+    // NULL URL
+    int result = extractous_extractor_extract_url_to_string(
+        extractor, NULL, &content, &metadata
+    );
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null URL error code");
+    
+    // NULL outputs
+    result = extractous_extractor_extract_url_to_string(
+        extractor, "http://example.com", NULL, NULL
+    );
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null outputs error code");
+    
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Batch Extraction
+// ============================================================================
+
+TEST(batch_null_checks) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const char *paths[] = { "a.txt", "b.txt" };
+    struct CBatchResult *results = NULL;
+
+    int result = extractous_extractor_extract_files_batch(NULL, paths, 2, 1, &results);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null extractor error code");
+
+    result = extractous_extractor_extract_files_batch(extractor, NULL, 2, 1, &results);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null paths error code");
+
+    result = extractous_extractor_extract_files_batch(extractor, paths, 2, 1, NULL);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null output error code");
+
+    result = extractous_extractor_extract_files_batch(extractor, NULL, 0, 1, &results);
+    ASSERT_EQ(ERR_OK, result, "empty batch error code");
+    ASSERT_NULL(results, "empty batch results");
+
+    extractous_extractor_free(extractor);
+}
+
+TEST(batch_per_item_errors) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const char *paths[] = { "/nonexistent/a.txt", NULL };
+    struct CBatchResult *results = NULL;
+
+    int result = extractous_extractor_extract_files_batch(extractor, paths, 2, 2, &results);
+    ASSERT_EQ(ERR_OK, result, "batch error code");
+    ASSERT_NOT_NULL(results, "results");
+    ASSERT_TRUE(results[0].error_code != ERR_OK, "missing file reports an error");
+    ASSERT_NULL(results[0].content, "failed item content");
+    ASSERT_EQ(ERR_NULL_POINTER, results[1].error_code, "null path error code");
+
+    extractous_batch_results_free(results, 2);
+    extractous_extractor_free(extractor);
+}
+
+TEST(batch_content_with_nul) {
+    const char *path = "batch_nul_test.txt";
+    const char text[] = "before\0after";
+    FILE *file = fopen(path, "wb");
+    ASSERT_NOT_NULL(file, "test file");
+    fwrite(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const char *paths[] = { path };
+    struct CBatchResult *results = NULL;
+    int result = extractous_extractor_extract_files_batch(extractor, paths, 1, 1, &results);
+    ASSERT_EQ(ERR_OK, result, "batch error code");
+    ASSERT_EQ(ERR_OK, results[0].error_code, "item error code");
+    ASSERT_NOT_NULL(results[0].content, "content with a NUL byte");
+    ASSERT_TRUE(results[0].content_len == sizeof(text) - 1, "content length includes the NUL");
+    ASSERT_TRUE(memcmp(results[0].content, text, sizeof(text) - 1) == 0, "content bytes");
+
+    extractous_batch_results_free(results, 1);
+    extractous_extractor_free(extractor);
+    remove(path);
+}
+
+// ============================================================================
+// Test: Statistics
+// ============================================================================
+
+TEST(stats_snapshot) {
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stats_snapshot(NULL), "null output error code");
+
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    extractous_stats_enable(true);
+    extractous_stats_reset();
+
+    const uint8_t data[] = "Statistics test content";
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    struct CMetadataPacked *metadata = NULL;
+    int result = extractous_extractor_extract_bytes_to_buffer_packed(
+        extractor, data, sizeof(data) - 1, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+
+    struct CMetadataPacked *failed = NULL;
+    result = extractous_extractor_extract_mmap_to_buffer_packed(
+        extractor, "/nonexistent/file.txt", &buffer, &len, &failed
+    );
+    ASSERT_EQ(ERR_IO_ERROR, result, "missing file error code");
+
+    // Calls rejected for a NULL handle or output do not count their input.
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_extractor_extract_bytes_to_buffer_packed(
+        NULL, data, sizeof(data) - 1, &buffer, &len, &failed
+    ), "null handle error code");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_extractor_extract_bytes_to_buffer_cancellable(
+        extractor, data, sizeof(data) - 1, NULL, &buffer, &len, NULL
+    ), "null output error code");
+
+    struct CStats stats;
+    ASSERT_EQ(ERR_OK, extractous_stats_snapshot(&stats), "snapshot error code");
+    extractous_stats_enable(false);
+
+    ASSERT_TRUE(stats.enabled, "stats are enabled");
+    ASSERT_TRUE(stats.calls == 1, "one completed call");
+    ASSERT_TRUE(stats.bytes_in == sizeof(data) - 1, "input bytes counted");
+    ASSERT_TRUE(stats.metadata_entries == metadata->len, "metadata entries counted");
+    ASSERT_TRUE(stats.ocr_pages == 0, "no OCR pages for plain text");
+    ASSERT_TRUE(stats.errors == 1, "one error");
+    ASSERT_TRUE(stats.errors_by_code[-ERR_IO_ERROR] == 1, "error counted by code");
+
+    uint64_t bucketed = 0;
+    for (size_t i = 0; i < STATS_LATENCY_BUCKETS; i++) {
+        bucketed += stats.latency_buckets[i];
+    }
+    ASSERT_TRUE(bucketed == stats.calls, "every call lands in one latency bucket");
+    ASSERT_TRUE(stats.latency_bounds_ns[STATS_LATENCY_BUCKETS - 1] == UINT64_MAX, "last bucket is unbounded");
+
+    extractous_metadata_packed_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Stream Reads
+// ============================================================================
+
+TEST(stream_read_null_checks) {
+    size_t n = 0;
+    uint8_t buf[8];
+    struct CIoVec iov = { buf, sizeof(buf) };
+
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_read_into_iov(NULL, &iov, 1, &n), "null handle error code");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_set_buffer_size(NULL, 0), "null handle error code");
+}
+
+TEST(stream_read_into_iov) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const uint8_t data[] = "Vectored stream read test content";
+    struct CStreamReader *expected_reader = NULL;
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+
+    int result = extractous_extractor_extract_bytes_packed(
+        extractor, data, sizeof(data) - 1, &expected_reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+    extractous_metadata_packed_free(metadata);
+    uint8_t *expected = NULL;
+    size_t expected_len = 0;
+    result = extractous_stream_read_all(expected_reader, &expected, &expected_len);
+    ASSERT_EQ(ERR_OK, result, "read_all error code");
+    extractous_stream_free(expected_reader);
+
+    result = extractous_extractor_extract_bytes_packed(
+        extractor, data, sizeof(data) - 1, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+    extractous_metadata_packed_free(metadata);
+
+    // The default read-ahead holds the whole stream after one core read, so a single
+    // call spreads it over every entry.
+    uint8_t first[4];
+    uint8_t rest[4096];
+    struct CIoVec iov[3] = {
+        { first, sizeof(first) },
+        { NULL, 0 },
+        { rest, sizeof(rest) },
+    };
+    size_t n = 0;
+    result = extractous_stream_read_into_iov(reader, iov, 3, &n);
+    ASSERT_EQ(ERR_OK, result, "read_into_iov error code");
+    ASSERT_TRUE(n == expected_len, "buffered bytes fill every iov entry");
+    ASSERT_TRUE(memcmp(first, expected, sizeof(first)) == 0, "first iov content");
+    ASSERT_TRUE(memcmp(rest, expected + sizeof(first), n - sizeof(first)) == 0, "second iov content");
+
+    result = extractous_stream_read_into_iov(reader, iov, 3, &n);
+    ASSERT_EQ(ERR_OK, result, "read_into_iov at end error code");
+    ASSERT_TRUE(n == 0, "no bytes after end of stream");
+    extractous_stream_free(reader);
+
+    result = extractous_extractor_extract_bytes_packed(
+        extractor, data, sizeof(data) - 1, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+    extractous_metadata_packed_free(metadata);
+
+    // With a tiny read-ahead buffer every call makes one core read and returns short,
+    // before the end of the stream.
+    ASSERT_EQ(ERR_OK, extractous_stream_set_buffer_size(reader, 3), "set_buffer_size error code");
+    uint8_t all[4096];
+    size_t total = 0;
+    int calls = 0;
+    do {
+        result = extractous_stream_read_into_iov(reader, iov, 3, &n);
+        ASSERT_EQ(ERR_OK, result, "read_into_iov error code");
+        ASSERT_TRUE(n <= sizeof(first), "one core read per call");
+        memcpy(all + total, first, n);
+        total += n;
+        calls++;
+    } while (n > 0);
+    ASSERT_TRUE(calls > 2, "short reads before the end of the stream");
+    ASSERT_TRUE(total == expected_len, "iov reads return the whole stream");
+    ASSERT_TRUE(memcmp(all, expected, total) == 0, "iov read content");
+
+    extractous_buffer_free(expected, expected_len);
+    extractous_stream_free(reader);
+    extractous_extractor_free(extractor);
+}
+
+TEST(stream_copy_to_fd) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const uint8_t data[] = "Copied straight to a file descriptor";
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+    int result = extractous_extractor_extract_bytes_packed(
+        extractor, data, sizeof(data) - 1, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+    extractous_metadata_packed_free(metadata);
+
+    size_t written = 0;
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_copy_to_fd(reader, 1, NULL), "null output error code");
+
+    FILE *out = tmpfile();
+    ASSERT_NOT_NULL(out, "temporary file");
+    result = extractous_stream_copy_to_fd(reader, fileno(out), &written);
+    ASSERT_EQ(ERR_OK, result, "copy_to_fd error code");
+    ASSERT_TRUE(written > 0, "bytes were written");
+
+    fseek(out, 0, SEEK_END);
+    ASSERT_TRUE((size_t)ftell(out) == written, "file size matches bytes written");
+
+    fclose(out);
+    extractous_stream_free(reader);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Borrowed-Bytes Extraction
+// ============================================================================
+
+static void count_release(void *user_data) {
+    (*(int *)user_data)++;
+}
+
+TEST(borrowed_release_on_error) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    int released = 0;
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+
+    int result = extractous_extractor_extract_bytes_borrowed(
+        extractor, NULL, 0, count_release, &released, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null data error code");
+    ASSERT_EQ(1, released, "release count after failure");
+
+    extractous_extractor_free(extractor);
+}
+
+TEST(borrowed_release_on_stream_free) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const uint8_t data[] = "Borrowed bytes content";
+    int released = 0;
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+
+    int result = extractous_extractor_extract_bytes_borrowed(
+        extractor, data, sizeof(data) - 1, count_release, &released, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+    ASSERT_NOT_NULL(reader, "reader");
+    ASSERT_EQ(0, released, "release count while stream is open");
+
+    extractous_stream_free(reader);
+    ASSERT_EQ(1, released, "release count after stream free");
+
+    extractous_metadata_packed_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Read-Callback Extraction
+// ============================================================================
+
+struct chunked_input {
+    const char *data;
+    size_t len;
+    size_t pos;
+    size_t chunk;
+};
+
+// Serves the input a few bytes at a time to exercise repeated callbacks.
+static intptr_t read_chunked(void *user_data, uint8_t *buf, size_t len) {
+    struct chunked_input *in = (struct chunked_input *)user_data;
+    size_t n = in->len - in->pos;
+    if (n > in->chunk) n = in->chunk;
+    if (n > len) n = len;
+    memcpy(buf, in->data + in->pos, n);
+    in->pos += n;
+    return (intptr_t)n;
+}
+
+static intptr_t read_failing(void *user_data, uint8_t *buf, size_t len) {
+    (void)user_data; (void)buf; (void)len;
+    return -1;
+}
+
+TEST(reader_null_checks) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+
+    int result = extractous_extractor_extract_reader(extractor, NULL, NULL, 0, &reader, &metadata);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null callback error code");
+
+    result = extractous_extractor_extract_reader(NULL, read_failing, NULL, 0, &reader, &metadata);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null extractor error code");
+
+    extractous_extractor_free(extractor);
+}
+
+TEST(reader_callback_error) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+
+    int result = extractous_extractor_extract_reader(
+        extractor, read_failing, NULL, 0, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_IO_ERROR, result, "callback error code");
+    ASSERT_NULL(reader, "reader");
+
+    extractous_extractor_free(extractor);
+}
+
+TEST(reader_chunked_input) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const char text[] = "Streamed through a read callback";
+    struct chunked_input in = { text, sizeof(text) - 1, 0, 5 };
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+
+    int result = extractous_extractor_extract_reader(
+        extractor, read_chunked, &in, 0, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+    ASSERT_NOT_NULL(reader, "reader");
+    ASSERT_TRUE(in.pos == in.len, "input read to the end");
+
+    uint8_t *buffer = NULL;
+    size_t size = 0;
+    result = extractous_stream_read_all(reader, &buffer, &size);
+    ASSERT_EQ(ERR_OK, result, "read_all error code");
+    ASSERT_TRUE(size > 0, "stream has content");
+
+    extractous_buffer_free(buffer, size);
+    extractous_stream_free(reader);
+    extractous_metadata_packed_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Memory-Mapped Extraction
+// ============================================================================
+
+TEST(mmap_null_checks) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    struct CStreamReader *reader = NULL;
+    struct CMetadata *metadata = NULL;
+
+    int result = extractous_extractor_extract_mmap(NULL, "test.txt", &reader, &metadata);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null extractor error code");
+
+    result = extractous_extractor_extract_mmap(extractor, NULL, &reader, &metadata);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null path error code");
+
+    result = extractous_extractor_extract_mmap(extractor, "test.txt", NULL, &metadata);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null reader error code");
+
+    extractous_extractor_free(extractor);
+}
+
+TEST(mmap_missing_file) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+
+    int result = extractous_extractor_extract_mmap_packed(
+        extractor, "/nonexistent/file.txt", &reader, &metadata
+    );
+    ASSERT_EQ(ERR_IO_ERROR, result, "missing file error code");
+    ASSERT_NULL(reader, "reader");
+
+    extractous_extractor_free(extractor);
+}
+
+TEST(mmap_stream_outlives_call) {
+    const char *path = "mmap_test.txt";
+    const char text[] = "Memory mapped content";
+    FILE *file = fopen(path, "wb");
+    ASSERT_NOT_NULL(file, "test file");
+    fwrite(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+    int result = extractous_extractor_extract_mmap_packed(extractor, path, &reader, &metadata);
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+    ASSERT_NOT_NULL(reader, "reader");
+
+    // The stream must still be readable after the call that created the mapping returned.
+    uint8_t *buffer = NULL;
+    size_t size = 0;
+    result = extractous_stream_read_all(reader, &buffer, &size);
+    ASSERT_EQ(ERR_OK, result, "read_all error code");
+    ASSERT_TRUE(size > 0, "stream has content");
+
+    extractous_buffer_free(buffer, size);
+    extractous_stream_free(reader);
+    extractous_metadata_packed_free(metadata);
+    extractous_extractor_free(extractor);
+    remove(path);
+}
+
+// ============================================================================
+// Test: Async Extraction
+// ============================================================================
+
+struct async_outcome {
+    int calls;
+    int error_code;
+    uint8_t *content;
+    size_t content_len;
+    struct CMetadataPacked *metadata;
+};
+
+static void record_outcome(void *user_data, int error_code, uint8_t *content,
+                           size_t content_len, struct CMetadataPacked *metadata) {
+    struct async_outcome *outcome = user_data;
+    outcome->calls++;
+    outcome->error_code = error_code;
+    outcome->content = content;
+    outcome->content_len = content_len;
+    outcome->metadata = metadata;
+}
+
+TEST(async_null_checks) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+    struct async_outcome outcome = {0};
+    struct CAsyncJob *job = (struct CAsyncJob *)&outcome;
+
+    int result = extractous_extractor_extract_file_async(NULL, "file.txt", record_outcome, &outcome, &job);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null extractor error code");
+    ASSERT_TRUE(job == NULL, "job is cleared on error");
+    result = extractous_extractor_extract_file_async(extractor, NULL, record_outcome, &outcome, &job);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null path error code");
+    result = extractous_extractor_extract_file_async(extractor, "file.txt", NULL, &outcome, &job);
+    ASSERT_EQ(ERR_NULL_POINTER, result, "null callback error code");
+    ASSERT_EQ(0, outcome.calls, "callback not invoked for rejected jobs");
+
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_job_wait(NULL), "wait on null job");
+    ASSERT_TRUE(!extractous_job_is_done(NULL), "null job is not done");
+    extractous_job_free(NULL);
+
+    extractous_extractor_free(extractor);
+}
+
+TEST(async_missing_file) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    struct async_outcome outcome = {0};
+    struct CAsyncJob *job = NULL;
+    int result = extractous_extractor_extract_file_async(
+        extractor, "/nonexistent/file.txt", record_outcome, &outcome, &job
+    );
+    ASSERT_EQ(ERR_OK, result, "submit error code");
+    ASSERT_NOT_NULL(job, "job");
+
+    ASSERT_EQ(ERR_IO_ERROR, extractous_job_wait(job), "job error code");
+    ASSERT_TRUE(extractous_job_is_done(job), "job is done after wait");
+    ASSERT_EQ(1, outcome.calls, "callback invoked once");
+    ASSERT_EQ(ERR_IO_ERROR, outcome.error_code, "callback error code");
+    ASSERT_TRUE(outcome.content == NULL && outcome.metadata == NULL, "no outputs on error");
+
+    extractous_job_free(job);
+    extractous_extractor_free(extractor);
+}
+
+TEST(async_extractor_freed_before_completion) {
+    const char *path = "async_test.txt";
+    const char text[] = "Async extraction content";
+    FILE *file = fopen(path, "wb");
+    ASSERT_NOT_NULL(file, "test file");
+    fwrite(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    struct async_outcome outcome = {0};
+    struct CAsyncJob *job = NULL;
+    int result = extractous_extractor_extract_file_async(extractor, path, record_outcome, &outcome, &job);
+    ASSERT_EQ(ERR_OK, result, "submit error code");
+
+    // The job captured the configuration, so the handle can go away immediately.
+    extractous_extractor_free(extractor);
+
+    ASSERT_EQ(ERR_OK, extractous_job_wait(job), "job error code");
+    ASSERT_EQ(1, outcome.calls, "callback invoked once");
+    ASSERT_TRUE(outcome.content_len > 0, "content delivered");
+    ASSERT_NOT_NULL(outcome.metadata, "metadata delivered");
+
+    extractous_buffer_free(outcome.content, outcome.content_len);
+    extractous_metadata_packed_free(outcome.metadata);
+    extractous_job_free(job);
+    remove(path);
+}
+
+// ============================================================================
+// Test: Cancellation
+// ============================================================================
+
+TEST(cancel_token_lifecycle) {
+    ASSERT_TRUE(!extractous_cancel_token_is_cancelled(NULL), "null token is not cancelled");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_cancel_token_set_timeout_ms(NULL, 10), "null token timeout");
+    extractous_cancel_token_cancel(NULL);
+    extractous_cancel_token_free(NULL);
+
+    struct CCancelToken *token = extractous_cancel_token_new();
+    ASSERT_NOT_NULL(token, "token");
+    ASSERT_TRUE(!extractous_cancel_token_is_cancelled(token), "new token is not cancelled");
+    extractous_cancel_token_cancel(token);
+    extractous_cancel_token_cancel(token);
+    ASSERT_TRUE(extractous_cancel_token_is_cancelled(token), "token is cancelled");
+    extractous_cancel_token_free(token);
+}
+
+TEST(cancel_token_deadline) {
+    struct CCancelToken *token = extractous_cancel_token_new();
+    ASSERT_NOT_NULL(token, "token");
+
+    ASSERT_EQ(ERR_OK, extractous_cancel_token_set_timeout_ms(token, 1), "set timeout");
+    clock_t start = clock();
+    while (!extractous_cancel_token_is_cancelled(token) && clock() - start < 2 * CLOCKS_PER_SEC) {
+    }
+    ASSERT_TRUE(extractous_cancel_token_is_cancelled(token), "deadline passed");
+
+    // Clearing the deadline un-expires a token that was never cancelled explicitly.
+    ASSERT_EQ(ERR_OK, extractous_cancel_token_set_timeout_ms(token, 0), "clear timeout");
+    ASSERT_TRUE(!extractous_cancel_token_is_cancelled(token), "deadline cleared");
+
+    extractous_cancel_token_free(token);
+}
+
+TEST(stream_cancel) {
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_set_cancel_token(NULL, NULL), "null stream");
+
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const uint8_t data[] = "Content that will be cancelled part way through";
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+    int result = extractous_extractor_extract_bytes_packed(extractor, data, sizeof(data) - 1, &reader, &metadata);
+    ASSERT_EQ(ERR_OK, result, "extraction error code");
+
+    struct CCancelToken *token = extractous_cancel_token_new();
+    ASSERT_EQ(ERR_OK, extractous_stream_set_cancel_token(reader, token), "attach token");
+    // The stream holds its own reference.
+    extractous_cancel_token_cancel(token);
+    extractous_cancel_token_free(token);
+
+    uint8_t buf[4];
+    size_t n = 0;
+    ASSERT_EQ(ERR_CANCELLED, extractous_stream_read(reader, buf, sizeof(buf), &n), "read after cancel");
+    ASSERT_TRUE(n == 0, "no bytes after cancel");
+    ASSERT_EQ(ERR_CANCELLED, extractous_stream_read(reader, buf, sizeof(buf), &n), "cancellation is sticky");
+
+    uint8_t *all = NULL;
+    size_t size = 0;
+    ASSERT_EQ(ERR_CANCELLED, extractous_stream_read_all(reader, &all, &size), "read_all after cancel");
+
+    extractous_stream_free(reader);
+    extractous_metadata_packed_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+TEST(cancellable_buffer_extraction) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    const uint8_t data[] = "Cancellable extraction content";
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    struct CMetadataPacked *metadata = NULL;
+
+    // A NULL token cannot be cancelled.
+    int result = extractous_extractor_extract_bytes_to_buffer_cancellable(
+        extractor, data, sizeof(data) - 1, NULL, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "uncancelled error code");
+    ASSERT_TRUE(len > 0, "content extracted");
+    ASSERT_NOT_NULL(metadata, "metadata");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_packed_free(metadata);
+
+    struct CCancelToken *token = extractous_cancel_token_new();
+    extractous_cancel_token_cancel(token);
+    buffer = NULL;
+    metadata = NULL;
+    result = extractous_extractor_extract_bytes_to_buffer_cancellable(
+        extractor, data, sizeof(data) - 1, token, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_CANCELLED, result, "cancelled error code");
+    ASSERT_TRUE(buffer == NULL && metadata == NULL, "no outputs when cancelled");
+
+    result = extractous_extractor_extract_file_to_buffer_cancellable(
+        extractor, "/nonexistent/file.txt", token, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_CANCELLED, result, "cancelled before the file is opened");
+
+    extractous_cancel_token_free(token);
+    extractous_extractor_free(extractor);
+}
+
+TEST(cancellable_budget_utf8) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    // "caf\u00e9s": a limit of 4 bytes ends inside the two-byte "\u00e9".
+    const uint8_t data[] = "caf\xc3\xa9s";
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    struct CMetadataPacked *metadata = NULL;
+
+    extractous_extractor_set_content_budget_mut(extractor, 4);
+    int result = extractous_extractor_extract_bytes_to_buffer_cancellable(
+        extractor, data, sizeof(data) - 1, NULL, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "budget error code");
+    ASSERT_TRUE(len == 3 && memcmp(buffer, "caf", 3) == 0, "budget cut on a character boundary");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_packed_free(metadata);
+
+    // The max length applies too, and the content stays UTF-8 whatever the charset.
+    extractous_extractor_set_content_budget_mut(extractor, 0);
+    extractous_extractor_set_extract_string_max_length_mut(extractor, 4);
+    extractous_extractor_set_encoding_mut(extractor, CHARSET_UTF_16BE);
+    result = extractous_extractor_extract_bytes_to_buffer_cancellable(
+        extractor, data, sizeof(data) - 1, NULL, &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "max length error code");
+    ASSERT_TRUE(len == 3 && memcmp(buffer, "caf", 3) == 0, "max length cut in UTF-8");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_packed_free(metadata);
+
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Shared Extractor
+// ============================================================================
+
+#define SHARED_WORKERS 4
+#define SHARED_ITERATIONS 50
+#define SHARED_BUDGET 8
+
+struct shared_worker {
+    struct CExtractor *extractor;
+    int failures;
+};
+
+static void *extract_repeatedly(void *arg) {
+    struct shared_worker *worker = arg;
+    const uint8_t data[] = "Shared extractor content";
+    for (int i = 0; i < SHARED_ITERATIONS; i++) {
+        uint8_t *buffer = NULL;
+        size_t len = 0;
+        struct CMetadataPacked *metadata = NULL;
+        int result = extractous_extractor_extract_bytes_to_buffer_packed(
+            worker->extractor, data, sizeof(data) - 1, &buffer, &len, &metadata
+        );
+        if (result != ERR_OK) {
+            worker->failures++;
+            continue;
+        }
+        // Either budget the reconfiguring thread sets, never a mix of two settings.
+        if (len != sizeof(data) - 1 && len != SHARED_BUDGET) {
+            worker->failures++;
+        }
+        extractous_buffer_free(buffer, len);
+        extractous_metadata_packed_free(metadata);
+    }
+    return NULL;
+}
+
+TEST(shared_extractor_concurrent_reconfigure) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(extractor, "extractor");
+
+    pthread_t threads[SHARED_WORKERS];
+    struct shared_worker workers[SHARED_WORKERS];
+    for (int i = 0; i < SHARED_WORKERS; i++) {
+        workers[i].extractor = extractor;
+        workers[i].failures = 0;
+        ASSERT_EQ(0, pthread_create(&threads[i], NULL, extract_repeatedly, &workers[i]), "spawn worker");
+    }
+
+    // Reconfigure the handle while the workers extract with it.
+    for (int i = 0; i < SHARED_ITERATIONS; i++) {
+        extractous_extractor_set_xml_output_mut(extractor, i % 2 == 0);
+        extractous_extractor_set_extract_string_max_length_mut(extractor, 1000 + i);
+        extractous_extractor_set_encoding_mut(extractor, -1); // Invalid; ignored
+        extractous_extractor_set_normalization_mut(extractor, i % 3 == 0 ? NORMALIZE_ALL : 0);
+        extractous_extractor_set_content_budget_mut(extractor, i % 2 == 0 ? SHARED_BUDGET : 0);
+    }
+
+    int failures = 0;
+    for (int i = 0; i < SHARED_WORKERS; i++) {
+        pthread_join(threads[i], NULL);
+        failures += workers[i].failures;
+    }
+    ASSERT_EQ(0, failures, "every concurrent extraction succeeded");
+
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Extractor Pool
+// ============================================================================
+
+TEST(pool_acquire_release) {
+    struct CExtractorPool *pool = extractous_pool_new(NULL, 2);
+    ASSERT_NOT_NULL(pool, "pool");
+    ASSERT_EQ(2, (int)extractous_pool_size(pool), "pool size");
+
+    struct CExtractor *first = extractous_pool_acquire(pool);
+    struct CExtractor *second = extractous_pool_try_acquire(pool);
+    ASSERT_NOT_NULL(first, "first extractor");
+    ASSERT_NOT_NULL(second, "second extractor");
+    ASSERT_TRUE(first != second, "distinct extractors");
+    ASSERT_NULL(extractous_pool_try_acquire(pool), "exhausted pool does not block");
+
+    ASSERT_EQ(ERR_OK, extractous_pool_release(pool, first), "release");
+    ASSERT_EQ(ERR_INVALID_CONFIG, extractous_pool_release(pool, first), "double release");
+
+    struct CExtractor *foreign = extractous_extractor_new();
+    ASSERT_EQ(ERR_INVALID_CONFIG, extractous_pool_release(pool, foreign), "foreign extractor");
+    extractous_extractor_free(foreign);
+
+    ASSERT_TRUE(extractous_pool_try_acquire(pool) == first, "released extractor is reused");
+    ASSERT_EQ(ERR_OK, extractous_pool_release(pool, first), "release first");
+    ASSERT_EQ(ERR_OK, extractous_pool_release(pool, second), "release second");
+
+    ASSERT_NULL(extractous_pool_acquire(NULL), "NULL pool");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_pool_release(NULL, first), "release to NULL pool");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_pool_release(pool, NULL), "release NULL");
+    ASSERT_EQ(0, (int)extractous_pool_size(NULL), "size of NULL pool");
+
+    extractous_pool_free(pool);
+    extractous_pool_free(NULL);
+}
+
+TEST(pool_restores_configuration) {
+    struct CExtractor *config = extractous_extractor_new();
+    extractous_extractor_set_extract_string_max_length_mut(config, 1000);
+    struct CExtractorPool *pool = extractous_pool_new(config, 1);
+    // The pool keeps its own copy of the configuration.
+    extractous_extractor_free(config);
+    ASSERT_NOT_NULL(pool, "pool");
+
+    const uint8_t data[] = "Pooled extractor content";
+    struct CExtractor *extractor = extractous_pool_acquire(pool);
+    ASSERT_NOT_NULL(extractor, "acquire");
+    extractous_extractor_set_extract_string_max_length_mut(extractor, 6);
+
+    char *content = NULL;
+    struct CMetadata *metadata = NULL;
+    int result = extractous_extractor_extract_bytes_to_string(
+        extractor, data, sizeof(data) - 1, &content, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extract with reconfigured extractor");
+    ASSERT_EQ(6, (int)strlen(content), "lease configuration applies");
+    extractous_string_free(content);
+    extractous_metadata_free(metadata);
+    ASSERT_EQ(ERR_OK, extractous_pool_release(pool, extractor), "release");
+
+    extractor = extractous_pool_acquire(pool);
+    result = extractous_extractor_extract_bytes_to_string(
+        extractor, data, sizeof(data) - 1, &content, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "extract after release");
+    ASSERT_EQ((int)sizeof(data) - 1, (int)strlen(content), "pool configuration restored");
+    extractous_string_free(content);
+    extractous_metadata_free(metadata);
+    extractous_pool_release(pool, extractor);
+
+    extractous_pool_free(pool);
+}
+
+// ============================================================================
+// Test: Initialization
+// ============================================================================
+
+TEST(init_and_warmup) {
+    ASSERT_EQ(ERR_OK, extractous_init(NULL), "init with defaults");
+
+    struct CInitOptions opts = { .warmup_formats = 0, .start_workers = false };
+    ASSERT_EQ(ERR_OK, extractous_init(&opts), "init without warm-up");
+    opts.warmup_formats = 1u << 31;
+    ASSERT_EQ(ERR_INVALID_ENUM, extractous_init(&opts), "init with unknown format");
+
+    // Warm-up samples are not counted in the statistics.
+    extractous_stats_reset();
+    extractous_stats_enable(true);
+    ASSERT_EQ(ERR_OK, extractous_warmup(WARMUP_FORMAT_ALL), "warm up every format");
+    ASSERT_EQ(ERR_OK, extractous_warmup(WARMUP_FORMAT_PDF | WARMUP_FORMAT_HTML), "warm up some");
+    ASSERT_EQ(ERR_OK, extractous_warmup(0), "empty mask");
+    struct CStats stats;
+    ASSERT_EQ(ERR_OK, extractous_stats_snapshot(&stats), "snapshot");
+    ASSERT_EQ(0, (int)stats.calls, "warm-up not counted");
+    extractous_stats_enable(false);
+
+    ASSERT_EQ(ERR_INVALID_ENUM, extractous_warmup(WARMUP_FORMAT_ALL + 1), "unknown format");
+}
+
+// ============================================================================
+// Test: Result Cache
+// ============================================================================
+
+// Extracts data through the packed buffer entry point, freeing the results.
+static int extract_and_discard(struct CExtractor *extractor, const uint8_t *data, size_t len) {
+    uint8_t *buffer = NULL;
+    size_t out_len = 0;
+    struct CMetadataPacked *metadata = NULL;
+    int result = extractous_extractor_extract_bytes_to_buffer_packed(
+        extractor, data, len, &buffer, &out_len, &metadata
+    );
+    if (result == ERR_OK) {
+        extractous_buffer_free(buffer, out_len);
+        extractous_metadata_packed_free(metadata);
+    }
+    return result;
+}
+
+static struct CStats stats_now(void) {
+    struct CStats stats;
+    extractous_stats_snapshot(&stats);
+    return stats;
+}
+
+TEST(cache_hits_and_misses) {
+    struct CResultCache *cache = extractous_cache_new(1 << 20);
+    struct CExtractor *extractor = extractous_extractor_new();
+    ASSERT_NOT_NULL(cache, "cache");
+    extractous_extractor_set_cache_mut(extractor, cache);
+    // The extractor keeps its own reference.
+    extractous_cache_free(cache);
+
+    extractous_stats_enable(true);
+    extractous_stats_reset();
+
+    const uint8_t data[] = "Cached content";
+    char *first = NULL;
+    char *second = NULL;
+    struct CMetadata *metadata = NULL;
+    ASSERT_EQ(ERR_OK, extractous_extractor_extract_bytes_to_string(
+        extractor, data, sizeof(data) - 1, &first, &metadata), "first extraction");
+    extractous_metadata_free(metadata);
+    ASSERT_EQ(ERR_OK, extractous_extractor_extract_bytes_to_string(
+        extractor, data, sizeof(data) - 1, &second, &metadata), "second extraction");
+    ASSERT_TRUE(metadata != NULL && metadata->len > 0, "cached metadata returned");
+    extractous_metadata_free(metadata);
+    ASSERT_TRUE(strcmp(first, second) == 0, "hit returns the cached content");
+    extractous_string_free(first);
+    extractous_string_free(second);
+
+    struct CStats stats = stats_now();
+    ASSERT_TRUE(stats.cache_misses == 1 && stats.cache_hits == 1, "one miss then one hit");
+
+    // A different configuration is a different entry.
+    extractous_extractor_set_xml_output_mut(extractor, true);
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "reconfigured");
+    stats = stats_now();
+    ASSERT_TRUE(stats.cache_misses == 2, "configuration is part of the key");
+
+    // Detached extractors do not consult the cache.
+    extractous_extractor_set_cache_mut(extractor, NULL);
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "detached");
+    stats = stats_now();
+    ASSERT_TRUE(stats.cache_hits == 1 && stats.cache_misses == 2, "detached cache untouched");
+    extractous_stats_enable(false);
+
+    extractous_extractor_set_cache_mut(NULL, NULL);
+    extractous_cache_clear(NULL);
+    extractous_cache_free(NULL);
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_cache_set_disk_tier(NULL, "/tmp", 0), "NULL cache");
+    extractous_extractor_free(extractor);
+}
+
+TEST(cache_lru_eviction) {
+    // Room for two of the documents below, but not three.
+    struct CResultCache *cache = extractous_cache_new(12 * 1024);
+    struct CExtractor *extractor = extractous_extractor_new();
+    extractous_extractor_set_cache_mut(extractor, cache);
+
+    static uint8_t docs[3][5000];
+    for (int i = 0; i < 3; i++) {
+        memset(docs[i], 'a' + i, sizeof(docs[i]));
+    }
+
+    extractous_stats_enable(true);
+    extractous_stats_reset();
+    extract_and_discard(extractor, docs[0], sizeof(docs[0]));
+    extract_and_discard(extractor, docs[1], sizeof(docs[1]));
+    extract_and_discard(extractor, docs[0], sizeof(docs[0])); // docs[1] is now the oldest
+    extract_and_discard(extractor, docs[2], sizeof(docs[2])); // Evicts docs[1]
+    struct CStats before = stats_now();
+    extract_and_discard(extractor, docs[0], sizeof(docs[0]));
+    struct CStats after_recent = stats_now();
+    extract_and_discard(extractor, docs[1], sizeof(docs[1]));
+    struct CStats after_evicted = stats_now();
+    extractous_stats_enable(false);
+
+    ASSERT_TRUE(after_recent.cache_hits == before.cache_hits + 1, "recently used entry kept");
+    ASSERT_TRUE(after_evicted.cache_misses == after_recent.cache_misses + 1, "oldest entry evicted");
+
+    extractous_extractor_free(extractor);
+    extractous_cache_free(cache);
+}
+
+TEST(cache_disk_tier) {
+    char dir[] = "/tmp/extractous-cache-XXXXXX";
+    ASSERT_NOT_NULL(mkdtemp(dir), "temporary directory");
+
+    const uint8_t data[] = "Disk cached content";
+    struct CExtractor *extractor = extractous_extractor_new();
+    struct CResultCache *cache = extractous_cache_new(0); // Disk only
+    ASSERT_EQ(ERR_OK, extractous_cache_set_disk_tier(cache, dir, 1 << 20), "attach disk tier");
+    extractous_extractor_set_cache_mut(extractor, cache);
+
+    extractous_stats_enable(true);
+    extractous_stats_reset();
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "miss");
+    // Keys must not change between releases, or upgrades would orphan every entry.
+    char entry[256];
+    snprintf(entry, sizeof(entry), "%s/%s", dir,
+             "130000000000000061e61d08eb625a16cfcf3cf7bfd9aacc27011c2ca7aa1c41.exc");
+    ASSERT_EQ(0, access(entry, F_OK), "entry stored under its stable key");
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "disk hit");
+    struct CStats stats = stats_now();
+    ASSERT_TRUE(stats.cache_disk_hits == 1, "answered from disk");
+
+    // A new cache over the same directory sees the entry, as after a restart.
+    struct CResultCache *reopened = extractous_cache_new(1 << 20);
+    ASSERT_EQ(ERR_OK, extractous_cache_set_disk_tier(reopened, dir, 1 << 20), "reopen disk tier");
+    extractous_extractor_set_cache_mut(extractor, reopened);
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "reopened hit");
+    stats = stats_now();
+    ASSERT_TRUE(stats.cache_disk_hits == 2, "entry survives a new cache");
+
+    extractous_cache_clear(reopened);
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "after clear");
+    stats = stats_now();
+    ASSERT_TRUE(stats.cache_disk_hits == 2 && stats.cache_misses == 2, "clear drops entries");
+    extractous_stats_enable(false);
+
+    extractous_extractor_free(extractor);
+    extractous_cache_clear(reopened);
+    extractous_cache_free(reopened);
+    extractous_cache_free(cache);
+    ASSERT_EQ(0, rmdir(dir), "clear leaves the directory empty");
+}
+
+TEST(cache_key_parser_config) {
+    const uint8_t data[] = "Parser config keyed content";
+    struct CExtractor *extractor = extractous_extractor_new();
+    struct CResultCache *cache = extractous_cache_new(1 << 20);
+    extractous_extractor_set_cache_mut(extractor, cache);
+
+    extractous_stats_enable(true);
+    extractous_stats_reset();
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "default config");
+
+    struct CPdfParserConfig *pdf = extractous_pdf_config_new();
+    extractous_pdf_config_set_extract_annotation_text(pdf, false);
+    extractous_extractor_set_pdf_config_mut(extractor, pdf);
+    extractous_pdf_config_free(pdf);
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "changed PDF config");
+
+    // Another config handle with the same settings shares the entry.
+    pdf = extractous_pdf_config_new();
+    extractous_pdf_config_set_extract_annotation_text(pdf, false);
+    extractous_extractor_set_pdf_config_mut(extractor, pdf);
+    extractous_pdf_config_free(pdf);
+    ASSERT_EQ(ERR_OK, extract_and_discard(extractor, data, sizeof(data) - 1), "same PDF settings");
+
+    struct CStats stats = stats_now();
+    ASSERT_TRUE(stats.cache_misses == 2 && stats.cache_hits == 1, "keyed by parser settings");
+    extractous_stats_enable(false);
+
+    extractous_extractor_free(extractor);
+    extractous_cache_free(cache);
+}
+
+// ============================================================================
+// Test: Metadata-Only Extraction
+// ============================================================================
+
+TEST(metadata_only_file) {
+    const char *path = "metadata_only_test.txt";
+    const char text[] = "Metadata only content";
+    FILE *file = fopen(path, "wb");
+    ASSERT_NOT_NULL(file, "test file");
+    fwrite(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+
+    struct CExtractor *extractor = extractous_extractor_new();
+    struct CMetadata *metadata = NULL;
+    int result = extractous_extractor_extract_metadata_only(extractor, path, &metadata);
+    ASSERT_EQ(ERR_OK, result, "metadata-only extraction");
+    ASSERT_NOT_NULL(metadata, "metadata");
+    int has_content_type = 0;
+    for (size_t i = 0; i < metadata->len; i++) {
+        if (strcmp(metadata->keys[i], "Content-Type") == 0) {
+            has_content_type = 1;
+        }
+    }
+    ASSERT_TRUE(has_content_type, "Content-Type present");
+    extractous_metadata_free(metadata);
+
+    struct CMetadataPacked *packed = NULL;
+    result = extractous_extractor_extract_metadata_only_packed(extractor, path, &packed);
+    ASSERT_EQ(ERR_OK, result, "packed metadata-only extraction");
+    ASSERT_TRUE(packed != NULL && packed->len > 0, "packed metadata");
+    extractous_metadata_packed_free(packed);
+
+    result = extractous_extractor_extract_metadata_only_packed(
+        extractor, "/nonexistent/file.txt", &packed
+    );
+    ASSERT_EQ(ERR_IO_ERROR, result, "missing file");
+
+    extractous_extractor_free(extractor);
+    remove(path);
+}
+
+TEST(metadata_only_bytes) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    const uint8_t data[] = "Metadata only content";
+    struct CMetadataPacked *packed = NULL;
+
+    int result = extractous_extractor_extract_bytes_metadata_only_packed(
+        extractor, data, sizeof(data) - 1, &packed
+    );
+    ASSERT_EQ(ERR_OK, result, "bytes metadata-only extraction");
+    ASSERT_TRUE(packed != NULL && packed->len > 0, "packed metadata");
+    extractous_metadata_packed_free(packed);
+
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_extractor_extract_bytes_metadata_only_packed(
+        NULL, data, sizeof(data) - 1, &packed), "NULL handle");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_extractor_extract_bytes_metadata_only_packed(
+        extractor, NULL, 0, &packed), "NULL data");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_extractor_extract_metadata_only(
+        extractor, "test.txt", NULL), "NULL output");
+    extractous_extractor_free(extractor);
+}
+
 // ============================================================================
-// Test: Metadata Functions
+// Test: Content Budget
 // ============================================================================
 
-TEST(metadata_free_null) {
-    // Should not crash
-    extractous_metadata_free(NULL);
+TEST(content_budget_to_buffer) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    uint8_t data[4096];
+    memset(data, 'a', sizeof(data));
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    struct CMetadata *metadata = NULL;
+
+    extractous_extractor_set_content_budget_mut(extractor, 100);
+    int result = extractous_extractor_extract_bytes_to_buffer(
+        extractor, data, sizeof(data), &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "budgeted extraction");
+    ASSERT_EQ(100, (int)len, "content stops at the budget");
+    ASSERT_NOT_NULL(metadata, "metadata is still returned");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_free(metadata);
+
+    extractous_extractor_set_content_budget_mut(extractor, 0);
+    result = extractous_extractor_extract_bytes_to_buffer(
+        extractor, data, sizeof(data), &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "unbudgeted extraction");
+    ASSERT_TRUE(len >= sizeof(data), "0 removes the budget");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_free(metadata);
+
+    extractous_extractor_set_content_budget_mut(NULL, 100);
+    extractous_extractor_free(extractor);
+}
+
+TEST(content_budget_stream) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    uint8_t data[4096];
+    memset(data, 'b', sizeof(data));
+    struct CStreamReader *reader = NULL;
+    struct CMetadata *metadata = NULL;
+
+    extractous_extractor_set_content_budget_mut(extractor, 1000);
+    int result = extractous_extractor_extract_bytes(
+        extractor, data, sizeof(data), &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "budgeted stream extraction");
+
+    uint8_t *content = NULL;
+    size_t size = 0;
+    ASSERT_EQ(ERR_OK, extractous_stream_read_all(reader, &content, &size), "read to the end");
+    ASSERT_EQ(1000, (int)size, "stream ends at the budget");
+    extractous_buffer_free(content, size);
+
+    uint8_t byte;
+    size_t bytes_read = 1;
+    ASSERT_EQ(ERR_OK, extractous_stream_read(reader, &byte, 1, &bytes_read), "read past the budget");
+    ASSERT_EQ(0, (int)bytes_read, "reads past the budget report the end of the stream");
+
+    extractous_stream_free(reader);
+    extractous_metadata_free(metadata);
+    extractous_extractor_free(extractor);
 }
 
 // ============================================================================
-// Test: URL Extraction Functions (if they exist)
+// Test: Stream Events
 // ============================================================================
 
-TEST(url_extraction_null_checks) {
+TEST(stream_events_xhtml) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    extractous_extractor_set_xml_output_mut(extractor, true);
+    const uint8_t data[] = "Fish & <chips>";
+    struct CStreamReader *reader = NULL;
+    struct CMetadata *metadata = NULL;
+
+    int result = extractous_extractor_extract_bytes(
+        extractor, data, sizeof(data) - 1, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "XML stream extraction");
+
+    struct CStreamEvent event;
+    int pages = 0, page_ends = 0, text_found = 0;
+    for (;;) {
+        ASSERT_EQ(ERR_OK, extractous_stream_next_event(reader, &event), "next event");
+        if (event.kind == STREAM_EVENT_END) {
+            break;
+        }
+        if (event.kind == STREAM_EVENT_PAGE_START) {
+            pages++;
+            ASSERT_EQ(pages, (int)event.index, "pages are numbered from 1");
+        } else if (event.kind == STREAM_EVENT_PAGE_END) {
+            page_ends++;
+        } else if (event.kind == STREAM_EVENT_TEXT) {
+            ASSERT_EQ(1, (int)event.index, "text carries its page number");
+            if (event.len >= 14 && memcmp(event.data, "Fish & <chips>", 14) == 0) {
+                text_found = 1;
+            }
+        }
+    }
+    ASSERT_TRUE(pages >= 1 && pages == page_ends, "balanced page events");
+    ASSERT_TRUE(text_found, "markup removed and references decoded");
+
+    ASSERT_EQ(ERR_OK, extractous_stream_next_event(reader, &event), "next event after the end");
+    ASSERT_EQ(STREAM_EVENT_END, event.kind, "end is reported again");
+
+    extractous_stream_free(reader);
+    extractous_metadata_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+TEST(stream_events_plain_text) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    const uint8_t data[] = "Plain event text";
+    struct CStreamReader *reader = NULL;
+    struct CMetadata *metadata = NULL;
+
+    int result = extractous_extractor_extract_bytes(
+        extractor, data, sizeof(data) - 1, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "plain stream extraction");
+
+    struct CStreamEvent event;
+    size_t text_len = 0;
+    for (;;) {
+        ASSERT_EQ(ERR_OK, extractous_stream_next_event(reader, &event), "next event");
+        if (event.kind == STREAM_EVENT_END) {
+            break;
+        }
+        ASSERT_EQ(STREAM_EVENT_TEXT, event.kind, "plain text yields text events only");
+        ASSERT_EQ(0, (int)event.index, "no page outside XHTML");
+        text_len += event.len;
+    }
+    ASSERT_TRUE(text_len >= sizeof(data) - 1, "all text returned");
+
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_next_event(NULL, &event), "NULL handle");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_next_event(reader, NULL), "NULL event");
+
+    extractous_stream_free(reader);
+    extractous_metadata_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Recursive Embedded Extraction
+// ============================================================================
+
+TEST(recursive_plain_file) {
+    const char *path = "recursive_test.txt";
+    const char text[] = "Container without attachments";
+    FILE *file = fopen(path, "wb");
+    ASSERT_NOT_NULL(file, "test file");
+    fwrite(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+
+    struct CExtractor *extractor = extractous_extractor_new();
+    struct CEmbeddedResult *results = NULL;
+    size_t n = 0;
+    int result = extractous_extractor_extract_file_recursive(extractor, path, 4, 100, &results, &n);
+    ASSERT_EQ(ERR_OK, result, "recursive extraction");
+    ASSERT_EQ(1, (int)n, "container only");
+    ASSERT_NOT_NULL(results[0].path, "container path");
+    ASSERT_EQ(0, (int)strlen(results[0].path), "container path is empty");
+    ASSERT_EQ(0, (int)results[0].depth, "container depth");
+    ASSERT_TRUE(!results[0].truncated, "not truncated");
+    ASSERT_NOT_NULL(results[0].metadata, "container metadata");
+    ASSERT_TRUE(results[0].content_len >= sizeof(text) - 1, "container content");
+    ASSERT_TRUE(memcmp(results[0].content, text, sizeof(text) - 1) == 0, "content text");
+    extractous_embedded_results_free(results, n);
+
+    result = extractous_extractor_extract_file_recursive(
+        extractor, "/nonexistent/file.txt", 4, 100, &results, &n
+    );
+    ASSERT_EQ(ERR_IO_ERROR, result, "missing file");
+    ASSERT_NULL(results, "no results on error");
+
+    extractous_extractor_free(extractor);
+    remove(path);
+}
+
+TEST(recursive_null_pointers) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    struct CEmbeddedResult *results = NULL;
+    size_t n = 0;
+
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_file_recursive(NULL, "a.txt", 1, 0, &results, &n),
+        "NULL handle");
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_file_recursive(extractor, NULL, 1, 0, &results, &n),
+        "NULL path");
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_file_recursive(extractor, "a.txt", 1, 0, NULL, &n),
+        "NULL results");
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_file_recursive(extractor, "a.txt", 1, 0, &results, NULL),
+        "NULL count");
+
+    extractous_embedded_results_free(NULL, 0);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Type Detection
+// ============================================================================
+
+TEST(detect_bytes_signatures) {
+    const char *mime = NULL;
+
+    const uint8_t pdf[] = "%PDF-1.7\n";
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(pdf, sizeof(pdf) - 1, &mime), "detect PDF");
+    ASSERT_TRUE(strcmp(mime, "application/pdf") == 0, "PDF type");
+
+    const uint8_t html[] = "\n<!DOCTYPE html><html><body>Hi</body></html>";
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(html, sizeof(html) - 1, &mime), "detect HTML");
+    ASSERT_TRUE(strcmp(mime, "text/html") == 0, "HTML type");
+
+    const uint8_t text[] = "Plain text to detect";
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(text, sizeof(text) - 1, &mime), "detect text");
+    ASSERT_TRUE(strcmp(mime, "text/plain") == 0, "text type");
+
+    const uint8_t binary[] = {0x00, 0x01, 0x02, 0x03};
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(binary, sizeof(binary), &mime), "detect binary");
+    ASSERT_TRUE(strcmp(mime, "application/octet-stream") == 0, "unknown type");
+
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(NULL, 0, &mime), "empty input");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_detect_bytes(NULL, 4, &mime), "NULL data");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_detect_bytes(pdf, sizeof(pdf) - 1, NULL), "NULL out");
+}
+
+// Appends a stored ZIP entry to out, with its sizes in a data descriptor after the
+// data when descriptor is set, as streaming writers do. Returns the bytes written.
+static size_t zip_entry(uint8_t *out, const char *name, const char *data, int descriptor) {
+    size_t name_len = strlen(name), data_len = strlen(data), n = 0;
+    uint32_t size = descriptor ? 0 : (uint32_t)data_len;
+    uint8_t header[30] = {'P', 'K', 3, 4, 20, 0, descriptor ? 8 : 0};
+    memcpy(header + 18, &size, 4);
+    memcpy(header + 22, &size, 4);
+    header[26] = (uint8_t)name_len;
+    memcpy(out, header, sizeof(header));
+    n += sizeof(header);
+    memcpy(out + n, name, name_len);
+    n += name_len;
+    memcpy(out + n, data, data_len);
+    n += data_len;
+    if (descriptor) {
+        uint8_t trailer[16] = {'P', 'K', 7, 8};
+        uint32_t len32 = (uint32_t)data_len;
+        memcpy(trailer + 8, &len32, 4);
+        memcpy(trailer + 12, &len32, 4);
+        memcpy(out + n, trailer, sizeof(trailer));
+        n += sizeof(trailer);
+    }
+    return n;
+}
+
+TEST(detect_bytes_containers) {
+    const char *mime = NULL;
+    uint8_t zip[512];
+
+    // Every entry has a data descriptor, the first is not in the main folder.
+    size_t len = zip_entry(zip, "[Content_Types].xml", "<Types/>", 1);
+    len += zip_entry(zip + len, "_rels/.rels", "<Relationships/>", 1);
+    len += zip_entry(zip + len, "word/document.xml", "<w:document/>", 1);
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(zip, len, &mime), "detect DOCX");
+    ASSERT_TRUE(strcmp(mime, "application/vnd.openxmlformats-officedocument."
+                             "wordprocessingml.document") == 0, "DOCX type");
+
+    len = zip_entry(zip, "mimetype", "application/vnd.oasis.opendocument.text", 0);
+    len += zip_entry(zip + len, "content.xml", "<office:document-content/>", 1);
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(zip, len, &mime), "detect ODT");
+    ASSERT_TRUE(strcmp(mime, "application/vnd.oasis.opendocument.text") == 0, "ODT type");
+
+    len = zip_entry(zip, "notes.txt", "Just a zip", 1);
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(zip, len, &mime), "detect ZIP");
+    ASSERT_TRUE(strcmp(mime, "application/zip") == 0, "ZIP type");
+
+    // An OLE2 header followed by a directory entry for the main Word stream.
+    uint8_t ole2[1024] = {0xd0, 0xcf, 0x11, 0xe0, 0xa1, 0xb1, 0x1a, 0xe1};
+    const char *stream = "WordDocument";
+    for (size_t i = 0; stream[i]; i++) {
+        ole2[512 + 2 * i] = (uint8_t)stream[i];
+    }
+    ASSERT_EQ(ERR_OK, extractous_detect_bytes(ole2, sizeof(ole2), &mime), "detect DOC");
+    ASSERT_TRUE(strcmp(mime, "application/msword") == 0, "DOC type");
+}
+
+TEST(detect_file) {
+    const char *path = "detect_test.pdf";
+    const char header[] = "%PDF-1.4\n%\xe2\xe3\xcf\xd3\n";
+    FILE *file = fopen(path, "wb");
+    ASSERT_NOT_NULL(file, "test file");
+    fwrite(header, 1, sizeof(header) - 1, file);
+    fclose(file);
+
+    const char *mime = NULL;
+    ASSERT_EQ(ERR_OK, extractous_detect_file(path, &mime), "detect file");
+    ASSERT_TRUE(strcmp(mime, "application/pdf") == 0, "file type");
+
+    ASSERT_EQ(ERR_IO_ERROR, extractous_detect_file("/nonexistent/file.pdf", &mime), "missing file");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_detect_file(NULL, &mime), "NULL path");
+    remove(path);
+}
+
+// ============================================================================
+// Test: Reusable Output Buffers
+// ============================================================================
+
+TEST(buffer_lifecycle) {
+    struct CBuffer *buffer = extractous_buffer_new(0);
+    ASSERT_NOT_NULL(buffer, "buffer");
+    ASSERT_EQ(0, (int)buffer->len, "empty");
+    ASSERT_NULL(buffer->data, "nothing allocated");
+
+    ASSERT_EQ(ERR_OK, extractous_buffer_reserve(buffer, 4096), "reserve");
+    ASSERT_TRUE(buffer->capacity >= 4096, "capacity reserved");
+    ASSERT_NOT_NULL(buffer->data, "allocated");
+    ASSERT_EQ(ERR_OK, extractous_buffer_reserve(buffer, 16), "smaller reserve");
+    ASSERT_TRUE(buffer->capacity >= 4096, "capacity kept");
+
+    extractous_buffer_clear(buffer);
+    ASSERT_EQ(0, (int)buffer->len, "cleared");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_buffer_reserve(NULL, 16), "NULL buffer");
+    extractous_buffer_clear(NULL);
+    extractous_buffer_destroy(NULL);
+    extractous_buffer_destroy(buffer);
+}
+
+TEST(extract_bytes_into_reuse) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    struct CBuffer *buffer = extractous_buffer_new(64 * 1024);
+    ASSERT_NOT_NULL(buffer, "buffer");
+    const uint8_t *data_before = buffer->data;
+
+    const uint8_t first[] = "A first, somewhat longer document";
+    struct CMetadataPacked *metadata = NULL;
+    int result = extractous_extractor_extract_bytes_into(
+        extractor, first, sizeof(first) - 1, buffer, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "first extraction");
+    ASSERT_TRUE(buffer->len >= sizeof(first) - 1, "first content");
+    ASSERT_TRUE(memcmp(buffer->data, first, sizeof(first) - 1) == 0, "first text");
+    ASSERT_NOT_NULL(metadata, "first metadata");
+    extractous_metadata_packed_free(metadata);
+
+    const uint8_t second[] = "Second";
+    result = extractous_extractor_extract_bytes_into(
+        extractor, second, sizeof(second) - 1, buffer, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "second extraction");
+    ASSERT_TRUE(buffer->len < sizeof(first) - 1, "content replaced");
+    ASSERT_TRUE(memcmp(buffer->data, second, sizeof(second) - 1) == 0, "second text");
+    ASSERT_TRUE(buffer->data == data_before, "allocation reused");
+    extractous_metadata_packed_free(metadata);
+
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_bytes_into(extractor, second, 6, NULL, &metadata),
+        "NULL buffer");
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_file_into(extractor, NULL, buffer, &metadata),
+        "NULL path");
+    ASSERT_EQ(ERR_IO_ERROR,
+        extractous_extractor_extract_file_into(extractor, "/nonexistent/file.txt", buffer, &metadata),
+        "missing file");
+
+    extractous_buffer_destroy(buffer);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Single-Allocation Results
+// ============================================================================
+
+TEST(result_bytes) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    const uint8_t data[] = "Arena-backed result content";
+    struct CExtractionResult *result = NULL;
+
+    int code = extractous_extractor_extract_bytes_to_result(
+        extractor, data, sizeof(data) - 1, &result
+    );
+    ASSERT_EQ(ERR_OK, code, "result extraction");
+    ASSERT_NOT_NULL(result, "result");
+    ASSERT_TRUE(result->content_len >= sizeof(data) - 1, "content length");
+    ASSERT_TRUE(memcmp(result->content, data, sizeof(data) - 1) == 0, "content text");
+    ASSERT_EQ(0, (int)result->content[result->content_len], "content is null-terminated");
+
+    const struct CMetadataPacked *metadata = &result->metadata;
+    ASSERT_TRUE(metadata->len > 0, "metadata entries");
+    int has_content_type = 0;
+    for (size_t i = 0; i < metadata->len; i++) {
+        size_t start = metadata->key_offsets[i];
+        size_t key_len = metadata->key_offsets[i + 1] - start;
+        if (key_len == strlen("Content-Type")
+            && memcmp(metadata->data + start, "Content-Type", key_len) == 0) {
+            has_content_type = 1;
+        }
+    }
+    ASSERT_TRUE(has_content_type, "Content-Type present");
+    ASSERT_TRUE(metadata->value_offsets[metadata->value_count] == metadata->data_len, "last value offset is data_len");
+
+    extractous_result_free(result);
+    extractous_result_free(NULL);
+    extractous_extractor_free(extractor);
+}
+
+TEST(result_file_errors) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    struct CExtractionResult *result = NULL;
+
+    ASSERT_EQ(ERR_IO_ERROR,
+        extractous_extractor_extract_file_to_result(extractor, "/nonexistent/file.txt", &result),
+        "missing file");
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_file_to_result(extractor, NULL, &result),
+        "NULL path");
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_file_to_result(extractor, "a.txt", NULL),
+        "NULL out");
+    ASSERT_EQ(ERR_NULL_POINTER,
+        extractous_extractor_extract_bytes_to_result(NULL, (const uint8_t *)"a", 1, &result),
+        "NULL handle");
+
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Per-Call Accounting
+// ============================================================================
+
+TEST(stats_last_call) {
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stats_last_call(NULL), "null output error code");
+
     struct CExtractor *extractor = extractous_extractor_new();
     ASSERT_NOT_NULL(extractor, "extractor");
-    
+    const uint8_t data[] = "Per-call accounting test content";
+    struct CExtractionResult *result = NULL;
+    struct CExtractionStats stats;
+
+    extractous_stats_enable(true);
+    int code = extractous_extractor_extract_bytes_to_result(extractor, data, sizeof(data) - 1, &result);
+    ASSERT_EQ(ERR_OK, code, "extraction error code");
+    ASSERT_EQ(ERR_OK, extractous_stats_last_call(&stats), "last call error code");
+    ASSERT_EQ(ERR_OK, stats.code, "recorded code");
+    ASSERT_TRUE(stats.total_ns > 0, "total time");
+    ASSERT_TRUE(stats.total_ns >= stats.parse_ns + stats.convert_ns, "parse and convert within total");
+    ASSERT_TRUE(stats.bytes_out == result->content_len, "content bytes");
+    ASSERT_TRUE(stats.metadata_entries == result->metadata.len, "metadata entries");
+    ASSERT_TRUE(stats.ocr_pages == 0, "no OCR for plain text");
+    ASSERT_TRUE(stats.rss_bytes > 0, "RSS");
+    extractous_result_free(result);
+
+    code = extractous_extractor_extract_file_to_result(extractor, "/nonexistent/file.txt", &result);
+    ASSERT_EQ(ERR_IO_ERROR, code, "missing file error code");
+    extractous_stats_last_call(&stats);
+    ASSERT_EQ(ERR_IO_ERROR, stats.code, "failed call recorded");
+
+    // A call rejected before it is measured leaves the record reset.
+    extractous_stats_last_call_reset();
+    code = extractous_extractor_extract_bytes_to_result(extractor, NULL, 4, &result);
+    ASSERT_EQ(ERR_NULL_POINTER, code, "NULL data error code");
+    extractous_stats_last_call(&stats);
+    ASSERT_TRUE(stats.code == ERR_OK && stats.total_ns == 0, "reset record");
+
+    // A call made while collection is off replaces the record with zeros.
+    extractous_stats_enable(false);
+    code = extractous_extractor_extract_bytes_to_result(extractor, data, sizeof(data) - 1, &result);
+    ASSERT_EQ(ERR_OK, code, "extraction error code");
+    extractous_stats_last_call(&stats);
+    ASSERT_TRUE(stats.total_ns == 0 && stats.bytes_out == 0, "unmeasured call");
+
+    extractous_result_free(result);
+    extractous_extractor_free(extractor);
+}
+
+TEST(stream_get_stats) {
+    struct CExtractionStats stats;
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_get_stats(NULL, &stats), "null handle error code");
+
+    struct CExtractor *extractor = extractous_extractor_new();
+    const uint8_t data[] = "Streamed accounting test content";
+    struct CStreamReader *reader = NULL;
+    struct CMetadataPacked *metadata = NULL;
+
+    extractous_stats_enable(true);
+    int code = extractous_extractor_extract_bytes_packed(extractor, data, sizeof(data) - 1, &reader, &metadata);
+    ASSERT_EQ(ERR_OK, code, "extraction error code");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_get_stats(reader, NULL), "null output error code");
+
+    ASSERT_EQ(ERR_OK, extractous_stream_get_stats(reader, &stats), "stats error code");
+    ASSERT_TRUE(stats.bytes_out == 0 && stats.rss_bytes == 0, "nothing read yet");
+
+    uint8_t buf[256];
+    size_t n = 0, total = 0;
+    while (extractous_stream_read(reader, buf, sizeof(buf), &n) == ERR_OK && n > 0) {
+        total += n;
+    }
+    extractous_stream_get_stats(reader, &stats);
+    extractous_stats_enable(false);
+
+    ASSERT_TRUE(total > 0, "content read");
+    ASSERT_TRUE(stats.bytes_out == total, "read bytes accounted");
+    ASSERT_TRUE(stats.total_ns > 0, "read time");
+    ASSERT_EQ(ERR_OK, stats.code, "no failed read");
+    ASSERT_TRUE(stats.convert_ns == 0 && stats.metadata_entries == 0, "no conversion for reads");
+    ASSERT_TRUE(stats.rss_bytes > 0, "RSS sampled at the stream's boundaries");
+
+    extractous_stream_free(reader);
+    extractous_metadata_packed_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Memory Limits
+// ============================================================================
+
+TEST(memory_limit_to_buffer) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    uint8_t data[16384];
+    memset(data, 'm', sizeof(data));
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    struct CMetadata *metadata = NULL;
+
+    extractous_extractor_set_memory_limit_mut(extractor, 1024);
+    int result = extractous_extractor_extract_bytes_to_buffer(
+        extractor, data, sizeof(data), &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OUT_OF_MEMORY, result, "extraction over the limit");
+    ASSERT_TRUE(buffer == NULL && metadata == NULL, "no output on failure");
+
     char *content = NULL;
+    result = extractous_extractor_extract_bytes_to_string(
+        extractor, data, sizeof(data), &content, &metadata
+    );
+    ASSERT_EQ(ERR_OUT_OF_MEMORY, result, "to-string extraction over the limit");
+
+    extractous_extractor_set_memory_limit_mut(extractor, 0);
+    result = extractous_extractor_extract_bytes_to_buffer(
+        extractor, data, sizeof(data), &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "0 removes the limit");
+    ASSERT_TRUE(len >= sizeof(data), "whole content without a limit");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_free(metadata);
+
+    // A result cached without a limit is not handed to a limited extraction.
+    struct CResultCache *cache = extractous_cache_new(1 << 20);
+    extractous_extractor_set_cache_mut(extractor, cache);
+    extractous_cache_free(cache);
+    result = extractous_extractor_extract_bytes_to_buffer(
+        extractor, data, sizeof(data), &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "cached extraction without a limit");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_free(metadata);
+    extractous_extractor_set_memory_limit_mut(extractor, 1024);
+    result = extractous_extractor_extract_bytes_to_buffer(
+        extractor, data, sizeof(data), &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OUT_OF_MEMORY, result, "cache hit over the limit");
+
+    extractous_extractor_set_memory_limit_mut(NULL, 1024);
+    extractous_extractor_free(extractor);
+}
+
+TEST(memory_limit_stream) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    uint8_t data[16384];
+    memset(data, 'n', sizeof(data));
+    struct CStreamReader *reader = NULL;
     struct CMetadata *metadata = NULL;
-    
-    // NULL URL
-    int result = extractous_extractor_extract_url_to_string(
-        extractor, NULL, &content, &metadata
+
+    extractous_extractor_set_memory_limit_mut(extractor, 1024);
+    int result = extractous_extractor_extract_bytes(
+        extractor, data, sizeof(data), &reader, &metadata
     );
-    ASSERT_EQ(ERR_NULL_POINTER, result, "null URL error code");
-    
-    // NULL outputs
-    result = extractous_extractor_extract_url_to_string(
-        extractor, "http://example.com", NULL, NULL
+    ASSERT_EQ(ERR_OK, result, "limited stream extraction");
+
+    uint8_t *content = NULL;
+    size_t size = 0;
+    ASSERT_EQ(ERR_OUT_OF_MEMORY, extractous_stream_read_all(reader, &content, &size),
+              "reading everything goes over the limit");
+
+    extractous_stream_free(reader);
+    extractous_metadata_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Normalization
+// ============================================================================
+
+#define NORMALIZE_INPUT "  Hello \x01 world\r\n\r\n\r\nexam-\nple \t end  \n"
+#define NORMALIZE_EXPECTED "Hello world\n\nexample end"
+
+TEST(normalization_to_buffer) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    struct CMetadata *metadata = NULL;
+
+    extractous_extractor_set_normalization_mut(extractor, NORMALIZE_ALL);
+    int result = extractous_extractor_extract_bytes_to_buffer(
+        extractor, (const uint8_t *)NORMALIZE_INPUT, sizeof(NORMALIZE_INPUT) - 1,
+        &buffer, &len, &metadata
     );
-    ASSERT_EQ(ERR_NULL_POINTER, result, "null outputs error code");
-    
+    ASSERT_EQ(ERR_OK, result, "normalized extraction");
+    ASSERT_EQ((int)strlen(NORMALIZE_EXPECTED), (int)len, "normalized length");
+    ASSERT_TRUE(memcmp(buffer, NORMALIZE_EXPECTED, len) == 0, "normalized content");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_free(metadata);
+
+    char *content = NULL;
+    result = extractous_extractor_extract_bytes_to_string(
+        extractor, (const uint8_t *)NORMALIZE_INPUT, sizeof(NORMALIZE_INPUT) - 1,
+        &content, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "normalized to-string extraction");
+    ASSERT_TRUE(strcmp(content, NORMALIZE_EXPECTED) == 0, "normalized string");
+    extractous_string_free(content);
+    extractous_metadata_free(metadata);
+
+    // Read from the stream, to-string results are still cut at the string max length.
+    extractous_extractor_set_extract_string_max_length_mut(extractor, 5);
+    result = extractous_extractor_extract_bytes_to_string(
+        extractor, (const uint8_t *)NORMALIZE_INPUT, sizeof(NORMALIZE_INPUT) - 1,
+        &content, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "capped to-string extraction");
+    ASSERT_TRUE(strcmp(content, "Hello") == 0, "string max length applies");
+    extractous_string_free(content);
+    extractous_metadata_free(metadata);
+    extractous_extractor_set_extract_string_max_length_mut(extractor, 1 << 20);
+
+    extractous_extractor_set_normalization_mut(extractor, 0);
+    result = extractous_extractor_extract_bytes_to_buffer(
+        extractor, (const uint8_t *)NORMALIZE_INPUT, sizeof(NORMALIZE_INPUT) - 1,
+        &buffer, &len, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "unnormalized extraction");
+    ASSERT_TRUE(len > strlen(NORMALIZE_EXPECTED), "0 turns normalization off");
+    extractous_buffer_free(buffer, len);
+    extractous_metadata_free(metadata);
+
+    extractous_extractor_set_normalization_mut(NULL, NORMALIZE_ALL);
+    extractous_extractor_free(extractor);
+}
+
+TEST(normalization_stream) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    extractous_extractor_set_normalization_mut(extractor, NORMALIZE_ALL);
+    // The stages need UTF-8, so they override the configured encoding.
+    extractous_extractor_set_encoding_mut(extractor, CHARSET_UTF_16BE);
+    struct CStreamReader *reader = NULL;
+    struct CMetadata *metadata = NULL;
+
+    int result = extractous_extractor_extract_bytes(
+        extractor, (const uint8_t *)NORMALIZE_INPUT, sizeof(NORMALIZE_INPUT) - 1,
+        &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "normalized stream extraction");
+
+    // One byte at a time, so held-back bytes meet the following reads.
+    char content[64];
+    size_t total = 0, bytes_read = 0;
+    do {
+        result = extractous_stream_read(reader, (uint8_t *)content + total, 1, &bytes_read);
+        ASSERT_EQ(ERR_OK, result, "read one byte");
+        total += bytes_read;
+    } while (bytes_read > 0 && total < sizeof(content) - 1);
+    content[total] = '\0';
+    ASSERT_TRUE(strcmp(content, NORMALIZE_EXPECTED) == 0, "normalized stream content");
+    extractous_stream_free(reader);
+    extractous_metadata_free(metadata);
+
+    // Non-ASCII text shows whether the stages saw UTF-8 or UTF-16.
+    const char accented[] = "Caf\xc3\xa9 \x01 cr\xc3\xa8me";
+    result = extractous_extractor_extract_bytes(
+        extractor, (const uint8_t *)accented, sizeof(accented) - 1, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "accented stream extraction");
+    result = extractous_stream_read(reader, (uint8_t *)content, sizeof(content) - 1, &bytes_read);
+    ASSERT_EQ(ERR_OK, result, "read accented stream");
+    content[bytes_read] = '\0';
+    ASSERT_TRUE(strcmp(content, "Caf\xc3\xa9 cr\xc3\xa8me") == 0, "accented stream content");
+
+    extractous_stream_free(reader);
+    extractous_metadata_free(metadata);
+    extractous_extractor_free(extractor);
+}
+
+// ============================================================================
+// Test: Chunked Output
+// ============================================================================
+
+TEST(stream_next_chunk) {
+    struct CExtractor *extractor = extractous_extractor_new();
+    char text[4096];
+    size_t text_len = 0;
+    while (text_len + 64 < sizeof(text)) {
+        text_len += (size_t)snprintf(text + text_len, sizeof(text) - text_len,
+                                     "Sentence number %zu of the chunking test. ", text_len);
+    }
+    struct CStreamReader *reader = NULL;
+    struct CMetadata *metadata = NULL;
+
+    int result = extractous_extractor_extract_bytes(
+        extractor, (const uint8_t *)text, text_len, &reader, &metadata
+    );
+    ASSERT_EQ(ERR_OK, result, "stream extraction");
+
+    struct CStreamChunk chunk;
+    ASSERT_EQ(ERR_INVALID_CONFIG, extractous_stream_next_chunk(reader, 0, 0, &chunk),
+              "max_bytes of 0");
+    ASSERT_EQ(ERR_INVALID_CONFIG, extractous_stream_next_chunk(reader, 256, 256, &chunk),
+              "overlap as large as max_bytes");
+
+    int chunks = 0, bounded = 1, overlapping = 1, on_boundary = 1;
+    uint64_t prev_end = 0;
+    for (;;) {
+        ASSERT_EQ(ERR_OK, extractous_stream_next_chunk(reader, 256, 64, &chunk), "next chunk");
+        if (chunk.len == 0) {
+            ASSERT_TRUE(chunk.data == NULL, "end of stream has no data");
+            break;
+        }
+        bounded &= chunk.len <= 256;
+        if (chunks > 0) {
+            overlapping &= chunk.offset <= prev_end && prev_end - chunk.offset <= 64;
+        }
+        if (chunk.offset + chunk.len < text_len) {
+            char last = (char)chunk.data[chunk.len - 1];
+            on_boundary &= last == ' ' || last == '\n';
+        }
+        prev_end = chunk.offset + chunk.len;
+        chunks++;
+    }
+    ASSERT_TRUE(chunks > (int)(text_len / 256), "content split into several chunks");
+    ASSERT_TRUE(bounded, "chunks are at most max_bytes");
+    ASSERT_TRUE(overlapping, "chunks overlap by at most the overlap");
+    ASSERT_TRUE(on_boundary, "chunks end on a word boundary");
+    ASSERT_TRUE(prev_end >= text_len, "chunks cover the content");
+
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_next_chunk(NULL, 256, 0, &chunk), "NULL stream");
+    ASSERT_EQ(ERR_NULL_POINTER, extractous_stream_next_chunk(reader, 256, 0, NULL), "NULL chunk");
+
+    extractous_stream_free(reader);
+    extractous_metadata_free(metadata);
     extractous_extractor_free(extractor);
 }
 
@@ -398,11 +2322,127 @@ void run_all_tests() {
     // Memory management tests
     printf(COLOR_YELLOW "\n--- Memory Management ---\n" COLOR_RESET);
     run_test_string_free_null();
+    run_test_to_buffer_null_checks();
+    run_test_buffer_free_null();
     run_test_metadata_free_null();
+    run_test_metadata_packed_free_null();
+    run_test_metadata_packed_layout();
     
     // URL extraction tests
     printf(COLOR_YELLOW "\n--- URL Extraction ---\n" COLOR_RESET);
     run_test_url_extraction_null_checks();
+
+    // Batch extraction tests
+    printf(COLOR_YELLOW "\n--- Batch Extraction ---\n" COLOR_RESET);
+    run_test_batch_null_checks();
+    run_test_batch_per_item_errors();
+    run_test_batch_content_with_nul();
+
+    // Statistics tests
+    printf(COLOR_YELLOW "\n--- Statistics ---\n" COLOR_RESET);
+    run_test_stats_snapshot();
+
+    // Stream read tests
+    printf(COLOR_YELLOW "\n--- Stream Reads ---\n" COLOR_RESET);
+    run_test_stream_read_null_checks();
+    run_test_stream_read_into_iov();
+    run_test_stream_copy_to_fd();
+
+    // Borrowed-bytes extraction tests
+    printf(COLOR_YELLOW "\n--- Borrowed-Bytes Extraction ---\n" COLOR_RESET);
+    run_test_borrowed_release_on_error();
+    run_test_borrowed_release_on_stream_free();
+
+    // Read-callback extraction tests
+    printf(COLOR_YELLOW "\n--- Read-Callback Extraction ---\n" COLOR_RESET);
+    run_test_reader_null_checks();
+    run_test_reader_callback_error();
+    run_test_reader_chunked_input();
+
+    // Memory-mapped extraction tests
+    printf(COLOR_YELLOW "\n--- Memory-Mapped Extraction ---\n" COLOR_RESET);
+    run_test_mmap_null_checks();
+    run_test_mmap_missing_file();
+    run_test_mmap_stream_outlives_call();
+
+    // Async extraction tests
+    printf(COLOR_YELLOW "\n--- Async Extraction ---\n" COLOR_RESET);
+    run_test_async_null_checks();
+    run_test_async_missing_file();
+    run_test_async_extractor_freed_before_completion();
+
+    // Cancellation tests
+    printf(COLOR_YELLOW "\n--- Cancellation ---\n" COLOR_RESET);
+    run_test_cancel_token_lifecycle();
+    run_test_cancel_token_deadline();
+    run_test_stream_cancel();
+    run_test_cancellable_buffer_extraction();
+    run_test_cancellable_budget_utf8();
+
+    // Shared extractor tests
+    printf(COLOR_YELLOW "\n--- Shared Extractor ---\n" COLOR_RESET);
+    run_test_shared_extractor_concurrent_reconfigure();
+
+    // Extractor pool tests
+    printf(COLOR_YELLOW "\n--- Extractor Pool ---\n" COLOR_RESET);
+    run_test_pool_acquire_release();
+    run_test_pool_restores_configuration();
+
+    // Initialization tests
+    printf(COLOR_YELLOW "\n--- Initialization ---\n" COLOR_RESET);
+    run_test_init_and_warmup();
+
+    // Result cache tests
+    printf(COLOR_YELLOW "\n--- Result Cache ---\n" COLOR_RESET);
+    run_test_cache_hits_and_misses();
+    run_test_cache_lru_eviction();
+    run_test_cache_disk_tier();
+    run_test_cache_key_parser_config();
+
+    // Metadata-only extraction tests
+    printf(COLOR_YELLOW "\n--- Metadata-Only Extraction ---\n" COLOR_RESET);
+    run_test_metadata_only_file();
+    run_test_metadata_only_bytes();
+    
+    printf(COLOR_YELLOW "\n--- Content Budget ---\n" COLOR_RESET);
+    run_test_content_budget_to_buffer();
+    run_test_content_budget_stream();
+    
+    printf(COLOR_YELLOW "\n--- Stream Events ---\n" COLOR_RESET);
+    run_test_stream_events_xhtml();
+    run_test_stream_events_plain_text();
+    
+    printf(COLOR_YELLOW "\n--- Recursive Embedded Extraction ---\n" COLOR_RESET);
+    run_test_recursive_plain_file();
+    run_test_recursive_null_pointers();
+    
+    printf(COLOR_YELLOW "\n--- Type Detection ---\n" COLOR_RESET);
+    run_test_detect_bytes_signatures();
+    run_test_detect_bytes_containers();
+    run_test_detect_file();
+    
+    printf(COLOR_YELLOW "\n--- Reusable Output Buffers ---\n" COLOR_RESET);
+    run_test_buffer_lifecycle();
+    run_test_extract_bytes_into_reuse();
+    
+    printf(COLOR_YELLOW "\n--- Single-Allocation Results ---\n" COLOR_RESET);
+    run_test_result_bytes();
+    run_test_result_file_errors();
+    
+    printf(COLOR_YELLOW "\n--- Per-Call Accounting ---\n" COLOR_RESET);
+    run_test_stats_last_call();
+    run_test_stream_get_stats();
+    
+    printf(COLOR_YELLOW "\n--- Memory Limits ---\n" COLOR_RESET);
+    run_test_memory_limit_to_buffer();
+    run_test_memory_limit_stream();
+    
+    printf(COLOR_YELLOW "\n--- Normalization ---\n" COLOR_RESET);
+    run_test_normalization_to_buffer();
+    run_test_normalization_stream();
+    
+    printf(COLOR_YELLOW "\n--- Chunked Output ---\n" COLOR_RESET);
+    run_test_stream_next_chunk();
     
     // Summary
     printf("\n");
@@ -0,0 +1,206 @@
+package extractous_test
+
+import (
+	"bytes"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"sort"
+	"strings"
+	"testing"
+	"time"
+
+	extractous "github.com/rahulpoonia29/extractous-go"
+)
+
+// ============================================================================
+// Benchmark Corpus
+// ============================================================================
+
+// benchCorpusEnv lists extra corpus files, separated like PATH, e.g. larger
+// PDFs, XLSX workbooks or scanned PDFs.
+const benchCorpusEnv = "EXTRACTOUS_BENCH_CORPUS"
+
+const samplesDir = "../../ffi/samples"
+
+type benchDoc struct {
+	name string
+	path string
+	data []byte
+}
+
+// benchCorpus returns the library's warm-up samples, generated HTML and text
+// documents of 16 KiB, 256 KiB and 4 MiB, and the files in benchCorpusEnv.
+func benchCorpus(b *testing.B) []benchDoc {
+	b.Helper()
+	var paths []string
+	for _, name := range []string{"warmup.pdf", "warmup.docx", "warmup.html"} {
+		paths = append(paths, filepath.Join(samplesDir, name))
+	}
+
+	dir := b.TempDir()
+	para := "The quick brown fox jumps over the lazy dog while extraction keeps pace " +
+		"with every paragraph, table and heading it is given."
+	for _, size := range []int{16 << 10, 256 << 10, 4 << 20} {
+		var html, text bytes.Buffer
+		html.WriteString("<html><head><title>Benchmark</title></head><body>\n")
+		for i := 0; html.Len() < size; i++ {
+			if i%16 == 0 {
+				fmt.Fprintf(&html, "<h2>Section %d</h2>\n", i/16)
+			}
+			fmt.Fprintf(&html, "<p>%s</p>\n", para)
+		}
+		html.WriteString("</body></html>\n")
+		for text.Len() < size {
+			text.WriteString(para + "\n")
+		}
+
+		for _, gen := range []struct {
+			ext     string
+			content []byte
+		}{{"html", html.Bytes()}, {"txt", text.Bytes()}} {
+			path := filepath.Join(dir, fmt.Sprintf("generated-%dk.%s", size>>10, gen.ext))
+			if err := os.WriteFile(path, gen.content, 0644); err != nil {
+				b.Fatalf("Failed to write corpus file: %v", err)
+			}
+			paths = append(paths, path)
+		}
+	}
+	paths = append(paths, filepath.SplitList(os.Getenv(benchCorpusEnv))...)
+
+	var docs []benchDoc
+	for _, path := range paths {
+		data, err := os.ReadFile(path)
+		if err != nil || len(data) == 0 {
+			b.Logf("Skipping corpus file %s: %v", path, err)
+			continue
+		}
+		docs = append(docs, benchDoc{name: filepath.Base(path), path: path, data: data})
+	}
+	sort.SliceStable(docs, func(i, j int) bool { return len(docs[i].data) < len(docs[j].data) })
+	return docs
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+func drain(reader *extractous.StreamReader, err error) error {
+	if err != nil {
+		return err
+	}
+	defer reader.Close()
+	_, err = io.Copy(io.Discard, reader)
+	return err
+}
+
+// benchVariants runs one extraction of doc per call through each Go entry point.
+var benchVariants = []struct {
+	name string
+	run  func(e *extractous.Extractor, buf *extractous.Buffer, doc benchDoc) error
+}{
+	{"FileToString", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		_, _, err := e.ExtractFileToString(doc.path)
+		return err
+	}},
+	{"FileInto", func(e *extractous.Extractor, buf *extractous.Buffer, doc benchDoc) error {
+		_, err := e.ExtractFileInto(doc.path, buf)
+		return err
+	}},
+	{"FileStream", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		reader, _, err := e.ExtractFile(doc.path)
+		return drain(reader, err)
+	}},
+	{"FileMmap", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		reader, _, err := e.ExtractFileMmap(doc.path)
+		return drain(reader, err)
+	}},
+	{"FileMmapToString", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		_, _, err := e.ExtractFileMmapToString(doc.path)
+		return err
+	}},
+	{"FileMetadata", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		_, err := e.ExtractMetadata(doc.path)
+		return err
+	}},
+	{"BytesToString", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		_, _, err := e.ExtractBytesToString(doc.data)
+		return err
+	}},
+	{"BytesInto", func(e *extractous.Extractor, buf *extractous.Buffer, doc benchDoc) error {
+		_, err := e.ExtractBytesInto(doc.data, buf)
+		return err
+	}},
+	{"BytesStream", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		reader, _, err := e.ExtractBytes(doc.data)
+		return drain(reader, err)
+	}},
+	{"BytesNoCopy", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		reader, _, err := e.ExtractBytesNoCopy(doc.data)
+		return drain(reader, err)
+	}},
+	{"Reader", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		reader, _, err := e.ExtractReader(bytes.NewReader(doc.data))
+		return drain(reader, err)
+	}},
+	{"BytesMetadata", func(e *extractous.Extractor, _ *extractous.Buffer, doc benchDoc) error {
+		_, err := e.ExtractBytesMetadata(doc.data)
+		return err
+	}},
+}
+
+// BenchmarkExtract runs every entry point over the corpus. Besides ns/op, MB/s
+// of input and allocations, it reports docs/s and the p50 and p99 latency of
+// single calls. For machine-readable output, run with -json, or pipe the text
+// output to benchstat:
+//
+//	go test -run '^$' -bench Extract -benchmem -json
+func BenchmarkExtract(b *testing.B) {
+	docs := benchCorpus(b)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		b.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+	buf := extractous.NewBuffer(0)
+	defer buf.Close()
+
+	for _, variant := range benchVariants {
+		for _, doc := range docs {
+			name := variant.name + "/" + strings.ReplaceAll(doc.name, "/", "_")
+			b.Run(name, func(b *testing.B) {
+				b.SetBytes(int64(len(doc.data)))
+				b.ReportAllocs()
+
+				latencies := make([]time.Duration, 0, b.N)
+				b.ResetTimer()
+				start := time.Now()
+				for i := 0; i < b.N; i++ {
+					t0 := time.Now()
+					if err := variant.run(extractor, buf, doc); err != nil {
+						b.Fatalf("%s failed on %s: %v", variant.name, doc.name, err)
+					}
+					latencies = append(latencies, time.Since(t0))
+				}
+				elapsed := time.Since(start)
+				b.StopTimer()
+
+				sort.Slice(latencies, func(i, j int) bool { return latencies[i] < latencies[j] })
+				b.ReportMetric(float64(b.N)/elapsed.Seconds(), "docs/s")
+				b.ReportMetric(float64(percentile(latencies, 50).Nanoseconds()), "p50-ns")
+				b.ReportMetric(float64(percentile(latencies, 99).Nanoseconds()), "p99-ns")
+			})
+		}
+	}
+}
+
+// percentile returns the nearest-rank percentile of sorted latencies.
+func percentile(sorted []time.Duration, p int) time.Duration {
+	rank := (len(sorted)*p + 99) / 100
+	if rank < 1 {
+		rank = 1
+	}
+	return sorted[rank-1]
+}
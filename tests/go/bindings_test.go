@@ -1,6 +1,13 @@
 package extractous_test
 
 import (
+	"archive/zip"
+	"bytes"
+	"context"
+	"errors"
+	"hash/crc32"
+	"io"
+	"strings"
 	"testing"
 
 	extractous "github.com/rahulpoonia29/extractous-go"
@@ -130,6 +137,32 @@ func TestExtractor_SetXmlOutput_Nil(t *testing.T) {
 	}
 }
 
+func TestExtractor_SetContentBudget_Nil(t *testing.T) {
+	var extractor *extractous.Extractor
+	if extractor.SetContentBudget(1024) != nil {
+		t.Error("Expected nil when calling SetContentBudget on nil extractor")
+	}
+
+	closed := extractous.New()
+	closed.Close()
+	if closed.SetContentBudget(1024) != nil {
+		t.Error("Expected nil when calling SetContentBudget on a closed extractor")
+	}
+}
+
+func TestExtractor_SetHTTPConfig_Nil(t *testing.T) {
+	var extractor *extractous.Extractor
+	if extractor.SetHTTPConfig(extractous.NewHTTPConfig()) != nil {
+		t.Error("Expected nil when calling SetHTTPConfig on nil extractor")
+	}
+
+	valid := extractous.New()
+	defer valid.Close()
+	if valid.SetHTTPConfig(nil) != valid {
+		t.Error("Expected SetHTTPConfig(nil) to return the extractor")
+	}
+}
+
 func TestExtractor_ChainedConfiguration(t *testing.T) {
 	extractor := extractous.New().
 		SetExtractStringMaxLength(5000).
@@ -338,6 +371,125 @@ func TestExtractor_ExtractBytes_NilExtractor(t *testing.T) {
 	}
 }
 
+func TestExtractor_ExtractBytesNoCopy_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	_, _, err := extractor.ExtractBytesNoCopy([]byte("test"))
+	if err == nil {
+		t.Error("Expected error when using nil extractor")
+	}
+}
+
+func TestExtractor_ExtractReader_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	_, _, err := extractor.ExtractReader(strings.NewReader("test"))
+	if err == nil {
+		t.Error("Expected error when using nil extractor")
+	}
+}
+
+func TestExtractor_ExtractReader_NilReader(t *testing.T) {
+	extractor := extractous.New()
+	defer extractor.Close()
+
+	_, _, err := extractor.ExtractReader(nil)
+	if !errors.Is(err, extractous.ErrNullPointer) {
+		t.Errorf("Expected ErrNullPointer, got %v", err)
+	}
+}
+
+func TestExtractor_ExtractFileAsync_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	r, ok := <-extractor.ExtractFileAsync("test.pdf")
+	if !ok || !errors.Is(r.Err, extractous.ErrNullPointer) {
+		t.Errorf("Expected ErrNullPointer, got %v", r.Err)
+	}
+	if _, ok := <-extractor.ExtractFileAsync("test.pdf"); !ok {
+		t.Error("Expected one result before the channel is closed")
+	}
+}
+
+func TestWarmup_InvalidFormat(t *testing.T) {
+	if err := extractous.Warmup(extractous.WarmupAll + 1); !errors.Is(err, extractous.ErrInvalidEnum) {
+		t.Errorf("Expected ErrInvalidEnum, got %v", err)
+	}
+	err := extractous.Init(&extractous.InitOptions{WarmupFormats: 1 << 31})
+	if !errors.Is(err, extractous.ErrInvalidEnum) {
+		t.Errorf("Expected ErrInvalidEnum from Init, got %v", err)
+	}
+}
+
+func TestExtractor_ExtractMetadata_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	if _, err := extractor.ExtractMetadata("test.pdf"); !errors.Is(err, extractous.ErrNullPointer) {
+		t.Errorf("Expected ErrNullPointer, got %v", err)
+	}
+	if _, err := extractor.ExtractBytesMetadata([]byte("test")); !errors.Is(err, extractous.ErrNullPointer) {
+		t.Errorf("Expected ErrNullPointer, got %v", err)
+	}
+}
+
+func TestCache_NilAndClosed(t *testing.T) {
+	var cache *extractous.Cache
+	if err := cache.SetDiskTier(t.TempDir(), 0); !errors.Is(err, extractous.ErrNullPointer) {
+		t.Errorf("Expected ErrNullPointer from nil cache, got %v", err)
+	}
+	cache.Clear()
+	if err := cache.Close(); err != nil {
+		t.Errorf("Close on nil cache returned %v", err)
+	}
+
+	extractor := extractous.New()
+	defer extractor.Close()
+	if extractor.SetCache(nil) != extractor {
+		t.Error("Detaching with SetCache(nil) should return the extractor")
+	}
+	closed := extractous.NewCache(1024)
+	closed.Close()
+	if extractor.SetCache(closed) != nil {
+		t.Error("Expected nil when attaching a closed cache")
+	}
+}
+
+func TestPool_NilAndInvalid(t *testing.T) {
+	var pool *extractous.Pool
+	if _, err := pool.Acquire(context.Background()); !errors.Is(err, extractous.ErrNullPointer) {
+		t.Errorf("Expected ErrNullPointer from nil pool, got %v", err)
+	}
+	if err := pool.Close(); err != nil {
+		t.Errorf("Close on nil pool returned %v", err)
+	}
+
+	if _, err := extractous.NewPool(nil, -1); !errors.Is(err, extractous.ErrInvalidConfig) {
+		t.Errorf("Expected ErrInvalidConfig for negative size, got %v", err)
+	}
+
+	closed := extractous.New()
+	closed.Close()
+	if _, err := extractous.NewPool(closed, 1); !errors.Is(err, extractous.ErrNullPointer) {
+		t.Errorf("Expected ErrNullPointer for closed config, got %v", err)
+	}
+}
+
+func TestExtractor_ExtractFileToStringContext_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	_, _, err := extractor.ExtractFileToStringContext(context.Background(), "test.pdf")
+	if !errors.Is(err, extractous.ErrNullPointer) {
+		t.Errorf("Expected ErrNullPointer, got %v", err)
+	}
+}
+
+func TestExtractor_ExtractBytesToStringContext_Cancelled(t *testing.T) {
+	extractor := extractous.New()
+	defer extractor.Close()
+
+	ctx, cancel := context.WithCancel(context.Background())
+	cancel()
+	_, _, err := extractor.ExtractBytesToStringContext(ctx, []byte("test"))
+	if !errors.Is(err, extractous.ErrCancelled) || !errors.Is(err, context.Canceled) {
+		t.Errorf("Expected ErrCancelled wrapping context.Canceled, got %v", err)
+	}
+}
+
 func TestExtractor_ExtractUrlToString_NilExtractor(t *testing.T) {
 	var extractor *extractous.Extractor
 	_, _, err := extractor.ExtractURLToString("http://example.com")
@@ -354,6 +506,185 @@ func TestExtractor_ExtractUrl_NilExtractor(t *testing.T) {
 	}
 }
 
+func TestExtractor_ExtractFilesBatch_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	_, err := extractor.ExtractFilesBatch([]string{"test.txt"}, 1)
+	if err == nil {
+		t.Error("Expected error when using nil extractor")
+	}
+}
+
+func TestExtractor_ExtractFileRecursive_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	_, err := extractor.ExtractFileRecursive("test.zip", 1, 10)
+	if err == nil {
+		t.Error("Expected error when using nil extractor")
+	}
+}
+
+func TestDetect(t *testing.T) {
+	tests := []struct {
+		data []byte
+		want string
+	}{
+		{[]byte("%PDF-1.7\n"), "application/pdf"},
+		{[]byte("<html><body>Hi</body></html>"), "text/html"},
+		{[]byte("Plain text"), "text/plain"},
+		{[]byte{0x00, 0x01, 0x02}, "application/octet-stream"},
+		{nil, "text/plain"},
+	}
+	for _, tt := range tests {
+		if got := extractous.Detect(tt.data); got != tt.want {
+			t.Errorf("Detect(%q) = %q, want %q", tt.data, got, tt.want)
+		}
+	}
+}
+
+func TestDetect_Containers(t *testing.T) {
+	// archive/zip writes the sizes of every entry in a data descriptor.
+	build := func(entries ...string) []byte {
+		var buf bytes.Buffer
+		w := zip.NewWriter(&buf)
+		for i := 0; i < len(entries); i += 2 {
+			f, err := w.Create(entries[i])
+			if err != nil {
+				t.Fatalf("Failed to create zip entry: %v", err)
+			}
+			f.Write([]byte(entries[i+1]))
+		}
+		if err := w.Close(); err != nil {
+			t.Fatalf("Failed to write zip: %v", err)
+		}
+		return buf.Bytes()
+	}
+
+	xlsx := build("[Content_Types].xml", "<Types/>", "_rels/.rels", "<Relationships/>",
+		"xl/workbook.xml", "<workbook/>")
+	if got, want := extractous.Detect(xlsx), "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"; got != want {
+		t.Errorf("Detect(xlsx) = %q, want %q", got, want)
+	}
+	if got := extractous.Detect(build("notes.txt", "Just a zip")); got != "application/zip" {
+		t.Errorf("Detect(zip) = %q, want application/zip", got)
+	}
+
+	// OpenDocument stores its mimetype entry first, uncompressed and with its sizes.
+	var odt bytes.Buffer
+	w := zip.NewWriter(&odt)
+	mimetype := "application/vnd.oasis.opendocument.text"
+	f, err := w.CreateRaw(&zip.FileHeader{
+		Name:               "mimetype",
+		Method:             zip.Store,
+		CRC32:              crc32.ChecksumIEEE([]byte(mimetype)),
+		CompressedSize64:   uint64(len(mimetype)),
+		UncompressedSize64: uint64(len(mimetype)),
+	})
+	if err != nil {
+		t.Fatalf("Failed to create mimetype entry: %v", err)
+	}
+	f.Write([]byte(mimetype))
+	if f, err = w.Create("content.xml"); err != nil {
+		t.Fatalf("Failed to create content entry: %v", err)
+	}
+	f.Write([]byte("<office:document-content/>"))
+	w.Close()
+	if got := extractous.Detect(odt.Bytes()); got != mimetype {
+		t.Errorf("Detect(odt) = %q, want %q", got, mimetype)
+	}
+
+	// An OLE2 header followed by a directory entry for the main Excel stream.
+	ole2 := make([]byte, 1024)
+	copy(ole2, "\xd0\xcf\x11\xe0\xa1\xb1\x1a\xe1")
+	for i, c := range "Workbook" {
+		ole2[512+2*i] = byte(c)
+	}
+	if got := extractous.Detect(ole2); got != "application/vnd.ms-excel" {
+		t.Errorf("Detect(xls) = %q, want application/vnd.ms-excel", got)
+	}
+}
+
+func TestExtractor_ExtractBytesInto_Nil(t *testing.T) {
+	var extractor *extractous.Extractor
+	buf := extractous.NewBuffer(0)
+	defer buf.Close()
+	if _, err := extractor.ExtractBytesInto([]byte("test"), buf); err == nil {
+		t.Error("Expected error when using nil extractor")
+	}
+
+	valid := extractous.New()
+	defer valid.Close()
+	if _, err := valid.ExtractBytesInto([]byte("test"), nil); err == nil {
+		t.Error("Expected error when using nil buffer")
+	}
+}
+
+func TestBuffer_Lifecycle(t *testing.T) {
+	buf := extractous.NewBuffer(1024)
+	if buf == nil {
+		t.Fatal("Failed to create buffer")
+	}
+	if buf.Len() != 0 || buf.Cap() < 1024 || buf.Bytes() != nil {
+		t.Errorf("Unexpected new buffer: len %d, cap %d", buf.Len(), buf.Cap())
+	}
+	if err := buf.Reserve(8192); err != nil || buf.Cap() < 8192 {
+		t.Errorf("Reserve failed: %v, cap %d", err, buf.Cap())
+	}
+	buf.Close()
+	buf.Close()
+	if buf.Len() != 0 || buf.Reserve(16) == nil {
+		t.Error("Expected a closed buffer to be empty and unusable")
+	}
+	extractous.PutBuffer(buf)
+}
+
+func TestStreamReader_Stats_Nil(t *testing.T) {
+	var reader *extractous.StreamReader
+	if reader.Stats() != (extractous.ExtractionStats{}) {
+		t.Error("Expected zero stats for a nil StreamReader")
+	}
+}
+
+func TestExtractor_SetMemoryLimit_Nil(t *testing.T) {
+	var extractor *extractous.Extractor
+	if extractor.SetMemoryLimit(1024) != nil {
+		t.Error("Expected nil when calling SetMemoryLimit on nil extractor")
+	}
+
+	closed := extractous.New()
+	closed.Close()
+	if closed.SetMemoryLimit(1024) != nil {
+		t.Error("Expected nil when calling SetMemoryLimit on a closed extractor")
+	}
+}
+
+func TestExtractor_SetNormalization_Nil(t *testing.T) {
+	var extractor *extractous.Extractor
+	if extractor.SetNormalization(extractous.NormalizeAll) != nil {
+		t.Error("Expected nil when calling SetNormalization on nil extractor")
+	}
+
+	closed := extractous.New()
+	closed.Close()
+	if closed.SetNormalization(extractous.NormalizeAll) != nil {
+		t.Error("Expected nil when calling SetNormalization on a closed extractor")
+	}
+}
+
+func TestExtractor_ExtractFileMmap_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	_, _, err := extractor.ExtractFileMmap("test.txt")
+	if err == nil {
+		t.Error("Expected error when using nil extractor")
+	}
+}
+
+func TestExtractor_ExtractFileMmapToString_NilExtractor(t *testing.T) {
+	var extractor *extractous.Extractor
+	_, _, err := extractor.ExtractFileMmapToString("test.txt")
+	if err == nil {
+		t.Error("Expected error when using nil extractor")
+	}
+}
+
 func TestExtractor_ExtractBytesToString_EmptyBytes(t *testing.T) {
 	extractor := extractous.New()
 	if extractor == nil {
@@ -373,6 +704,39 @@ func TestExtractor_ExtractBytesToString_EmptyBytes(t *testing.T) {
 	}
 }
 
+func TestStreamReader_SetBufferSize_Nil(t *testing.T) {
+	var reader *extractous.StreamReader
+	if reader.SetBufferSize(1024) != nil {
+		t.Error("Expected nil reader to stay nil")
+	}
+}
+
+func TestStreamReader_NextEvent_Closed(t *testing.T) {
+	extractor := extractous.New()
+	defer extractor.Close()
+	reader, _, err := extractor.ExtractBytes([]byte("closed stream"))
+	if err != nil {
+		t.Fatalf("ExtractBytes failed: %v", err)
+	}
+	reader.Close()
+	if _, err := reader.NextEvent(); err != io.EOF {
+		t.Errorf("Expected io.EOF from a closed reader, got %v", err)
+	}
+}
+
+func TestStreamReader_NextChunk_Closed(t *testing.T) {
+	extractor := extractous.New()
+	defer extractor.Close()
+	reader, _, err := extractor.ExtractBytes([]byte("closed stream"))
+	if err != nil {
+		t.Fatalf("ExtractBytes failed: %v", err)
+	}
+	reader.Close()
+	if _, err := reader.NextChunk(1024, 0); err != io.EOF {
+		t.Errorf("Expected io.EOF from a closed reader, got %v", err)
+	}
+}
+
 // ============================================================================
 // Metadata Tests
 // ============================================================================
@@ -1,10 +1,22 @@
 package extractous_test
 
 import (
+	"bytes"
+	"context"
+	"errors"
+	"fmt"
+	"io"
+	"net/http"
+	"net/http/httptest"
 	"os"
 	"path/filepath"
+	"runtime"
 	"strings"
+	"sync"
+	"sync/atomic"
 	"testing"
+	"testing/iotest"
+	"time"
 
 	extractous "github.com/rahulpoonia29/extractous-go"
 )
@@ -129,6 +141,35 @@ func TestIntegration_ExtractBytesStream(t *testing.T) {
 	}
 }
 
+func TestIntegration_ExtractLargeContentToString(t *testing.T) {
+	// Large enough that the content buffer is well past any small-string path.
+	content := strings.Repeat("Large content line for buffer extraction.\n", 50000)
+	filePath := createTestFile(t, "large_buffer_test.txt", content)
+	defer os.Remove(filePath)
+
+	extractor := extractous.New().SetExtractStringMaxLength(len(content) * 2)
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	fromFile, _, err := extractor.ExtractFileToString(filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileToString failed: %v", err)
+	}
+	fromBytes, _, err := extractor.ExtractBytesToString([]byte(content))
+	if err != nil {
+		t.Fatalf("ExtractBytesToString failed: %v", err)
+	}
+
+	if strings.TrimSpace(fromFile) != strings.TrimSpace(content) {
+		t.Errorf("File extraction mismatch: got %d bytes, want %d", len(fromFile), len(content))
+	}
+	if fromFile != fromBytes {
+		t.Errorf("File and bytes extraction differ: %d vs %d bytes", len(fromFile), len(fromBytes))
+	}
+}
+
 // ============================================================================
 // Configuration Tests
 // ============================================================================
@@ -271,6 +312,38 @@ func TestIntegration_MetadataExtraction(t *testing.T) {
 	}
 }
 
+func TestIntegration_PackedMetadataMatchesStreamMetadata(t *testing.T) {
+	filePath := createTestFile(t, "packed_metadata_test.txt", "Packed metadata content")
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	// The buffer and stream paths build their packed metadata independently.
+	_, packed, err := extractor.ExtractFileToString(filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileToString failed: %v", err)
+	}
+	reader, arrays, err := extractor.ExtractFile(filePath)
+	if err != nil {
+		t.Fatalf("ExtractFile failed: %v", err)
+	}
+	defer reader.Close()
+
+	if len(packed) != len(arrays) {
+		t.Fatalf("Metadata size mismatch: packed %d, arrays %d", len(packed), len(arrays))
+	}
+	for key, want := range arrays {
+		got := packed.GetAll(key)
+		if strings.Join(got, "\x00") != strings.Join(want, "\x00") {
+			t.Errorf("Key %q: packed %v, arrays %v", key, got, want)
+		}
+	}
+}
+
 func TestIntegration_MetadataWithMultipleValues(t *testing.T) {
 	// Some metadata fields can have multiple values (comma-separated)
 	content := "Test content"
@@ -297,6 +370,33 @@ func TestIntegration_MetadataWithMultipleValues(t *testing.T) {
 	}
 }
 
+func TestIntegration_MultiValuedMetadataNotFlattened(t *testing.T) {
+	filePath := createTestFile(t, "multi_value_test.txt", "Multi-valued metadata content")
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	_, metadata, err := extractor.ExtractFileToString(filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileToString failed: %v", err)
+	}
+
+	// Tika records every parser in the chain as a separate value.
+	parsers := metadata.GetAll("X-TIKA:Parsed-By")
+	if len(parsers) == 0 {
+		t.Fatal("Expected X-TIKA:Parsed-By metadata")
+	}
+	for _, parser := range parsers {
+		if parser == "" || strings.Contains(parser, ", ") {
+			t.Errorf("Parser value looks flattened: %q (all: %v)", parser, parsers)
+		}
+	}
+}
+
 // ============================================================================
 // Error Handling Tests
 // ============================================================================
@@ -409,6 +509,1429 @@ func TestIntegration_MultipleExtractorsSameFile(t *testing.T) {
 	}
 }
 
+// ============================================================================
+// Batch Extraction Tests
+// ============================================================================
+
+func TestIntegration_ExtractFilesBatch(t *testing.T) {
+	paths := []string{
+		createTestFile(t, "batch_a.txt", "Batch document A"),
+		createTestFile(t, "batch_b.txt", "Batch document B"),
+		"/nonexistent/batch_missing.txt",
+		createTestFile(t, "batch_c.txt", "Batch document C"),
+	}
+	for _, p := range paths {
+		defer os.Remove(p)
+	}
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	results, err := extractor.ExtractFilesBatch(paths, 2)
+	if err != nil {
+		t.Fatalf("ExtractFilesBatch failed: %v", err)
+	}
+	if len(results) != len(paths) {
+		t.Fatalf("Expected %d results, got %d", len(paths), len(results))
+	}
+
+	for i, want := range []string{"Batch document A", "Batch document B", "", "Batch document C"} {
+		r := results[i]
+		if r.Path != paths[i] {
+			t.Errorf("Result %d: expected path %q, got %q", i, paths[i], r.Path)
+		}
+		if want == "" {
+			if r.Err == nil {
+				t.Errorf("Result %d: expected error for missing file", i)
+			}
+			continue
+		}
+		if r.Err != nil {
+			t.Errorf("Result %d: unexpected error: %v", i, r.Err)
+			continue
+		}
+		if !strings.Contains(r.Content, want) {
+			t.Errorf("Result %d: expected content %q, got %q", i, want, r.Content)
+		}
+		if r.Metadata == nil {
+			t.Errorf("Result %d: expected non-nil metadata", i)
+		}
+	}
+}
+
+func TestIntegration_ExtractFilesBatch_NULContent(t *testing.T) {
+	content := "before\x00after"
+	path := createTestFile(t, "batch_nul.txt", content)
+	defer os.Remove(path)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	results, err := extractor.ExtractFilesBatch([]string{path}, 1)
+	if err != nil {
+		t.Fatalf("ExtractFilesBatch failed: %v", err)
+	}
+	if results[0].Err != nil {
+		t.Fatalf("Unexpected item error: %v", results[0].Err)
+	}
+	if !strings.Contains(results[0].Content, content) {
+		t.Errorf("Expected content %q, got %q", content, results[0].Content)
+	}
+}
+
+func TestIntegration_ExtractFilesBatch_Empty(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	results, err := extractor.ExtractFilesBatch(nil, 0)
+	if err != nil {
+		t.Fatalf("ExtractFilesBatch failed: %v", err)
+	}
+	if len(results) != 0 {
+		t.Errorf("Expected no results, got %d", len(results))
+	}
+}
+
+func TestIntegration_ExtractFileMmap(t *testing.T) {
+	content := "Memory mapped extraction content"
+	filePath := createTestFile(t, "mmap_test.txt", content)
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	want, _, err := extractor.ExtractFileToString(filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileToString failed: %v", err)
+	}
+
+	reader, metadata, err := extractor.ExtractFileMmap(filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileMmap failed: %v", err)
+	}
+	defer reader.Close()
+
+	got, err := io.ReadAll(reader)
+	if err != nil {
+		t.Fatalf("ReadAll failed: %v", err)
+	}
+	if string(got) != want {
+		t.Errorf("Stream content mismatch: got %q, want %q", got, want)
+	}
+	if len(metadata) == 0 {
+		t.Error("Expected metadata from mmap extraction")
+	}
+
+	str, _, err := extractor.ExtractFileMmapToString(filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileMmapToString failed: %v", err)
+	}
+	if str != want {
+		t.Errorf("String content mismatch: got %q, want %q", str, want)
+	}
+}
+
+func TestIntegration_ExtractFileMmap_NonexistentFile(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	_, _, err := extractor.ExtractFileMmap("/nonexistent/file.txt")
+	if err == nil {
+		t.Error("Expected error for nonexistent file")
+	}
+}
+
+func TestIntegration_ExtractBytesNoCopy(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	data := []byte("Borrowed bytes extraction content")
+	want, _, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("ExtractBytesToString failed: %v", err)
+	}
+
+	// Repeat so that pins and handles are released and reused across calls.
+	for i := 0; i < 3; i++ {
+		reader, metadata, err := extractor.ExtractBytesNoCopy(data)
+		if err != nil {
+			t.Fatalf("ExtractBytesNoCopy failed: %v", err)
+		}
+		got, err := io.ReadAll(reader)
+		reader.Close()
+		if err != nil {
+			t.Fatalf("ReadAll failed: %v", err)
+		}
+		if string(got) != want {
+			t.Errorf("Content mismatch: got %q, want %q", got, want)
+		}
+		if len(metadata) == 0 {
+			t.Error("Expected metadata from borrowed extraction")
+		}
+	}
+}
+
+func TestIntegration_ExtractBytesNoCopy_Empty(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	reader, metadata, err := extractor.ExtractBytesNoCopy(nil)
+	if err != nil {
+		t.Fatalf("ExtractBytesNoCopy failed: %v", err)
+	}
+	if reader != nil {
+		t.Error("Expected nil reader for empty input")
+	}
+	if metadata == nil {
+		t.Error("Expected non-nil metadata for empty input")
+	}
+}
+
+func TestIntegration_ExtractReader(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	data := strings.Repeat("Streamed input line\n", 10000)
+	want, _, err := extractor.ExtractBytesToString([]byte(data))
+	if err != nil {
+		t.Fatalf("ExtractBytesToString failed: %v", err)
+	}
+
+	// iotest.OneByteReader hides Len() and forces many short callbacks.
+	inputs := map[string]io.Reader{
+		"strings.Reader": strings.NewReader(data),
+		"one byte":       iotest.OneByteReader(strings.NewReader(data)),
+	}
+	for name, input := range inputs {
+		reader, metadata, err := extractor.ExtractReader(input)
+		if err != nil {
+			t.Fatalf("%s: ExtractReader failed: %v", name, err)
+		}
+		got, err := io.ReadAll(reader)
+		reader.Close()
+		if err != nil {
+			t.Fatalf("%s: ReadAll failed: %v", name, err)
+		}
+		if string(got) != want {
+			t.Errorf("%s: content mismatch (got %d bytes, want %d)", name, len(got), len(want))
+		}
+		if len(metadata) == 0 {
+			t.Errorf("%s: expected metadata", name)
+		}
+	}
+}
+
+func TestIntegration_ExtractReader_ReaderError(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	readErr := errors.New("connection reset")
+	input := io.MultiReader(strings.NewReader("partial"), iotest.ErrReader(readErr))
+
+	_, _, err := extractor.ExtractReader(input)
+	if !errors.Is(err, readErr) {
+		t.Errorf("Expected reader error to be wrapped, got %v", err)
+	}
+	if !errors.Is(err, extractous.ErrIO) {
+		t.Errorf("Expected ErrIO, got %v", err)
+	}
+}
+
+// emptyReader returns no data and no error, forever.
+type emptyReader struct{}
+
+func (emptyReader) Read([]byte) (int, error) { return 0, nil }
+
+func TestIntegration_ExtractReader_NoProgress(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	_, _, err := extractor.ExtractReader(emptyReader{})
+	if !errors.Is(err, io.ErrNoProgress) {
+		t.Errorf("Expected io.ErrNoProgress, got %v", err)
+	}
+	if !errors.Is(err, extractous.ErrIO) {
+		t.Errorf("Expected ErrIO, got %v", err)
+	}
+}
+
+func TestIntegration_StreamReaderBufferSizes(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	data := []byte(strings.Repeat("Buffered stream line\n", 5000))
+	want, _, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("ExtractBytesToString failed: %v", err)
+	}
+
+	for _, size := range []int{0, 7, extractous.DefaultStreamBufferSize} {
+		reader, _, err := extractor.ExtractBytes(data)
+		if err != nil {
+			t.Fatalf("size %d: ExtractBytes failed: %v", size, err)
+		}
+		reader.SetBufferSize(size)
+
+		// Odd-sized small reads straddle every refill boundary.
+		var got []byte
+		buf := make([]byte, 13)
+		for {
+			n, err := reader.Read(buf)
+			got = append(got, buf[:n]...)
+			if err == io.EOF {
+				break
+			}
+			if err != nil {
+				t.Fatalf("size %d: Read failed: %v", size, err)
+			}
+		}
+		reader.Close()
+
+		if string(got) != want {
+			t.Errorf("size %d: content mismatch (got %d bytes, want %d)", size, len(got), len(want))
+		}
+	}
+}
+
+func TestIntegration_StreamReaderWriteTo(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	data := []byte(strings.Repeat("Copied stream line\n", 5000))
+	want, _, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("ExtractBytesToString failed: %v", err)
+	}
+
+	// *os.File takes the native copy path, bytes.Buffer the Go one. A short
+	// Read first leaves bytes in the internal buffer that must come first.
+	file, err := os.CreateTemp(t.TempDir(), "writeto-*.txt")
+	if err != nil {
+		t.Fatalf("CreateTemp failed: %v", err)
+	}
+	defer file.Close()
+	var buffer bytes.Buffer
+
+	for _, w := range []io.Writer{file, &buffer} {
+		reader, _, err := extractor.ExtractBytes(data)
+		if err != nil {
+			t.Fatalf("ExtractBytes failed: %v", err)
+		}
+		head := make([]byte, 10)
+		n, err := reader.Read(head)
+		if err != nil {
+			t.Fatalf("Read failed: %v", err)
+		}
+		if _, err := w.Write(head[:n]); err != nil {
+			t.Fatalf("Write failed: %v", err)
+		}
+		copied, err := io.Copy(w, reader)
+		reader.Close()
+		if err != nil {
+			t.Fatalf("%T: io.Copy failed: %v", w, err)
+		}
+		if int(copied)+n != len(want) {
+			t.Errorf("%T: copied %d bytes, want %d", w, int(copied)+n, len(want))
+		}
+	}
+
+	got, err := os.ReadFile(file.Name())
+	if err != nil {
+		t.Fatalf("ReadFile failed: %v", err)
+	}
+	if string(got) != want {
+		t.Errorf("File content mismatch (got %d bytes, want %d)", len(got), len(want))
+	}
+	if buffer.String() != want {
+		t.Errorf("Buffer content mismatch (got %d bytes, want %d)", buffer.Len(), len(want))
+	}
+}
+
+func TestIntegration_Stats(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	extractous.EnableStats(true)
+	defer extractous.EnableStats(false)
+	extractous.ResetStats()
+
+	data := []byte("Statistics integration content")
+	content, metadata, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("ExtractBytesToString failed: %v", err)
+	}
+	if _, _, err := extractor.ExtractFileMmap("/nonexistent/file.txt"); err == nil {
+		t.Fatal("Expected error for nonexistent file")
+	}
+
+	s := extractous.Stats()
+	if !s.Enabled {
+		t.Error("Expected stats to be enabled")
+	}
+	if s.Calls < 1 {
+		t.Errorf("Expected at least one call, got %d", s.Calls)
+	}
+	if s.BytesIn < uint64(len(data)) {
+		t.Errorf("BytesIn = %d, want at least %d", s.BytesIn, len(data))
+	}
+	if s.BytesOut < uint64(len(content)) {
+		t.Errorf("BytesOut = %d, want at least %d", s.BytesOut, len(content))
+	}
+	if s.MetadataEntries < uint64(len(metadata)) {
+		t.Errorf("MetadataEntries = %d, want at least %d", s.MetadataEntries, len(metadata))
+	}
+	if s.ErrorsByCode[-5] < 1 {
+		t.Errorf("Expected an IO error to be counted, got %v", s.ErrorsByCode)
+	}
+
+	var bucketed uint64
+	for _, b := range s.Latency {
+		bucketed += b.Count
+	}
+	if bucketed != s.Calls {
+		t.Errorf("Latency buckets hold %d calls, want %d", bucketed, s.Calls)
+	}
+
+	extractous.ResetStats()
+	if s := extractous.Stats(); s.Calls != 0 || s.BytesIn != 0 || s.OCRPages != 0 {
+		t.Errorf("Expected counters to be reset, got %+v", s)
+	}
+}
+
+func TestIntegration_ExtractFileAsync(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	const numFiles = 8
+	paths := make([]string, numFiles)
+	want := make([]string, numFiles)
+	for i := range paths {
+		paths[i] = createTestFile(t, fmt.Sprintf("async_%d.txt", i), fmt.Sprintf("Async document %d", i))
+		defer os.Remove(paths[i])
+
+		content, _, err := extractor.ExtractFileToString(paths[i])
+		if err != nil {
+			t.Fatalf("ExtractFileToString failed: %v", err)
+		}
+		want[i] = content
+	}
+
+	results := make([]<-chan extractous.AsyncResult, numFiles)
+	for i, p := range paths {
+		results[i] = extractor.ExtractFileAsync(p)
+	}
+	for i, ch := range results {
+		r := <-ch
+		if r.Err != nil {
+			t.Errorf("%s: %v", paths[i], r.Err)
+			continue
+		}
+		if r.Content != want[i] {
+			t.Errorf("%s: content mismatch: got %q, want %q", paths[i], r.Content, want[i])
+		}
+		if len(r.Metadata) == 0 {
+			t.Errorf("%s: expected metadata", paths[i])
+		}
+		if _, ok := <-ch; ok {
+			t.Errorf("%s: expected channel to be closed after one result", paths[i])
+		}
+	}
+}
+
+func TestIntegration_ExtractFileAsync_NonexistentFile(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	r := <-extractor.ExtractFileAsync("/nonexistent/file.txt")
+	if !errors.Is(r.Err, extractous.ErrIO) {
+		t.Errorf("Expected ErrIO, got %v", r.Err)
+	}
+}
+
+func TestIntegration_ExtractFileAsync_ExtractorClosed(t *testing.T) {
+	filePath := createTestFile(t, "async_closed.txt", "Async content after close")
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	ch := extractor.ExtractFileAsync(filePath)
+	// The configuration was captured at submission, so closing is safe.
+	extractor.Close()
+
+	r := <-ch
+	if r.Err != nil {
+		t.Fatalf("ExtractFileAsync failed: %v", r.Err)
+	}
+	if !strings.Contains(r.Content, "Async content after close") {
+		t.Errorf("Unexpected content: %q", r.Content)
+	}
+}
+
+func TestIntegration_ExtractFileToStringContext(t *testing.T) {
+	content := "Extraction under a context"
+	filePath := createTestFile(t, "context_test.txt", content)
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	ctx, cancel := context.WithTimeout(context.Background(), time.Minute)
+	defer cancel()
+	got, metadata, err := extractor.ExtractFileToStringContext(ctx, filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileToStringContext failed: %v", err)
+	}
+	if !strings.Contains(got, content) {
+		t.Errorf("Expected content to contain %q, got %q", content, got)
+	}
+	if len(metadata) == 0 {
+		t.Error("Expected metadata")
+	}
+
+	expired, cancelExpired := context.WithTimeout(context.Background(), -time.Second)
+	defer cancelExpired()
+	_, _, err = extractor.ExtractFileToStringContext(expired, filePath)
+	if !errors.Is(err, extractous.ErrCancelled) || !errors.Is(err, context.DeadlineExceeded) {
+		t.Errorf("Expected ErrCancelled wrapping DeadlineExceeded, got %v", err)
+	}
+}
+
+func TestIntegration_ExtractBytesToStringContext_Budget(t *testing.T) {
+	extractor := extractous.New().SetContentBudget(4).SetEncoding(extractous.CharSetUTF16BE)
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	// The budget ends inside the two-byte "é".
+	got, _, err := extractor.ExtractBytesToStringContext(context.Background(), []byte("cafés"))
+	if err != nil {
+		t.Fatalf("ExtractBytesToStringContext failed: %v", err)
+	}
+	if got != "caf" {
+		t.Errorf("Expected %q, got %q", "caf", got)
+	}
+}
+
+func TestIntegration_ExtractFileContext_CancelMidStream(t *testing.T) {
+	content := strings.Repeat("Streamed content that is cancelled. ", 200)
+	filePath := createTestFile(t, "context_stream.txt", content)
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	ctx, cancel := context.WithCancel(context.Background())
+	defer cancel()
+	reader, _, err := extractor.ExtractFileContext(ctx, filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileContext failed: %v", err)
+	}
+	defer reader.Close()
+
+	buf := make([]byte, 16)
+	if _, err := reader.Read(buf); err != nil {
+		t.Fatalf("Read before cancel failed: %v", err)
+	}
+
+	cancel()
+	for i := 0; i < 2; i++ {
+		_, err = reader.Read(buf)
+		if !errors.Is(err, extractous.ErrCancelled) || !errors.Is(err, context.Canceled) {
+			t.Fatalf("Read %d after cancel: expected ErrCancelled wrapping context.Canceled, got %v", i, err)
+		}
+	}
+	if _, err := io.Copy(io.Discard, reader); !errors.Is(err, extractous.ErrCancelled) {
+		t.Errorf("Expected WriteTo to fail with ErrCancelled, got %v", err)
+	}
+}
+
+func TestIntegration_ExtractFileContext_Background(t *testing.T) {
+	content := "Stream without cancellation"
+	filePath := createTestFile(t, "context_background.txt", content)
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	reader, _, err := extractor.ExtractFileContext(context.Background(), filePath)
+	if err != nil {
+		t.Fatalf("ExtractFileContext failed: %v", err)
+	}
+	defer reader.Close()
+
+	got, err := io.ReadAll(reader)
+	if err != nil {
+		t.Fatalf("ReadAll failed: %v", err)
+	}
+	if !strings.Contains(string(got), content) {
+		t.Errorf("Expected content to contain %q, got %q", content, got)
+	}
+}
+
+func TestIntegration_SharedExtractorConcurrentReconfigure(t *testing.T) {
+	content := "Shared extractor content"
+	filePath := createTestFile(t, "shared_test.txt", content)
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	const numGoroutines = 8
+	const iterations = 20
+	errs := make(chan error, numGoroutines*iterations)
+	var wg sync.WaitGroup
+	for i := 0; i < numGoroutines; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < iterations; j++ {
+				extracted, _, err := extractor.ExtractFileToString(filePath)
+				if err != nil {
+					errs <- err
+					continue
+				}
+				if !strings.Contains(extracted, content) {
+					errs <- fmt.Errorf("unexpected content %q", extracted)
+				}
+			}
+		}()
+	}
+
+	// Setters publish new snapshots while the goroutines extract.
+	for i := 0; i < iterations; i++ {
+		extractor.SetXmlOutput(i%2 == 0).SetExtractStringMaxLength(100_000 + i)
+	}
+
+	wg.Wait()
+	close(errs)
+	for err := range errs {
+		t.Errorf("Concurrent extraction failed: %v", err)
+	}
+}
+
+func TestIntegration_Pool(t *testing.T) {
+	content := "Pooled extractor content"
+	filePath := createTestFile(t, "pool_test.txt", content)
+	defer os.Remove(filePath)
+
+	pool, err := extractous.NewPool(nil, 2)
+	if err != nil {
+		t.Fatalf("NewPool failed: %v", err)
+	}
+	defer pool.Close()
+	if pool.Size() != 2 {
+		t.Fatalf("Expected pool size 2, got %d", pool.Size())
+	}
+
+	const numGoroutines = 8
+	errs := make(chan error, numGoroutines)
+	var wg sync.WaitGroup
+	for i := 0; i < numGoroutines; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			ext, err := pool.Acquire(context.Background())
+			if err != nil {
+				errs <- err
+				return
+			}
+			defer ext.Close()
+			extracted, _, err := ext.ExtractFileToString(filePath)
+			if err != nil {
+				errs <- err
+			} else if !strings.Contains(extracted, content) {
+				errs <- fmt.Errorf("unexpected content %q", extracted)
+			}
+		}()
+	}
+	wg.Wait()
+	close(errs)
+	for err := range errs {
+		t.Errorf("Pooled extraction failed: %v", err)
+	}
+}
+
+func TestIntegration_PoolRestoresConfiguration(t *testing.T) {
+	content := "Pooled extractor content"
+	filePath := createTestFile(t, "pool_config_test.txt", content)
+	defer os.Remove(filePath)
+
+	pool, err := extractous.NewPool(nil, 1)
+	if err != nil {
+		t.Fatalf("NewPool failed: %v", err)
+	}
+	defer pool.Close()
+
+	ext, err := pool.Acquire(context.Background())
+	if err != nil {
+		t.Fatalf("Acquire failed: %v", err)
+	}
+	ext.SetExtractStringMaxLength(6)
+	if err := pool.Release(ext); err != nil {
+		t.Fatalf("Release failed: %v", err)
+	}
+
+	ext, err = pool.Acquire(context.Background())
+	if err != nil {
+		t.Fatalf("Acquire failed: %v", err)
+	}
+	defer ext.Close()
+	extracted, _, err := ext.ExtractFileToString(filePath)
+	if err != nil {
+		t.Fatalf("Extraction failed: %v", err)
+	}
+	if !strings.Contains(extracted, content) {
+		t.Errorf("Expected the pool configuration to be restored, got %q", extracted)
+	}
+}
+
+func TestIntegration_PoolExhausted(t *testing.T) {
+	pool, err := extractous.NewPool(nil, 1)
+	if err != nil {
+		t.Fatalf("NewPool failed: %v", err)
+	}
+
+	ext, err := pool.Acquire(context.Background())
+	if err != nil {
+		t.Fatalf("Acquire failed: %v", err)
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(), 20*time.Millisecond)
+	defer cancel()
+	if _, err := pool.Acquire(ctx); !errors.Is(err, context.DeadlineExceeded) {
+		t.Errorf("Expected DeadlineExceeded while exhausted, got %v", err)
+	}
+	if err := pool.Close(); !errors.Is(err, extractous.ErrPoolInUse) {
+		t.Errorf("Expected ErrPoolInUse, got %v", err)
+	}
+
+	ext.Close()
+	if err := pool.Close(); err != nil {
+		t.Errorf("Close after release failed: %v", err)
+	}
+}
+
+func TestIntegration_PoolCloseWithWaiters(t *testing.T) {
+	pool, err := extractous.NewPool(nil, 2)
+	if err != nil {
+		t.Fatalf("NewPool failed: %v", err)
+	}
+
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for {
+				ext, err := pool.Acquire(context.Background())
+				if err != nil {
+					if !errors.Is(err, extractous.ErrNullPointer) {
+						t.Errorf("Expected ErrNullPointer after Close, got %v", err)
+					}
+					return
+				}
+				ext.Close()
+			}
+		}()
+	}
+
+	for {
+		err := pool.Close()
+		if err == nil {
+			break
+		}
+		if !errors.Is(err, extractous.ErrPoolInUse) {
+			t.Fatalf("Close failed: %v", err)
+		}
+		runtime.Gosched()
+	}
+
+	finished := make(chan struct{})
+	go func() {
+		wg.Wait()
+		close(finished)
+	}()
+	select {
+	case <-finished:
+	case <-time.After(5 * time.Second):
+		t.Fatal("Acquire still blocked after the pool was closed")
+	}
+}
+
+func TestIntegration_InitAndWarmup(t *testing.T) {
+	if err := extractous.Init(nil); err != nil {
+		t.Fatalf("Init failed: %v", err)
+	}
+	if err := extractous.Init(&extractous.InitOptions{StartWorkers: true}); err != nil {
+		t.Errorf("Init without warm-up failed: %v", err)
+	}
+	for _, formats := range []extractous.WarmupFormat{
+		extractous.WarmupPDF,
+		extractous.WarmupOffice,
+		extractous.WarmupHTML,
+		extractous.WarmupAll,
+	} {
+		if err := extractous.Warmup(formats); err != nil {
+			t.Errorf("Warmup(%d) failed: %v", formats, err)
+		}
+	}
+}
+
+func TestIntegration_Cache(t *testing.T) {
+	cache := extractous.NewCache(1 << 20)
+	extractor := extractous.New().SetCache(cache)
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+	// The extractor keeps the cache alive.
+	cache.Close()
+
+	extractous.EnableStats(true)
+	defer extractous.EnableStats(false)
+	extractous.ResetStats()
+
+	data := []byte("Cached integration content")
+	first, _, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("First extraction failed: %v", err)
+	}
+	second, metadata, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("Second extraction failed: %v", err)
+	}
+	if first != second || len(metadata) == 0 {
+		t.Errorf("Cache hit returned %q with %d metadata keys, want %q", second, len(metadata), first)
+	}
+
+	s := extractous.Stats()
+	if s.CacheMisses != 1 || s.CacheHits != 1 {
+		t.Errorf("Expected 1 miss and 1 hit, got %d and %d", s.CacheMisses, s.CacheHits)
+	}
+}
+
+func TestIntegration_CacheDiskTier(t *testing.T) {
+	dir := t.TempDir()
+	data := []byte("Disk cached integration content")
+
+	extractous.EnableStats(true)
+	defer extractous.EnableStats(false)
+	extractous.ResetStats()
+
+	// Each cache stands for one process run; the second only finds the entry on disk.
+	for run := 0; run < 2; run++ {
+		cache := extractous.NewCache(1 << 20)
+		if err := cache.SetDiskTier(dir, 1<<20); err != nil {
+			t.Fatalf("SetDiskTier failed: %v", err)
+		}
+		extractor := extractous.New().SetCache(cache)
+		if _, _, err := extractor.ExtractBytesToString(data); err != nil {
+			t.Fatalf("Extraction failed: %v", err)
+		}
+		extractor.Close()
+		cache.Close()
+	}
+
+	s := extractous.Stats()
+	if s.CacheMisses != 1 || s.CacheDiskHits != 1 {
+		t.Errorf("Expected 1 miss and 1 disk hit, got %d and %d", s.CacheMisses, s.CacheDiskHits)
+	}
+}
+
+func TestIntegration_ExtractMetadata(t *testing.T) {
+	content := "Metadata only integration content"
+	filePath := createTestFile(t, "metadata_only_test.txt", content)
+	defer os.Remove(filePath)
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	metadata, err := extractor.ExtractMetadata(filePath)
+	if err != nil {
+		t.Fatalf("ExtractMetadata failed: %v", err)
+	}
+	if metadata.Get("Content-Type") == "" {
+		t.Errorf("Expected Content-Type in %v", metadata)
+	}
+
+	fromBytes, err := extractor.ExtractBytesMetadata([]byte(content))
+	if err != nil {
+		t.Fatalf("ExtractBytesMetadata failed: %v", err)
+	}
+	if fromBytes.Get("Content-Type") == "" {
+		t.Errorf("Expected Content-Type in %v", fromBytes)
+	}
+
+	if _, err := extractor.ExtractMetadata("/nonexistent/file.txt"); !errors.Is(err, extractous.ErrIO) {
+		t.Errorf("Expected ErrIO for a missing file, got %v", err)
+	}
+}
+
+func TestIntegration_ContentBudget(t *testing.T) {
+	data := []byte(strings.Repeat("Budgeted integration content. ", 1000))
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	full, _, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("Unbudgeted extraction failed: %v", err)
+	}
+	const budget = 100
+	if len(full) <= budget {
+		t.Fatalf("Expected more than %d bytes without a budget, got %d", budget, len(full))
+	}
+
+	extractor = extractor.SetContentBudget(budget)
+	content, metadata, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("Budgeted extraction failed: %v", err)
+	}
+	if content != full[:budget] || len(metadata) == 0 {
+		t.Errorf("Budgeted string is %q with %d metadata keys, want %q", content, len(metadata), full[:budget])
+	}
+
+	reader, _, err := extractor.ExtractBytes(data)
+	if err != nil {
+		t.Fatalf("Budgeted stream extraction failed: %v", err)
+	}
+	streamed, err := io.ReadAll(reader)
+	reader.Close()
+	if err != nil {
+		t.Fatalf("Reading the budgeted stream failed: %v", err)
+	}
+	if string(streamed) != full[:budget] {
+		t.Errorf("Budgeted stream is %q, want %q", streamed, full[:budget])
+	}
+
+	unbounded, _, err := extractor.SetContentBudget(0).ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("Extraction after removing the budget failed: %v", err)
+	}
+	if unbounded != full {
+		t.Errorf("Removing the budget returned %d bytes, want %d", len(unbounded), len(full))
+	}
+}
+
+func TestIntegration_StreamEvents(t *testing.T) {
+	extractor := extractous.New().SetXmlOutput(true)
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	reader, _, err := extractor.ExtractBytes([]byte("Paged <event> & content"))
+	if err != nil {
+		t.Fatalf("ExtractBytes failed: %v", err)
+	}
+	defer reader.Close()
+
+	var kinds []extractous.StreamEventKind
+	var text strings.Builder
+	for {
+		event, err := reader.NextEvent()
+		if err == io.EOF {
+			break
+		}
+		if err != nil {
+			t.Fatalf("NextEvent failed: %v", err)
+		}
+		kinds = append(kinds, event.Kind)
+		if event.Kind == extractous.EventText {
+			if event.Index != 1 {
+				t.Errorf("Text event on page %d, want 1", event.Index)
+			}
+			text.Write(event.Data)
+		}
+	}
+
+	if len(kinds) < 3 || kinds[0] != extractous.EventPageStart || kinds[len(kinds)-1] != extractous.EventPageEnd {
+		t.Errorf("Expected text between page start and end events, got %v", kinds)
+	}
+	if !strings.Contains(text.String(), "Paged <event> & content") || strings.Contains(text.String(), "<p>") {
+		t.Errorf("Expected decoded text without markup, got %q", text.String())
+	}
+	if _, err := reader.NextEvent(); err != io.EOF {
+		t.Errorf("Expected io.EOF after the end, got %v", err)
+	}
+}
+
+func TestIntegration_ExtractFileRecursive(t *testing.T) {
+	path := createTestFile(t, "recursive.txt", "A container without attachments")
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	docs, err := extractor.ExtractFileRecursive(path, 4, 100)
+	if err != nil {
+		t.Fatalf("Recursive extraction failed: %v", err)
+	}
+	if len(docs) != 1 {
+		t.Fatalf("Expected the container alone, got %d documents", len(docs))
+	}
+	root := docs[0]
+	if root.Path != "" || root.Depth != 0 || root.Truncated {
+		t.Errorf("Unexpected container result %+v", root)
+	}
+	if !strings.Contains(root.Content, "A container without attachments") || len(root.Metadata) == 0 {
+		t.Errorf("Expected container content and metadata, got %q with %d keys", root.Content, len(root.Metadata))
+	}
+
+	if _, err := extractor.ExtractFileRecursive("/nonexistent/file.txt", 4, 100); err == nil {
+		t.Error("Expected error for a missing file")
+	}
+}
+
+func TestIntegration_DetectFile(t *testing.T) {
+	path := createTestFile(t, "detect.html", "<!DOCTYPE html><html><body>Detected</body></html>")
+
+	mime, err := extractous.DetectFile(path)
+	if err != nil {
+		t.Fatalf("DetectFile failed: %v", err)
+	}
+	if mime != "text/html" {
+		t.Errorf("Expected text/html, got %q", mime)
+	}
+
+	if _, err := extractous.DetectFile("/nonexistent/file.pdf"); err == nil {
+		t.Error("Expected error for a missing file")
+	}
+}
+
+func TestIntegration_ExtractBytesInto(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	for _, text := range []string{"A first, somewhat longer document", "Second"} {
+		want, _, err := extractor.ExtractBytesToString([]byte(text))
+		if err != nil {
+			t.Fatalf("ExtractBytesToString failed: %v", err)
+		}
+
+		buf := extractous.GetBuffer()
+		metadata, err := extractor.ExtractBytesInto([]byte(text), buf)
+		if err != nil {
+			t.Fatalf("ExtractBytesInto failed: %v", err)
+		}
+		if buf.String() != want || len(metadata) == 0 {
+			t.Errorf("Buffer holds %q with %d metadata keys, want %q", buf.String(), len(metadata), want)
+		}
+		extractous.PutBuffer(buf)
+	}
+
+	path := createTestFile(t, "into.txt", "File content into a buffer")
+	buf := extractous.NewBuffer(0)
+	defer buf.Close()
+	if _, err := extractor.ExtractFileInto(path, buf); err != nil {
+		t.Fatalf("ExtractFileInto failed: %v", err)
+	}
+	if !strings.Contains(buf.String(), "File content into a buffer") {
+		t.Errorf("Unexpected file content %q", buf.String())
+	}
+}
+
+func TestIntegration_HTTPConfig(t *testing.T) {
+	const perHost = 2
+	var inFlight, peak atomic.Int32
+	server := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		n := inFlight.Add(1)
+		defer inFlight.Add(-1)
+		for {
+			p := peak.Load()
+			if n <= p || peak.CompareAndSwap(p, n) {
+				break
+			}
+		}
+		time.Sleep(20 * time.Millisecond)
+		switch r.URL.Path {
+		case "/doc.txt":
+			w.Write([]byte("Fetched over a pooled connection"))
+		case "/large.txt":
+			w.Write(bytes.Repeat([]byte("x"), 4096))
+		default:
+			http.NotFound(w, r)
+		}
+	}))
+	defer server.Close()
+
+	cfg := extractous.NewHTTPConfig()
+	cfg.MaxBodySize = 1024
+	cfg.MaxPerHost = perHost
+	extractor := extractous.New().SetHTTPConfig(cfg)
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	var wg sync.WaitGroup
+	errs := make(chan error, 6)
+	for i := 0; i < cap(errs); i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			content, _, err := extractor.ExtractURLToString(server.URL + "/doc.txt")
+			if err == nil && !strings.Contains(content, "Fetched over a pooled connection") {
+				err = fmt.Errorf("unexpected content %q", content)
+			}
+			errs <- err
+		}()
+	}
+	wg.Wait()
+	close(errs)
+	for err := range errs {
+		if err != nil {
+			t.Errorf("ExtractURLToString failed: %v", err)
+		}
+	}
+	if got := peak.Load(); got > perHost {
+		t.Errorf("Expected at most %d fetches in flight, saw %d", perHost, got)
+	}
+
+	if _, _, err := extractor.ExtractURLToString(server.URL + "/large.txt"); !errors.Is(err, extractous.ErrIO) {
+		t.Errorf("Expected ErrIO for a body over MaxBodySize, got %v", err)
+	}
+	if _, _, err := extractor.ExtractURL(server.URL + "/missing"); !errors.Is(err, extractous.ErrIO) {
+		t.Errorf("Expected ErrIO for HTTP 404, got %v", err)
+	}
+
+	reader, _, err := extractor.ExtractURL(server.URL + "/doc.txt")
+	if err != nil {
+		t.Fatalf("ExtractURL failed: %v", err)
+	}
+	defer reader.Close()
+	if data, _ := io.ReadAll(reader); !strings.Contains(string(data), "Fetched over a pooled connection") {
+		t.Errorf("Unexpected streamed content %q", data)
+	}
+}
+
+func TestIntegration_HTTPConfig_ContentLength(t *testing.T) {
+	// A Content-Length far beyond the body must not be reserved up front.
+	server := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		conn, buf, err := w.(http.Hijacker).Hijack()
+		if err != nil {
+			return
+		}
+		defer conn.Close()
+		buf.WriteString("HTTP/1.1 200 OK\r\nContent-Length: 1000000000000\r\n\r\nTruncated body")
+		buf.Flush()
+	}))
+	defer server.Close()
+
+	extractor := extractous.New().SetHTTPConfig(extractous.NewHTTPConfig())
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	if _, _, err := extractor.ExtractURLToString(server.URL + "/doc.txt"); !errors.Is(err, extractous.ErrIO) {
+		t.Errorf("Expected ErrIO for a truncated body, got %v", err)
+	}
+}
+
+func TestIntegration_Measure(t *testing.T) {
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	extractous.EnableStats(true)
+	defer extractous.EnableStats(false)
+
+	var content string
+	stats, err := extractous.Measure(func() (err error) {
+		content, _, err = extractor.ExtractBytesToString([]byte("Per-call accounting content"))
+		return err
+	})
+	if err != nil {
+		t.Fatalf("ExtractBytesToString failed: %v", err)
+	}
+	if stats.Err != nil {
+		t.Errorf("Stats.Err = %v, want nil", stats.Err)
+	}
+	if stats.Total <= 0 || stats.Total < stats.Parse+stats.Convert {
+		t.Errorf("Unexpected times: total %v, parse %v, convert %v", stats.Total, stats.Parse, stats.Convert)
+	}
+	if stats.BytesOut != uint64(len(content)) {
+		t.Errorf("BytesOut = %d, want %d", stats.BytesOut, len(content))
+	}
+	if stats.MetadataEntries == 0 || stats.RSS == 0 {
+		t.Errorf("Expected metadata entries and RSS, got %+v", stats)
+	}
+
+	stats, err = extractous.Measure(func() error {
+		_, _, err := extractor.ExtractFileToString("/nonexistent/file.txt")
+		return err
+	})
+	if err == nil || !errors.Is(stats.Err, extractous.ErrIO) {
+		t.Errorf("Expected ErrIO for a missing file, got %v (stats %v)", err, stats.Err)
+	}
+
+	// A call that fails before reaching the native library reports nothing,
+	// not the call before it.
+	var closed *extractous.Extractor
+	stats, err = extractous.Measure(func() error {
+		_, _, err := closed.ExtractBytesToString([]byte("Never extracted"))
+		return err
+	})
+	if err == nil || stats != (extractous.ExtractionStats{}) {
+		t.Errorf("Expected an error and zero stats for a nil extractor, got %v, %+v", err, stats)
+	}
+
+	// The stream's reads are accounted on the stream itself.
+	reader, _, err := extractor.ExtractBytes([]byte("Streamed accounting content"))
+	if err != nil {
+		t.Fatalf("ExtractBytes failed: %v", err)
+	}
+	data, _ := io.ReadAll(reader)
+	streamStats := reader.Stats()
+	reader.Close()
+	if streamStats.BytesOut != uint64(len(data)) || streamStats.Total <= 0 {
+		t.Errorf("Unexpected stream stats %+v for %d bytes", streamStats, len(data))
+	}
+	if reader.Stats() != (extractous.ExtractionStats{}) {
+		t.Error("Expected zero stats after Close")
+	}
+
+	path := createTestFile(t, "stats_async.txt", "Accounted on the worker thread")
+	defer os.Remove(path)
+	result := <-extractor.ExtractFileAsync(path)
+	if result.Err != nil {
+		t.Fatalf("ExtractFileAsync failed: %v", result.Err)
+	}
+	if result.Stats.BytesOut != uint64(len(result.Content)) || result.Stats.Total <= 0 {
+		t.Errorf("Unexpected async stats %+v", result.Stats)
+	}
+
+	extractous.EnableStats(false)
+	stats, _ = extractous.Measure(func() error {
+		_, _, err := extractor.ExtractBytesToString([]byte("Not measured"))
+		return err
+	})
+	if stats != (extractous.ExtractionStats{}) {
+		t.Errorf("Expected zero stats while collection is off, got %+v", stats)
+	}
+}
+
+func TestIntegration_MemoryLimit(t *testing.T) {
+	data := []byte(strings.Repeat("Memory limited integration content. ", 1000))
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	extractor = extractor.SetMemoryLimit(1024)
+	if _, _, err := extractor.ExtractBytesToString(data); !errors.Is(err, extractous.ErrOutOfMemory) {
+		t.Errorf("Expected ErrOutOfMemory over the limit, got %v", err)
+	}
+
+	reader, _, err := extractor.ExtractBytes(data)
+	if err != nil {
+		t.Fatalf("Limited stream extraction failed: %v", err)
+	}
+	_, err = io.ReadAll(reader)
+	reader.Close()
+	if err != nil && !errors.Is(err, extractous.ErrOutOfMemory) {
+		t.Errorf("Reading the limited stream failed with %v, want ErrOutOfMemory or none", err)
+	}
+
+	content, _, err := extractor.SetMemoryLimit(0).ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("Extraction without a limit failed: %v", err)
+	}
+	if !strings.Contains(content, "Memory limited integration content.") {
+		t.Errorf("Expected the whole content once the limit is removed, got %d bytes", len(content))
+	}
+}
+
+func TestIntegration_Normalization(t *testing.T) {
+	data := []byte("  Hello \x01 world\r\n\r\n\r\nexam-\nple \t end  \n")
+	const want = "Hello world\n\nexample end"
+
+	extractor := extractous.New().SetNormalization(extractous.NormalizeAll)
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	content, _, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("Normalized extraction failed: %v", err)
+	}
+	if content != want {
+		t.Errorf("Normalized string is %q, want %q", content, want)
+	}
+
+	// The stages need UTF-8, so they override the configured encoding.
+	reader, _, err := extractor.SetEncoding(extractous.CharSetUTF16BE).ExtractBytes(data)
+	if err != nil {
+		t.Fatalf("Normalized stream extraction failed: %v", err)
+	}
+	streamed, err := io.ReadAll(iotest.OneByteReader(reader))
+	reader.Close()
+	if err != nil {
+		t.Fatalf("Reading the normalized stream failed: %v", err)
+	}
+	if string(streamed) != want {
+		t.Errorf("Normalized stream is %q, want %q", streamed, want)
+	}
+	// Non-ASCII text shows whether the stages saw UTF-8 or UTF-16.
+	reader, _, err = extractor.ExtractBytes([]byte("Café \x01 crème"))
+	if err != nil {
+		t.Fatalf("Normalized stream extraction failed: %v", err)
+	}
+	streamed, err = io.ReadAll(reader)
+	reader.Close()
+	if err != nil || string(streamed) != "Café crème" {
+		t.Errorf("Normalized accented stream is %q (%v), want %q", streamed, err, "Café crème")
+	}
+
+	raw, _, err := extractor.SetNormalization(0).ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("Extraction without normalization failed: %v", err)
+	}
+	if raw == want {
+		t.Error("Expected content to be left as is once normalization is turned off")
+	}
+
+	// Read from the stream, string results are still cut at the max length.
+	capped, _, err := extractor.SetNormalization(extractous.NormalizeAll).
+		SetExtractStringMaxLength(5).ExtractBytesToString(data)
+	if err != nil || capped != "Hello" {
+		t.Errorf("Capped normalized string is %q (%v), want %q", capped, err, "Hello")
+	}
+}
+
+func TestIntegration_Chunks(t *testing.T) {
+	var text strings.Builder
+	for i := 0; text.Len() < 8<<10; i++ {
+		fmt.Fprintf(&text, "Sentence %d of the chunking test. ", i)
+	}
+	data := []byte(text.String())
+
+	extractor := extractous.New()
+	if extractor == nil {
+		t.Fatal("Failed to create extractor")
+	}
+	defer extractor.Close()
+
+	full, _, err := extractor.ExtractBytesToString(data)
+	if err != nil {
+		t.Fatalf("String extraction failed: %v", err)
+	}
+	reader, _, err := extractor.ExtractBytes(data)
+	if err != nil {
+		t.Fatalf("Stream extraction failed: %v", err)
+	}
+	defer reader.Close()
+	if _, err := reader.NextChunk(256, 256); !errors.Is(err, extractous.ErrInvalidConfig) {
+		t.Errorf("Expected ErrInvalidConfig for an overlap of maxBytes, got %v", err)
+	}
+
+	const maxBytes, overlap = 512, 64
+	var chunks []extractous.Chunk
+	for chunk, err := range reader.Chunks(maxBytes, overlap) {
+		if err != nil {
+			t.Fatalf("Chunks failed: %v", err)
+		}
+		chunks = append(chunks, chunk)
+	}
+	if len(chunks) <= len(full)/maxBytes {
+		t.Fatalf("Expected more than %d chunks, got %d", len(full)/maxBytes, len(chunks))
+	}
+
+	var end int64
+	for i, chunk := range chunks {
+		if len(chunk.Data) > maxBytes {
+			t.Errorf("Chunk %d holds %d bytes, more than %d", i, len(chunk.Data), maxBytes)
+		}
+		if i > 0 && (chunk.Offset > end || end-chunk.Offset > overlap) {
+			t.Errorf("Chunk %d starts at %d, want within %d bytes before %d", i, chunk.Offset, overlap, end)
+		}
+		if stop := chunk.Offset + int64(len(chunk.Data)); stop > int64(len(full)) || string(chunk.Data) != full[chunk.Offset:stop] {
+			t.Errorf("Chunk %d does not match the content at offset %d", i, chunk.Offset)
+		}
+		end = chunk.Offset + int64(len(chunk.Data))
+	}
+	if end != int64(len(full)) {
+		t.Errorf("Chunks end at %d, want %d", end, len(full))
+	}
+}
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
@@ -87,7 +87,7 @@ const (
 	//
 	// Modern systems should use UTF-8 instead. Only use UTF-16BE if you have
 	// explicit requirements for this encoding.
-	CharSetUTF16BE CharSet = 2
+	CharSetUTF16BE CharSet = 3
 )
 
 // String returns the human-readable name of the character set.
@@ -308,12 +308,14 @@ func (s PdfOcrStrategy) String() string {
 //
 // Internal use only.
 const (
-	errOK               = 0  // No error
-	errNullPointer      = -1 // Null pointer passed to FFI
-	errInvalidUTF8      = -2 // String is not valid UTF-8
-	errInvalidString    = -3 // String parameter is invalid
-	errExtractionFailed = -4 // Document extraction failed
-	errIOError          = -5 // File I/O error
-	errInvalidConfig    = -6 // Configuration is invalid
-	errInvalidEnum      = -7 // Enum value is invalid
+	errOK               = 0   // No error
+	errNullPointer      = -1  // Null pointer passed to FFI
+	errInvalidUTF8      = -2  // String is not valid UTF-8
+	errInvalidString    = -3  // String parameter is invalid
+	errExtractionFailed = -4  // Document extraction failed
+	errIOError          = -5  // File I/O error
+	errInvalidConfig    = -6  // Configuration is invalid
+	errInvalidEnum      = -7  // Enum value is invalid
+	errOutOfMemory      = -9  // Extraction ran out of memory
+	errCancelled        = -11 // Extraction was cancelled
 )